@@ -1,11 +1,14 @@
 #pragma once
 
+#include <functional>
+
 #include "BSL/integral_types.h"
 #include "BSL/vec_types.h"
 #include "PHX/interface/acceleration_structure.h"
 #include "PHX/interface/buffer.h"
 #include "PHX/interface/uniform.h"
 #include "PHX/types/clear_color.h"
+#include "PHX/types/shader_desc.h"
 #include "PHX/types/status_code.h"
 
 #include "PHX/interface/handle.h"
@@ -17,6 +20,60 @@ namespace PHX
 		u32 assignedFrameIndex;
 	};
 
+	struct TransientUniformAllocation
+	{
+		void* pData = nullptr;	// Persistently mapped memory to write the uniform data to. Only valid until the end of the frame
+		u32 offset = 0;			// Dynamic offset to pass to BindUniformCollection() for the binding reading this allocation
+	};
+
+	struct BufferCopyRegion
+	{
+		u64 dstOffset = 0;			// Offset into the destination buffer, in bytes
+		const void* pData = nullptr;
+		u64 sizeBytes = 0;
+	};
+
+	// Uploads a rectangle of one mip level, for one or more array layers. Data is tightly packed, one layer after the other,
+	// and compressed formats are uploaded in whole 4x4 blocks
+	struct TextureUploadRegion
+	{
+		const void* pData 	= nullptr;
+		u64 sizeBytes 		= 0;
+		u32 mipLevel 		= 0;
+		u32 baseArrayLayer 	= 0;
+		u32 layerCount 		= 0;	// 0 covers every layer from baseArrayLayer
+		u32 offsetX 		= 0;	// In texels. Must be a multiple of 4 for compressed formats
+		u32 offsetY 		= 0;
+		u32 width 			= 0;	// 0 covers the rest of the mip level from offsetX
+		u32 height 			= 0;	// 0 covers the rest of the mip level from offsetY
+	};
+
+	// Matches the layout of an indexed indirect draw command, so batches can be consumed by the GPU as is
+	struct DrawIndexedArgs
+	{
+		u32 indexCount 		= 0;
+		u32 instanceCount 	= 1;
+		u32 firstIndex 		= 0;
+		i32 vertexOffset 	= 0;
+		u32 firstInstance 	= 0;
+	};
+
+	enum class READBACK_STATUS : u8
+	{
+		INVALID = 0,	// Unknown or released ticket
+		PENDING,		// The GPU hasn't finished the frame which recorded the readback yet
+		READY
+	};
+
+	// Identifies a readback until it's released. Generation 0 is never handed out, so a default constructed ticket is invalid
+	struct ReadbackTicket
+	{
+		u32 slot = 0;
+		u32 generation = 0;
+	};
+
+	typedef std::function<void(const void* pData, u64 sizeBytes)> ReadbackCallbackFn;
+
 	struct PHX_API DeviceContextHandle : public Handle
 	{
 		DECLARE_PHX_HANDLE(DeviceContextHandle);
@@ -24,14 +81,27 @@ namespace PHX
 		STATUS_CODE BindVertexBuffer(BufferHandle vertexBuffer);
 		STATUS_CODE BindMesh(BufferHandle vertexBuffer, BufferHandle indexBuffer, INDEX_TYPE indexType = INDEX_TYPE::U32);
 		STATUS_CODE BindUniformCollection(UniformCollectionHandle uniformCollection);
+
+		// Binds a uniform collection with UNIFORM_BUFFER_DYNAMIC or STORAGE_BUFFER_DYNAMIC bindings. There must be one offset per
+		// dynamic binding (per array element), ordered by set and then by binding number
+		STATUS_CODE BindUniformCollection(UniformCollectionHandle uniformCollection, const u32* pDynamicOffsets, u32 dynamicOffsetCount);
 		STATUS_CODE FlushUniformUpdates(UniformCollectionHandle uniformCollection);
 		STATUS_CODE SetViewport(BSL::Vec2u size, BSL::Vec2u offset);
 		STATUS_CODE SetScissor(BSL::Vec2u size, BSL::Vec2u offset);
 
+		// Updates sizeBytes bytes of the bound pipeline's push constants, starting at offsetBytes. The stages must include every
+		// stage of the pipeline's push constant ranges that overlap the update. Offset and size must be multiples of 4
+		STATUS_CODE SetPushConstants(ShaderStageFlags stages, u32 offsetBytes, u32 sizeBytes, const void* data);
+
 		STATUS_CODE Draw(u32 vertexCount);
 		STATUS_CODE DrawIndexed(u32 indexCount, u32 firstIndex = 0, u32 vertexOffset = 0);
 		STATUS_CODE DrawIndexedInstanced(u32 indexCount, u32 instanceCount, u32 firstIndex = 0, u32 vertexOffset = 0, u32 instanceOffset = 0);
 
+		// Records every draw with the currently bound state, for draws which only differ in their ranges. Much cheaper than
+		// the equivalent DrawIndexedInstanced() calls, and larger batches are issued as a single indirect draw when the
+		// device supports multi-draw indirect
+		STATUS_CODE DrawIndexedBatch(const DrawIndexedArgs* pDraws, u32 drawCount);
+
 		// Indirect draws read VkDrawIndexedIndirectCommand records from argsBuffer.
 		// DrawIndexedIndirect issues a fixed CPU-known drawCount draws.
 		// DrawIndexedIndirectCount reads the actual draw count from countBuffer at draw time
@@ -45,7 +115,40 @@ namespace PHX
 		STATUS_CODE BuildBottomLevelAccelerationStructure(AccelerationStructureHandle handle);
 		STATUS_CODE BuildTopLevelAccelerationStructure(AccelerationStructureHandle handle, BufferHandle instanceBuffer, u32 instanceCount);
 
+		// Allocates memory for per-frame shader constants from the transient uniform ring, which the CPU writes to directly. There
+		// is no copy or render graph pass involved, so the data must be written before the frame is submitted, and not be changed
+		// after. Read through bindings set with UniformCollectionHandle::QueueTransientBufferUpdate(), using the allocation's offset
+		// as the dynamic offset. Allocations are released automatically once the GPU is done with the frame
+		STATUS_CODE AllocateTransientUniform(u64 sizeBytes, TransientUniformAllocation& out_allocation);
+
 		STATUS_CODE CopyDataToBuffer(BufferHandle buffer, const void* data, u64 sizeBytes);
+
+		// Updates only the given byte range of the buffer, leaving the rest of its contents untouched
+		STATUS_CODE CopyDataToBuffer(BufferHandle buffer, u64 dstOffset, const void* data, u64 sizeBytes);
+
+		// Scatters several ranges into the buffer at once. All regions are packed into a single staging allocation and copied
+		// with a single transfer command, so this should be preferred over multiple ranged copies to the same buffer. Regions
+		// must not overlap
+		STATUS_CODE CopyDataToBuffer(BufferHandle buffer, const BufferCopyRegion* pRegions, u32 regionCount);
 		STATUS_CODE CopyDataToTexture(TextureHandle texture, const void* data, u64 sizeBytes, u32 mipLevel = 0);
+
+		// Uploads any number of mip levels, layers and subregions at once. All regions are packed into a single staging
+		// allocation and copied with a single transfer command, so this should be preferred over one call per mip level
+		STATUS_CODE CopyDataToTexture(TextureHandle texture, const TextureUploadRegion* pRegions, u32 regionCount);
+
+		// Asynchronous readbacks. The data is copied into pooled host-cached memory, and is available once the GPU is done with
+		// the frame which recorded the copy, usually a few frames later. Nothing ever waits on the GPU: poll the ticket with
+		// GetReadbackStatus(), or pass a callback, which runs when the next frame with the same frame-in-flight index begins.
+		// Readbacks must be recorded in TRANSFER passes which declare the source as an input. Textures must be created with
+		// USAGE_TYPE_FLAG_TRANSFER_SRC, and a single mip level of a single array layer is read back, tightly packed.
+		// Tickets must be released with ReleaseReadback() once the data is consumed so their memory can be reused, except
+		// for readbacks with a callback, which are released automatically after the callback returns
+		STATUS_CODE ReadbackBuffer(BufferHandle buffer, u64 srcOffset, u64 sizeBytes, ReadbackTicket& out_ticket, ReadbackCallbackFn callback = nullptr);
+		STATUS_CODE ReadbackTexture(TextureHandle texture, u32 mipLevel, u32 arrayLayer, ReadbackTicket& out_ticket, ReadbackCallbackFn callback = nullptr);
+		READBACK_STATUS GetReadbackStatus(ReadbackTicket ticket);
+
+		// The returned data stays valid until the ticket is released
+		STATUS_CODE GetReadbackData(ReadbackTicket ticket, const void*& out_pData, u64& out_sizeBytes);
+		void ReleaseReadback(ReadbackTicket ticket);
 	};
 }
\ No newline at end of file
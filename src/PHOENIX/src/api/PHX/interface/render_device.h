@@ -19,6 +19,19 @@ namespace PHX
 		DebugMessageCallbackFn debugMessageCallback = nullptr;
 		WindowHandle window							= INVALID_HANDLE; // Currently unused, but keeping around for possible future multi-window support
 		u32 framesInFlight							= 2;
+
+		// Size in bytes of the staging ring every frame in flight sub-allocates uploads from. Its memory is reused once the
+		// frame that used it is done on the GPU. Uploads that don't fit in the free part of the ring get staging memory of
+		// their own, which is released again as soon as their frame is done
+		u64 stagingRingSize							= 64 * 1024 * 1024;
+
+		// Size in bytes of the transient uniform memory every frame in flight can allocate per-frame shader constants from.
+		// It never grows, so allocations fail once a frame has used it up
+		u64 transientUniformRingSize				= 4 * 1024 * 1024;
+
+		// Size in bytes of the memory every frame in flight can write the indirect commands of batched draws to. Batches that
+		// don't fit in it are recorded as direct draws instead
+		u64 indirectCommandRingSize					= 1 * 1024 * 1024;
 	};
 
 	struct PHX_API RenderDeviceHandle : Handle
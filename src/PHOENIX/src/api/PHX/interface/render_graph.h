@@ -22,7 +22,7 @@ namespace PHX
 	{
 		GRAPHICS = 0,
 		COMPUTE,
-		TRANSFER,
+		TRANSFER,		// Runs on a dedicated transfer queue if the device has one, and the pass doesn't touch any attachment textures
 		RAY_TRACING,
 		AS_BUILD
 	};
@@ -33,15 +33,31 @@ namespace PHX
 
 		// Inputs
 		void SetTextureInput(TextureHandle texture);
+
+		// Reads only the given mip levels and array layers of the texture. Passes using ranges of the same texture which don't
+		// overlap don't depend on each other, and barriers only cover the range
+		void SetTextureInput(TextureHandle texture, const TextureSubresourceRange& range);
+
 		void SetBufferInput(BufferHandle buffer);
 		void SetUniformInput(UniformCollectionHandle uniformCollection); // Not sure if I want to keep this
 		void SetAccelerationStructureInput(AccelerationStructureHandle accelerationStructure);
 
+		// Reads the texture only at the pixel being shaded, through an input attachment (UNIFORM_TYPE::INPUT_ATTACHMENT). The
+		// texture must be created with USAGE_TYPE_FLAG_INPUT_ATTACHMENT, and must not be written by the same pass. This lets the
+		// render graph merge the pass with the passes producing the texture into subpasses of a single render pass, so the
+		// texture never has to leave tile memory on tiled GPUs
+		void SetInputAttachment(TextureHandle texture);
+
 		// Outputs
 		// SetTextureOutput is the generic texture-write entry point. The attachment type (color/depth/
 		// stencil/resolve) is inferred from the texture's aspect flags. Swapchain images are written
 		// through this same path - there is nothing special about them other than being presented.
 		void SetTextureOutput(TextureHandle texture, ATTACHMENT_LOAD_OP loadOp, ATTACHMENT_STORE_OP storeOp, ClearValues clearValue = {});
+
+		// Writes only the given mip levels and array layers of the texture (e.g. one level of a mip chain). Graphics passes
+		// render to a single mip level of all array layers, which requires a texture created with VIEW_SCOPE::PER_MIP
+		void SetTextureOutput(TextureHandle texture, const TextureSubresourceRange& range, ATTACHMENT_LOAD_OP loadOp, ATTACHMENT_STORE_OP storeOp, ClearValues clearValue = {});
+
 		void SetColorOutput(TextureHandle texture);
 		void SetDepthOutput(TextureHandle texture);
 		void SetDepthStencilOutput(TextureHandle texture);
@@ -56,6 +72,17 @@ namespace PHX
 
 		// Callbacks
 		void SetExecuteCallback(ExecuteRenderPassCallbackFn callback);
+
+		// Scheduling
+		// Compute passes only. Submits the pass to a separate compute queue, so it can overlap with graphics work it doesn't
+		// depend on. The pass still waits on the passes producing its inputs. Runs on the graphics queue if the device
+		// doesn't support async compute
+		void SetAsyncCompute(bool asyncCompute);
+
+		// Marks the pass as an output of the render graph. Root passes and all the passes they depend on are never trimmed,
+		// even if nothing else in the frame uses their results (e.g. results read back by the host or used in a later frame).
+		// Headless render graphs have no swapchain image to trim against, so they need at least one root pass
+		void MarkAsRoot();
 	};
 
 	struct PHX_API RenderGraphHandle : public Handle
@@ -64,18 +91,40 @@ namespace PHX
 
 		STATUS_CODE BeginFrame(SwapChainHandle swapChain);
 		STATUS_CODE EndFrame(SwapChainHandle swapChain);
+
+		// Headless frames. No swapchain image is acquired or presented, so frames are only limited by the number of frames
+		// in flight. Must be baked with the headless Bake() overload
+		STATUS_CODE BeginFrame();
+		STATUS_CODE EndFrame();
+
 		STATUS_CODE RegisterPass(const char* passName, PASS_TYPE passType, RenderPassHandle& renderPass);
 
+		// Transient resources are owned by the render graph and only exist for the frame they're created in, so they must be
+		// created every frame before they're used by any pass. Memory is shared between transient resources whose lifetimes
+		// don't overlap in the baked render graph, so their contents are undefined when they're first used in a frame. The
+		// handles stay the same across frames as long as the same resources are created in the same order, but the underlying
+		// objects may be re-created whenever the render graph changes
+		STATUS_CODE CreateTransientTexture(const TextureBaseCreateInfo& baseCreateInfo, const TextureViewCreateInfo& viewCreateInfo, const TextureSamplerCreateInfo& samplerCreateInfo, TextureHandle& texture);
+		STATUS_CODE CreateTransientBuffer(const BufferCreateInfo& createInfo, BufferHandle& buffer);
+
 		// Bakes and executes the render graph. The swap chain is passed in so the graph can identify
 		// which passes write to the current swapchain image (the present target). Any number of passes
 		// may write to it; the last one (in registration order) owns presentation.
 		STATUS_CODE Bake(SwapChainHandle swapChain);
 
+		// Bakes and executes a headless render graph. Passes marked with RenderPassHandle::MarkAsRoot() are the outputs of
+		// the graph, everything they don't depend on is trimmed
+		STATUS_CODE Bake();
+
 		u32 GetFrameNumber() const;
 
 		// Returns the current frame's metrics
 		const Metrics& GetMetrics() const;
 
+		// Returns the GPU metrics of every timed pass in the frame given by Metrics::gpuFrameNumber, in execution order.
+		// Only gathered if Settings::gatherMetrics is set. The returned data is valid until the next call to BeginFrame()
+		const PassMetrics* GetPassMetrics(u32& out_passCount) const;
+
 		// Generates a visualization of the render graph by creating a .dot file. This file can then be
 		// opened with a graph visualization tool such as GraphViz to examine the graph structure. If
 		// the "generateIfUnique" parameter is set to true, a new file will be written out only if the
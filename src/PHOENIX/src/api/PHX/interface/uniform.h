@@ -29,5 +29,10 @@ namespace PHX
 		STATUS_CODE QueueBufferUpdate(BufferHandle buffer, u32 set, u32 binding, u64 offset, u64 size = U64_MAX);
 		STATUS_CODE QueueImageUpdate(TextureHandle texture, u32 set, u32 binding, u32 imageViewIndex, u32 arrayElement = 0);
 		STATUS_CODE QueueAccelerationStructureUpdate(AccelerationStructureHandle accelerationStructure, u32 set, u32 binding);
+
+		// Points a UNIFORM_BUFFER_DYNAMIC or STORAGE_BUFFER_DYNAMIC binding at the transient uniform ring. The allocation the
+		// binding reads from is selected by the dynamic offset passed to DeviceContextHandle::BindUniformCollection(), and
+		// must be at least size bytes large. The ring never moves, so this only has to be flushed once for every frame in flight
+		STATUS_CODE QueueTransientBufferUpdate(u32 set, u32 binding, u64 size);
 	};
 }
\ No newline at end of file
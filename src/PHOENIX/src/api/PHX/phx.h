@@ -14,6 +14,9 @@
 namespace PHX
 {
 	// State calls
+	// Passing an invalid window handle runs the library headless. No surface is created, so swap chains can't be
+	// allocated and render graphs only run through their headless BeginFrame()/Bake()/EndFrame() overloads. Headless
+	// runs work on any Vulkan device, including software implementations
 	PHX_API STATUS_CODE Initialize(const Settings& initSettings, WindowHandle window);
 	PHX_API STATUS_CODE Update(float deltaTime);
 	PHX_API STATUS_CODE Shutdown();
@@ -12,9 +12,8 @@ namespace PHX
 	// Note: TRANSFER_SRC and TRANSFER_DST are intentionally NOT exposed here. TRANSFER_DST is
 	// force-OR'd onto every buffer in BufferVk::BufferVk because CopyDataToBuffer uses a staging
 	// copy (vkCmdCopyBuffer) for all non-uniform buffers, and requiring every call site to
-	// remember the flag is a footgun. TRANSFER_SRC is not currently needed by any API; if a
-	// readback/copy-from-buffer API is added in the future, it should be handled internally
-	// rather than exposing the flag to the client.
+	// remember the flag is a footgun. TRANSFER_SRC is force-OR'd for the same reason, since
+	// DeviceContextHandle::ReadbackBuffer can read back any buffer.
 	enum BUFFER_USAGE_FLAG : u32
 	{
 		BUFFER_USAGE_FLAG_INVALID                            = 0,
@@ -4,6 +4,24 @@
 
 namespace PHX
 {
+	// GPU metrics of a single render graph pass. Transfer passes aren't timed, and pipeline
+	// statistics are only gathered for passes on the graphics queue if Settings::gatherPipelineStatistics is set
+	struct PassMetrics
+	{
+		const char* name = nullptr; // Debug name of the pass, or its index if debug names aren't available
+		u32 frameNumber  = 0;       // Frame the pass was executed in
+
+		// GPU time in milliseconds spent between the start and end of the pass' execution callback
+		float gpuTime = 0.0f;
+
+		// Pipeline statistics. Only valid if hasPipelineStatistics is true
+		bool hasPipelineStatistics    = false;
+		u64 vertexShaderInvocations   = 0;
+		u64 clippingPrimitives        = 0;
+		u64 fragmentShaderInvocations = 0;
+		u64 computeShaderInvocations  = 0;
+	};
+
 	struct Metrics
 	{
 		// Draw stats
@@ -15,9 +33,36 @@ namespace PHX
 		// Uniform updates
 		u32 uniformUpdates  = 0;
 
+		// Pipeline, descriptor set, vertex/index buffer, viewport and scissor commands that weren't recorded, because the
+		// command buffer already had the same state bound
+		u32 skippedStateCommands = 0;
+
+		// Pipeline barriers. A single barrier command holds any number of image and memory barriers
+		u32 barrierCommands = 0;
+		u32 barriers        = 0;
+
+		// Barriers split into an event signal after the producer and a wait before the consumer, so the passes in
+		// between can overlap with the producer
+		u32 splitBarriers   = 0;
+
+		// Pipeline stage bits removed from the render graph's barriers, because shader reflection showed the stages
+		// never access the pass' resources
+		u32 removedStageBits = 0;
+
 		// Passes
 		u32 passCount       = 0;
 
+		// Number of the containers reused every frame that had to grow this frame, plus one for a bake that missed the bake
+		// cache. Covers the render graph's per-frame state (registered passes, resource usages, barriers, execution scratch
+		// memory and pass query records), the scratch memory of the device contexts used to record and submit the frame,
+		// and the readback pool. Zero once the render graph reaches a steady state. This isn't an allocation count: a
+		// container can allocate more than once in a frame, and memory allocated outside of these containers isn't seen
+		u32 frameStorageGrowths = 0;
+
+		// Render graph bake cache. Hits and misses are accumulated over the lifetime of the render graph
+		u32 bakeCacheHits   = 0;
+		u32 bakeCacheMisses = 0;
+
 		// Resource handles
 		u32 bufferCount                = 0;
 		u32 textureCount               = 0;
@@ -29,7 +74,25 @@ namespace PHX
 		// Total allocated GPU memory in bytes
 		u64 allocatedMemoryBytes = 0;
 
+		// Memory in bytes that transient render graph resources are placed in, which is the peak memory they require at
+		// any point in the frame. The unaliased size is how much they would take up if every resource had its own memory
+		u64 transientMemoryBytes          = 0;
+		u64 transientMemoryUnaliasedBytes = 0;
+
+		// Staging memory in bytes held for uploads. Settles at the staging ring and the slabs of small uploads once no upload
+		// overflows the ring. The peak is the highest it has been over the device's lifetime
+		u64 stagingMemoryBytes     = 0;
+		u64 peakStagingMemoryBytes = 0;
+
 		// GPU frame time in milliseconds
 		float gpuFrameTime = 0.0f;
+
+		// Frame the GPU metrics (GPU frame time and pass metrics) were gathered in. GPU results are read back without
+		// waiting on the GPU, so they trail the current frame by the number of frames in flight
+		u32 gpuFrameNumber = 0;
+
+		// CPU time in milliseconds spent resolving the render graph schedule in Bake(), excluding
+		// pass execution. Close to zero when the baked render graph is replayed from the cache
+		float bakeTime     = 0.0f;
 	};
 }
@@ -150,6 +150,14 @@ namespace PHX
 		u32 intersectionShaderIndex = U32_MAX; // Index into pShaders, or U32_MAX if none
 	};
 
+	// Range of push constant bytes visible to the given shader stages. Offset and size are in bytes, and must be multiples of 4
+	struct PushConstantRange
+	{
+		ShaderStageFlags stages = 0;
+		u32 offset              = 0;
+		u32 size                = 0;
+	};
+
 	struct GraphicsPipelineDesc
 	{
 		// Input assembler
@@ -204,6 +212,8 @@ namespace PHX
 
 		// Pipeline layout
 		UniformCollectionHandle uniformCollection	= INVALID_HANDLE;
+		const PushConstantRange* pPushConstantRanges	= nullptr; // If null, the ranges are derived from the shaders' reflection data
+		u32 pushConstantRangeCount					= 0;
 
 		// Shader create info
 		ShaderHandle* pShaders						= nullptr;
@@ -219,6 +229,10 @@ namespace PHX
 		ShaderHandle shader = INVALID_HANDLE;
 		UniformCollectionHandle uniformCollection = INVALID_HANDLE;
 
+		// If null, the range is derived from the shader's reflection data
+		const PushConstantRange* pPushConstantRanges = nullptr;
+		u32 pushConstantRangeCount = 0;
+
 		////////
 		bool operator==(const ComputePipelineDesc& other) const;
 		////////
@@ -236,6 +250,10 @@ namespace PHX
 
 		UniformCollectionHandle uniformCollection = INVALID_HANDLE;
 
+		// If null, the ranges are derived from the shaders' reflection data
+		const PushConstantRange* pPushConstantRanges = nullptr;
+		u32 pushConstantRangeCount = 0;
+
 		u32 maxRecursionDepth = 2;
 
 		////////
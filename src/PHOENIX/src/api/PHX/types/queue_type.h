@@ -8,6 +8,7 @@ namespace PHX
 		PRESENT,
 		TRANSFER,
 		COMPUTE,
+		ASYNC_COMPUTE, // Separate queue that compute passes can opt into, so they overlap with graphics work
 
 		COUNT
 	};
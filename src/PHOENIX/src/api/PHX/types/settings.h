@@ -64,5 +64,9 @@ namespace PHX
 		/* [OPTIONAL ] */ bool enableValidation                                     = false;   // Enable validation messages, whenever applicable
 
 		/* [OPTIONAL ] */ bool enableShaderCache                                    = true;    // Toggle shader caching without clearing the cache directory. If false, always compiles
+
+		/* [OPTIONAL ] */ bool gatherPipelineStatistics                             = false;   // Gather pipeline statistics (shader invocations, clipping primitives) per render graph pass. Requires gatherMetrics, and is ignored if the device doesn't support pipeline statistics queries
+
+		/* [OPTIONAL ] */ u32 recordingThreadCount                                  = 0;       // Number of worker threads render graph passes are recorded on. If 0, passes are recorded on the thread calling Bake(). Otherwise, execution callbacks of different passes can run at the same time, so they must not write to the same uniform collections
 	};
 }
\ No newline at end of file
@@ -68,7 +68,7 @@ namespace PHX
 	struct ShaderUniformData
 	{
 		const char* name        = nullptr;
-		ShaderStageFlags stages = 0;
+		ShaderStageFlags stages = 0; // Stages which access the uniform. Empty if the shader doesn't use it
 		u32 size                = 0;
 		u32 binding             = 0;
 		u32 offset              = 0;
@@ -97,6 +97,8 @@ namespace PHX
 
 		BSL::Vec3u localSize                                = BSL::Vec3u(0); // Only valid for compute shaders
 
+		u32 pushConstantSize                                = 0; // Size in bytes of the shader's push constant block, 0 if it has none
+
 		// Owned string storage for name pointers when loaded from cache.
 		// When compiled via Slang, names point into Slang's internal string pool and this is null.
 		// When deserialized from cache, names point into this arena.
@@ -215,4 +215,17 @@ namespace PHX
 		BC7_UNORM,
 		BC7_SRGB,
 	};
+
+	// Passing this as a count extends a subresource range to the last mip level / array layer of the texture
+	static constexpr u32 REMAINING_SUBRESOURCES = U32_MAX;
+
+	// Range of mip levels and array layers of a texture. Cube map faces are array layers. The default range covers
+	// the entire texture
+	struct TextureSubresourceRange
+	{
+		u32 baseMipLevel	= 0;
+		u32 mipLevelCount	= REMAINING_SUBRESOURCES;
+		u32 baseArrayLayer	= 0;
+		u32 arrayLayerCount	= REMAINING_SUBRESOURCES;
+	};
 }
\ No newline at end of file
@@ -15,6 +15,8 @@ namespace PHX
 		STORAGE_BUFFER,
 		INPUT_ATTACHMENT,
 		ACCELERATION_STRUCTURE,
+		UNIFORM_BUFFER_DYNAMIC,		// Offset is given when the uniform collection is bound, see DeviceContextHandle::AllocateTransientUniform()
+		STORAGE_BUFFER_DYNAMIC,		// Offset is given when the uniform collection is bound, see DeviceContextHandle::AllocateTransientUniform()
 
 		MAX
 	};
@@ -41,7 +41,19 @@ namespace PHX
 		IDeviceContext* pContext = HANDLE_UTILS::ResolveHandle(*this);
 		if (pContext != nullptr)
 		{
-			return pContext->BindUniformCollection(uniformCollection);
+			return pContext->BindUniformCollection(uniformCollection, nullptr, 0);
+		}
+
+		LogError("Failed to bind uniform collection. Could not resolve device context handle!");
+		return STATUS_CODE::ERR_INTERNAL;
+	}
+
+	STATUS_CODE DeviceContextHandle::BindUniformCollection(UniformCollectionHandle uniformCollection, const u32* pDynamicOffsets, u32 dynamicOffsetCount)
+	{
+		IDeviceContext* pContext = HANDLE_UTILS::ResolveHandle(*this);
+		if (pContext != nullptr)
+		{
+			return pContext->BindUniformCollection(uniformCollection, pDynamicOffsets, dynamicOffsetCount);
 		}
 
 		LogError("Failed to bind uniform collection. Could not resolve device context handle!");
@@ -84,6 +96,18 @@ namespace PHX
 		return STATUS_CODE::ERR_INTERNAL;
 	}
 
+	STATUS_CODE DeviceContextHandle::SetPushConstants(ShaderStageFlags stages, u32 offsetBytes, u32 sizeBytes, const void* data)
+	{
+		IDeviceContext* pContext = HANDLE_UTILS::ResolveHandle(*this);
+		if (pContext != nullptr)
+		{
+			return pContext->SetPushConstants(stages, offsetBytes, sizeBytes, data);
+		}
+
+		LogError("Failed to set push constants. Could not resolve device context handle!");
+		return STATUS_CODE::ERR_INTERNAL;
+	}
+
 	STATUS_CODE DeviceContextHandle::Draw(u32 vertexCount)
 	{
 		IDeviceContext* pContext = HANDLE_UTILS::ResolveHandle(*this);
@@ -120,6 +144,18 @@ namespace PHX
 		return STATUS_CODE::ERR_INTERNAL;
 	}
 
+	STATUS_CODE DeviceContextHandle::DrawIndexedBatch(const DrawIndexedArgs* pDraws, u32 drawCount)
+	{
+		IDeviceContext* pContext = HANDLE_UTILS::ResolveHandle(*this);
+		if (pContext != nullptr)
+		{
+			return pContext->DrawIndexedBatch(pDraws, drawCount);
+		}
+
+		LogError("Failed to issue draw indexed batch. Could not resolve device context handle!");
+		return STATUS_CODE::ERR_INTERNAL;
+	}
+
 	STATUS_CODE DeviceContextHandle::DrawIndexedIndirect(BufferHandle argsBuffer, u32 drawCount, u32 stride, u64 argsOffset)
 	{
 		IDeviceContext* pContext = HANDLE_UTILS::ResolveHandle(*this);
@@ -192,12 +228,39 @@ namespace PHX
 		return STATUS_CODE::ERR_INTERNAL;
 	}
 
+	STATUS_CODE DeviceContextHandle::AllocateTransientUniform(u64 sizeBytes, TransientUniformAllocation& out_allocation)
+	{
+		IDeviceContext* pContext = HANDLE_UTILS::ResolveHandle(*this);
+		if (pContext != nullptr)
+		{
+			return pContext->AllocateTransientUniform(sizeBytes, out_allocation);
+		}
+
+		LogError("Failed to allocate transient uniform. Could not resolve device context handle!");
+		return STATUS_CODE::ERR_INTERNAL;
+	}
+
 	STATUS_CODE DeviceContextHandle::CopyDataToBuffer(BufferHandle buffer, const void* data, u64 sizeBytes)
+	{
+		return CopyDataToBuffer(buffer, 0, data, sizeBytes);
+	}
+
+	STATUS_CODE DeviceContextHandle::CopyDataToBuffer(BufferHandle buffer, u64 dstOffset, const void* data, u64 sizeBytes)
+	{
+		BufferCopyRegion region{};
+		region.dstOffset = dstOffset;
+		region.pData = data;
+		region.sizeBytes = sizeBytes;
+
+		return CopyDataToBuffer(buffer, &region, 1);
+	}
+
+	STATUS_CODE DeviceContextHandle::CopyDataToBuffer(BufferHandle buffer, const BufferCopyRegion* pRegions, u32 regionCount)
 	{
 		IDeviceContext* pContext = HANDLE_UTILS::ResolveHandle(*this);
 		if (pContext != nullptr)
 		{
-			return pContext->CopyDataToBuffer(buffer, data, sizeBytes);
+			return pContext->CopyDataToBuffer(buffer, pRegions, regionCount);
 		}
 
 		LogError("Failed to copy data to buffer. Could not resolve device context handle!");
@@ -205,14 +268,84 @@ namespace PHX
 	}
 
 	STATUS_CODE DeviceContextHandle::CopyDataToTexture(TextureHandle texture, const void* data, u64 sizeBytes, u32 mipLevel)
+	{
+		TextureUploadRegion region{};
+		region.pData = data;
+		region.sizeBytes = sizeBytes;
+		region.mipLevel = mipLevel;
+
+		return CopyDataToTexture(texture, &region, 1);
+	}
+
+	STATUS_CODE DeviceContextHandle::CopyDataToTexture(TextureHandle texture, const TextureUploadRegion* pRegions, u32 regionCount)
 	{
 		IDeviceContext* pContext = HANDLE_UTILS::ResolveHandle(*this);
 		if (pContext != nullptr)
 		{
-			return pContext->CopyDataToTexture(texture, data, sizeBytes, mipLevel);
+			return pContext->CopyDataToTexture(texture, pRegions, regionCount);
 		}
 
 		LogError("Failed to copy data to texture. Could not resolve device context handle!");
 		return STATUS_CODE::ERR_INTERNAL;
 	}
+
+	STATUS_CODE DeviceContextHandle::ReadbackBuffer(BufferHandle buffer, u64 srcOffset, u64 sizeBytes, ReadbackTicket& out_ticket, ReadbackCallbackFn callback)
+	{
+		IDeviceContext* pContext = HANDLE_UTILS::ResolveHandle(*this);
+		if (pContext != nullptr)
+		{
+			return pContext->ReadbackBuffer(buffer, srcOffset, sizeBytes, out_ticket, callback);
+		}
+
+		LogError("Failed to read back buffer. Could not resolve device context handle!");
+		return STATUS_CODE::ERR_INTERNAL;
+	}
+
+	STATUS_CODE DeviceContextHandle::ReadbackTexture(TextureHandle texture, u32 mipLevel, u32 arrayLayer, ReadbackTicket& out_ticket, ReadbackCallbackFn callback)
+	{
+		IDeviceContext* pContext = HANDLE_UTILS::ResolveHandle(*this);
+		if (pContext != nullptr)
+		{
+			return pContext->ReadbackTexture(texture, mipLevel, arrayLayer, out_ticket, callback);
+		}
+
+		LogError("Failed to read back texture. Could not resolve device context handle!");
+		return STATUS_CODE::ERR_INTERNAL;
+	}
+
+	READBACK_STATUS DeviceContextHandle::GetReadbackStatus(ReadbackTicket ticket)
+	{
+		IDeviceContext* pContext = HANDLE_UTILS::ResolveHandle(*this);
+		if (pContext != nullptr)
+		{
+			return pContext->GetReadbackStatus(ticket);
+		}
+
+		LogError("Failed to get readback status. Could not resolve device context handle!");
+		return READBACK_STATUS::INVALID;
+	}
+
+	STATUS_CODE DeviceContextHandle::GetReadbackData(ReadbackTicket ticket, const void*& out_pData, u64& out_sizeBytes)
+	{
+		IDeviceContext* pContext = HANDLE_UTILS::ResolveHandle(*this);
+		if (pContext != nullptr)
+		{
+			return pContext->GetReadbackData(ticket, out_pData, out_sizeBytes);
+		}
+
+		LogError("Failed to get readback data. Could not resolve device context handle!");
+		return STATUS_CODE::ERR_INTERNAL;
+	}
+
+	void DeviceContextHandle::ReleaseReadback(ReadbackTicket ticket)
+	{
+		IDeviceContext* pContext = HANDLE_UTILS::ResolveHandle(*this);
+		if (pContext != nullptr)
+		{
+			pContext->ReleaseReadback(ticket);
+			return;
+		}
+
+		LogError("Failed to release readback. Could not resolve device context handle!");
+	}
 }
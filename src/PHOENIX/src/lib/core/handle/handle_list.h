@@ -124,6 +124,14 @@ namespace PHX
 			m_freeList.clear();
 		}
 
+		// Empties the list without deleting the objects. Used for objects whose memory is owned
+		// elsewhere (e.g. render passes, which the render graph reuses every frame)
+		void Clear()
+		{
+			m_slots.clear();
+			m_freeList.clear();
+		}
+
 		// Returns number of slots, including free ones
 		u32 Size() const
 		{
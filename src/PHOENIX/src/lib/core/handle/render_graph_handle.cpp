@@ -16,6 +16,15 @@ namespace PHX
 		}
 	}
 
+	void RenderPassHandle::SetTextureInput(TextureHandle texture, const TextureSubresourceRange& range)
+	{
+		IRenderPass* pPass = HANDLE_UTILS::ResolveHandle(*this);
+		if (pPass != nullptr)
+		{
+			return pPass->SetTextureInput(texture, range);
+		}
+	}
+
 	void RenderPassHandle::SetBufferInput(BufferHandle buffer)
 	{
 		IRenderPass* pPass = HANDLE_UTILS::ResolveHandle(*this);
@@ -43,6 +52,15 @@ namespace PHX
 		}
 	}
 
+	void RenderPassHandle::SetInputAttachment(TextureHandle texture)
+	{
+		IRenderPass* pPass = HANDLE_UTILS::ResolveHandle(*this);
+		if (pPass != nullptr)
+		{
+			return pPass->SetInputAttachment(texture);
+		}
+	}
+
 	void RenderPassHandle::SetColorOutput(TextureHandle texture)
 	{
 		IRenderPass* pPass = HANDLE_UTILS::ResolveHandle(*this);
@@ -88,6 +106,15 @@ namespace PHX
 		}
 	}
 
+	void RenderPassHandle::SetTextureOutput(TextureHandle texture, const TextureSubresourceRange& range, ATTACHMENT_LOAD_OP loadOp, ATTACHMENT_STORE_OP storeOp, ClearValues clearValue)
+	{
+		IRenderPass* pPass = HANDLE_UTILS::ResolveHandle(*this);
+		if (pPass != nullptr)
+		{
+			return pPass->SetTextureOutput(texture, range, loadOp, storeOp, clearValue);
+		}
+	}
+
 	void RenderPassHandle::SetBufferOutput(BufferHandle buffer)
 	{
 		IRenderPass* pPass = HANDLE_UTILS::ResolveHandle(*this);
@@ -142,6 +169,24 @@ namespace PHX
 		}
 	}
 
+	void RenderPassHandle::SetAsyncCompute(bool asyncCompute)
+	{
+		IRenderPass* pPass = HANDLE_UTILS::ResolveHandle(*this);
+		if (pPass != nullptr)
+		{
+			return pPass->SetAsyncCompute(asyncCompute);
+		}
+	}
+
+	void RenderPassHandle::MarkAsRoot()
+	{
+		IRenderPass* pPass = HANDLE_UTILS::ResolveHandle(*this);
+		if (pPass != nullptr)
+		{
+			return pPass->MarkAsRoot();
+		}
+	}
+
 	/////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	RenderGraphHandle::RenderGraphHandle() : Handle(HANDLE_TYPE::RENDER_GRAPH)
@@ -199,6 +244,30 @@ namespace PHX
 		return STATUS_CODE::ERR_INTERNAL;
 	}
 
+	STATUS_CODE RenderGraphHandle::BeginFrame()
+	{
+		IRenderGraph* pGraph = HANDLE_UTILS::ResolveHandle(*this);
+		if (pGraph != nullptr)
+		{
+			return pGraph->BeginFrame();
+		}
+
+		ASSERT_ALWAYS("Failed to begin headless frame. Could not resolve render graph handle!");
+		return STATUS_CODE::ERR_INTERNAL;
+	}
+
+	STATUS_CODE RenderGraphHandle::EndFrame()
+	{
+		IRenderGraph* pGraph = HANDLE_UTILS::ResolveHandle(*this);
+		if (pGraph != nullptr)
+		{
+			return pGraph->EndFrame();
+		}
+
+		ASSERT_ALWAYS("Failed to end headless frame. Could not resolve render graph handle!");
+		return STATUS_CODE::ERR_INTERNAL;
+	}
+
 	STATUS_CODE RenderGraphHandle::RegisterPass(const char* passName, PASS_TYPE passType, RenderPassHandle& renderPass)
 	{
 		IRenderGraph* pGraph = HANDLE_UTILS::ResolveHandle(*this);
@@ -211,6 +280,30 @@ namespace PHX
 		return STATUS_CODE::ERR_INTERNAL;
 	}
 
+	STATUS_CODE RenderGraphHandle::CreateTransientTexture(const TextureBaseCreateInfo& baseCreateInfo, const TextureViewCreateInfo& viewCreateInfo, const TextureSamplerCreateInfo& samplerCreateInfo, TextureHandle& texture)
+	{
+		IRenderGraph* pGraph = HANDLE_UTILS::ResolveHandle(*this);
+		if (pGraph != nullptr)
+		{
+			return pGraph->CreateTransientTexture(baseCreateInfo, viewCreateInfo, samplerCreateInfo, texture);
+		}
+
+		ASSERT_ALWAYS("Failed to create transient texture. Could not resolve render graph handle!");
+		return STATUS_CODE::ERR_INTERNAL;
+	}
+
+	STATUS_CODE RenderGraphHandle::CreateTransientBuffer(const BufferCreateInfo& createInfo, BufferHandle& buffer)
+	{
+		IRenderGraph* pGraph = HANDLE_UTILS::ResolveHandle(*this);
+		if (pGraph != nullptr)
+		{
+			return pGraph->CreateTransientBuffer(createInfo, buffer);
+		}
+
+		ASSERT_ALWAYS("Failed to create transient buffer. Could not resolve render graph handle!");
+		return STATUS_CODE::ERR_INTERNAL;
+	}
+
 	STATUS_CODE RenderGraphHandle::Bake(SwapChainHandle swapChain)
 	{
 		IRenderGraph* pGraph = HANDLE_UTILS::ResolveHandle(*this);
@@ -259,4 +352,17 @@ namespace PHX
 		static Metrics s_defaultMetrics{};
 		return s_defaultMetrics;
 	}
+
+	const PassMetrics* RenderGraphHandle::GetPassMetrics(u32& out_passCount) const
+	{
+		IRenderGraph* pGraph = HANDLE_UTILS::ResolveHandle(*this);
+		if (pGraph != nullptr)
+		{
+			return pGraph->GetPassMetrics(out_passCount);
+		}
+
+		ASSERT_ALWAYS("Failed to get pass metrics. Could not resolve render graph handle!");
+		out_passCount = 0;
+		return nullptr;
+	}
 }
\ No newline at end of file
@@ -79,4 +79,16 @@ namespace PHX
 		return STATUS_CODE::ERR_INTERNAL;
 	}
 
+	STATUS_CODE UniformCollectionHandle::QueueTransientBufferUpdate(u32 set, u32 binding, u64 size)
+	{
+		IUniformCollection* pUniformCollection = HANDLE_UTILS::ResolveHandle(*this);
+		if (pUniformCollection != nullptr)
+		{
+			return pUniformCollection->QueueTransientBufferUpdate(set, binding, size);
+		}
+
+		LogError("Failed to queue transient buffer update. Could not resolve uniform collection handle!");
+		return STATUS_CODE::ERR_INTERNAL;
+	}
+
 }
\ No newline at end of file
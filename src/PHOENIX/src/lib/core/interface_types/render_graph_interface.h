@@ -24,12 +24,15 @@ namespace PHX
 
 		// Inputs
 		virtual void SetTextureInput(TextureHandle texture) = 0;
+		virtual void SetTextureInput(TextureHandle texture, const TextureSubresourceRange& range) = 0;
 		virtual void SetBufferInput(BufferHandle buffer) = 0;							// Not sure if I want to keep this
 		virtual void SetUniformInput(UniformCollectionHandle uniformCollection) = 0;	// Not sure if I want to keep this
 		virtual void SetAccelerationStructureInput(AccelerationStructureHandle accelerationStructure) = 0;
+		virtual void SetInputAttachment(TextureHandle texture) = 0;
 
 		// Outputs
 		virtual void SetTextureOutput(TextureHandle handle, ATTACHMENT_LOAD_OP loadOp, ATTACHMENT_STORE_OP storeOp, ClearValues clearValue = {}) = 0;
+		virtual void SetTextureOutput(TextureHandle handle, const TextureSubresourceRange& range, ATTACHMENT_LOAD_OP loadOp, ATTACHMENT_STORE_OP storeOp, ClearValues clearValue = {}) = 0;
 		virtual void SetColorOutput(TextureHandle handle) = 0;
 		virtual void SetDepthOutput(TextureHandle handle) = 0;
 		virtual void SetDepthStencilOutput(TextureHandle handle) = 0;
@@ -44,6 +47,10 @@ namespace PHX
 
 		// Callbacks
 		virtual void SetExecuteCallback(ExecuteRenderPassCallbackFn callback) = 0;
+
+		// Scheduling
+		virtual void SetAsyncCompute(bool asyncCompute) = 0;
+		virtual void MarkAsRoot() = 0;
 	};
 
 	class IRenderGraph : public RefCounted, public HandleOwner
@@ -54,12 +61,18 @@ namespace PHX
 
 		virtual STATUS_CODE BeginFrame(SwapChainHandle swapChain) = 0;
 		virtual STATUS_CODE EndFrame(SwapChainHandle swapChain) = 0;
+		virtual STATUS_CODE BeginFrame() = 0;
+		virtual STATUS_CODE EndFrame() = 0;
 		virtual STATUS_CODE RegisterPass(const char* passName, PASS_TYPE passType, RenderPassHandle& renderPass) = 0;
+		virtual STATUS_CODE CreateTransientTexture(const TextureBaseCreateInfo& baseCreateInfo, const TextureViewCreateInfo& viewCreateInfo, const TextureSamplerCreateInfo& samplerCreateInfo, TextureHandle& texture) = 0;
+		virtual STATUS_CODE CreateTransientBuffer(const BufferCreateInfo& createInfo, BufferHandle& buffer) = 0;
 		virtual STATUS_CODE Bake(SwapChainHandle swapChain) = 0;
+		virtual STATUS_CODE Bake() = 0;
 
 		virtual u32 GetFrameNumber() const = 0;
 
 		virtual const Metrics& GetMetrics() const = 0;
+		virtual const PassMetrics* GetPassMetrics(u32& out_passCount) const = 0;
 
 		// Generates a visualization of the render graph by creating a .dot file. This file can then be
 		// opened with a graph visualization tool such as GraphViz to examine the graph structure. If
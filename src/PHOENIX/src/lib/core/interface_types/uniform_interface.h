@@ -26,5 +26,6 @@ namespace PHX
 		virtual STATUS_CODE QueueBufferUpdate(BufferHandle buffer, u32 set, u32 binding, u64 offset, u64 size) = 0;
 		virtual STATUS_CODE QueueImageUpdate(TextureHandle texture, u32 set, u32 binding, u32 imageViewIndex, u32 arrayElement) = 0;
 		virtual STATUS_CODE QueueAccelerationStructureUpdate(AccelerationStructureHandle accelerationStructure, u32 set, u32 binding) = 0;
+		virtual STATUS_CODE QueueTransientBufferUpdate(u32 set, u32 binding, u64 size) = 0;
 	};
 }
\ No newline at end of file
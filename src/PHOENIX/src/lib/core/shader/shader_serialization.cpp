@@ -11,8 +11,10 @@ using namespace BSL;
 namespace PHX
 {
 	// PHXS magic number and format version
+	// Version 2: Uniform stages hold the stages that actually use the uniform, rather than always being 0
+	// Version 3: Push constant block size, push constant blocks are no longer listed as uniforms
 	static constexpr u32 PHXS_MAGIC = BSL::MakeMagicNumber("PHXS");
-	static constexpr u32 PHXS_VERSION = 1;
+	static constexpr u32 PHXS_VERSION = 3;
 
 	static void WriteIOEntry(std::ostream& os, const ShaderIOData& io)
 	{
@@ -76,6 +78,9 @@ namespace PHX
 			WriteTrivial(os, r.localSize.GetX());
 			WriteTrivial(os, r.localSize.GetY());
 			WriteTrivial(os, r.localSize.GetZ());
+
+			// Push constants
+			WriteTrivial(os, r.pushConstantSize);
 		}
 
 		// Shader bytecode
@@ -176,6 +181,9 @@ namespace PHX
 			u32 lz = ReadTrivial<u32>(is);
 			r.localSize = Vec3u(lx, ly, lz);
 
+			// Push constants
+			r.pushConstantSize = ReadTrivial<u32>(is);
+
 			r.isValid = true;
 
 			// Build string arena
@@ -1,4 +1,5 @@
 
+#include <algorithm>
 #include <filesystem>
 #include <slang.h>
 #include <slang-com-ptr.h>
@@ -72,7 +73,7 @@ namespace PHX
 		return g_slangGlobalSession;
 	}
 
-	static bool CheckMandatorySettings(const PHX::Settings& settings)
+	static bool CheckMandatorySettings(const PHX::Settings& settings, bool hasWindow)
 	{
 		bool isValid = true;
 
@@ -90,34 +91,38 @@ namespace PHX
 			isValid = false;
 		}
 
-		if (settings.swapChainOutdatedCallback == nullptr)
+		// Window and swap chain callbacks are never called when running headless
+		if (hasWindow)
 		{
-			LogError("Mandatory setting \"swapChainOutdatedCallback\" has not been set!");
-			isValid = false;
-		}
+			if (settings.swapChainOutdatedCallback == nullptr)
+			{
+				LogError("Mandatory setting \"swapChainOutdatedCallback\" has not been set!");
+				isValid = false;
+			}
 
-		if (settings.windowFocusChangedCallback == nullptr)
-		{
-			LogError("Mandatory setting \"windowFocusChangedCallback\" has not been set!");
-			isValid = false;
-		}
+			if (settings.windowFocusChangedCallback == nullptr)
+			{
+				LogError("Mandatory setting \"windowFocusChangedCallback\" has not been set!");
+				isValid = false;
+			}
 
-		if (settings.windowMaximizedCallback == nullptr)
-		{
-			LogError("Mandatory setting \"windowMaximizedCallback\" has not been set!");
-			isValid = false;
-		}
+			if (settings.windowMaximizedCallback == nullptr)
+			{
+				LogError("Mandatory setting \"windowMaximizedCallback\" has not been set!");
+				isValid = false;
+			}
 
-		if (settings.windowMinimizedCallback == nullptr)
-		{
-			LogError("Mandatory setting \"windowMinimizedCallback\" has not been set!");
-			isValid = false;
-		}
+			if (settings.windowMinimizedCallback == nullptr)
+			{
+				LogError("Mandatory setting \"windowMinimizedCallback\" has not been set!");
+				isValid = false;
+			}
 
-		if (settings.windowResizedCallback == nullptr)
-		{
-			LogError("Mandatory setting \"windowResizedCallback\" has not been set!");
-			isValid = false;
+			if (settings.windowResizedCallback == nullptr)
+			{
+				LogError("Mandatory setting \"windowResizedCallback\" has not been set!");
+				isValid = false;
+			}
 		}
 
 		if (settings.cacheDirectory == nullptr || settings.cacheDirectory[0] == '\0')
@@ -131,13 +136,9 @@ namespace PHX
 
 	STATUS_CODE Initialize(const Settings& initSettings, WindowHandle window)
 	{
-		if (!window.IsValid())
-		{
-			LogError("Failed to initialize library. Window handle is invalid!");
-			return STATUS_CODE::ERR_API;
-		}
-
-		if (!CheckMandatorySettings(initSettings))
+		// Without a window, the library runs headless
+		const bool hasWindow = window.IsValid();
+		if (!CheckMandatorySettings(initSettings, hasWindow))
 		{
 			// Errors are logged in the check function specifically for what's missing
 			LogError("Failed to initialize library! One or more mandatory settings have not been set");
@@ -366,23 +367,57 @@ namespace PHX
 				return STATUS_CODE::ERR_INTERNAL;
 			}
 
-			// UNIFORMS (global shader parameters)
+			// UNIFORMS and PUSH CONSTANTS (global shader parameters)
 			{
 				u32 paramCount = programLayout->getParameterCount();
 				if (paramCount > 0)
 				{
 					out_result.reflectionData.uniforms = std::shared_ptr<ShaderUniformData[]>(new ShaderUniformData[paramCount]);
-					out_result.reflectionData.uniformCount = paramCount;
+					out_result.reflectionData.uniformCount = 0;
+
+					// Global parameters are declared for the whole module, so the entry point metadata is used to tell
+					// which of them this stage actually accesses. The render graph relies on this to only synchronize
+					// the stages that touch a pass' resources
+					Slang::ComPtr<slang::IMetadata> metadata;
+					diagnostics = nullptr;
+					result = composedProgram->getEntryPointMetadata(0, 0, metadata.writeRef(), diagnostics.writeRef());
+					if (SLANG_FAILED(result))
+					{
+						metadata = nullptr;
+					}
 
+					const ShaderStageFlags stageFlag = static_cast<ShaderStageFlags>(1u << static_cast<u32>(srcData.stage));
 					for (u32 i = 0; i < paramCount; i++)
 					{
 						slang::VariableLayoutReflection* param = programLayout->getParameterByIndex(i);
-						ShaderUniformData& uniformData = out_result.reflectionData.uniforms[i];
+
+						// Push constant blocks ([[vk::push_constant]]) don't occupy a descriptor binding, so they're not uniforms.
+						// Slang always places them at offset 0, so only the size of the block is needed to build the range
+						if (param->getCategory() == slang::ParameterCategory::PushConstantBuffer)
+						{
+							slang::TypeLayoutReflection* elementTypeLayout = param->getTypeLayout()->getElementTypeLayout();
+							const u32 blockSize = static_cast<u32>((elementTypeLayout != nullptr) ? elementTypeLayout->getSize() : param->getTypeLayout()->getSize());
+							out_result.reflectionData.pushConstantSize = std::max(out_result.reflectionData.pushConstantSize, blockSize);
+							continue;
+						}
+
+						ShaderUniformData& uniformData = out_result.reflectionData.uniforms[out_result.reflectionData.uniformCount++];
 						uniformData.name = param->getName();
 						uniformData.binding = param->getBindingIndex();
 						uniformData.size = static_cast<u32>(param->getTypeLayout()->getSize());
-						uniformData.stages = 0; // Global parameters are accessible from all stages
 						uniformData.offset = static_cast<u32>(param->getOffset());
+
+						// Assume the parameter is used if Slang can't tell
+						bool isUsed = true;
+						if (metadata != nullptr)
+						{
+							const SlangParameterCategory category = static_cast<SlangParameterCategory>(param->getCategory());
+							if (SLANG_FAILED(metadata->isParameterLocationUsed(category, param->getBindingSpace(), param->getBindingIndex(), isUsed)))
+							{
+								isUsed = true;
+							}
+						}
+						uniformData.stages = isUsed ? stageFlag : 0;
 					}
 				}
 			}
@@ -42,10 +42,9 @@ namespace PHX
 
 		// TRANSFER_DST is added onto every buffer because CopyDataToBuffer uses a staging
 		// buffer + vkCmdCopyBuffer for all non-uniform buffers. This is harmless on buffers that 
-		// are never copied to (the driver ignores unused usage flags). TRANSFER_SRC is NOT added,
-		// no current API copies from a user buffer to elsewhere. If this is implemented in the future
-		// it will be handled then
-		const VkBufferUsageFlags bufferUsageFlags = BUFFER_UTILS::ConvertBufferUsageFlags(createInfo.bufferUsage) | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		// are never copied to (the driver ignores unused usage flags). TRANSFER_SRC is added for
+		// the same reason, since ReadbackBuffer copies from any buffer into readback memory
+		const VkBufferUsageFlags bufferUsageFlags = BUFFER_UTILS::ConvertBufferUsageFlags(createInfo.bufferUsage) | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
 		newBuffer = CreateBuffer(m_renderDevice, createInfo.pName, createInfo.sizeBytes, bufferUsageFlags, bufferCreateFlags, 0, 0);
 		if (!newBuffer.isValid)
 		{
@@ -58,6 +57,39 @@ namespace PHX
 		m_usage = createInfo.bufferUsage;
 	}
 
+	BufferVk::BufferVk(RenderDeviceVk* pRenderDevice, const BufferCreateInfo& createInfo, VmaAllocation aliasedAlloc, VkDeviceSize aliasedOffset) : m_renderDevice(VK_NULL_HANDLE), m_pName(""), m_usage()
+	{
+		if (createInfo.sizeBytes == 0)
+		{
+			LogError("Failed to create aliased buffer. Buffer size is 0!");
+			return;
+		}
+
+		// Aliased memory is not host visible, so it can't be directly mapped
+		if (ShouldUseDirectMemoryMapping(createInfo.bufferUsage))
+		{
+			LogError("Failed to create aliased buffer. Directly mapped buffers can't be aliased!");
+			return;
+		}
+
+		HasConflictingUsageFlags(createInfo.bufferUsage);
+
+		m_renderDevice = pRenderDevice;
+
+		// See the comment in the constructor above regarding TRANSFER_SRC/TRANSFER_DST
+		const VkBufferUsageFlags bufferUsageFlags = BUFFER_UTILS::ConvertBufferUsageFlags(createInfo.bufferUsage) | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		BufferData newBuffer = CreateAliasedBuffer(m_renderDevice, createInfo.pName, createInfo.sizeBytes, bufferUsageFlags, aliasedAlloc, aliasedOffset);
+		if (!newBuffer.isValid)
+		{
+			LogError("Failed to create aliased buffer!");
+			return;
+		}
+
+		m_pName = createInfo.pName;
+		m_buffer = newBuffer;
+		m_usage = createInfo.bufferUsage;
+	}
+
 	BufferVk::~BufferVk()
 	{
 		DestroyBuffer(m_renderDevice, m_buffer);
@@ -78,7 +110,7 @@ namespace PHX
 		return m_buffer.size;
 	}
 
-	STATUS_CODE BufferVk::CopyToMappedData(const void* data, u64 sizeBytes)
+	STATUS_CODE BufferVk::CopyToMappedData(const void* data, u64 sizeBytes, u64 dstOffset)
 	{
 		PROFILE_SCOPE("BufferVk_CopyToMappedData");
 
@@ -96,7 +128,7 @@ namespace PHX
 			return STATUS_CODE::SUCCESS;
 		}
 
-		VkResult res = vmaCopyMemoryToAllocation(m_renderDevice->GetAllocator(), data, m_buffer.alloc, 0, sizeBytes);
+		VkResult res = vmaCopyMemoryToAllocation(m_renderDevice->GetAllocator(), data, m_buffer.alloc, dstOffset, sizeBytes);
 		if (res != VK_SUCCESS)
 		{
 			LogError("Failed to copy data to buffer! Got result: \"%s\"", string_VkResult(res));
@@ -12,6 +12,7 @@ namespace PHX
 	public:
 
 		explicit BufferVk(RenderDeviceVk* pRenderDevice, const BufferCreateInfo& createInfo);
+		explicit BufferVk(RenderDeviceVk* pRenderDevice, const BufferCreateInfo& createInfo, VmaAllocation aliasedAlloc, VkDeviceSize aliasedOffset); // Create buffer in existing memory (e.g. aliased transient resources)
 		~BufferVk();
 
 		const char* GetName() const override;
@@ -20,7 +21,7 @@ namespace PHX
 
 		// Copies to mapped data only. If the buffer's data is not directly mapped
 		// this function will do nothing
-		STATUS_CODE CopyToMappedData(const void* data, u64 sizeBytes);
+		STATUS_CODE CopyToMappedData(const void* data, u64 sizeBytes, u64 dstOffset = 0);
 
 		VkBuffer GetBuffer() const;
 		VkDeviceSize GetOffset() const;
@@ -69,8 +69,14 @@ namespace PHX
 		"VK_LAYER_KHRONOS_validation"
 	};
 
-	static std::vector<const char*> GetRequiredExtensions()
+	static std::vector<const char*> GetRequiredExtensions(bool hasWindow)
 	{
+		// Surface extensions are only needed to present to a window
+		if (!hasWindow)
+		{
+			return {};
+		}
+
 		uint32_t glfwExtensionCount = 0;
 		const char** glfwExtensions;
 		glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
@@ -118,16 +124,23 @@ namespace PHX
 		// Set the API version
 		m_apiVersion = VK_MAKE_API_VERSION(0, settings.backendAPIMajorVersion, settings.backendAPIMinorVersion, 0);
 
-		res = CreateInstance(settings.enableValidation);
+		res = CreateInstance(settings.enableValidation, window.IsValid());
 		if (res != STATUS_CODE::SUCCESS)
 		{
 			return res;
 		}
 
-		res = CreateSurface(window);
-		if (res != STATUS_CODE::SUCCESS)
+		if (window.IsValid())
 		{
-			return res;
+			res = CreateSurface(window);
+			if (res != STATUS_CODE::SUCCESS)
+			{
+				return res;
+			}
+		}
+		else
+		{
+			LogInfo("No window was provided, running headless");
 		}
 
 		LogInfo("Successfully initialized Vulkan version %u.%u.%u", VK_API_VERSION_MAJOR(m_apiVersion), VK_API_VERSION_MINOR(m_apiVersion), VK_API_VERSION_PATCH(m_apiVersion));
@@ -160,7 +173,7 @@ namespace PHX
 		DestroyInstance();
 	}
 
-	STATUS_CODE CoreVk::CreateInstance(bool enableValidationLayers)
+	STATUS_CODE CoreVk::CreateInstance(bool enableValidationLayers, bool hasWindow)
 	{
 		// Check that we support all requested validation layers
 		if (enableValidationLayers && !CheckValidationLayerSupport())
@@ -189,7 +202,7 @@ namespace PHX
 			createInfo.ppEnabledLayerNames = g_ValidationLayers.data();
 		}
 
-		std::vector<const char*> requiredExtensions = GetRequiredExtensions();
+		std::vector<const char*> requiredExtensions = GetRequiredExtensions(hasWindow);
 
 		if (enableValidationLayers)
 		{
@@ -283,7 +296,12 @@ namespace PHX
 
 	void CoreVk::DestroySurface()
 	{
-		vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
+		// Headless instances don't enable the surface extension
+		if (m_surface != VK_NULL_HANDLE)
+		{
+			vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
+			m_surface = VK_NULL_HANDLE;
+		}
 	}
 
 }
\ No newline at end of file
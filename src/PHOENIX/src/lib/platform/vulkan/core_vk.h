@@ -18,10 +18,11 @@ namespace PHX
 			return instance;
 		}
 
+		// Runs headless if the window handle is invalid
 		STATUS_CODE Initialize(WindowHandle window);
 
 		VkInstance GetInstance() const;
-		VkSurfaceKHR GetSurface() const;
+		VkSurfaceKHR GetSurface() const; // VK_NULL_HANDLE when running headless
 
 		// Returns the API version, made through VK_MAKE_API_VERSION(X, Y, Z)
 		u32 GetAPIVersion() const;
@@ -31,7 +32,7 @@ namespace PHX
 		CoreVk();
 		~CoreVk();
 
-		STATUS_CODE CreateInstance(bool enableValidationLayers);
+		STATUS_CODE CreateInstance(bool enableValidationLayers, bool hasWindow);
 		STATUS_CODE CreateSurface(WindowHandle window);
 
 		void DestroyInstance();
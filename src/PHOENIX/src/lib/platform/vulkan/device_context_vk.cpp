@@ -1,10 +1,12 @@
 
 #include <algorithm>
+#include <numeric>
 #include <vulkan/vk_enum_string_helper.h>
 
 #include "device_context_vk.h"
 
 #include "BSL/logger.h"
+#include "BSL/math.h"
 #include "BSL/sanity.h"
 #include "core/profiling.h"
 #include "PHX/types/acceleration_structure_desc.h"
@@ -20,8 +22,12 @@
 #include "utils/buffer_utils.h"
 #include "utils/buffer_type_converter.h"
 #include "utils/debug_utils.h"
+#include "utils/readback_pool.h"
+#include "utils/shader_type_converter.h"
+#include "utils/transient_uniform_ring.h"
 #include "utils/texture_type_converter.h"
 #include "utils/pipeline_type_converter.h"
+#include "utils/texture_utils.h"
 
 STATIC_ASSERT_MSG(sizeof(PHX::AccelerationStructureInstance) == sizeof(VkAccelerationStructureInstanceKHR), "PHX::AccelerationStructureInstance size mismatch with VkAccelerationStructureInstanceKHR");
 STATIC_ASSERT_MSG(alignof(PHX::AccelerationStructureInstance) == alignof(VkAccelerationStructureInstanceKHR), "PHX::AccelerationStructureInstance alignment mismatch with VkAccelerationStructureInstanceKHR");
@@ -32,9 +38,52 @@ using namespace BSL;
 
 namespace PHX
 {
-	DeviceContextVk::DeviceContextVk(RenderDeviceVk* pRenderDevice, const DeviceContextCreateInfo& createInfo) : m_pRenderDevice(nullptr),
-		m_submissionBatches(), m_chainSemaphores(), m_stagingPool(pRenderDevice), m_workFlushed(true), m_assignedFrameIndex(0), m_contextualPipeline(nullptr),
-		m_pMetrics(nullptr), m_queryPool(VK_NULL_HANDLE), m_queryFrameBaseIndex(0), m_beginTimestampWritten(false)
+	// Synchronization2 flags share their bit values with the legacy flags, except for the bits that only exist in
+	// synchronization2. Those are replaced by the legacy flags that cover them
+	static VkPipelineStageFlags ConvertToLegacyStageFlags(VkPipelineStageFlags2KHR stageFlags)
+	{
+		VkPipelineStageFlags legacyFlags = static_cast<VkPipelineStageFlags>(stageFlags & 0xFFFFFFFFull);
+
+		if (stageFlags & (VK_PIPELINE_STAGE_2_COPY_BIT_KHR | VK_PIPELINE_STAGE_2_RESOLVE_BIT_KHR | VK_PIPELINE_STAGE_2_BLIT_BIT_KHR | VK_PIPELINE_STAGE_2_CLEAR_BIT_KHR))
+		{
+			legacyFlags |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+		}
+
+		if (stageFlags & (VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT_KHR | VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT_KHR))
+		{
+			legacyFlags |= VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+		}
+
+		if (stageFlags & VK_PIPELINE_STAGE_2_PRE_RASTERIZATION_SHADERS_BIT_KHR)
+		{
+			legacyFlags |= VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_TESSELLATION_CONTROL_SHADER_BIT |
+				VK_PIPELINE_STAGE_TESSELLATION_EVALUATION_SHADER_BIT | VK_PIPELINE_STAGE_GEOMETRY_SHADER_BIT;
+		}
+
+		return legacyFlags;
+	}
+
+	static VkAccessFlags ConvertToLegacyAccessFlags(VkAccessFlags2KHR accessFlags)
+	{
+		VkAccessFlags legacyFlags = static_cast<VkAccessFlags>(accessFlags & 0xFFFFFFFFull);
+
+		if (accessFlags & (VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR | VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR))
+		{
+			legacyFlags |= VK_ACCESS_SHADER_READ_BIT;
+		}
+
+		if (accessFlags & VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR)
+		{
+			legacyFlags |= VK_ACCESS_SHADER_WRITE_BIT;
+		}
+
+		return legacyFlags;
+	}
+
+	DeviceContextVk::DeviceContextVk(RenderDeviceVk* pRenderDevice, const DeviceContextCreateInfo& createInfo, u32 workerIndex) : m_pRenderDevice(nullptr),
+		m_submissionBatches(), m_commandBufferCache(), m_acquiredCmdBuffers(), m_recordingTarget(VK_NULL_HANDLE), m_workerIndex(workerIndex), m_chainSemaphores(), m_lastUntrackedBatch(U32_MAX), m_isPreparingBatch(false), m_useAsyncCompute(false), m_transferOnGraphicsQueue(false), m_workFlushed(true), m_assignedFrameIndex(0), m_contextualPipeline(nullptr), m_boundState(),
+		m_pendingImageBarriers(), m_pendingMemoryBarrier(), m_hasPendingMemoryBarrier(false), m_legacyImageBarriers(), m_events(), m_usedEventCount(0), m_recycledBatches(), m_startedQueues(), m_waitSemaphores(), m_waitStages(), m_waitValues(), m_joinedQueues(),
+		m_clearValues(), m_bufferCopyRegions(), m_imageCopyRegions(), m_textureRegionLayouts(), m_countedScratchCapacity(0), m_pMetrics(nullptr), m_queryPool(VK_NULL_HANDLE), m_queryFrameBaseIndex(0), m_beginTimestampWritten(false)
 	{
 		UNUSED(createInfo);
 
@@ -51,7 +100,14 @@ namespace PHX
 
 		m_assignedFrameIndex = createInfo.assignedFrameIndex;
 
-		InitTracyContexts();
+		// Worker device contexts never submit, so GPU zones recorded by them can't be collected
+#if defined(PROFILER_TRACY)
+		m_tracyCtxs.fill(nullptr);
+#endif
+		if (!IsWorkerContext())
+		{
+			InitTracyContexts();
+		}
 	}
 
 	DeviceContextVk::~DeviceContextVk()
@@ -59,7 +115,7 @@ namespace PHX
 		DestroyTracyContexts();
 		DeallocateCommandBuffers();
 		DestroyChainSemaphores();
-		m_stagingPool.Destroy();
+		DestroyEvents();
 	}
 
 	STATUS_CODE DeviceContextVk::BindVertexBuffer(BufferHandle vertexBuffer)
@@ -81,15 +137,24 @@ namespace PHX
 			return STATUS_CODE::ERR_INTERNAL;
 		}
 
+		VkBuffer vkBuffer = vBufferVk->GetBuffer();
+		VkDeviceSize offset = vBufferVk->GetOffset();
+
+		BoundCommandState& boundState = GetBoundState(cmdBuffer);
+		if (boundState.vertexBuffer == vkBuffer && boundState.vertexBufferOffset == offset)
+		{
+			CountSkippedCommand();
+			return STATUS_CODE::SUCCESS;
+		}
+		boundState.vertexBuffer = vkBuffer;
+		boundState.vertexBufferOffset = offset;
+
 #if defined(PROFILER_TRACY)
 		tracy::VkCtx* pTracyCtx = m_tracyCtxs[static_cast<u32>(QUEUE_TYPE::GRAPHICS)];
 		ASSERT_PTR(pTracyCtx);
 		PROFILE_VK_ZONE(pTracyCtx, cmdBuffer, "BindVertexBuffer");
 #endif
 
-		VkBuffer vkBuffer = vBufferVk->GetBuffer();
-		VkDeviceSize offset = vBufferVk->GetOffset();
-
 		vkCmdBindVertexBuffers(cmdBuffer, 0, 1, &vkBuffer, &offset);
 		return STATUS_CODE::SUCCESS;
 	}
@@ -120,21 +185,54 @@ namespace PHX
 			return STATUS_CODE::ERR_INTERNAL;
 		}
 
+		VkBuffer vkBuffer = vBufferVk->GetBuffer();
+		VkDeviceSize offset = vBufferVk->GetOffset();
+		VkBuffer vkIndexBuffer = iBufferVk->GetBuffer();
+		const VkIndexType vkIndexType = BUFFER_UTILS::ConvertIndexType(indexType);
+
+		// The vertex and index buffers are filtered separately, since meshes often share one of them
+		BoundCommandState& boundState = GetBoundState(cmdBuffer);
+		const bool vertexBufferBound = (boundState.vertexBuffer == vkBuffer && boundState.vertexBufferOffset == offset);
+		const bool indexBufferBound = (boundState.indexBuffer == vkIndexBuffer && boundState.indexType == vkIndexType);
+		if (vertexBufferBound && indexBufferBound)
+		{
+			CountSkippedCommand();
+			CountSkippedCommand();
+			return STATUS_CODE::SUCCESS;
+		}
+
 #if defined(PROFILER_TRACY)
 		tracy::VkCtx* pTracyCtx = m_tracyCtxs[static_cast<u32>(QUEUE_TYPE::GRAPHICS)];
 		ASSERT_PTR(pTracyCtx);
 		PROFILE_VK_ZONE(pTracyCtx, cmdBuffer, "BindMesh");
 #endif
 
-		VkBuffer vkBuffer = vBufferVk->GetBuffer();
-		VkDeviceSize offset = vBufferVk->GetOffset();
+		if (vertexBufferBound)
+		{
+			CountSkippedCommand();
+		}
+		else
+		{
+			vkCmdBindVertexBuffers(cmdBuffer, 0, 1, &vkBuffer, &offset);
+			boundState.vertexBuffer = vkBuffer;
+			boundState.vertexBufferOffset = offset;
+		}
+
+		if (indexBufferBound)
+		{
+			CountSkippedCommand();
+		}
+		else
+		{
+			vkCmdBindIndexBuffer(cmdBuffer, vkIndexBuffer, 0, vkIndexType);
+			boundState.indexBuffer = vkIndexBuffer;
+			boundState.indexType = vkIndexType;
+		}
 
-		vkCmdBindVertexBuffers(cmdBuffer, 0, 1, &vkBuffer, &offset);
-		vkCmdBindIndexBuffer(cmdBuffer, iBufferVk->GetBuffer(), 0, BUFFER_UTILS::ConvertIndexType(indexType));
 		return STATUS_CODE::SUCCESS;
 	}
 
-	STATUS_CODE DeviceContextVk::BindUniformCollection(UniformCollectionHandle uniformCollection)
+	STATUS_CODE DeviceContextVk::BindUniformCollection(UniformCollectionHandle uniformCollection, const u32* pDynamicOffsets, u32 dynamicOffsetCount)
 	{
 		PROFILE_SCOPE("DeviceContextVk_BindUniformCollection");
 
@@ -145,6 +243,12 @@ namespace PHX
 			return STATUS_CODE::ERR_API;
 		}
 
+		if (dynamicOffsetCount != uniformCollectionVk->GetDynamicOffsetCount() || (dynamicOffsetCount > 0 && pDynamicOffsets == nullptr))
+		{
+			LogError("Failed to bind uniform collection. Expected %u dynamic offsets, but %u were given!", uniformCollectionVk->GetDynamicOffsetCount(), dynamicOffsetCount);
+			return STATUS_CODE::ERR_API;
+		}
+
 		if (m_contextualPipeline == nullptr)
 		{
 			LogError("Failed to bind uniform collection. Pipeline is null!");
@@ -166,14 +270,40 @@ namespace PHX
 			return STATUS_CODE::ERR_INTERNAL;
 		}
 
+		const VkPipelineBindPoint bindPoint = m_contextualPipeline->GetBindPoint();
+		const VkPipelineLayout pipelineLayout = m_contextualPipeline->GetLayout();
+		const VkDescriptorSet* descriptorSets = uniformCollectionVk->GetDescriptorSets(m_assignedFrameIndex);
+		const u32 descriptorSetCount = uniformCollectionVk->GetDescriptorSetCount(m_assignedFrameIndex);
+
+		BoundCommandState& boundState = GetBoundState(cmdBuffer);
+		if (dynamicOffsetCount == 0 && boundState.descriptorSetBindPoint == bindPoint && boundState.descriptorSetLayout == pipelineLayout &&
+			boundState.descriptorSetCount == descriptorSetCount && std::equal(descriptorSets, descriptorSets + descriptorSetCount, boundState.descriptorSets.begin()))
+		{
+			CountSkippedCommand();
+			return STATUS_CODE::SUCCESS;
+		}
+
+		// Collections with more sets than can be shadowed are always bound. Dynamic offsets usually change on every bind, so
+		// collections with dynamic bindings are always bound as well
+		if (dynamicOffsetCount == 0 && descriptorSetCount <= BoundCommandState::MAX_DESCRIPTOR_SETS)
+		{
+			boundState.descriptorSetBindPoint = bindPoint;
+			boundState.descriptorSetLayout = pipelineLayout;
+			boundState.descriptorSetCount = descriptorSetCount;
+			std::copy(descriptorSets, descriptorSets + descriptorSetCount, boundState.descriptorSets.begin());
+		}
+		else
+		{
+			boundState.descriptorSetLayout = VK_NULL_HANDLE;
+		}
+
 #if defined(PROFILER_TRACY)
 		tracy::VkCtx* pTracyCtx = m_tracyCtxs[static_cast<u32>(cmdQueueType)];
 		ASSERT_PTR(pTracyCtx);
 		PROFILE_VK_ZONE(pTracyCtx, cmdBuffer, "BindUniformCollection");
 #endif
 
-		const VkDescriptorSet* descriptorSets = uniformCollectionVk->GetDescriptorSets(m_assignedFrameIndex);
-		vkCmdBindDescriptorSets(cmdBuffer, m_contextualPipeline->GetBindPoint(), m_contextualPipeline->GetLayout(), 0, uniformCollectionVk->GetDescriptorSetCount(m_assignedFrameIndex), descriptorSets, 0, nullptr);
+		vkCmdBindDescriptorSets(cmdBuffer, bindPoint, pipelineLayout, 0, descriptorSetCount, descriptorSets, dynamicOffsetCount, pDynamicOffsets);
 
 		return STATUS_CODE::SUCCESS;
 	}
@@ -214,12 +344,6 @@ namespace PHX
 			return STATUS_CODE::ERR_INTERNAL;
 		}
 
-#if defined(PROFILER_TRACY)
-		tracy::VkCtx* pTracyCtx = m_tracyCtxs[static_cast<u32>(QUEUE_TYPE::GRAPHICS)];
-		ASSERT_PTR(pTracyCtx);
-		PROFILE_VK_ZONE(pTracyCtx, cmdBuffer, "SetViewport");
-#endif
-
 		VkViewport viewport{};
 		viewport.x = static_cast<float>(offset.GetX());
 		viewport.y = static_cast<float>(offset.GetY());
@@ -227,6 +351,22 @@ namespace PHX
 		viewport.height = static_cast<float>(size.GetY());
 		viewport.minDepth = 0.0f;
 		viewport.maxDepth = 1.0f;
+
+		BoundCommandState& boundState = GetBoundState(cmdBuffer);
+		if (boundState.hasViewport && memcmp(&boundState.viewport, &viewport, sizeof(VkViewport)) == 0)
+		{
+			CountSkippedCommand();
+			return STATUS_CODE::SUCCESS;
+		}
+		boundState.hasViewport = true;
+		boundState.viewport = viewport;
+
+#if defined(PROFILER_TRACY)
+		tracy::VkCtx* pTracyCtx = m_tracyCtxs[static_cast<u32>(QUEUE_TYPE::GRAPHICS)];
+		ASSERT_PTR(pTracyCtx);
+		PROFILE_VK_ZONE(pTracyCtx, cmdBuffer, "SetViewport");
+#endif
+
 		vkCmdSetViewport(cmdBuffer, 0, 1, &viewport);
 
 		return STATUS_CODE::SUCCESS;
@@ -249,20 +389,105 @@ namespace PHX
 			return STATUS_CODE::ERR_INTERNAL;
 		}
 
+		VkRect2D scissor{};
+		scissor.offset = { static_cast<int>(offset.GetX()), static_cast<int>(offset.GetY()) };
+		scissor.extent = { size.GetX(), size.GetY() };
+
+		BoundCommandState& boundState = GetBoundState(cmdBuffer);
+		if (boundState.hasScissor && memcmp(&boundState.scissor, &scissor, sizeof(VkRect2D)) == 0)
+		{
+			CountSkippedCommand();
+			return STATUS_CODE::SUCCESS;
+		}
+		boundState.hasScissor = true;
+		boundState.scissor = scissor;
+
 #if defined(PROFILER_TRACY)
 		tracy::VkCtx* pTracyCtx = m_tracyCtxs[static_cast<u32>(QUEUE_TYPE::GRAPHICS)];
 		ASSERT_PTR(pTracyCtx);
 		PROFILE_VK_ZONE(pTracyCtx, cmdBuffer, "SetScissor");
 #endif
 
-		VkRect2D scissor{};
-		scissor.offset = { static_cast<int>(offset.GetX()), static_cast<int>(offset.GetY()) };
-		scissor.extent = { size.GetX(), size.GetY() };
 		vkCmdSetScissor(cmdBuffer, 0, 1, &scissor);
 
 		return STATUS_CODE::SUCCESS;
 	}
 
+	STATUS_CODE DeviceContextVk::SetPushConstants(ShaderStageFlags stages, u32 offsetBytes, u32 sizeBytes, const void* data)
+	{
+		PROFILE_SCOPE("DeviceContextVk_SetPushConstants");
+
+		if (data == nullptr || sizeBytes == 0 || stages == 0)
+		{
+			LogError("Failed to set push constants. Data is null, or the size or stages are empty!");
+			return STATUS_CODE::ERR_API;
+		}
+
+		if ((offsetBytes % 4) != 0 || (sizeBytes % 4) != 0)
+		{
+			LogError("Failed to set push constants. Offset (%u) and size (%u) must be multiples of 4!", offsetBytes, sizeBytes);
+			return STATUS_CODE::ERR_API;
+		}
+
+		if (m_contextualPipeline == nullptr)
+		{
+			LogError("Failed to set push constants. Pipeline is null!");
+			return STATUS_CODE::ERR_INTERNAL;
+		}
+
+		// Every byte of the update must be visible to the given stages, and the stages must include all stages of every range
+		// the update overlaps
+		const VkShaderStageFlags stageFlags = SHADER_UTILS::ConvertShaderStageFlags(stages);
+		const u32 updateEnd = offsetBytes + sizeBytes;
+		u32 visibleEnd = 0;
+		for (const VkPushConstantRange& range : m_contextualPipeline->GetPushConstantRanges())
+		{
+			const u32 rangeEnd = range.offset + range.size;
+			const bool overlapsUpdate = (range.offset < updateEnd && offsetBytes < rangeEnd);
+			if (overlapsUpdate && (range.stageFlags & ~stageFlags) != 0)
+			{
+				LogError("Failed to set push constants. Stages 0x%x don't include all stages of the overlapping push constant range (offset %u, size %u)", stages, range.offset, range.size);
+				return STATUS_CODE::ERR_API;
+			}
+
+			if ((range.stageFlags & stageFlags) != 0)
+			{
+				visibleEnd = std::max(visibleEnd, rangeEnd);
+			}
+		}
+
+		if (updateEnd > visibleEnd)
+		{
+			LogError("Failed to set push constants. Update (offset %u, size %u) is outside of the pipeline's push constant ranges for stages 0x%x", offsetBytes, sizeBytes, stages);
+			return STATUS_CODE::ERR_API;
+		}
+
+		QUEUE_TYPE cmdQueueType = GetQueueTypeFromBindPoint(m_contextualPipeline->GetBindPoint());
+		if (cmdQueueType == QUEUE_TYPE::COUNT)
+		{
+			LogError("Failed to set push constants. Could not convert from bind point %u to queue type!", static_cast<u32>(m_contextualPipeline->GetBindPoint()));
+			return STATUS_CODE::ERR_INTERNAL;
+		}
+
+		VkCommandBuffer cmdBuffer = VK_NULL_HANDLE;
+		STATUS_CODE res = GetOrCreateCommandBuffer(cmdQueueType, cmdBuffer);
+		if (res != STATUS_CODE::SUCCESS)
+		{
+			LogError("Failed to set push constants! Could not get or create command buffer");
+			return STATUS_CODE::ERR_INTERNAL;
+		}
+
+#if defined(PROFILER_TRACY)
+		tracy::VkCtx* pTracyCtx = m_tracyCtxs[static_cast<u32>(cmdQueueType)];
+		ASSERT_PTR(pTracyCtx);
+		PROFILE_VK_ZONE(pTracyCtx, cmdBuffer, "SetPushConstants");
+#endif
+
+		vkCmdPushConstants(cmdBuffer, m_contextualPipeline->GetLayout(), stageFlags, offsetBytes, sizeBytes, data);
+
+		return STATUS_CODE::SUCCESS;
+	}
+
 	STATUS_CODE DeviceContextVk::Draw(u32 vertexCount)
 	{
 		PROFILE_SCOPE("DeviceContextVk_Draw");
@@ -353,6 +578,83 @@ namespace PHX
 		return STATUS_CODE::SUCCESS;
 	}
 
+	STATUS_CODE DeviceContextVk::DrawIndexedBatch(const DrawIndexedArgs* pDraws, u32 drawCount)
+	{
+		PROFILE_SCOPE("DeviceContextVk_DrawIndexedBatch");
+
+		static_assert(sizeof(DrawIndexedArgs) == sizeof(VkDrawIndexedIndirectCommand), "DrawIndexedArgs must match the layout of VkDrawIndexedIndirectCommand");
+
+		// Smaller batches are cheaper as direct draws, since indirect arguments are read from host memory
+		static constexpr u32 MIN_DRAWS_FOR_INDIRECT_BATCH = 8;
+
+		if (pDraws == nullptr || drawCount == 0)
+		{
+			LogError("Failed to issue draw indexed batch. No draws were provided!");
+			return STATUS_CODE::ERR_API;
+		}
+
+		VkCommandBuffer cmdBuffer = VK_NULL_HANDLE;
+		STATUS_CODE res = GetOrCreateCommandBuffer(QUEUE_TYPE::GRAPHICS, cmdBuffer);
+		if (res != STATUS_CODE::SUCCESS)
+		{
+			LogError("Failed to issue draw indexed batch! Could not get or create command buffer");
+			return STATUS_CODE::ERR_INTERNAL;
+		}
+
+#if defined(PROFILER_TRACY)
+		tracy::VkCtx* pTracyCtx = m_tracyCtxs[static_cast<u32>(QUEUE_TYPE::GRAPHICS)];
+		ASSERT_PTR(pTracyCtx);
+		PROFILE_VK_ZONE(pTracyCtx, cmdBuffer, "DrawIndexedBatch");
+#endif
+
+		bool recordedIndirect = false;
+		if (drawCount >= MIN_DRAWS_FOR_INDIRECT_BATCH && m_pRenderDevice->IsMultiDrawIndirectSupported())
+		{
+			// The commands are written to the indirect command ring, which is persistently mapped and recycled per frame.
+			// Running out of space isn't an error, the batch falls back to direct draws
+			const u64 commandsSize = static_cast<u64>(drawCount) * sizeof(VkDrawIndexedIndirectCommand);
+			TransientUniformRing* pRing = m_pRenderDevice->GetIndirectCommandRing();
+			const TransientUniformRingAllocation ringAlloc = pRing->TryAllocate(m_assignedFrameIndex, commandsSize);
+			if (ringAlloc.isValid)
+			{
+				memcpy(ringAlloc.mappedData, pDraws, commandsSize);
+
+				const u32 maxDrawsPerCommand = m_pRenderDevice->GetDeviceProperties().limits.maxDrawIndirectCount;
+				for (u32 firstDraw = 0; firstDraw < drawCount; firstDraw += maxDrawsPerCommand)
+				{
+					const u32 commandDrawCount = std::min(drawCount - firstDraw, maxDrawsPerCommand);
+					const u64 commandOffset = ringAlloc.offset + static_cast<u64>(firstDraw) * sizeof(VkDrawIndexedIndirectCommand);
+					vkCmdDrawIndexedIndirect(cmdBuffer, pRing->GetBuffer(), commandOffset, commandDrawCount, sizeof(VkDrawIndexedIndirectCommand));
+				}
+				recordedIndirect = true;
+			}
+		}
+
+		if (!recordedIndirect)
+		{
+			for (u32 i = 0; i < drawCount; i++)
+			{
+				const DrawIndexedArgs& draw = pDraws[i];
+				vkCmdDrawIndexed(cmdBuffer, draw.indexCount, draw.instanceCount, draw.firstIndex, draw.vertexOffset, draw.firstInstance);
+			}
+		}
+
+		if (m_pMetrics)
+		{
+			u32 indexCount = 0;
+			for (u32 i = 0; i < drawCount; i++)
+			{
+				indexCount += pDraws[i].indexCount * pDraws[i].instanceCount;
+			}
+
+			m_pMetrics->drawCalls += drawCount;
+			m_pMetrics->indices += indexCount;
+			m_pMetrics->triangles += indexCount / 3;
+		}
+
+		return STATUS_CODE::SUCCESS;
+	}
+
 	STATUS_CODE DeviceContextVk::DrawIndexedIndirect(BufferHandle argsBuffer, u32 drawCount, u32 stride, u64 argsOffset)
 	{
 		PROFILE_SCOPE("DeviceContextVk_DrawIndexedIndirect");
@@ -447,7 +749,7 @@ namespace PHX
 		}
 
 #if defined(PROFILER_TRACY)
-		tracy::VkCtx* pTracyCtx = m_tracyCtxs[static_cast<u32>(QUEUE_TYPE::COMPUTE)];
+		tracy::VkCtx* pTracyCtx = m_tracyCtxs[static_cast<u32>(ResolveQueueType(QUEUE_TYPE::COMPUTE))];
 		ASSERT_PTR(pTracyCtx);
 		PROFILE_VK_ZONE(pTracyCtx, cmdBuffer, "Dispatch");
 #endif
@@ -728,19 +1030,43 @@ namespace PHX
 		return STATUS_CODE::SUCCESS;
 	}
 
-	STATUS_CODE DeviceContextVk::CopyDataToBuffer(BufferHandle buffer, const void* data, u64 sizeBytes)
+	STATUS_CODE DeviceContextVk::AllocateTransientUniform(u64 sizeBytes, TransientUniformAllocation& out_allocation)
 	{
-		PROFILE_SCOPE("DeviceContextVk_CopyDataToBuffer");
+		PROFILE_SCOPE("DeviceContextVk_AllocateTransientUniform");
 
-		if (data == nullptr)
+		if (sizeBytes == 0)
 		{
-			LogError("Failed to copy data to buffer. Data pointer is null!");
+			LogError("Failed to allocate transient uniform. Size is 0!");
 			return STATUS_CODE::ERR_API;
 		}
 
-		if (sizeBytes <= 0)
+		TransientUniformRing* pRing = m_pRenderDevice->GetTransientUniformRing();
+		if (pRing == nullptr)
+		{
+			LogError("Failed to allocate transient uniform. Transient uniform ring is null!");
+			return STATUS_CODE::ERR_INTERNAL;
+		}
+
+		const TransientUniformRingAllocation ringAlloc = pRing->Allocate(m_assignedFrameIndex, sizeBytes);
+		if (!ringAlloc.isValid)
+		{
+			LogError("Failed to allocate transient uniform of %llu bytes!", sizeBytes);
+			return STATUS_CODE::ERR_INTERNAL;
+		}
+
+		out_allocation.pData = ringAlloc.mappedData;
+		out_allocation.offset = ringAlloc.offset;
+
+		return STATUS_CODE::SUCCESS;
+	}
+
+	STATUS_CODE DeviceContextVk::CopyDataToBuffer(BufferHandle buffer, const BufferCopyRegion* pRegions, u32 regionCount)
+	{
+		PROFILE_SCOPE("DeviceContextVk_CopyDataToBuffer");
+
+		if (pRegions == nullptr || regionCount == 0)
 		{
-			LogError("Failed to copy data to buffer. Size is 0!");
+			LogError("Failed to copy data to buffer. No copy regions were provided!");
 			return STATUS_CODE::ERR_API;
 		}
 
@@ -751,24 +1077,86 @@ namespace PHX
 			return STATUS_CODE::ERR_API;
 		}
 
+		// Validate every region up front, so a bad region doesn't leave the buffer partially updated. Each region is packed at
+		// a 16 byte aligned offset into the staging allocation
+		static constexpr u64 STAGING_REGION_ALIGNMENT = 16;
+		const u64 bufferSize = bufferVk->GetSize();
+		u64 stagingSize = 0;
+		for (u32 i = 0; i < regionCount; i++)
+		{
+			const BufferCopyRegion& region = pRegions[i];
+			if (region.pData == nullptr)
+			{
+				LogError("Failed to copy data to buffer. Data pointer of region %u is null!", i);
+				return STATUS_CODE::ERR_API;
+			}
+
+			if (region.sizeBytes == 0)
+			{
+				LogError("Failed to copy data to buffer. Size of region %u is 0!", i);
+				return STATUS_CODE::ERR_API;
+			}
+
+			if (region.dstOffset > bufferSize || region.sizeBytes > bufferSize - region.dstOffset)
+			{
+				LogError("Failed to copy data to buffer. Region %u (offset %llu, size %llu) is out of bounds of buffer of size %llu!", i, region.dstOffset, region.sizeBytes, bufferSize);
+				return STATUS_CODE::ERR_API;
+			}
+
+			stagingSize = AlignUp(stagingSize, STAGING_REGION_ALIGNMENT) + region.sizeBytes;
+		}
+
+		// A single copy command doesn't order overlapping regions, so they would land differently than through mapped memory.
+		// Regions sorted by offset only need to be checked against their neighbour, anything else is checked pair by pair
+		bool isSorted = true;
+		for (u32 i = 1; i < regionCount && isSorted; i++)
+		{
+			isSorted = (pRegions[i - 1].dstOffset + pRegions[i - 1].sizeBytes <= pRegions[i].dstOffset);
+		}
+
+		if (!isSorted)
+		{
+			for (u32 i = 0; i < regionCount; i++)
+			{
+				for (u32 j = i + 1; j < regionCount; j++)
+				{
+					const BufferCopyRegion& a = pRegions[i];
+					const BufferCopyRegion& b = pRegions[j];
+					if (a.dstOffset < b.dstOffset + b.sizeBytes && b.dstOffset < a.dstOffset + a.sizeBytes)
+					{
+						LogError("Failed to copy data to buffer. Regions %u and %u overlap!", i, j);
+						return STATUS_CODE::ERR_API;
+					}
+				}
+			}
+		}
+
 		STATUS_CODE res = STATUS_CODE::SUCCESS;
 
 		if (ShouldUseDirectMemoryMapping(bufferVk->GetUsage()))
 		{
 			// Copy to memory directly, no need to go through a staging buffer
-			bufferVk->CopyToMappedData(data, sizeBytes);
+			for (u32 i = 0; i < regionCount; i++)
+			{
+				res = bufferVk->CopyToMappedData(pRegions[i].pData, pRegions[i].sizeBytes, pRegions[i].dstOffset);
+				if (res != STATUS_CODE::SUCCESS)
+				{
+					return res;
+				}
+			}
 		}
 		else
 		{
 			// All other buffers must copy to staging buffer and then issue
 			// a transfer command to copy the data over to the GPU
-			StagingAllocation stagingAlloc = AllocateStaging(sizeBytes);
+			StagingAllocation stagingAlloc = AllocateStaging(stagingSize, STAGING_REGION_ALIGNMENT);
 			if (!stagingAlloc.isValid)
 			{
 				LogError("Failed to copy data to buffer. Could not allocate staging memory!");
 				return STATUS_CODE::ERR_INTERNAL;
 			}
 
+			// Buffers are shared with the transfer queue family, so they can always be uploaded on the transfer queue
 			VkCommandBuffer cmdBuffer = VK_NULL_HANDLE;
 			const QUEUE_TYPE transferQueueType = QUEUE_TYPE::TRANSFER;
 
@@ -780,25 +1168,37 @@ namespace PHX
 			}
 
 #if defined(PROFILER_TRACY)
-			tracy::VkCtx* pTracyCtx = m_tracyCtxs[static_cast<u32>(QUEUE_TYPE::TRANSFER)];
+			tracy::VkCtx* pTracyCtx = m_tracyCtxs[static_cast<u32>(ResolveQueueType(transferQueueType))];
 			ASSERT_PTR(pTracyCtx);
 			PROFILE_VK_ZONE(pTracyCtx, cmdBuffer, "CopyDataToBuffer");
 #endif
 
-			memcpy(stagingAlloc.mappedData, data, sizeBytes);
+			// Pack every region into the staging allocation, and copy them all over to the GPU buffer with a single command
+			std::vector<VkBufferCopy>& copyRegions = m_bufferCopyRegions;
+			copyRegions.resize(regionCount);
+			u64 packedOffset = 0;
+			for (u32 i = 0; i < regionCount; i++)
+			{
+				const BufferCopyRegion& region = pRegions[i];
+				packedOffset = AlignUp(packedOffset, STAGING_REGION_ALIGNMENT);
+
+				memcpy(static_cast<u8*>(stagingAlloc.mappedData) + packedOffset, region.pData, region.sizeBytes);
+
+				VkBufferCopy& copyRegion = copyRegions[i];
+				copyRegion.srcOffset = stagingAlloc.offset + packedOffset;
+				copyRegion.dstOffset = region.dstOffset;
+				copyRegion.size = region.sizeBytes;
+
+				packedOffset += region.sizeBytes;
+			}
 
-			// Copy from staging buffer to GPU buffer
-			VkBufferCopy copyRegion{};
-			copyRegion.srcOffset = stagingAlloc.offset;
-			copyRegion.dstOffset = 0;
-			copyRegion.size = sizeBytes;
-			vkCmdCopyBuffer(cmdBuffer, stagingAlloc.buffer, bufferVk->GetBuffer(), 1, &copyRegion);
+			vkCmdCopyBuffer(cmdBuffer, stagingAlloc.buffer, bufferVk->GetBuffer(), regionCount, copyRegions.data());
 		}
 
 		return res;
 	}
 
-	STATUS_CODE DeviceContextVk::CopyDataToTexture(TextureHandle texture, const void* data, u64 sizeBytes, u32 mipLevel)
+	STATUS_CODE DeviceContextVk::CopyDataToTexture(TextureHandle texture, const TextureUploadRegion* pRegions, u32 regionCount)
 	{
 		PROFILE_SCOPE("DeviceContextVk_CopyDataToTexture");
 
@@ -809,67 +1209,392 @@ namespace PHX
 			return STATUS_CODE::ERR_API;
 		}
 
-		if (data == nullptr)
+		if (pRegions == nullptr || regionCount == 0)
 		{
-			LogError("Failed to copy data to texture. Data pointer is null!");
+			LogError("Failed to copy data to texture. No upload regions were provided!");
 			return STATUS_CODE::ERR_API;
 		}
 
-		if (sizeBytes <= 0)
+		// Compressed formats are copied in 4x4 blocks, so sizes and row lengths are counted in blocks rather than texels
+		const BASE_FORMAT format = textureVk->GetFormat();
+		const bool isCompressed = IsCompressedFormat(format);
+		const u32 blockDim = isCompressed ? 4 : 1;
+		const u64 blockSize = GetBaseFormatSize(format);
+		if (blockSize == 0)
 		{
-			LogError("Failed to copy data to texture. Size in bytes is 0!");
+			LogError("Failed to copy data to texture. Texture format has no known size!");
 			return STATUS_CODE::ERR_API;
 		}
 
-		STATUS_CODE res;
-		VkCommandBuffer cmdBuffer = VK_NULL_HANDLE;
-		const QUEUE_TYPE transferQueueType = QUEUE_TYPE::TRANSFER;
+		// Region offsets must be a multiple of the block size and of 4, and rows are padded to the optimal pitch whenever the
+		// padded pitch is still a whole number of blocks
+		const VkPhysicalDeviceLimits& limits = m_pRenderDevice->GetDeviceProperties().limits;
+		const u64 regionAlignment = std::lcm(std::lcm(std::max<u64>(limits.optimalBufferCopyOffsetAlignment, 1), blockSize), static_cast<u64>(4));
+		const u64 rowPitchAlignment = std::max<u64>(limits.optimalBufferCopyRowPitchAlignment, 1);
 
-		res = GetOrCreateCommandBuffer(transferQueueType, cmdBuffer);
-		if (res != STATUS_CODE::SUCCESS)
+		std::vector<TextureRegionLayout>& layouts = m_textureRegionLayouts;
+		std::vector<VkBufferImageCopy>& copyRegions = m_imageCopyRegions;
+		layouts.resize(regionCount);
+		copyRegions.resize(regionCount);
+
+		// Validate and lay out every region up front, so a bad region doesn't leave the texture partially updated
+		u64 stagingSize = 0;
+		bool isTransferCopyAligned = true;
+		for (u32 i = 0; i < regionCount; i++)
 		{
-			LogError("Failed to copy data to texture! Command buffer creation failed");
-			return res;
-		}
+			const TextureUploadRegion& region = pRegions[i];
+			if (region.pData == nullptr)
+			{
+				LogError("Failed to copy data to texture. Data pointer of region %u is null!", i);
+				return STATUS_CODE::ERR_API;
+			}
+
+			if (region.mipLevel >= textureVk->GetMipLevels() || region.baseArrayLayer >= textureVk->GetArrayLayers())
+			{
+				LogError("Failed to copy data to texture. Mip level %u or array layer %u of region %u is out of range!", region.mipLevel, region.baseArrayLayer, i);
+				return STATUS_CODE::ERR_API;
+			}
+
+			const u32 layerCount = (region.layerCount == 0) ? (textureVk->GetArrayLayers() - region.baseArrayLayer) : region.layerCount;
+			if (region.baseArrayLayer + layerCount > textureVk->GetArrayLayers())
+			{
+				LogError("Failed to copy data to texture. Layers of region %u are out of range!", i);
+				return STATUS_CODE::ERR_API;
+			}
+
+			const u32 mipWidth = std::max(1u, textureVk->GetWidth() >> region.mipLevel);
+			const u32 mipHeight = std::max(1u, textureVk->GetHeight() >> region.mipLevel);
+			if (region.offsetX >= mipWidth || region.offsetY >= mipHeight || (region.offsetX % blockDim) != 0 || (region.offsetY % blockDim) != 0)
+			{
+				LogError("Failed to copy data to texture. Offset (%u, %u) of region %u is out of range or not block aligned!", region.offsetX, region.offsetY, i);
+				return STATUS_CODE::ERR_API;
+			}
+
+			const u32 width = (region.width == 0) ? (mipWidth - region.offsetX) : region.width;
+			const u32 height = (region.height == 0) ? (mipHeight - region.offsetY) : region.height;
+			if (width > mipWidth - region.offsetX || height > mipHeight - region.offsetY)
+			{
+				LogError("Failed to copy data to texture. Extent (%u, %u) of region %u is out of bounds of mip level %u!", width, height, i, region.mipLevel);
+				return STATUS_CODE::ERR_API;
+			}
+
+			// Partial blocks are only allowed where the region ends at the edge of the mip level
+			const bool isWidthBlockAligned = ((width % blockDim) == 0) || (region.offsetX + width == mipWidth);
+			const bool isHeightBlockAligned = ((height % blockDim) == 0) || (region.offsetY + height == mipHeight);
+			if (!isWidthBlockAligned || !isHeightBlockAligned)
+			{
+				LogError("Failed to copy data to texture. Extent (%u, %u) of region %u is neither a multiple of the %ux%u block size nor reaches the edge of mip level %u!", width, height, i, blockDim, blockDim, region.mipLevel);
+				return STATUS_CODE::ERR_API;
+			}
+
+			TextureRegionLayout& layout = layouts[i];
+			const u32 rowBlocks = (width + blockDim - 1) / blockDim;
+			layout.rowBytes = static_cast<u64>(rowBlocks) * blockSize;
+			layout.rowCount = (height + blockDim - 1) / blockDim;
+			layout.layerCount = layerCount;
+
+			const u64 packedSize = layout.rowBytes * layout.rowCount * layerCount;
+			if (region.sizeBytes < packedSize)
+			{
+				LogError("Failed to copy data to texture. Region %u has %llu bytes, but %llu are needed!", i, region.sizeBytes, packedSize);
+				return STATUS_CODE::ERR_API;
+			}
+
+			layout.paddedRowBytes = AlignUp(layout.rowBytes, rowPitchAlignment);
+			if ((layout.paddedRowBytes % blockSize) != 0)
+			{
+				layout.paddedRowBytes = layout.rowBytes;
+			}
+
+			layout.stagingOffset = AlignUp(stagingSize, regionAlignment);
+			stagingSize = layout.stagingOffset + layout.paddedRowBytes * layout.rowCount * layerCount;
+
+			// Row and slice pitches are counted in whole blocks, and Vulkan expects them in texels
+			const u32 paddedRowBlocks = static_cast<u32>(layout.paddedRowBytes / blockSize);
+			VkBufferImageCopy& copyRegion = copyRegions[i];
+			copyRegion.bufferOffset = layout.stagingOffset; // Made absolute once the staging memory is allocated
+			copyRegion.bufferRowLength = paddedRowBlocks * blockDim;
+			copyRegion.bufferImageHeight = layout.rowCount * blockDim;
+
+			copyRegion.imageSubresource.aspectMask = TEX_UTILS::ConvertAspectFlags(textureVk->GetAspectFlags());
+			copyRegion.imageSubresource.mipLevel = region.mipLevel;
+			copyRegion.imageSubresource.baseArrayLayer = region.baseArrayLayer;
+			copyRegion.imageSubresource.layerCount = layerCount;
+
+			copyRegion.imageOffset = { static_cast<i32>(region.offsetX), static_cast<i32>(region.offsetY), 0 };
+			copyRegion.imageExtent = { width, height, 1 };
+
+			isTransferCopyAligned = isTransferCopyAligned && m_pRenderDevice->IsTransferImageCopyAligned(copyRegion.imageOffset, copyRegion.imageExtent, { mipWidth, mipHeight, 1 }, blockDim);
+		}
+
+		// Textures which aren't shared with the transfer queue family (attachments) are owned by the graphics queue family,
+		// so they're uploaded on the graphics queue. So are regions the transfer queue family can't copy at its granularity
+		STATUS_CODE res;
+		VkCommandBuffer cmdBuffer = VK_NULL_HANDLE;
+		const QUEUE_TYPE transferQueueType = (textureVk->IsConcurrent() && isTransferCopyAligned) ? QUEUE_TYPE::TRANSFER : QUEUE_TYPE::GRAPHICS;
+
+		res = GetOrCreateCommandBuffer(transferQueueType, cmdBuffer);
+		if (res != STATUS_CODE::SUCCESS)
+		{
+			LogError("Failed to copy data to texture! Command buffer creation failed");
+			return res;
+		}
 
 #if defined(PROFILER_TRACY)
-		tracy::VkCtx* pTracyCtx = m_tracyCtxs[static_cast<u32>(QUEUE_TYPE::TRANSFER)];
+		tracy::VkCtx* pTracyCtx = m_tracyCtxs[static_cast<u32>(ResolveQueueType(transferQueueType))];
 		ASSERT_PTR(pTracyCtx);
 		PROFILE_VK_ZONE(pTracyCtx, cmdBuffer, "CopyDataToTexture");
 #endif
 
-		// Sub-allocate from staging pool and copy data
-		StagingAllocation stagingAlloc = AllocateStaging(sizeBytes);
+		// Sub-allocate from staging pool and pack every region into it
+		StagingAllocation stagingAlloc = AllocateStaging(stagingSize, regionAlignment);
 		if (!stagingAlloc.isValid)
 		{
 			LogError("Failed to copy data to texture. Could not allocate staging memory!");
 			return STATUS_CODE::ERR_INTERNAL;
 		}
 
-		memcpy(stagingAlloc.mappedData, data, sizeBytes);
+		for (u32 i = 0; i < regionCount; i++)
+		{
+			const TextureRegionLayout& layout = layouts[i];
+			u8* pDst = static_cast<u8*>(stagingAlloc.mappedData) + layout.stagingOffset;
+			const u8* pSrc = static_cast<const u8*>(pRegions[i].pData);
+
+			if (layout.paddedRowBytes == layout.rowBytes)
+			{
+				memcpy(pDst, pSrc, layout.rowBytes * layout.rowCount * layout.layerCount);
+			}
+			else
+			{
+				const u32 totalRows = layout.rowCount * layout.layerCount;
+				for (u32 row = 0; row < totalRows; row++)
+				{
+					memcpy(pDst + row * layout.paddedRowBytes, pSrc + row * layout.rowBytes, layout.rowBytes);
+				}
+			}
+
+			copyRegions[i].bufferOffset += stagingAlloc.offset;
+		}
+
+		vkCmdCopyBufferToImage(cmdBuffer, stagingAlloc.buffer, textureVk->GetBaseImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regionCount, copyRegions.data());
+
+		return STATUS_CODE::SUCCESS;
+	}
+
+	STATUS_CODE DeviceContextVk::ReadbackBuffer(BufferHandle buffer, u64 srcOffset, u64 sizeBytes, ReadbackTicket& out_ticket, ReadbackCallbackFn callback)
+	{
+		PROFILE_SCOPE("DeviceContextVk_ReadbackBuffer");
+
+		out_ticket = {};
+
+		BufferVk* bufferVk = static_cast<BufferVk*>(m_pRenderDevice->ResolveHandle(buffer));
+		if (bufferVk == nullptr)
+		{
+			LogError("Failed to read back buffer. Buffer is null!");
+			return STATUS_CODE::ERR_API;
+		}
+
+		if (sizeBytes == 0)
+		{
+			LogError("Failed to read back buffer. Size is 0!");
+			return STATUS_CODE::ERR_API;
+		}
+
+		const u64 bufferSize = bufferVk->GetSize();
+		if (srcOffset > bufferSize || sizeBytes > bufferSize - srcOffset)
+		{
+			LogError("Failed to read back buffer. Range (offset %llu, size %llu) is out of bounds of buffer of size %llu!", srcOffset, sizeBytes, bufferSize);
+			return STATUS_CODE::ERR_API;
+		}
+
+		// Buffers are shared with the transfer queue family, so they can always be read back on the transfer queue
+		VkCommandBuffer cmdBuffer = VK_NULL_HANDLE;
+		const QUEUE_TYPE transferQueueType = QUEUE_TYPE::TRANSFER;
+
+		STATUS_CODE res = GetOrCreateCommandBuffer(transferQueueType, cmdBuffer);
+		if (res != STATUS_CODE::SUCCESS)
+		{
+			LogError("Failed to read back buffer! Command buffer creation failed");
+			return res;
+		}
+
+		const ReadbackAllocation readbackAlloc = m_pRenderDevice->GetReadbackPool()->Acquire(m_assignedFrameIndex, sizeBytes, callback);
+		if (!readbackAlloc.isValid)
+		{
+			LogError("Failed to read back buffer. Could not acquire readback memory!");
+			return STATUS_CODE::ERR_INTERNAL;
+		}
+
+#if defined(PROFILER_TRACY)
+		tracy::VkCtx* pTracyCtx = m_tracyCtxs[static_cast<u32>(ResolveQueueType(transferQueueType))];
+		ASSERT_PTR(pTracyCtx);
+		PROFILE_VK_ZONE(pTracyCtx, cmdBuffer, "ReadbackBuffer");
+#endif
+
+		VkBufferCopy copyRegion{};
+		copyRegion.srcOffset = srcOffset;
+		copyRegion.dstOffset = 0;
+		copyRegion.size = sizeBytes;
+		vkCmdCopyBuffer(cmdBuffer, bufferVk->GetBuffer(), readbackAlloc.buffer, 1, &copyRegion);
+
+		// Makes the copy available to the host once the frame fence signals
+		res = InsertMemoryBarrier(transferQueueType, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_HOST_READ_BIT);
+		if (res != STATUS_CODE::SUCCESS)
+		{
+			LogError("Failed to read back buffer! Could not insert host barrier");
+			return res;
+		}
+
+		out_ticket = readbackAlloc.ticket;
+		return STATUS_CODE::SUCCESS;
+	}
+
+	STATUS_CODE DeviceContextVk::ReadbackTexture(TextureHandle texture, u32 mipLevel, u32 arrayLayer, ReadbackTicket& out_ticket, ReadbackCallbackFn callback)
+	{
+		PROFILE_SCOPE("DeviceContextVk_ReadbackTexture");
+
+		out_ticket = {};
+
+		TextureVk* textureVk = static_cast<TextureVk*>(m_pRenderDevice->ResolveHandle(texture));
+		if (textureVk == nullptr)
+		{
+			LogError("Failed to read back texture. Texture pointer is null!");
+			return STATUS_CODE::ERR_API;
+		}
+
+		if (mipLevel >= textureVk->GetMipLevels() || arrayLayer >= textureVk->GetArrayLayers())
+		{
+			LogError("Failed to read back texture. Mip level %u or array layer %u is out of range (texture has %u mip levels and %u array layers)", mipLevel, arrayLayer, textureVk->GetMipLevels(), textureVk->GetArrayLayers());
+			return STATUS_CODE::ERR_API;
+		}
+
+		// Copies can only read a single aspect at a time
+		const AspectTypeFlags aspectFlags = textureVk->GetAspectFlags();
+		if ((aspectFlags & ASPECT_TYPE_FLAG_DEPTH) && (aspectFlags & ASPECT_TYPE_FLAG_STENCIL))
+		{
+			LogError("Failed to read back texture. Depth/stencil textures can't be read back!");
+			return STATUS_CODE::ERR_API;
+		}
 
-		// Calculate mip-level dimensions from the base texture size
+		if ((textureVk->GetUsageFlags() & USAGE_TYPE_FLAG_TRANSFER_SRC) == 0)
+		{
+			LogError("Failed to read back texture \"%s\". It wasn't created with USAGE_TYPE_FLAG_TRANSFER_SRC!", textureVk->GetName());
+			return STATUS_CODE::ERR_API;
+		}
+
+		VkImageSubresourceRange readbackRange{};
+		readbackRange.aspectMask = TEX_UTILS::ConvertAspectFlags(aspectFlags);
+		readbackRange.baseMipLevel = mipLevel;
+		readbackRange.levelCount = 1;
+		readbackRange.baseArrayLayer = arrayLayer;
+		readbackRange.layerCount = 1;
+
+		// Layouts are only ever changed on the main thread, so worker contexts can only read back textures the render graph
+		// already transitioned (texture inputs of transfer passes)
+		const VkImageLayout srcLayout = textureVk->GetLayout(readbackRange);
+		if (srcLayout != VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL && IsWorkerContext())
+		{
+			LogError("Failed to read back texture \"%s\". Textures read back from worker threads must be in TRANSFER_SRC_OPTIMAL layout!", textureVk->GetName());
+			return STATUS_CODE::ERR_API;
+		}
+
+		// Tightly packed, compressed formats are read back as whole 4x4 blocks
 		const u32 mipWidth = std::max(1u, textureVk->GetWidth() >> mipLevel);
 		const u32 mipHeight = std::max(1u, textureVk->GetHeight() >> mipLevel);
+		const BASE_FORMAT format = textureVk->GetFormat();
+		u64 sizeBytes = 0;
+		if (IsCompressedFormat(format))
+		{
+			sizeBytes = static_cast<u64>((mipWidth + 3) / 4) * ((mipHeight + 3) / 4) * GetBaseFormatSize(format);
+		}
+		else
+		{
+			sizeBytes = static_cast<u64>(mipWidth) * mipHeight * GetBaseFormatSize(format);
+		}
+
+		// Textures which aren't shared with the transfer queue family (attachments) are owned by the graphics queue family,
+		// so they're read back on the graphics queue. Whole mip levels always fit the transfer queue family's granularity
+		const bool isTransferCopyAligned = m_pRenderDevice->IsTransferImageCopyAligned({ 0, 0, 0 }, { mipWidth, mipHeight, 1 }, { mipWidth, mipHeight, 1 }, IsCompressedFormat(format) ? 4 : 1);
+		VkCommandBuffer cmdBuffer = VK_NULL_HANDLE;
+		const QUEUE_TYPE transferQueueType = (textureVk->IsConcurrent() && isTransferCopyAligned) ? QUEUE_TYPE::TRANSFER : QUEUE_TYPE::GRAPHICS;
+
+		STATUS_CODE res = GetOrCreateCommandBuffer(transferQueueType, cmdBuffer);
+		if (res != STATUS_CODE::SUCCESS)
+		{
+			LogError("Failed to read back texture! Command buffer creation failed");
+			return res;
+		}
+
+		const ReadbackAllocation readbackAlloc = m_pRenderDevice->GetReadbackPool()->Acquire(m_assignedFrameIndex, sizeBytes, callback);
+		if (!readbackAlloc.isValid)
+		{
+			LogError("Failed to read back texture. Could not acquire readback memory!");
+			return STATUS_CODE::ERR_INTERNAL;
+		}
+
+#if defined(PROFILER_TRACY)
+		tracy::VkCtx* pTracyCtx = m_tracyCtxs[static_cast<u32>(ResolveQueueType(transferQueueType))];
+		ASSERT_PTR(pTracyCtx);
+		PROFILE_VK_ZONE(pTracyCtx, cmdBuffer, "ReadbackTexture");
+#endif
 
 		VkBufferImageCopy copyRegion{};
-		copyRegion.bufferOffset = stagingAlloc.offset;
+		copyRegion.bufferOffset = 0;
 		copyRegion.bufferRowLength = 0;
 		copyRegion.bufferImageHeight = 0;
 
-		copyRegion.imageSubresource.aspectMask = TEX_UTILS::ConvertAspectFlags(textureVk->GetAspectFlags());
+		copyRegion.imageSubresource.aspectMask = readbackRange.aspectMask;
 		copyRegion.imageSubresource.mipLevel = mipLevel;
-		copyRegion.imageSubresource.baseArrayLayer = 0;
-		copyRegion.imageSubresource.layerCount = textureVk->GetArrayLayers();
+		copyRegion.imageSubresource.baseArrayLayer = arrayLayer;
+		copyRegion.imageSubresource.layerCount = 1;
 
 		copyRegion.imageOffset = { 0, 0, 0 };
 		copyRegion.imageExtent = { mipWidth, mipHeight, 1 };
 
-		vkCmdCopyBufferToImage(cmdBuffer, stagingAlloc.buffer, textureVk->GetBaseImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
+		// Texture inputs of transfer passes are already transitioned by the render graph. Anything else is transitioned from its
+		// tracked layout, which is left at TRANSFER_SRC_OPTIMAL so the render graph transitions it back when it's next used
+		if (srcLayout != VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL)
+		{
+			QueueImageMemoryBarrier(textureVk, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_MEMORY_WRITE_BIT_KHR,
+				VK_ACCESS_2_TRANSFER_READ_BIT_KHR, srcLayout, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readbackRange);
+			res = FlushBarriers(transferQueueType);
+			if (res != STATUS_CODE::SUCCESS)
+			{
+				LogError("Failed to read back texture! Could not transition texture to TRANSFER_SRC_OPTIMAL");
+				return res;
+			}
+			textureVk->SetLayout(VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readbackRange);
+		}
+
+		vkCmdCopyImageToBuffer(cmdBuffer, textureVk->GetBaseImage(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readbackAlloc.buffer, 1, &copyRegion);
 
+		// Makes the copy available to the host once the frame fence signals
+		res = InsertMemoryBarrier(transferQueueType, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_HOST_READ_BIT);
+		if (res != STATUS_CODE::SUCCESS)
+		{
+			LogError("Failed to read back texture! Could not insert host barrier");
+			return res;
+		}
+
+		out_ticket = readbackAlloc.ticket;
 		return STATUS_CODE::SUCCESS;
 	}
 
+	READBACK_STATUS DeviceContextVk::GetReadbackStatus(ReadbackTicket ticket)
+	{
+		return m_pRenderDevice->GetReadbackPool()->GetStatus(ticket);
+	}
+
+	STATUS_CODE DeviceContextVk::GetReadbackData(ReadbackTicket ticket, const void*& out_pData, u64& out_sizeBytes)
+	{
+		return m_pRenderDevice->GetReadbackPool()->GetData(ticket, out_pData, out_sizeBytes);
+	}
+
+	void DeviceContextVk::ReleaseReadback(ReadbackTicket ticket)
+	{
+		m_pRenderDevice->GetReadbackPool()->Release(ticket);
+	}
+
 	STATUS_CODE DeviceContextVk::BeginFrame(SwapChainVk* pSwapChain)
 	{
 		PROFILE_SCOPE("DeviceContextVk_BeginFrame");
@@ -880,17 +1605,11 @@ namespace PHX
 			return STATUS_CODE::ERR_INTERNAL;
 		}
 
-		if (pSwapChain == nullptr)
-		{
-			LogError("Failed to begin frame! Swap chain pointer is null");
-			return STATUS_CODE::ERR_INTERNAL;
-		}
-
 		STATUS_CODE res;
 		VkResult vkRes;
 
 		// Wait on the single frame fence signaled by the last submission batch of the previous frame
-		// with this index. Because batches are chained with semaphores (each waits on the previous),
+		// with this index. Because the last batch waits on every other batch through semaphores,
 		// the last batch completing guarantees that every batch — and therefore all command buffers and
 		// staging memory — from that frame is done on the GPU.
 		if (m_workFlushed)
@@ -909,6 +1628,10 @@ namespace PHX
 				}
 			}
 
+			// Readbacks recorded in the previous frame with this index are done. Completed before the fence is reset, so
+			// readbacks polled in the meantime never see an unsignaled fence for a finished frame
+			m_pRenderDevice->GetReadbackPool()->CompleteFrame(m_assignedFrameIndex);
+
 			// Reset fences
 			{
 				PROFILE_SCOPE("DeviceContextVk_ResetFences");
@@ -921,12 +1644,20 @@ namespace PHX
 			}
 		}
 
-		// Reset staging pool for reuse. The fence wait above guarantees the GPU is done
-		// with the staging memory from the previous frame with the same index.
-		ResetStagingPool();
+		// Reclaim the staging memory of the previous frame with the same index, including the uploads of its worker device
+		// contexts. The fence wait above guarantees the GPU is done with it
+		m_pRenderDevice->GetStagingBufferPool()->CompleteFrame(m_assignedFrameIndex);
+		m_pRenderDevice->GetTransientUniformRing()->Reset(m_assignedFrameIndex);
+		TransientUniformRing* pIndirectCommandRing = m_pRenderDevice->GetIndirectCommandRing();
+		if (pIndirectCommandRing != nullptr)
+		{
+			pIndirectCommandRing->Reset(m_assignedFrameIndex);
+		}
 		ResetCommandBuffers();
+		ResetEvents();
 
-		// Acquire next image
+		// Acquire next image. Headless frames have nothing to acquire
+		if (pSwapChain != nullptr)
 		{
 			PROFILE_SCOPE("DeviceContextVk_AcquireNextImage");
 
@@ -940,7 +1671,10 @@ namespace PHX
 		}
 
 		// Reset work submission tracking for the new frame
+		InvalidateBoundState();
 		m_workFlushed = false;
+		m_useAsyncCompute = false;
+		m_transferOnGraphicsQueue = false;
 
 		return STATUS_CODE::SUCCESS;
 	}
@@ -956,6 +1690,45 @@ namespace PHX
 			return STATUS_CODE::SUCCESS;
 		}
 
+		// Headless frames neither wait on an acquired image nor signal presentation
+		VkSemaphore imageAvailableSemaphore = VK_NULL_HANDLE;
+		VkSemaphore renderFinishedSemaphore = VK_NULL_HANDLE;
+		if (pSwapChain != nullptr)
+		{
+			imageAvailableSemaphore = m_pRenderDevice->GetImageAvailableSemaphore(m_assignedFrameIndex);
+			renderFinishedSemaphore = pSwapChain->GetRenderFinishedSemaphore();
+		}
+		VkFence frameFence = m_pRenderDevice->GetQueueFence(QUEUE_TYPE::GRAPHICS, m_assignedFrameIndex);
+
+		STATUS_CODE res = STATUS_CODE::SUCCESS;
+		if (m_pRenderDevice->IsTimelineSemaphoreSupported())
+		{
+			res = SubmitTimelineBatches(imageAvailableSemaphore, renderFinishedSemaphore, frameFence);
+		}
+		else
+		{
+			res = SubmitChainedBatches(imageAvailableSemaphore, renderFinishedSemaphore, frameFence);
+		}
+
+		if (res != STATUS_CODE::SUCCESS)
+		{
+			// If we failed to flush, we cannot delete resources because they
+			// might still be in-use by the GPU
+			return res;
+		}
+
+		// At least one batch was submitted and the last one signaled the frame fence, so BeginFrame
+		// must wait on it next time this frame index comes around.
+		m_workFlushed = true;
+		m_pRenderDevice->GetReadbackPool()->SubmitFrame(m_assignedFrameIndex);
+
+		return STATUS_CODE::SUCCESS;
+	}
+
+	STATUS_CODE DeviceContextVk::SubmitChainedBatches(VkSemaphore imageAvailableSemaphore, VkSemaphore renderFinishedSemaphore, VkFence frameFence)
+	{
+		PROFILE_SCOPE("DeviceContextVk_SubmitChainedBatches");
+
 		// Submit the batches in the order they were recorded (which is the render graph's dependency
 		// order). Batches are chained together with binary semaphores so that a consumer batch on one
 		// queue does not begin until its producer batch on another queue has finished:
@@ -966,7 +1739,9 @@ namespace PHX
 		//   - the last batch signals 'render finished' (which Present waits on) and the frame fence
 		//
 		// Only the last batch signals the frame fence: since every batch waits on the previous one,
-		// the last batch completing implies all earlier batches are done too.
+		// the last batch completing implies all earlier batches are done too. Headless frames have no
+		// 'image available' or 'render finished' semaphores, so those waits and signals are skipped.
+		const u32 batchCount = static_cast<u32>(m_submissionBatches.size());
 		STATUS_CODE res = EnsureChainSemaphores(batchCount > 0 ? batchCount - 1 : 0);
 		if (res != STATUS_CODE::SUCCESS)
 		{
@@ -974,16 +1749,6 @@ namespace PHX
 			return res;
 		}
 
-		if (pSwapChain == nullptr)
-		{
-			LogError("Failed to end frame! Swap chain pointer is null");
-			return STATUS_CODE::ERR_INTERNAL;
-		}
-
-		VkSemaphore imageAvailableSemaphore = m_pRenderDevice->GetImageAvailableSemaphore(m_assignedFrameIndex);
-		VkSemaphore renderFinishedSemaphore = pSwapChain->GetRenderFinishedSemaphore();
-		VkFence frameFence = m_pRenderDevice->GetQueueFence(QUEUE_TYPE::GRAPHICS, m_assignedFrameIndex);
-
 		for (u32 i = 0; i < batchCount; i++)
 		{
 			const SubmissionBatch& batch = m_submissionBatches[i];
@@ -995,24 +1760,126 @@ namespace PHX
 
 			FlushSyncData syncData{};
 			syncData.pWaitSemaphores     = &waitSemaphore;
-			syncData.waitSemaphoreCount  = 1;
+			syncData.waitSemaphoreCount  = (waitSemaphore != VK_NULL_HANDLE) ? 1 : 0;
 			syncData.pSignalSemaphores   = &signalSemaphore;
-			syncData.signalSemaphoreCount = 1;
+			syncData.signalSemaphoreCount = (signalSemaphore != VK_NULL_HANDLE) ? 1 : 0;
 			syncData.signalFence         = isLastBatch ? frameFence : VK_NULL_HANDLE;
 
-			res = FlushInternal(batch.queueType, &batch.cmdBuffer, 1, syncData);
+			res = FlushInternal(batch.queueType, batch.cmdBuffers.data(), static_cast<u32>(batch.cmdBuffers.size()), syncData);
 			if (res != STATUS_CODE::SUCCESS)
 			{
 				LogError("Failed to end frame. Could not flush submission batch %u (queue type %u)!", i, static_cast<u32>(batch.queueType));
-				// If we failed to flush, we cannot delete resources because they
-				// might still be in-use by the GPU
 				return res;
 			}
 		}
 
-		// At least one batch was submitted and the last one signaled the frame fence, so BeginFrame
-		// must wait on it next time this frame index comes around.
-		m_workFlushed = true;
+		return STATUS_CODE::SUCCESS;
+	}
+
+	STATUS_CODE DeviceContextVk::SubmitTimelineBatches(VkSemaphore imageAvailableSemaphore, VkSemaphore renderFinishedSemaphore, VkFence frameFence)
+	{
+		PROFILE_SCOPE("DeviceContextVk_SubmitTimelineBatches");
+
+		// Submit the batches in the order they were recorded (which is the render graph's dependency
+		// order). Every batch signals the next value of its queue type's timeline semaphore, and only
+		// waits on the batches it actually depends on:
+		//
+		//   - batch i waits on the timeline values signaled by its producer batches on other queues
+		//   - the batch that first writes the swapchain image waits on the 'image available' semaphore
+		//   - the first batch on every queue waits on the end of the previous frame
+		//   - the last batch waits on the last batch of every other queue, then signals 'render finished'
+		//     (which Present waits on) and the frame fence
+		//
+		// Batches on the same queue are ordered by their pipeline barriers, so they never wait on each other.
+		// Since the last batch joins every queue, its completion implies all earlier batches are done too.
+		// Headless frames skip the 'image available' wait and the 'render finished' signal.
+		const u32 batchCount = static_cast<u32>(m_submissionBatches.size());
+		const u32 lastBatchIndex = batchCount - 1;
+		AddJoinWaits(lastBatchIndex);
+
+		// The swap chain image is acquired by the batch that first writes it. If no batch is marked,
+		// nothing may start before the acquire
+		u32 swapChainBatchIndex = 0;
+		for (u32 i = 0; i < batchCount; i++)
+		{
+			if (m_submissionBatches[i].waitsOnSwapChain)
+			{
+				swapChainBatchIndex = i;
+				break;
+			}
+		}
+
+		QUEUE_TYPE prevFrameQueueType = QUEUE_TYPE::GRAPHICS;
+		u64 prevFrameValue = 0;
+		const bool hasPrevFrame = m_pRenderDevice->GetFrameEndTimelinePoint(prevFrameQueueType, prevFrameValue);
+		const VkQueue prevFrameQueue = hasPrevFrame ? m_pRenderDevice->GetQueue(prevFrameQueueType) : VK_NULL_HANDLE;
+
+		std::vector<VkQueue>& startedQueues = m_startedQueues;
+		std::vector<VkSemaphore>& waitSemaphores = m_waitSemaphores;
+		std::vector<VkPipelineStageFlags>& waitStages = m_waitStages;
+		std::vector<u64>& waitValues = m_waitValues;
+		startedQueues.clear();
+
+		for (u32 i = 0; i < batchCount; i++)
+		{
+			SubmissionBatch& batch = m_submissionBatches[i];
+			const bool isLastBatch = (i == lastBatchIndex);
+
+			waitSemaphores.clear();
+			waitStages.clear();
+			waitValues.clear();
+
+			if (i == swapChainBatchIndex && imageAvailableSemaphore != VK_NULL_HANDLE)
+			{
+				waitSemaphores.push_back(imageAvailableSemaphore);
+				waitStages.push_back(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+				waitValues.push_back(0);
+			}
+
+			if (std::find(startedQueues.begin(), startedQueues.end(), batch.queue) == startedQueues.end())
+			{
+				startedQueues.push_back(batch.queue);
+				if (hasPrevFrame && batch.queue != prevFrameQueue)
+				{
+					waitSemaphores.push_back(m_pRenderDevice->GetTimelineSemaphore(prevFrameQueueType));
+					waitStages.push_back(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+					waitValues.push_back(prevFrameValue);
+				}
+			}
+
+			for (u32 producerBatchIndex : batch.waitBatches)
+			{
+				const SubmissionBatch& producerBatch = m_submissionBatches[producerBatchIndex];
+				waitSemaphores.push_back(m_pRenderDevice->GetTimelineSemaphore(producerBatch.queueType));
+				waitStages.push_back(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+				waitValues.push_back(producerBatch.signalValue);
+			}
+
+			batch.signalValue = m_pRenderDevice->AdvanceTimelineValue(batch.queueType);
+
+			VkSemaphore signalSemaphores[] = { m_pRenderDevice->GetTimelineSemaphore(batch.queueType), renderFinishedSemaphore };
+			u64 signalValues[] = { batch.signalValue, 0 };
+
+			FlushSyncData syncData{};
+			syncData.pWaitSemaphores      = waitSemaphores.data();
+			syncData.pWaitDstStageMasks   = waitStages.data();
+			syncData.pWaitValues          = waitValues.data();
+			syncData.waitSemaphoreCount   = static_cast<u32>(waitSemaphores.size());
+			syncData.pSignalSemaphores    = signalSemaphores;
+			syncData.pSignalValues        = signalValues;
+			syncData.signalSemaphoreCount = (isLastBatch && renderFinishedSemaphore != VK_NULL_HANDLE) ? 2 : 1;
+			syncData.signalFence          = isLastBatch ? frameFence : VK_NULL_HANDLE;
+
+			STATUS_CODE res = FlushInternal(batch.queueType, batch.cmdBuffers.data(), static_cast<u32>(batch.cmdBuffers.size()), syncData);
+			if (res != STATUS_CODE::SUCCESS)
+			{
+				LogError("Failed to end frame. Could not flush submission batch %u (queue type %u)!", i, static_cast<u32>(batch.queueType));
+				return res;
+			}
+		}
+
+		const SubmissionBatch& lastBatch = m_submissionBatches[lastBatchIndex];
+		m_pRenderDevice->SetFrameEndTimelinePoint(lastBatch.queueType, lastBatch.signalValue);
 
 		return STATUS_CODE::SUCCESS;
 	}
@@ -1022,6 +1889,120 @@ namespace PHX
 		return m_workFlushed;
 	}
 
+	void DeviceContextVk::SetAsyncCompute(bool enabled)
+	{
+		m_useAsyncCompute = enabled;
+	}
+
+	void DeviceContextVk::SetTransferOnGraphicsQueue(bool enabled)
+	{
+		m_transferOnGraphicsQueue = enabled;
+	}
+
+	STATUS_CODE DeviceContextVk::PrepareBatch(QUEUE_TYPE type, const u32* pProducerBatchIndices, u32 producerCount, bool waitsOnSwapChain, u32& out_batchIndex)
+	{
+		PROFILE_SCOPE("DeviceContextVk_PrepareBatch");
+
+		// The current batch is reused as is if it targets the same queue, or if commands are being recorded into a worker's
+		// command buffer of it. This doesn't acquire a command buffer, since the pass might be recorded by a worker
+		const bool canReuseBatch = !m_submissionBatches.empty() &&
+			(m_recordingTarget != VK_NULL_HANDLE || m_submissionBatches.back().queue == m_pRenderDevice->GetQueue(ResolveQueueType(type)));
+		if (!canReuseBatch)
+		{
+			// Batches created here have their dependencies tracked by the caller
+			m_isPreparingBatch = true;
+			VkCommandBuffer cmdBuffer = VK_NULL_HANDLE;
+			STATUS_CODE res = GetOrCreateCommandBuffer(type, cmdBuffer);
+			m_isPreparingBatch = false;
+
+			if (res != STATUS_CODE::SUCCESS)
+			{
+				LogError("Failed to prepare submission batch! Could not get or create command buffer");
+				return res;
+			}
+		}
+
+		out_batchIndex = static_cast<u32>(m_submissionBatches.size()) - 1;
+		for (u32 i = 0; i < producerCount; i++)
+		{
+			AddBatchWait(out_batchIndex, pProducerBatchIndices[i]);
+		}
+
+		m_submissionBatches[out_batchIndex].waitsOnSwapChain |= waitsOnSwapChain;
+
+		return STATUS_CODE::SUCCESS;
+	}
+
+	STATUS_CODE DeviceContextVk::AppendWorkerCommandBuffer(DeviceContextVk* pWorkerContext, VkCommandBuffer& out_cmdBuffer)
+	{
+		PROFILE_SCOPE("DeviceContextVk_AppendWorkerCommandBuffer");
+
+		if (pWorkerContext == nullptr || !pWorkerContext->IsWorkerContext())
+		{
+			LogError("Failed to append worker command buffer! Device context is not a worker context");
+			return STATUS_CODE::ERR_INTERNAL;
+		}
+
+		if (m_submissionBatches.empty())
+		{
+			LogError("Failed to append worker command buffer! No batch has been prepared");
+			return STATUS_CODE::ERR_INTERNAL;
+		}
+
+		// The command buffer comes from the worker's pools, so the worker can record into it without synchronizing with
+		// any other thread. It's returned to the worker's cache when the worker begins its next frame with this index
+		SubmissionBatch& batch = m_submissionBatches.back();
+		STATUS_CODE res = pWorkerContext->AcquireCommandBuffer(batch.queueType, out_cmdBuffer);
+		if (res != STATUS_CODE::SUCCESS)
+		{
+			LogError("Failed to append worker command buffer! Could not acquire command buffer from worker");
+			return res;
+		}
+
+		TryWriteBeginTimestamp(batch.queueType, out_cmdBuffer);
+
+		// Anything this context records into the batch afterwards must go into a new command buffer, so it isn't
+		// submitted before the commands of the worker
+		batch.cmdBuffers.push_back(out_cmdBuffer);
+		batch.cmdBuffer = VK_NULL_HANDLE;
+
+		m_recordingTarget = out_cmdBuffer;
+
+		return STATUS_CODE::SUCCESS;
+	}
+
+	void DeviceContextVk::SetRecordingTarget(VkCommandBuffer cmdBuffer)
+	{
+		m_recordingTarget = cmdBuffer;
+		InvalidateBoundState();
+	}
+
+	void DeviceContextVk::ResetRecordingTarget()
+	{
+		m_recordingTarget = VK_NULL_HANDLE;
+		InvalidateBoundState();
+	}
+
+	STATUS_CODE DeviceContextVk::BeginWorkerFrame()
+	{
+		PROFILE_SCOPE("DeviceContextVk_BeginWorkerFrame");
+
+		// Workers never submit, so the primary device context's fence wait for this frame index already guarantees the
+		// GPU is done with the worker's command buffers. Their staging memory is reclaimed along with the primary's
+		ResetCommandBuffers();
+
+		m_recordingTarget = VK_NULL_HANDLE;
+		m_contextualPipeline = nullptr;
+		InvalidateBoundState();
+
+		return STATUS_CODE::SUCCESS;
+	}
+
+	bool DeviceContextVk::IsWorkerContext() const
+	{
+		return m_workerIndex != U32_MAX;
+	}
+
 	STATUS_CODE DeviceContextVk::BeginRenderPass(VkRenderPass renderPass, FramebufferVk* pFramebuffer, ClearValues* pClearColors, u32 clearColorCount)
 	{
 		PROFILE_SCOPE("DeviceContextVk_BeginRenderPass");
@@ -1035,7 +2016,8 @@ namespace PHX
 		}
 
 		// Process clear values
-		std::vector<VkClearValue> vkClearValues(clearColorCount);
+		std::vector<VkClearValue>& vkClearValues = m_clearValues;
+		vkClearValues.resize(clearColorCount);
 		for (u32 i = 0; i < clearColorCount; i++)
 		{
 			VkClearValue clearValues{};
@@ -1065,6 +2047,23 @@ namespace PHX
 		return STATUS_CODE::SUCCESS;
 	}
 
+	STATUS_CODE DeviceContextVk::NextSubpass()
+	{
+		PROFILE_SCOPE("DeviceContextVk_NextSubpass");
+
+		VkCommandBuffer cmdBuffer = VK_NULL_HANDLE;
+		STATUS_CODE res = GetOrCreateCommandBuffer(QUEUE_TYPE::GRAPHICS, cmdBuffer);
+		if (res != STATUS_CODE::SUCCESS)
+		{
+			LogError("Failed to move to next subpass! Could not get or create command buffer");
+			return STATUS_CODE::ERR_INTERNAL;
+		}
+
+		vkCmdNextSubpass(cmdBuffer, VK_SUBPASS_CONTENTS_INLINE);
+
+		return STATUS_CODE::SUCCESS;
+	}
+
 	STATUS_CODE DeviceContextVk::EndRenderPass()
 	{
 		PROFILE_SCOPE("DeviceContextVk_EndRenderPass");
@@ -1126,101 +2125,240 @@ namespace PHX
 			return STATUS_CODE::ERR_INTERNAL;
 		}
 
-		VkCommandBuffer cmdBuffer;
+		QueueImageMemoryBarrier(pTexture, srcStageMask, dstStageMask, srcAccessMask, dstAccessMask, oldLayout, newLayout, pTexture->GetSubresourceRange());
+		return FlushBarriers(queueType);
+	}
+
+	STATUS_CODE DeviceContextVk::InsertBufferMemoryBarrier(BufferVk* pBuffer, QUEUE_TYPE queueType, VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask, VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask)
+	{
+		PROFILE_SCOPE("DeviceContextVk_InsertBufferMemoryBarrier");
+
+		if (pBuffer == nullptr)
+		{
+			LogError("Failed to insert buffer memory barrier. Buffer pointer is null!");
+			return STATUS_CODE::ERR_API;
+		}
+
+		QueueMemoryBarrier(srcStageMask, dstStageMask, srcAccessMask, dstAccessMask);
+		return FlushBarriers(queueType);
+	}
+
+	STATUS_CODE DeviceContextVk::InsertAccelerationStructureMemoryBarrier(AccelerationStructureVk* pAS, QUEUE_TYPE queueType, VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask, VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask)
+	{
+		PROFILE_SCOPE("DeviceContextVk_InsertAccelerationStructureMemoryBarrier");
+
+		ASSERT_MSG(m_pRenderDevice->IsRayTracingSupported(), "Failed to insert acceleration structure memory barrier. Ray tracing is not supported on this device!");
+
+		if (pAS == nullptr)
+		{
+			LogError("Failed to insert acceleration structure memory barrier. Acceleration structure pointer is null!");
+			return STATUS_CODE::ERR_API;
+		}
+
+		BufferData& resultBuffer = pAS->GetResultBuffer();
+		if (!resultBuffer.isValid)
+		{
+			LogError("Failed to insert acceleration structure memory barrier. Result buffer is invalid!");
+			return STATUS_CODE::ERR_INTERNAL;
+		}
+
+		QueueMemoryBarrier(srcStageMask, dstStageMask, srcAccessMask, dstAccessMask);
+		return FlushBarriers(queueType);
+	}
+
+	STATUS_CODE DeviceContextVk::InsertMemoryBarrier(QUEUE_TYPE queueType, VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask, VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask)
+	{
+		PROFILE_SCOPE("DeviceContextVk_InsertMemoryBarrier");
+
+		QueueMemoryBarrier(srcStageMask, dstStageMask, srcAccessMask, dstAccessMask);
+		return FlushBarriers(queueType);
+	}
+
+	void DeviceContextVk::QueueImageMemoryBarrier(TextureVk* pTexture, VkPipelineStageFlags2KHR srcStageMask, VkPipelineStageFlags2KHR dstStageMask, VkAccessFlags2KHR srcAccessMask, VkAccessFlags2KHR dstAccessMask, VkImageLayout oldLayout, VkImageLayout newLayout, const VkImageSubresourceRange& subresourceRange)
+	{
+		ASSERT_PTR(pTexture);
+
+		VkImageMemoryBarrier2KHR imageBarrier{};
+		imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR;
+		imageBarrier.srcStageMask = srcStageMask;
+		imageBarrier.srcAccessMask = srcAccessMask;
+		imageBarrier.dstStageMask = dstStageMask;
+		imageBarrier.dstAccessMask = dstAccessMask;
+		imageBarrier.oldLayout = oldLayout;
+		imageBarrier.newLayout = newLayout;
+		imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		imageBarrier.image = pTexture->GetBaseImage();
+		imageBarrier.subresourceRange = subresourceRange;
+
+		m_pendingImageBarriers.push_back(imageBarrier);
+	}
+
+	void DeviceContextVk::QueueMemoryBarrier(VkPipelineStageFlags2KHR srcStageMask, VkPipelineStageFlags2KHR dstStageMask, VkAccessFlags2KHR srcAccessMask, VkAccessFlags2KHR dstAccessMask)
+	{
+		if (!m_hasPendingMemoryBarrier)
+		{
+			m_pendingMemoryBarrier = {};
+			m_pendingMemoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2_KHR;
+			m_hasPendingMemoryBarrier = true;
+		}
+
+		m_pendingMemoryBarrier.srcStageMask |= srcStageMask;
+		m_pendingMemoryBarrier.srcAccessMask |= srcAccessMask;
+		m_pendingMemoryBarrier.dstStageMask |= dstStageMask;
+		m_pendingMemoryBarrier.dstAccessMask |= dstAccessMask;
+	}
+
+	STATUS_CODE DeviceContextVk::FlushBarriers(QUEUE_TYPE queueType)
+	{
+		PROFILE_SCOPE("DeviceContextVk_FlushBarriers");
+
+		const u32 imageBarrierCount = static_cast<u32>(m_pendingImageBarriers.size());
+		const u32 memoryBarrierCount = m_hasPendingMemoryBarrier ? 1 : 0;
+		if (imageBarrierCount == 0 && memoryBarrierCount == 0)
+		{
+			return STATUS_CODE::SUCCESS;
+		}
+
+		VkCommandBuffer cmdBuffer = VK_NULL_HANDLE;
 		STATUS_CODE res = GetOrCreateCommandBuffer(queueType, cmdBuffer);
 		if (res != STATUS_CODE::SUCCESS)
 		{
-			LogError("Failed to insert image memory barrier. Could not retrive or create a valid command buffer!");
-			return res;
+			LogError("Failed to flush barriers. Could not get or create command buffer!");
+			ClearPendingBarriers();
+			return res;
+		}
+
+		if (m_pRenderDevice->IsSynchronization2Supported())
+		{
+			VkDependencyInfoKHR dependencyInfo{};
+			BuildPendingDependencyInfo(dependencyInfo);
+
+			m_pRenderDevice->CmdPipelineBarrier2(cmdBuffer, &dependencyInfo);
+		}
+		else
+		{
+			// Legacy barrier commands only have a single pair of stage masks for all of their barriers
+			VkPipelineStageFlags srcStageMask = 0;
+			VkPipelineStageFlags dstStageMask = 0;
+
+			VkMemoryBarrier memoryBarrier{};
+			memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+			if (m_hasPendingMemoryBarrier)
+			{
+				memoryBarrier.srcAccessMask = ConvertToLegacyAccessFlags(m_pendingMemoryBarrier.srcAccessMask);
+				memoryBarrier.dstAccessMask = ConvertToLegacyAccessFlags(m_pendingMemoryBarrier.dstAccessMask);
+				srcStageMask |= ConvertToLegacyStageFlags(m_pendingMemoryBarrier.srcStageMask);
+				dstStageMask |= ConvertToLegacyStageFlags(m_pendingMemoryBarrier.dstStageMask);
+			}
+
+			m_legacyImageBarriers.resize(imageBarrierCount);
+			for (u32 i = 0; i < imageBarrierCount; i++)
+			{
+				const VkImageMemoryBarrier2KHR& imageBarrier = m_pendingImageBarriers[i];
+
+				VkImageMemoryBarrier& legacyBarrier = m_legacyImageBarriers[i];
+				legacyBarrier = {};
+				legacyBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+				legacyBarrier.srcAccessMask = ConvertToLegacyAccessFlags(imageBarrier.srcAccessMask);
+				legacyBarrier.dstAccessMask = ConvertToLegacyAccessFlags(imageBarrier.dstAccessMask);
+				legacyBarrier.oldLayout = imageBarrier.oldLayout;
+				legacyBarrier.newLayout = imageBarrier.newLayout;
+				legacyBarrier.srcQueueFamilyIndex = imageBarrier.srcQueueFamilyIndex;
+				legacyBarrier.dstQueueFamilyIndex = imageBarrier.dstQueueFamilyIndex;
+				legacyBarrier.image = imageBarrier.image;
+				legacyBarrier.subresourceRange = imageBarrier.subresourceRange;
+
+				srcStageMask |= ConvertToLegacyStageFlags(imageBarrier.srcStageMask);
+				dstStageMask |= ConvertToLegacyStageFlags(imageBarrier.dstStageMask);
+			}
+
+			// An empty stage mask is only valid with synchronization2
+			vkCmdPipelineBarrier(
+				cmdBuffer,
+				(srcStageMask != 0) ? srcStageMask : static_cast<VkPipelineStageFlags>(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT),
+				(dstStageMask != 0) ? dstStageMask : static_cast<VkPipelineStageFlags>(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT),
+				0,
+				memoryBarrierCount, &memoryBarrier,
+				0, nullptr, // Buffer barriers are folded into the memory barrier
+				imageBarrierCount, m_legacyImageBarriers.data()
+			);
+		}
+
+		if (m_pMetrics)
+		{
+			m_pMetrics->barrierCommands++;
+			m_pMetrics->barriers += imageBarrierCount + memoryBarrierCount;
+		}
+
+		ClearPendingBarriers();
+
+		return STATUS_CODE::SUCCESS;
+	}
+
+	STATUS_CODE DeviceContextVk::AcquireEvent(VkEvent& out_event)
+	{
+		if (m_usedEventCount < static_cast<u32>(m_events.size()))
+		{
+			out_event = m_events[m_usedEventCount++];
+			return STATUS_CODE::SUCCESS;
+		}
+
+		VkEventCreateInfo createInfo{};
+		createInfo.sType = VK_STRUCTURE_TYPE_EVENT_CREATE_INFO;
+
+		VkEvent event = VK_NULL_HANDLE;
+		VkResult res = vkCreateEvent(m_pRenderDevice->GetLogicalDevice(), &createInfo, nullptr, &event);
+		if (res != VK_SUCCESS)
+		{
+			LogError("Failed to create event! Got error: \"%s\"", string_VkResult(res));
+			return STATUS_CODE::ERR_INTERNAL;
 		}
 
-		VkImageMemoryBarrier imageBarrier;
-		imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-		imageBarrier.pNext = nullptr;
-		imageBarrier.oldLayout = oldLayout;
-		imageBarrier.newLayout = newLayout;
-		imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		imageBarrier.image = pTexture->GetBaseImage();
-		imageBarrier.subresourceRange.aspectMask = TEX_UTILS::ConvertAspectFlags(pTexture->GetAspectFlags());
-		imageBarrier.subresourceRange.baseMipLevel = 0;
-		imageBarrier.subresourceRange.levelCount = pTexture->GetMipLevels();
-		imageBarrier.subresourceRange.baseArrayLayer = 0;
-		imageBarrier.subresourceRange.layerCount = pTexture->GetArrayLayers();
-		imageBarrier.srcAccessMask = srcAccessMask;
-		imageBarrier.dstAccessMask = dstAccessMask;
-
-		vkCmdPipelineBarrier(
-			cmdBuffer,
-			srcStageMask,
-			dstStageMask,
-			0,
-			0, nullptr, // No memory barriers
-			0, nullptr, // No buffer barriers
-			1, &imageBarrier
-		);
+		m_events.push_back(event);
+		m_usedEventCount++;
 
+		out_event = event;
 		return STATUS_CODE::SUCCESS;
 	}
 
-	STATUS_CODE DeviceContextVk::InsertBufferMemoryBarrier(BufferVk* pBuffer, QUEUE_TYPE queueType, VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask, VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask)
+	STATUS_CODE DeviceContextVk::SignalEvent(QUEUE_TYPE queueType, VkEvent event)
 	{
-		PROFILE_SCOPE("DeviceContextVk_InsertBufferMemoryBarrier");
+		PROFILE_SCOPE("DeviceContextVk_SignalEvent");
 
-		if (pBuffer == nullptr)
+		if (!m_pRenderDevice->IsSynchronization2Supported())
 		{
-			LogError("Failed to insert buffer memory barrier. Buffer pointer is null!");
-			return STATUS_CODE::ERR_API;
+			LogError("Failed to signal event. Split barriers require synchronization2!");
+			ClearPendingBarriers();
+			return STATUS_CODE::ERR_INTERNAL;
 		}
 
-		VkCommandBuffer cmdBuffer;
+		VkCommandBuffer cmdBuffer = VK_NULL_HANDLE;
 		STATUS_CODE res = GetOrCreateCommandBuffer(queueType, cmdBuffer);
 		if (res != STATUS_CODE::SUCCESS)
 		{
-			LogError("Failed to insert buffer memory barrier. Could not retrive or create a valid command buffer!");
+			LogError("Failed to signal event. Could not get or create command buffer!");
+			ClearPendingBarriers();
 			return res;
 		}
 
-		VkBufferMemoryBarrier bufferBarrier;
-		bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
-		bufferBarrier.pNext = nullptr;
-		bufferBarrier.srcAccessMask = srcAccessMask;
-		bufferBarrier.dstAccessMask = dstAccessMask;
-		bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		bufferBarrier.buffer = pBuffer->GetBuffer();
-		bufferBarrier.offset = 0;
-		bufferBarrier.size = pBuffer->GetSize();
+		VkDependencyInfoKHR dependencyInfo{};
+		BuildPendingDependencyInfo(dependencyInfo);
+		m_pRenderDevice->CmdSetEvent2(cmdBuffer, event, &dependencyInfo);
 
-		vkCmdPipelineBarrier(
-			cmdBuffer,
-			srcStageMask,
-			dstStageMask,
-			0,
-			0, nullptr, // No memory barriers
-			1, &bufferBarrier,
-			0, nullptr	// No image barriers
-		);
+		ClearPendingBarriers();
 
 		return STATUS_CODE::SUCCESS;
 	}
 
-	STATUS_CODE DeviceContextVk::InsertAccelerationStructureMemoryBarrier(AccelerationStructureVk* pAS, QUEUE_TYPE queueType, VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask, VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask)
+	STATUS_CODE DeviceContextVk::WaitEvent(QUEUE_TYPE queueType, VkEvent event)
 	{
-		PROFILE_SCOPE("DeviceContextVk_InsertAccelerationStructureMemoryBarrier");
-
-		ASSERT_MSG(m_pRenderDevice->IsRayTracingSupported(), "Failed to insert acceleration structure memory barrier. Ray tracing is not supported on this device!");
-
-		if (pAS == nullptr)
-		{
-			LogError("Failed to insert acceleration structure memory barrier. Acceleration structure pointer is null!");
-			return STATUS_CODE::ERR_API;
-		}
+		PROFILE_SCOPE("DeviceContextVk_WaitEvent");
 
-		BufferData& resultBuffer = pAS->GetResultBuffer();
-		if (!resultBuffer.isValid)
+		if (!m_pRenderDevice->IsSynchronization2Supported())
 		{
-			LogError("Failed to insert acceleration structure memory barrier. Result buffer is invalid!");
+			LogError("Failed to wait on event. Split barriers require synchronization2!");
+			ClearPendingBarriers();
 			return STATUS_CODE::ERR_INTERNAL;
 		}
 
@@ -1228,33 +2366,43 @@ namespace PHX
 		STATUS_CODE res = GetOrCreateCommandBuffer(queueType, cmdBuffer);
 		if (res != STATUS_CODE::SUCCESS)
 		{
-			LogError("Failed to insert acceleration structure memory barrier. Could not get or create command buffer!");
-			return STATUS_CODE::ERR_INTERNAL;
+			LogError("Failed to wait on event. Could not get or create command buffer!");
+			ClearPendingBarriers();
+			return res;
 		}
 
-		VkBufferMemoryBarrier bufferBarrier{};
-		bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
-		bufferBarrier.srcAccessMask = srcAccessMask;
-		bufferBarrier.dstAccessMask = dstAccessMask;
-		bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		bufferBarrier.buffer = resultBuffer.buffer;
-		bufferBarrier.offset = 0;
-		bufferBarrier.size = resultBuffer.size;
+		VkDependencyInfoKHR dependencyInfo{};
+		BuildPendingDependencyInfo(dependencyInfo);
+		m_pRenderDevice->CmdWaitEvents2(cmdBuffer, 1, &event, &dependencyInfo);
 
-		vkCmdPipelineBarrier(
-			cmdBuffer,
-			srcStageMask,
-			dstStageMask,
-			0,
-			0, nullptr,
-			1, &bufferBarrier,
-			0, nullptr
-		);
+		if (m_pMetrics)
+		{
+			m_pMetrics->splitBarriers += dependencyInfo.imageMemoryBarrierCount + dependencyInfo.memoryBarrierCount;
+		}
+
+		ClearPendingBarriers();
 
 		return STATUS_CODE::SUCCESS;
 	}
 
+	bool DeviceContextVk::BuildPendingDependencyInfo(VkDependencyInfoKHR& out_dependencyInfo)
+	{
+		out_dependencyInfo = {};
+		out_dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+		out_dependencyInfo.memoryBarrierCount = m_hasPendingMemoryBarrier ? 1 : 0;
+		out_dependencyInfo.pMemoryBarriers = &m_pendingMemoryBarrier;
+		out_dependencyInfo.imageMemoryBarrierCount = static_cast<u32>(m_pendingImageBarriers.size());
+		out_dependencyInfo.pImageMemoryBarriers = m_pendingImageBarriers.data();
+
+		return (out_dependencyInfo.memoryBarrierCount + out_dependencyInfo.imageMemoryBarrierCount) > 0;
+	}
+
+	void DeviceContextVk::ClearPendingBarriers()
+	{
+		m_pendingImageBarriers.clear();
+		m_hasPendingMemoryBarrier = false;
+	}
+
 	STATUS_CODE DeviceContextVk::GetOrCreateCommandBuffer(QUEUE_TYPE type, VkCommandBuffer& out_cmdBuffer)
 	{
 		PROFILE_SCOPE("DeviceContextVk_GetOrCreateCommandBuffer");
@@ -1265,28 +2413,110 @@ namespace PHX
 			return STATUS_CODE::ERR_INTERNAL;
 		}
 
+		// Commands of a pass recorded in parallel all go into the pass' command buffer, which is part of the batch of
+		// the pass' queue. Every queue the render graph submits to supports transfer commands
+		if (m_recordingTarget != VK_NULL_HANDLE)
+		{
+			out_cmdBuffer = m_recordingTarget;
+			return STATUS_CODE::SUCCESS;
+		}
+
+		if (IsWorkerContext())
+		{
+			LogError("Failed to get command buffer. Worker device contexts can only record commands while the render graph executes passes!");
+			return STATUS_CODE::ERR_API;
+		}
+
+		const QUEUE_TYPE resolvedType = ResolveQueueType(type);
+
 		// Attempt to use an already-active command buffer from this frame
-		if (TryReuseActiveCommandBuffer(type, out_cmdBuffer))
+		if (TryReuseActiveCommandBuffer(resolvedType, out_cmdBuffer))
 		{
 			return STATUS_CODE::SUCCESS;
 		}
 
-		return AllocateCommandBuffer(type, out_cmdBuffer);
+		return AllocateCommandBuffer(resolvedType, out_cmdBuffer);
 	}
 
 	bool DeviceContextVk::TryReuseActiveCommandBuffer(QUEUE_TYPE type, VkCommandBuffer& out_cmdBuffer)
 	{
-		u32 familyIndex = m_pRenderDevice->GetQueueFamilyIndex(type);
+		VkQueue queue = m_pRenderDevice->GetQueue(type);
 
-		// Reuse the current (most recent) batch if it targets the same queue family. Commands
-		// recorded back-to-back on the same queue family belong in a single submission
-		if (!m_submissionBatches.empty() && m_submissionBatches.back().queueFamilyIndex == familyIndex)
+		// Reuse the current (most recent) batch if it targets the same queue. Commands
+		// recorded back-to-back on the same queue belong in a single submission
+		if (m_submissionBatches.empty() || m_submissionBatches.back().queue != queue)
 		{
-			out_cmdBuffer = m_submissionBatches.back().cmdBuffer;
-			return true;
+			return false;
 		}
 
-		return false;
+		// A worker's command buffer was appended to the batch since this device context last recorded into it. Commands
+		// recorded from now on must be submitted after it, so they go into a new command buffer at the end of the batch
+		SubmissionBatch& batch = m_submissionBatches.back();
+		if (batch.cmdBuffer == VK_NULL_HANDLE)
+		{
+			if (AcquireCommandBuffer(batch.queueType, batch.cmdBuffer) != STATUS_CODE::SUCCESS)
+			{
+				return false;
+			}
+			batch.cmdBuffers.push_back(batch.cmdBuffer);
+		}
+
+		out_cmdBuffer = batch.cmdBuffer;
+		return true;
+	}
+
+	QUEUE_TYPE DeviceContextVk::ResolveQueueType(QUEUE_TYPE type) const
+	{
+		if (type == QUEUE_TYPE::COMPUTE && m_useAsyncCompute && m_pRenderDevice->IsAsyncComputeSupported())
+		{
+			return QUEUE_TYPE::ASYNC_COMPUTE;
+		}
+
+		if (type == QUEUE_TYPE::TRANSFER && m_transferOnGraphicsQueue)
+		{
+			return QUEUE_TYPE::GRAPHICS;
+		}
+
+		return type;
+	}
+
+	void DeviceContextVk::AddBatchWait(u32 batchIndex, u32 producerBatchIndex)
+	{
+		ASSERT_MSG(producerBatchIndex <= batchIndex, "Batches can only wait on batches recorded before them!");
+
+		if (producerBatchIndex == batchIndex)
+		{
+			return;
+		}
+
+		SubmissionBatch& batch = m_submissionBatches[batchIndex];
+		if (m_submissionBatches[producerBatchIndex].queue == batch.queue)
+		{
+			return;
+		}
+
+		if (std::find(batch.waitBatches.begin(), batch.waitBatches.end(), producerBatchIndex) == batch.waitBatches.end())
+		{
+			batch.waitBatches.push_back(producerBatchIndex);
+		}
+	}
+
+	void DeviceContextVk::AddJoinWaits(u32 batchIndex)
+	{
+		std::vector<VkQueue>& joinedQueues = m_joinedQueues;
+		joinedQueues.clear();
+		joinedQueues.push_back(m_submissionBatches[batchIndex].queue);
+
+		for (u32 i = batchIndex; i > 0; i--)
+		{
+			const u32 producerBatchIndex = i - 1;
+			VkQueue producerQueue = m_submissionBatches[producerBatchIndex].queue;
+			if (std::find(joinedQueues.begin(), joinedQueues.end(), producerQueue) == joinedQueues.end())
+			{
+				joinedQueues.push_back(producerQueue);
+				AddBatchWait(batchIndex, producerBatchIndex);
+			}
+		}
 	}
 
 	void DeviceContextVk::InitTracyContexts()
@@ -1365,10 +2595,54 @@ namespace PHX
 	{
 		PROFILE_SCOPE("DeviceContextVk_AllocateCommandBuffer")
 
+		STATUS_CODE res = AcquireCommandBuffer(type, out_cmdBuffer);
+		if (res != STATUS_CODE::SUCCESS)
+		{
+			return res;
+		}
+
+		TryWriteBeginTimestamp(type, out_cmdBuffer);
+
+		SubmissionBatch newBatch{};
+		if (!m_recycledBatches.empty())
+		{
+			newBatch = std::move(m_recycledBatches.back());
+			m_recycledBatches.pop_back();
+		}
+		newBatch.queueType = type;
+		newBatch.queue = m_pRenderDevice->GetQueue(type);
+		newBatch.cmdBuffer = out_cmdBuffer;
+		newBatch.cmdBuffers.push_back(out_cmdBuffer);
+		newBatch.waitsOnSwapChain = false;
+		newBatch.signalValue = 0;
+		m_submissionBatches.push_back(std::move(newBatch));
+
+		// Batches created outside of PrepareBatch() (e.g. uploads recorded before the render graph executes) can't
+		// tell which batches they depend on, so they're ordered against everything around them
+		const u32 batchIndex = static_cast<u32>(m_submissionBatches.size()) - 1;
+		if (m_isPreparingBatch)
+		{
+			if (m_lastUntrackedBatch != U32_MAX)
+			{
+				AddBatchWait(batchIndex, m_lastUntrackedBatch);
+			}
+		}
+		else
+		{
+			AddJoinWaits(batchIndex);
+			m_lastUntrackedBatch = batchIndex;
+		}
+
+		return STATUS_CODE::SUCCESS;
+	}
+
+	STATUS_CODE DeviceContextVk::AcquireCommandBuffer(QUEUE_TYPE type, VkCommandBuffer& out_cmdBuffer)
+	{
+		PROFILE_SCOPE("DeviceContextVk_AcquireCommandBuffer");
+
 		u32 queueType = static_cast<u32>(type);
-		u32 familyIndex = m_pRenderDevice->GetQueueFamilyIndex(type);
 		VkDevice device = m_pRenderDevice->GetLogicalDevice();
-		VkCommandPool pool = m_pRenderDevice->GetCommandPool(type, m_assignedFrameIndex);
+		VkCommandPool pool = GetCommandPool(type);
 
 		// Pull from the cmd buffer cache. These are reset in bulk every frame through vkResetCommandPool()
 		auto& cache = m_commandBufferCache[static_cast<u32>(type)];
@@ -1405,35 +2679,56 @@ namespace PHX
 			return STATUS_CODE::ERR_INTERNAL;
 		}
 
+		m_acquiredCmdBuffers.push_back({ type, out_cmdBuffer });
+
+		// Command buffers are reused across frames, so the state shadowed for an earlier recording must be dropped
+		if (m_boundState.cmdBuffer == out_cmdBuffer)
+		{
+			InvalidateBoundState();
+		}
+
+		return STATUS_CODE::SUCCESS;
+	}
+
+	void DeviceContextVk::TryWriteBeginTimestamp(QUEUE_TYPE type, VkCommandBuffer cmdBuffer)
+	{
 		// If timestamp queries are enabled and this is the first graphics/compute command buffer
 		// of the frame, reset the query slots and write the begin timestamp. Transfer queues don't
 		// support timestamp queries, so we skip them and wait for a compatible queue
 		if (!m_beginTimestampWritten && m_queryPool != VK_NULL_HANDLE &&
-			(type == QUEUE_TYPE::GRAPHICS || type == QUEUE_TYPE::COMPUTE))
+			(type == QUEUE_TYPE::GRAPHICS || type == QUEUE_TYPE::COMPUTE || type == QUEUE_TYPE::ASYNC_COMPUTE))
 		{
-			vkCmdResetQueryPool(out_cmdBuffer, m_queryPool, m_queryFrameBaseIndex, 2);
-			vkCmdWriteTimestamp(out_cmdBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_queryPool, m_queryFrameBaseIndex);
+			vkCmdResetQueryPool(cmdBuffer, m_queryPool, m_queryFrameBaseIndex, 2);
+			vkCmdWriteTimestamp(cmdBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_queryPool, m_queryFrameBaseIndex);
 			m_beginTimestampWritten = true;
 		}
+	}
 
-		SubmissionBatch newBatch{};
-		newBatch.queueType = type;
-		newBatch.queueFamilyIndex = familyIndex;
-		newBatch.cmdBuffer = out_cmdBuffer;
-		m_submissionBatches.push_back(newBatch);
+	VkCommandPool DeviceContextVk::GetCommandPool(QUEUE_TYPE type) const
+	{
+		if (IsWorkerContext())
+		{
+			return m_pRenderDevice->GetWorkerCommandPool(type, m_assignedFrameIndex, m_workerIndex);
+		}
 
-		return STATUS_CODE::SUCCESS;
+		return m_pRenderDevice->GetCommandPool(type, m_assignedFrameIndex);
 	}
 
 	void DeviceContextVk::DeallocateCommandBuffers()
 	{
-		// Free all cached command buffers
+		// Free all cached command buffers, including the ones acquired this frame
 		VkDevice device = m_pRenderDevice->GetLogicalDevice();
 
+		for (const auto& acquired : m_acquiredCmdBuffers)
+		{
+			m_commandBufferCache[static_cast<u32>(acquired.first)].push_back(acquired.second);
+		}
+		m_acquiredCmdBuffers.clear();
+
 		for (u32 i = 0; i < static_cast<u32>(QUEUE_TYPE::COUNT); i++)
 		{
 			QUEUE_TYPE queueType = static_cast<QUEUE_TYPE>(i);
-			VkCommandPool pool = m_pRenderDevice->GetCommandPool(queueType, m_assignedFrameIndex);
+			VkCommandPool pool = GetCommandPool(queueType);
 			if (pool == VK_NULL_HANDLE)
 			{
 				continue;
@@ -1447,7 +2742,8 @@ namespace PHX
 			}
 		}
 
-		m_submissionBatches.clear();
+		RecycleSubmissionBatches();
+		m_lastUntrackedBatch = U32_MAX;
 	}
 
 	void DeviceContextVk::ResetCommandBuffers()
@@ -1460,26 +2756,82 @@ namespace PHX
 		for (u32 i = 0; i < static_cast<u32>(QUEUE_TYPE::COUNT); i++)
 		{
 			QUEUE_TYPE queueType = static_cast<QUEUE_TYPE>(i);
-			VkCommandPool pool = m_pRenderDevice->GetCommandPool(queueType, m_assignedFrameIndex);
+			VkCommandPool pool = GetCommandPool(queueType);
 			if (pool != VK_NULL_HANDLE)
 			{
 				vkResetCommandPool(device, pool, 0);
 			}
 		}
 
-		// Return all command buffers from this frame's batches back to the cache for reuse.
-		// BeginFrame's fence wait guarantees the GPU is done with all submissions.
-		for (const SubmissionBatch& batch : m_submissionBatches)
+		// Return all command buffers acquired this frame back to the cache for reuse. This includes the
+		// command buffers acquired on behalf of other device contexts' batches, which always come from
+		// this context's pools. BeginFrame's fence wait guarantees the GPU is done with all submissions.
+		for (const auto& acquired : m_acquiredCmdBuffers)
 		{
-			if (batch.cmdBuffer != VK_NULL_HANDLE)
-			{
-				m_commandBufferCache[static_cast<u32>(batch.queueType)].push_back(batch.cmdBuffer);
-			}
+			m_commandBufferCache[static_cast<u32>(acquired.first)].push_back(acquired.second);
 		}
+		m_acquiredCmdBuffers.clear();
+
+		RecycleSubmissionBatches();
+		m_lastUntrackedBatch = U32_MAX;
+	}
 
+	void DeviceContextVk::RecycleSubmissionBatches()
+	{
+		for (SubmissionBatch& batch : m_submissionBatches)
+		{
+			batch.cmdBuffers.clear();
+			batch.waitBatches.clear();
+			m_recycledBatches.push_back(std::move(batch));
+		}
 		m_submissionBatches.clear();
 	}
 
+	size_t DeviceContextVk::GetScratchStorageCapacity() const
+	{
+		size_t capacity = (m_submissionBatches.capacity() + m_recycledBatches.capacity()) * sizeof(SubmissionBatch);
+		for (const SubmissionBatch& batch : m_submissionBatches)
+		{
+			capacity += batch.cmdBuffers.capacity() * sizeof(VkCommandBuffer) + batch.waitBatches.capacity() * sizeof(u32);
+		}
+		for (const SubmissionBatch& batch : m_recycledBatches)
+		{
+			capacity += batch.cmdBuffers.capacity() * sizeof(VkCommandBuffer) + batch.waitBatches.capacity() * sizeof(u32);
+		}
+		for (const std::vector<VkCommandBuffer>& cache : m_commandBufferCache)
+		{
+			capacity += cache.capacity() * sizeof(VkCommandBuffer);
+		}
+		capacity += m_acquiredCmdBuffers.capacity() * sizeof(m_acquiredCmdBuffers[0]);
+		capacity += m_pendingImageBarriers.capacity() * sizeof(m_pendingImageBarriers[0]);
+		capacity += m_legacyImageBarriers.capacity() * sizeof(m_legacyImageBarriers[0]);
+		capacity += m_events.capacity() * sizeof(VkEvent);
+		capacity += m_startedQueues.capacity() * sizeof(VkQueue);
+		capacity += m_waitSemaphores.capacity() * sizeof(VkSemaphore);
+		capacity += m_waitStages.capacity() * sizeof(VkPipelineStageFlags);
+		capacity += m_waitValues.capacity() * sizeof(u64);
+		capacity += m_joinedQueues.capacity() * sizeof(VkQueue);
+		capacity += m_clearValues.capacity() * sizeof(VkClearValue);
+		capacity += m_bufferCopyRegions.capacity() * sizeof(VkBufferCopy);
+		capacity += m_imageCopyRegions.capacity() * sizeof(VkBufferImageCopy);
+		capacity += m_textureRegionLayouts.capacity() * sizeof(TextureRegionLayout);
+
+		return capacity;
+	}
+
+	bool DeviceContextVk::HasScratchStorageGrown()
+	{
+		// Containers never give back their memory, so their capacity only changes when they allocate
+		const size_t capacity = GetScratchStorageCapacity();
+		if (capacity > m_countedScratchCapacity)
+		{
+			m_countedScratchCapacity = capacity;
+			return true;
+		}
+
+		return false;
+	}
+
 	STATUS_CODE DeviceContextVk::EnsureChainSemaphores(u32 count)
 	{
 		VkSemaphoreCreateInfo semaphoreInfo{};
@@ -1500,6 +2852,31 @@ namespace PHX
 		return STATUS_CODE::SUCCESS;
 	}
 
+	void DeviceContextVk::ResetEvents()
+	{
+		// Only called after the frame fence wait, so the GPU is done with every event acquired last frame
+		for (u32 i = 0; i < m_usedEventCount; i++)
+		{
+			vkResetEvent(m_pRenderDevice->GetLogicalDevice(), m_events[i]);
+		}
+		m_usedEventCount = 0;
+	}
+
+	void DeviceContextVk::DestroyEvents()
+	{
+		if (m_pRenderDevice == nullptr)
+		{
+			return;
+		}
+
+		for (VkEvent event : m_events)
+		{
+			vkDestroyEvent(m_pRenderDevice->GetLogicalDevice(), event, nullptr);
+		}
+		m_events.clear();
+		m_usedEventCount = 0;
+	}
+
 	void DeviceContextVk::DestroyChainSemaphores()
 	{
 		if (m_pRenderDevice == nullptr)
@@ -1573,18 +2950,31 @@ namespace PHX
 			}
 		}
 
+		ASSERT_MSG(syncData.pWaitDstStageMasks != nullptr || syncData.waitSemaphoreCount <= 1, "Wait stages must be provided for multiple wait semaphores!");
 		VkPipelineStageFlags waitDstFlags = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
 
 		VkSubmitInfo vkSubmitInfo{};
 		vkSubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 		vkSubmitInfo.waitSemaphoreCount = syncData.waitSemaphoreCount;
 		vkSubmitInfo.pWaitSemaphores = syncData.pWaitSemaphores;
-		vkSubmitInfo.pWaitDstStageMask = &waitDstFlags;
+		vkSubmitInfo.pWaitDstStageMask = (syncData.pWaitDstStageMasks != nullptr) ? syncData.pWaitDstStageMasks : &waitDstFlags;
 		vkSubmitInfo.commandBufferCount = commandBufferCount;
 		vkSubmitInfo.pCommandBuffers = pCommandBuffers;
 		vkSubmitInfo.signalSemaphoreCount = syncData.signalSemaphoreCount;
 		vkSubmitInfo.pSignalSemaphores = syncData.pSignalSemaphores;
 
+		// Timeline semaphore values. Values of binary semaphores in the same submission are ignored
+		VkTimelineSemaphoreSubmitInfoKHR timelineSubmitInfo{};
+		if (syncData.pWaitValues != nullptr || syncData.pSignalValues != nullptr)
+		{
+			timelineSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+			timelineSubmitInfo.waitSemaphoreValueCount = (syncData.pWaitValues != nullptr) ? syncData.waitSemaphoreCount : 0;
+			timelineSubmitInfo.pWaitSemaphoreValues = syncData.pWaitValues;
+			timelineSubmitInfo.signalSemaphoreValueCount = (syncData.pSignalValues != nullptr) ? syncData.signalSemaphoreCount : 0;
+			timelineSubmitInfo.pSignalSemaphoreValues = syncData.pSignalValues;
+			vkSubmitInfo.pNext = &timelineSubmitInfo;
+		}
+
 		VkQueue queue = m_pRenderDevice->GetQueue(queueType);
 		VkResult res = vkQueueSubmit(queue, 1, &vkSubmitInfo, syncData.signalFence);
 		if (res != VK_SUCCESS)
@@ -1598,14 +2988,7 @@ namespace PHX
 
 	StagingAllocation DeviceContextVk::AllocateStaging(u64 sizeBytes, u64 alignment)
 	{
-		return m_stagingPool.Allocate(sizeBytes, alignment);
-	}
-
-	void DeviceContextVk::ResetStagingPool()
-	{
-		PROFILE_SCOPE("DeviceContextVk_ResetStagingPool");
-
-		m_stagingPool.Reset();
+		return m_pRenderDevice->GetStagingBufferPool()->Allocate(m_assignedFrameIndex, sizeBytes, alignment);
 	}
 
 	STATUS_CODE DeviceContextVk::SetContextualPipeline(PipelineVk* pPipeline)
@@ -1632,7 +3015,16 @@ namespace PHX
 			return STATUS_CODE::ERR_INTERNAL;
 		}
 
-		vkCmdBindPipeline(cmdBuffer, pPipeline->GetBindPoint(), pPipeline->GetPipeline());
+		BoundCommandState& boundState = GetBoundState(cmdBuffer);
+		if (boundState.pipeline == pPipeline->GetPipeline())
+		{
+			CountSkippedCommand();
+		}
+		else
+		{
+			vkCmdBindPipeline(cmdBuffer, pPipeline->GetBindPoint(), pPipeline->GetPipeline());
+			boundState.pipeline = pPipeline->GetPipeline();
+		}
 
 		// Cache the contextual pipeline so other calls can reference it. This should be cleared in ResetContextualPipeline
 		m_contextualPipeline = pPipeline;
@@ -1644,6 +3036,30 @@ namespace PHX
 		m_contextualPipeline = nullptr;
 	}
 
+	BoundCommandState& DeviceContextVk::GetBoundState(VkCommandBuffer cmdBuffer)
+	{
+		if (m_boundState.cmdBuffer != cmdBuffer)
+		{
+			m_boundState = BoundCommandState{};
+			m_boundState.cmdBuffer = cmdBuffer;
+		}
+
+		return m_boundState;
+	}
+
+	void DeviceContextVk::InvalidateBoundState()
+	{
+		m_boundState = BoundCommandState{};
+	}
+
+	void DeviceContextVk::CountSkippedCommand()
+	{
+		if (m_pMetrics)
+		{
+			m_pMetrics->skippedStateCommands++;
+		}
+	}
+
 	void DeviceContextVk::SetMetricsPointer(Metrics* pMetrics)
 	{
 		m_pMetrics = pMetrics;
@@ -1681,13 +3097,69 @@ namespace PHX
 			return STATUS_CODE::ERR_INTERNAL;
 		}
 
-		// Write the end timestamp into the last command buffer. Since batches are chained
-		// with semaphores, the last batch only starts after all previous ones complete.
+		// Write the end timestamp into the last command buffer. Since the last batch waits
+		// on every other queue, it only starts after all previous batches complete.
 		// BOTTOM_OF_PIPE fires after all work in that command buffer finishes, so the
 		// delta between begin (first cmd buffer, TOP_OF_PIPE) and end (last cmd buffer,
 		// BOTTOM_OF_PIPE) captures the entire frame's GPU execution time
-		VkCommandBuffer cmdBuffer = m_submissionBatches.back().cmdBuffer;
+		VkCommandBuffer cmdBuffer = m_submissionBatches.back().cmdBuffers.back();
 		vkCmdWriteTimestamp(cmdBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_queryPool, m_queryFrameBaseIndex + 1);
 		return STATUS_CODE::SUCCESS;
 	}
+
+	STATUS_CODE DeviceContextVk::ResetQueries(QUEUE_TYPE queueType, VkQueryPool queryPool, u32 firstQuery, u32 queryCount)
+	{
+		VkCommandBuffer cmdBuffer = VK_NULL_HANDLE;
+		STATUS_CODE res = GetOrCreateCommandBuffer(queueType, cmdBuffer);
+		if (res != STATUS_CODE::SUCCESS)
+		{
+			LogError("Failed to reset queries. Could not get or create command buffer!");
+			return res;
+		}
+
+		vkCmdResetQueryPool(cmdBuffer, queryPool, firstQuery, queryCount);
+		return STATUS_CODE::SUCCESS;
+	}
+
+	STATUS_CODE DeviceContextVk::WriteTimestamp(QUEUE_TYPE queueType, VkPipelineStageFlagBits stage, VkQueryPool queryPool, u32 query)
+	{
+		VkCommandBuffer cmdBuffer = VK_NULL_HANDLE;
+		STATUS_CODE res = GetOrCreateCommandBuffer(queueType, cmdBuffer);
+		if (res != STATUS_CODE::SUCCESS)
+		{
+			LogError("Failed to write timestamp. Could not get or create command buffer!");
+			return res;
+		}
+
+		vkCmdWriteTimestamp(cmdBuffer, stage, queryPool, query);
+		return STATUS_CODE::SUCCESS;
+	}
+
+	STATUS_CODE DeviceContextVk::BeginQuery(QUEUE_TYPE queueType, VkQueryPool queryPool, u32 query)
+	{
+		VkCommandBuffer cmdBuffer = VK_NULL_HANDLE;
+		STATUS_CODE res = GetOrCreateCommandBuffer(queueType, cmdBuffer);
+		if (res != STATUS_CODE::SUCCESS)
+		{
+			LogError("Failed to begin query. Could not get or create command buffer!");
+			return res;
+		}
+
+		vkCmdBeginQuery(cmdBuffer, queryPool, query, 0);
+		return STATUS_CODE::SUCCESS;
+	}
+
+	STATUS_CODE DeviceContextVk::EndQuery(QUEUE_TYPE queueType, VkQueryPool queryPool, u32 query)
+	{
+		VkCommandBuffer cmdBuffer = VK_NULL_HANDLE;
+		STATUS_CODE res = GetOrCreateCommandBuffer(queueType, cmdBuffer);
+		if (res != STATUS_CODE::SUCCESS)
+		{
+			LogError("Failed to end query. Could not get or create command buffer!");
+			return res;
+		}
+
+		vkCmdEndQuery(cmdBuffer, queryPool, query);
+		return STATUS_CODE::SUCCESS;
+	}
 }
\ No newline at end of file
@@ -24,42 +24,79 @@ namespace PHX
 
 	struct FlushSyncData
 	{
-		VkSemaphore* pWaitSemaphores   = nullptr;
-		u32 waitSemaphoreCount         = 0;
-		VkSemaphore* pSignalSemaphores = nullptr;
-		u32 signalSemaphoreCount       = 0;
-		VkFence signalFence            = VK_NULL_HANDLE;
+		VkSemaphore* pWaitSemaphores             = nullptr;
+		VkPipelineStageFlags* pWaitDstStageMasks = nullptr; // One per wait semaphore. Waits block TOP_OF_PIPE if null
+		u64* pWaitValues                         = nullptr; // One per wait semaphore, only read for timeline semaphores
+		u32 waitSemaphoreCount                   = 0;
+		VkSemaphore* pSignalSemaphores           = nullptr;
+		u64* pSignalValues                       = nullptr; // One per signal semaphore, only read for timeline semaphores
+		u32 signalSemaphoreCount                 = 0;
+		VkFence signalFence                      = VK_NULL_HANDLE;
+	};
+
+	// State last recorded into a command buffer. Binding the same state into the same command buffer again is skipped
+	struct BoundCommandState
+	{
+		static constexpr u32 MAX_DESCRIPTOR_SETS = 8;
+
+		VkCommandBuffer cmdBuffer                   = VK_NULL_HANDLE; // Command buffer the state was recorded into
+
+		VkPipeline pipeline                         = VK_NULL_HANDLE;
+
+		// Descriptor sets are only compared if they were bound through the same pipeline layout
+		VkPipelineBindPoint descriptorSetBindPoint  = VK_PIPELINE_BIND_POINT_MAX_ENUM;
+		VkPipelineLayout descriptorSetLayout        = VK_NULL_HANDLE;
+		u32 descriptorSetCount                      = 0;
+		std::array<VkDescriptorSet, MAX_DESCRIPTOR_SETS> descriptorSets = {};
+
+		VkBuffer vertexBuffer                       = VK_NULL_HANDLE;
+		VkDeviceSize vertexBufferOffset             = 0;
+		VkBuffer indexBuffer                        = VK_NULL_HANDLE;
+		VkIndexType indexType                       = VK_INDEX_TYPE_MAX_ENUM;
+
+		bool hasViewport                            = false;
+		VkViewport viewport                         = {};
+		bool hasScissor                             = false;
+		VkRect2D scissor                            = {};
 	};
 
 	// A single, contiguous run of commands recorded for one queue. Consecutive passes that
 	// use the same queue share a batch's command buffer; a queue switch (e.g. graphics -> compute)
-	// starts a new batch. Batches are submitted in recording (render-graph dependency) order and
-	// chained together with binary semaphores so that cross-queue producer/consumer dependencies
-	// are respected on the GPU.
+	// starts a new batch. Batches are submitted in recording (render-graph dependency) order. If
+	// timeline semaphores are supported, every batch only waits on the batches it depends on, so
+	// independent batches on different queues can overlap. Otherwise batches are chained together
+	// with binary semaphores and execute one after another.
 	struct SubmissionBatch
 	{
 		QUEUE_TYPE queueType       = QUEUE_TYPE::GRAPHICS;
-		u32 queueFamilyIndex       = QueueFamilyIndices::INVALID_INDEX;
-		VkCommandBuffer cmdBuffer  = VK_NULL_HANDLE;
+		VkQueue queue              = VK_NULL_HANDLE;
+		VkCommandBuffer cmdBuffer  = VK_NULL_HANDLE; // Command buffer the device context records into. Null once a worker's command buffer is appended, until more commands are recorded
+		std::vector<VkCommandBuffer> cmdBuffers;    // Every command buffer of the batch in submission order, including the ones recorded by worker device contexts
+		std::vector<u32> waitBatches;  // Batches on other queues which must complete before this batch starts
+		bool waitsOnSwapChain      = false; // Waits on the swap chain image being acquired
+		u64 signalValue            = 0;     // Value this batch signals on its queue type's timeline semaphore, set on submission
 	};
 
 	class DeviceContextVk : public IDeviceContext
 	{
 	public:
 
-		DeviceContextVk(RenderDeviceVk* pRenderDevice, const DeviceContextCreateInfo& createInfo);
+		// Worker device contexts are created with the index of the recording thread they're used on. See RenderDeviceVk::AllocateWorkerDeviceContext()
+		DeviceContextVk(RenderDeviceVk* pRenderDevice, const DeviceContextCreateInfo& createInfo, u32 workerIndex = U32_MAX);
 		~DeviceContextVk();
 
 		STATUS_CODE BindVertexBuffer(BufferHandle vertexBuffer) override;
 		STATUS_CODE BindMesh(BufferHandle vertexBuffer, BufferHandle indexBuffer, INDEX_TYPE indexType) override;
-		STATUS_CODE BindUniformCollection(UniformCollectionHandle uniformCollection) override;
+		STATUS_CODE BindUniformCollection(UniformCollectionHandle uniformCollection, const u32* pDynamicOffsets, u32 dynamicOffsetCount) override;
 		STATUS_CODE FlushUniformUpdates(UniformCollectionHandle uniformCollection) override;
 		STATUS_CODE SetViewport(BSL::Vec2u size, BSL::Vec2u offset) override;
 		STATUS_CODE SetScissor(BSL::Vec2u size, BSL::Vec2u offset) override;
+		STATUS_CODE SetPushConstants(ShaderStageFlags stages, u32 offsetBytes, u32 sizeBytes, const void* data) override;
 
 		STATUS_CODE Draw(u32 vertexCount) override;
 		STATUS_CODE DrawIndexed(u32 indexCount, u32 firstIndex, u32 vertexOffset) override;
 		STATUS_CODE DrawIndexedInstanced(u32 indexCount, u32 instanceCount, u32 firstIndex, u32 vertexOffset, u32 instanceOffset) override;
+		STATUS_CODE DrawIndexedBatch(const DrawIndexedArgs* pDraws, u32 drawCount) override;
 		STATUS_CODE DrawIndexedIndirect(BufferHandle argsBuffer, u32 drawCount, u32 stride, u64 argsOffset) override;
 		STATUS_CODE DrawIndexedIndirectCount(BufferHandle argsBuffer, u64 argsOffset, BufferHandle countBuffer, u64 countOffset, u32 maxDrawCount, u32 stride) override;
 
@@ -69,8 +106,15 @@ namespace PHX
 		STATUS_CODE BuildBottomLevelAccelerationStructure(AccelerationStructureHandle handle) override;
 		STATUS_CODE BuildTopLevelAccelerationStructure(AccelerationStructureHandle handle, BufferHandle instanceBuffer, u32 instanceCount) override;
 
-		STATUS_CODE CopyDataToBuffer(BufferHandle buffer, const void* data, u64 sizeBytes) override;
-		STATUS_CODE CopyDataToTexture(TextureHandle texture, const void* data, u64 sizeBytes, u32 mipLevel) override;
+		STATUS_CODE AllocateTransientUniform(u64 sizeBytes, TransientUniformAllocation& out_allocation) override;
+		STATUS_CODE CopyDataToBuffer(BufferHandle buffer, const BufferCopyRegion* pRegions, u32 regionCount) override;
+		STATUS_CODE CopyDataToTexture(TextureHandle texture, const TextureUploadRegion* pRegions, u32 regionCount) override;
+
+		STATUS_CODE ReadbackBuffer(BufferHandle buffer, u64 srcOffset, u64 sizeBytes, ReadbackTicket& out_ticket, ReadbackCallbackFn callback) override;
+		STATUS_CODE ReadbackTexture(TextureHandle texture, u32 mipLevel, u32 arrayLayer, ReadbackTicket& out_ticket, ReadbackCallbackFn callback) override;
+		READBACK_STATUS GetReadbackStatus(ReadbackTicket ticket) override;
+		STATUS_CODE GetReadbackData(ReadbackTicket ticket, const void*& out_pData, u64& out_sizeBytes) override;
+		void ReleaseReadback(ReadbackTicket ticket) override;
 
 		void SetMetricsPointer(Metrics* pMetrics) override;
 		void ResetMetricsPointer() override;
@@ -89,6 +133,7 @@ namespace PHX
 		STATUS_CODE SetContextualPipeline(PipelineVk* pPipeline);
 		void ResetContextualPipeline();
 
+		// The swap chain is null for headless frames, which don't acquire an image or signal presentation
 		STATUS_CODE BeginFrame(SwapChainVk* pSwapChain);
 		STATUS_CODE EndFrame(SwapChainVk* pSwapChain);
 
@@ -96,7 +141,35 @@ namespace PHX
 		// whether presenting is valid, and used to prevent softlocks if no work was submitted
 		bool WasWorkFlushed() const;
 
+		// Routes compute commands to the async compute queue while enabled, if the device supports it
+		void SetAsyncCompute(bool enabled);
+
+		// Routes transfer commands to the graphics queue while enabled. Set while recording transfer passes which can't run
+		// on the transfer queue, see RenderGraphVk::GetPassQueueType()
+		void SetTransferOnGraphicsQueue(bool enabled);
+
+		// Makes sure commands recorded for the given queue type from now on go into a batch which waits on the given
+		// producer batches, and on the swap chain image if requested. Called by the render graph before recording a pass,
+		// with the batches its dependencies were recorded into. Returns the index of the batch
+		STATUS_CODE PrepareBatch(QUEUE_TYPE type, const u32* pProducerBatchIndices, u32 producerCount, bool waitsOnSwapChain, u32& out_batchIndex);
+
+		// Parallel recording. The render graph appends a command buffer from the worker device context to the current
+		// batch, in graph order. It's made the recording target of this device context, so barriers are recorded into it,
+		// and the worker device context records the rest of the pass into it later on its own thread
+		STATUS_CODE AppendWorkerCommandBuffer(DeviceContextVk* pWorkerContext, VkCommandBuffer& out_cmdBuffer);
+
+		// While set, every command is recorded into the given command buffer regardless of its queue type. Worker
+		// device contexts can only record while a recording target is set
+		void SetRecordingTarget(VkCommandBuffer cmdBuffer);
+		void ResetRecordingTarget();
+
+		// Recycles the command buffers of a worker device context. Must be called after the
+		// device context of the same frame index began its frame
+		STATUS_CODE BeginWorkerFrame();
+		bool IsWorkerContext() const;
+
 		STATUS_CODE BeginRenderPass(VkRenderPass renderPass, FramebufferVk* pFramebuffer, ClearValues* pClearColors, u32 clearColorCount);
+		STATUS_CODE NextSubpass();
 		STATUS_CODE EndRenderPass();
 
 		// Inserts a debug label (marker region) into the command buffer for the given queue type
@@ -135,21 +208,107 @@ namespace PHX
 			VkAccessFlags dstAccessMask
 		);
 
+		// Global memory barrier, not tied to any resource. Used to guard memory which is shared between resources
+		STATUS_CODE InsertMemoryBarrier(
+			QUEUE_TYPE queueType,
+			VkPipelineStageFlags srcStageMask,
+			VkPipelineStageFlags dstStageMask,
+			VkAccessFlags srcAccessMask,
+			VkAccessFlags dstAccessMask
+		);
+
+		// Batched barriers. Queued barriers are recorded by FlushBarriers() in a single barrier command, which uses
+		// synchronization2 if the device supports it. Masks are synchronization2 flags, which are a superset of the legacy
+		// flags. Without synchronization2 the barriers share the union of their stage masks. Buffer barriers never transfer
+		// queue family ownership, so they're all folded into a single global memory barrier. Image barriers only cover
+		// the given subresource range
+		void QueueImageMemoryBarrier(
+			TextureVk* pTexture,
+			VkPipelineStageFlags2KHR srcStageMask,
+			VkPipelineStageFlags2KHR dstStageMask,
+			VkAccessFlags2KHR srcAccessMask,
+			VkAccessFlags2KHR dstAccessMask,
+			VkImageLayout oldLayout,
+			VkImageLayout newLayout,
+			const VkImageSubresourceRange& subresourceRange
+		);
+
+		void QueueMemoryBarrier(
+			VkPipelineStageFlags2KHR srcStageMask,
+			VkPipelineStageFlags2KHR dstStageMask,
+			VkAccessFlags2KHR srcAccessMask,
+			VkAccessFlags2KHR dstAccessMask
+		);
+
+		STATUS_CODE FlushBarriers(QUEUE_TYPE queueType);
+
+		// Split barriers. Events are pooled per device context, and are reset at the start of the next frame with the
+		// same index. SignalEvent() and WaitEvent() consume the queued barriers as the event's dependency, and the
+		// same barriers must be queued for both sides. Requires synchronization2
+		STATUS_CODE AcquireEvent(VkEvent& out_event);
+		STATUS_CODE SignalEvent(QUEUE_TYPE queueType, VkEvent event);
+		STATUS_CODE WaitEvent(QUEUE_TYPE queueType, VkEvent event);
+
+		// Query commands, recorded into the current command buffer of the given queue. Queries must be reset outside of
+		// a render pass before they're written, and a pipeline statistics query must begin and end in the same subpass
+		STATUS_CODE ResetQueries(QUEUE_TYPE queueType, VkQueryPool queryPool, u32 firstQuery, u32 queryCount);
+		STATUS_CODE WriteTimestamp(QUEUE_TYPE queueType, VkPipelineStageFlagBits stage, VkQueryPool queryPool, u32 query);
+		STATUS_CODE BeginQuery(QUEUE_TYPE queueType, VkQueryPool queryPool, u32 query);
+		STATUS_CODE EndQuery(QUEUE_TYPE queueType, VkQueryPool queryPool, u32 query);
+
+		// Returns true if any of the containers the device context reuses every frame had to grow since the last call
+		bool HasScratchStorageGrown();
+
 	private:
 
 		// Returns the command buffer from the current (most recent) batch if it targets
-		// the same queue family. Command buffers returned by this function are reused
+		// the same queue. Command buffers returned by this function are reused
 		// per-frame only
 		bool TryReuseActiveCommandBuffer(QUEUE_TYPE type, VkCommandBuffer& out_cmdBuffer);
 
+		// Returns the queue type commands of the given type are recorded for. Compute commands go to the
+		// async compute queue while async compute is enabled
+		QUEUE_TYPE ResolveQueueType(QUEUE_TYPE type) const;
+
+		// Makes the batch wait on the producer batch, unless they're submitted to the same queue
+		void AddBatchWait(u32 batchIndex, u32 producerBatchIndex);
+
+		// Makes the batch wait on the last earlier batch of every other queue
+		void AddJoinWaits(u32 batchIndex);
+
 		// Acquires a command buffer for a new batch
 		STATUS_CODE AllocateCommandBuffer(QUEUE_TYPE type, VkCommandBuffer& out_cmdBuffer);
 
+		// Takes a command buffer from the cache, or allocates a new one, and begins it. Command buffers are
+		// returned to the cache at the start of the next frame with the same index
+		STATUS_CODE AcquireCommandBuffer(QUEUE_TYPE type, VkCommandBuffer& out_cmdBuffer);
+
+		// Resets the query slots and writes the begin timestamp, if this is the first command buffer of the frame that supports it
+		void TryWriteBeginTimestamp(QUEUE_TYPE type, VkCommandBuffer cmdBuffer);
+
+		// Command pool this device context allocates from, which is the recording thread's pool for worker device contexts
+		VkCommandPool GetCommandPool(QUEUE_TYPE type) const;
+
 		STATUS_CODE GetOrCreateCommandBuffer(QUEUE_TYPE type, VkCommandBuffer& out_cmdBuffer);
 
 		void DeallocateCommandBuffers();
 		void ResetCommandBuffers();
 
+		// Returns the state bound in the given command buffer. The state is forgotten whenever commands are recorded into a
+		// different command buffer, or the command buffer is begun again
+		BoundCommandState& GetBoundState(VkCommandBuffer cmdBuffer);
+		void InvalidateBoundState();
+
+		// Counts a bind or dynamic state command that was skipped because its state was already bound
+		void CountSkippedCommand();
+
+		// Builds the dependency info of the queued barriers. Returns false if there are no queued barriers
+		bool BuildPendingDependencyInfo(VkDependencyInfoKHR& out_dependencyInfo);
+		void ClearPendingBarriers();
+
+		void ResetEvents();
+		void DestroyEvents();
+
 		// Manages the tracy VkCtx instances
 		void InitTracyContexts();
 		void DestroyTracyContexts();
@@ -159,6 +318,10 @@ namespace PHX
 		STATUS_CODE EnsureChainSemaphores(u32 count);
 		void DestroyChainSemaphores();
 
+		// Submits this frame's batches. The last batch signals the render finished semaphore and the frame fence
+		STATUS_CODE SubmitChainedBatches(VkSemaphore imageAvailableSemaphore, VkSemaphore renderFinishedSemaphore, VkFence frameFence);
+		STATUS_CODE SubmitTimelineBatches(VkSemaphore imageAvailableSemaphore, VkSemaphore renderFinishedSemaphore, VkFence frameFence);
+
 		// TODO - MOVE TO UTILS!
 		// Returns the queue type from the bind point. May return invalid result in the form of QUEUE_TYPE::COUNT!
 		QUEUE_TYPE GetQueueTypeFromBindPoint(VkPipelineBindPoint bindPoint);
@@ -166,10 +329,25 @@ namespace PHX
 		STATUS_CODE FlushInternal(QUEUE_TYPE queueType, const VkCommandBuffer* pCommandBuffers, u32 commandBufferCount, const FlushSyncData& syncData);
 
 		StagingAllocation AllocateStaging(u64 sizeBytes, u64 alignment = 16);
-		void ResetStagingPool();
 
 	private:
 
+		// Size of the memory held by the containers the device context reuses every frame, in bytes
+		size_t GetScratchStorageCapacity() const;
+
+		// Layout of a texture upload region in the staging memory
+		struct TextureRegionLayout
+		{
+			u64 stagingOffset;
+			u64 rowBytes;
+			u64 paddedRowBytes;
+			u32 rowCount;
+			u32 layerCount;
+		};
+
+		// Moves the batches of the frame to m_recycledBatches, so their command buffer and wait lists are reused
+		void RecycleSubmissionBatches();
+
 		RenderDeviceVk* m_pRenderDevice;
 
 		// Ordered list of submission batches recorded this frame, in render-graph dependency order.
@@ -179,13 +357,26 @@ namespace PHX
 		// Per-queue-type cache of command buffers that are reused across frames
 		std::array<std::vector<VkCommandBuffer>, static_cast<u32>(QUEUE_TYPE::COUNT)> m_commandBufferCache;
 
+		// Command buffers acquired this frame, which go back into the cache once the frame is done
+		std::vector<std::pair<QUEUE_TYPE, VkCommandBuffer>> m_acquiredCmdBuffers;
+
+		// Non-owning. Command buffer every command is recorded into while set
+		VkCommandBuffer m_recordingTarget;
+
+		// Index of the recording thread for worker device contexts, U32_MAX otherwise
+		u32 m_workerIndex;
+
 		// Binary semaphores used to chain consecutive submission batches together (batch i signals
 		// m_chainSemaphores[i], batch i+1 waits on it). Grown on demand and reused across frames.
+		// Only used if timeline semaphores are not supported
 		std::vector<VkSemaphore> m_chainSemaphores;
 
-		// Staging buffer pool for efficient sub-allocation. Avoids creating thousands
-		// of individual VMA allocations when uploading many textures/mip levels
-		StagingBufferPool m_stagingPool;
+		// Last batch created outside of PrepareBatch() this frame, or U32_MAX. Its dependencies are unknown, so
+		// it waits on every earlier batch, and every later batch created through PrepareBatch() waits on it
+		u32 m_lastUntrackedBatch;
+		bool m_isPreparingBatch;
+		bool m_useAsyncCompute;
+		bool m_transferOnGraphicsQueue;
 
 		// True if any command buffers were submitted last frame (tells BeginFrame whether the
 		// frame fence will actually be signaled, so it knows whether to wait on it).
@@ -197,6 +388,34 @@ namespace PHX
 		// Non-owning
 		PipelineVk* m_contextualPipeline;
 
+		// Shadow of the state bound in the command buffer commands were last recorded into
+		BoundCommandState m_boundState;
+
+		// Barriers queued since the last FlushBarriers() call. The legacy image barriers are only scratch memory for
+		// devices without synchronization2, and are kept around to avoid re-allocating them every flush
+		std::vector<VkImageMemoryBarrier2KHR> m_pendingImageBarriers;
+		VkMemoryBarrier2KHR m_pendingMemoryBarrier;
+		bool m_hasPendingMemoryBarrier;
+		std::vector<VkImageMemoryBarrier> m_legacyImageBarriers;
+
+		// Events used by split barriers. The first m_usedEventCount events were acquired this frame
+		std::vector<VkEvent> m_events;
+		u32 m_usedEventCount;
+
+		// Scratch memory of per-frame work, kept around so it isn't re-allocated every frame. Recycled batches are
+		// empty, but keep the capacity of their containers
+		std::vector<SubmissionBatch> m_recycledBatches;
+		std::vector<VkQueue> m_startedQueues;
+		std::vector<VkSemaphore> m_waitSemaphores;
+		std::vector<VkPipelineStageFlags> m_waitStages;
+		std::vector<u64> m_waitValues;
+		std::vector<VkQueue> m_joinedQueues;
+		std::vector<VkClearValue> m_clearValues;
+		std::vector<VkBufferCopy> m_bufferCopyRegions;
+		std::vector<VkBufferImageCopy> m_imageCopyRegions;
+		std::vector<TextureRegionLayout> m_textureRegionLayouts;
+		size_t m_countedScratchCapacity; // GetScratchStorageCapacity() on the last call to HasScratchStorageGrown()
+
 		// Non-owning, nullable
 		Metrics* m_pMetrics;
 
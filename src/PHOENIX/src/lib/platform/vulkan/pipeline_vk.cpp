@@ -1,6 +1,7 @@
 
 #include "pipeline_vk.h"
 
+#include <algorithm>
 #include <vector>
 #include <vulkan/vk_enum_string_helper.h>
 
@@ -15,6 +16,7 @@
 #include "utils/pipeline_type_converter.h"
 #include "utils/pipeline_utils.h"
 #include "utils/render_pass_cache.h"
+#include "utils/shader_type_converter.h"
 #include "utils/texture_type_converter.h"
 #include "utils/debug_utils.h"
 
@@ -24,7 +26,7 @@ namespace PHX
 {
 	static constexpr u32 SBT_REGION_COUNT = 4; // raygen, miss, hit, callable
 
-	PipelineVk::PipelineVk(RenderDeviceVk* pRenderDevice, VkPipelineCache cache, VkRenderPass renderPass, const GraphicsPipelineDesc& createInfo) : 
+	PipelineVk::PipelineVk(RenderDeviceVk* pRenderDevice, VkPipelineCache cache, VkRenderPass renderPass, u32 subpassIndex, const GraphicsPipelineDesc& createInfo) : 
 		m_pRenderDevice(nullptr), m_pipeline(), m_layout(), m_bindPoint(VK_PIPELINE_BIND_POINT_MAX_ENUM), m_sbt(nullptr), 
 		m_rayGenSBTRegion(), m_missSBTRegion(), m_hitSBTRegion(), m_callableSBTRegion()
 	{
@@ -34,7 +36,7 @@ namespace PHX
 		}
 		m_pRenderDevice = pRenderDevice;
 
-		CreateGraphicsPipeline(pRenderDevice, cache, renderPass, createInfo);
+		CreateGraphicsPipeline(pRenderDevice, cache, renderPass, subpassIndex, createInfo);
 	}
 
 	PipelineVk::PipelineVk(RenderDeviceVk* pRenderDevice, VkPipelineCache cache, const ComputePipelineDesc& createInfo) : 
@@ -115,7 +117,12 @@ namespace PHX
 		return m_bindPoint;
 	}
 
-	STATUS_CODE PipelineVk::CreateGraphicsPipeline(RenderDeviceVk* pRenderDevice, VkPipelineCache cache, VkRenderPass renderPass, const GraphicsPipelineDesc& createInfo)
+	const std::vector<VkPushConstantRange>& PipelineVk::GetPushConstantRanges() const
+	{
+		return m_pushConstantRanges;
+	}
+
+	STATUS_CODE PipelineVk::CreateGraphicsPipeline(RenderDeviceVk* pRenderDevice, VkPipelineCache cache, VkRenderPass renderPass, u32 subpassIndex, const GraphicsPipelineDesc& createInfo)
 	{
 		PROFILE_SCOPE("PipelineVk_CreateGraphicsPipeline");
 
@@ -127,7 +134,7 @@ namespace PHX
 
 		VkDevice logicalDevice = pRenderDevice->GetLogicalDevice();
 
-		m_layout = CreatePipelineLayout(logicalDevice, createInfo.uniformCollection);
+		m_layout = CreatePipelineLayout(logicalDevice, createInfo.uniformCollection, createInfo.pPushConstantRanges, createInfo.pushConstantRangeCount, createInfo.pShaders, createInfo.shaderCount);
 		if (m_layout == VK_NULL_HANDLE)
 		{
 			return STATUS_CODE::ERR_INTERNAL;
@@ -219,7 +226,7 @@ namespace PHX
 		pipelineInfo.pDynamicState = &dynamicState;
 		pipelineInfo.layout = m_layout;
 		pipelineInfo.renderPass = renderPass;
-		pipelineInfo.subpass = 0;
+		pipelineInfo.subpass = subpassIndex;
 		pipelineInfo.basePipelineHandle = VK_NULL_HANDLE; // Optional
 		pipelineInfo.basePipelineIndex = -1; // Optional
 
@@ -270,7 +277,7 @@ namespace PHX
 
 		VkDevice logicalDevice = pRenderDevice->GetLogicalDevice();
 
-		m_layout = CreatePipelineLayout(logicalDevice, createInfo.uniformCollection);
+		m_layout = CreatePipelineLayout(logicalDevice, createInfo.uniformCollection, createInfo.pPushConstantRanges, createInfo.pushConstantRangeCount, &createInfo.shader, 1);
 		if (m_layout == VK_NULL_HANDLE)
 		{
 			return STATUS_CODE::ERR_INTERNAL;
@@ -407,7 +414,7 @@ namespace PHX
 
 		VkDevice logicalDevice = pRenderDevice->GetLogicalDevice();
 
-		m_layout = CreatePipelineLayout(logicalDevice, createInfo.uniformCollection);
+		m_layout = CreatePipelineLayout(logicalDevice, createInfo.uniformCollection, createInfo.pPushConstantRanges, createInfo.pushConstantRangeCount, createInfo.pShaders, createInfo.shaderCount);
 		if (m_layout == VK_NULL_HANDLE)
 		{
 			return STATUS_CODE::ERR_INTERNAL;
@@ -791,20 +798,83 @@ namespace PHX
 		return STATUS_CODE::SUCCESS;
 	}
 
-	VkPipelineLayout PipelineVk::CreatePipelineLayout(VkDevice logicalDevice, UniformCollectionHandle uniformCollection)
+	VkPipelineLayout PipelineVk::CreatePipelineLayout(VkDevice logicalDevice, UniformCollectionHandle uniformCollection, const PushConstantRange* pPushConstantRanges,
+		u32 pushConstantRangeCount, const ShaderHandle* pShaders, u32 shaderCount)
 	{
 		PROFILE_SCOPE("PipelineVk_CreatePipelineLayout");
 
+		// Push constants
+		m_pushConstantRanges.clear();
+		if (pPushConstantRanges != nullptr)
+		{
+			m_pushConstantRanges.reserve(pushConstantRangeCount);
+			for (u32 i = 0; i < pushConstantRangeCount; i++)
+			{
+				const PushConstantRange& range = pPushConstantRanges[i];
+
+				VkPushConstantRange rangeVk{};
+				rangeVk.stageFlags = SHADER_UTILS::ConvertShaderStageFlags(range.stages);
+				rangeVk.offset = range.offset;
+				rangeVk.size = range.size;
+				m_pushConstantRanges.push_back(rangeVk);
+			}
+		}
+		else if (pShaders != nullptr)
+		{
+			// Shaders sharing a push constant block declare the same struct, so a single range visible to every stage
+			// with a push constant block is enough
+			ShaderStageFlags stages = 0;
+			u32 size = 0;
+			for (u32 i = 0; i < shaderCount; i++)
+			{
+				const ShaderVk* pShader = static_cast<const ShaderVk*>(m_pRenderDevice->ResolveHandle(pShaders[i]));
+				if (pShader == nullptr || pShader->GetReflectionData().pushConstantSize == 0)
+				{
+					continue;
+				}
+
+				stages |= (1u << static_cast<u32>(pShader->GetStage()));
+				size = std::max(size, pShader->GetReflectionData().pushConstantSize);
+			}
+
+			if (size > 0)
+			{
+				VkPushConstantRange rangeVk{};
+				rangeVk.stageFlags = SHADER_UTILS::ConvertShaderStageFlags(stages);
+				rangeVk.offset = 0;
+				rangeVk.size = size;
+				m_pushConstantRanges.push_back(rangeVk);
+			}
+		}
+
+		const u32 maxPushConstantsSize = m_pRenderDevice->GetDeviceProperties().limits.maxPushConstantsSize;
+		for (const VkPushConstantRange& range : m_pushConstantRanges)
+		{
+			if (range.size == 0 || (range.offset % 4) != 0 || (range.size % 4) != 0)
+			{
+				LogError("Failed to create pipeline layout! Push constant range (offset %u, size %u) must have a non-zero size, and both must be multiples of 4", range.offset, range.size);
+				return VK_NULL_HANDLE;
+			}
+
+			if (range.offset + range.size > maxPushConstantsSize)
+			{
+				LogError("Failed to create pipeline layout! Push constant range (offset %u, size %u) exceeds the device limit of %u bytes", range.offset, range.size, maxPushConstantsSize);
+				return VK_NULL_HANDLE;
+			}
+		}
+
+		const VkPushConstantRange* pushConstantRanges = m_pushConstantRanges.empty() ? nullptr : m_pushConstantRanges.data();
+		const u32 pushConstantCount = static_cast<u32>(m_pushConstantRanges.size());
+
 		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
 		if (uniformCollection.IsValid())
 		{
-			// TODO - Add support for push constants
 			UniformCollectionVk* pUniformCollectionVk = static_cast<UniformCollectionVk*>(m_pRenderDevice->ResolveHandle(uniformCollection));
-			pipelineLayoutInfo = PopulatePipelineLayoutCreateInfo(pUniformCollectionVk->GetDescriptorSetLayouts(), pUniformCollectionVk->GetDescriptorSetLayoutCount(), nullptr, 0);
+			pipelineLayoutInfo = PopulatePipelineLayoutCreateInfo(pUniformCollectionVk->GetDescriptorSetLayouts(), pUniformCollectionVk->GetDescriptorSetLayoutCount(), pushConstantRanges, pushConstantCount);
 		}
 		else
 		{
-			pipelineLayoutInfo = PopulatePipelineLayoutCreateInfo(nullptr, 0, nullptr, 0);
+			pipelineLayoutInfo = PopulatePipelineLayoutCreateInfo(nullptr, 0, pushConstantRanges, pushConstantCount);
 		}
 
 		VkPipelineLayout layout;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <vector>
 #include <vulkan/vulkan.h>
 
 #include "PHX/types/pipeline_desc.h"
@@ -16,7 +17,7 @@ namespace PHX
 	{
 	public:
 
-		PipelineVk(RenderDeviceVk* pRenderDevice, VkPipelineCache cache, VkRenderPass renderPass, const GraphicsPipelineDesc& createInfo);
+		PipelineVk(RenderDeviceVk* pRenderDevice, VkPipelineCache cache, VkRenderPass renderPass, u32 subpassIndex, const GraphicsPipelineDesc& createInfo);
 		PipelineVk(RenderDeviceVk* pRenderDevice, VkPipelineCache cache, const ComputePipelineDesc& createInfo);
 		PipelineVk(RenderDeviceVk* pRenderDevice, VkPipelineCache cache, const RayTracingPipelineDesc& createInfo);
 		~PipelineVk();
@@ -24,6 +25,7 @@ namespace PHX
 		VkPipeline GetPipeline() const;
 		VkPipelineLayout GetLayout() const;
 		VkPipelineBindPoint GetBindPoint() const;
+		const std::vector<VkPushConstantRange>& GetPushConstantRanges() const;
 
 		const VkStridedDeviceAddressRegionKHR* GetRayGenSBTRegion() const;
 		const VkStridedDeviceAddressRegionKHR* GetMissSBTRegion() const;
@@ -32,7 +34,7 @@ namespace PHX
 
 	private:
 
-		STATUS_CODE CreateGraphicsPipeline(RenderDeviceVk* pRenderDevice, VkPipelineCache cache, VkRenderPass renderPass, const GraphicsPipelineDesc& createInfo);
+		STATUS_CODE CreateGraphicsPipeline(RenderDeviceVk* pRenderDevice, VkPipelineCache cache, VkRenderPass renderPass, u32 subpassIndex, const GraphicsPipelineDesc& createInfo);
 		STATUS_CODE CreateComputePipeline(RenderDeviceVk* pRenderDevice, VkPipelineCache cache, const ComputePipelineDesc& createInfo);
 		STATUS_CODE CreateRayTracingPipeline(RenderDeviceVk* pRenderDevice, VkPipelineCache cache, const RayTracingPipelineDesc& createInfo);
 
@@ -40,7 +42,9 @@ namespace PHX
 		STATUS_CODE VerifyCreateInfo(const ComputePipelineDesc& createInfo);
 		STATUS_CODE VerifyCreateInfo(const RayTracingPipelineDesc& createInfo);
 
-		VkPipelineLayout CreatePipelineLayout(VkDevice logicalDevice, UniformCollectionHandle uniformCollection);
+		// If no push constant ranges are given, a single range covering the largest push constant block in the shaders is used
+		VkPipelineLayout CreatePipelineLayout(VkDevice logicalDevice, UniformCollectionHandle uniformCollection, const PushConstantRange* pPushConstantRanges,
+			u32 pushConstantRangeCount, const ShaderHandle* pShaders, u32 shaderCount);
 
 		bool IsRayTracingShaderStage(SHADER_STAGE stage) const;
 
@@ -51,6 +55,7 @@ namespace PHX
 		VkPipeline m_pipeline;
 		VkPipelineLayout m_layout;
 		VkPipelineBindPoint m_bindPoint;
+		std::vector<VkPushConstantRange> m_pushConstantRanges;
 
 		BufferData* m_sbt;
 		VkStridedDeviceAddressRegionKHR m_rayGenSBTRegion;
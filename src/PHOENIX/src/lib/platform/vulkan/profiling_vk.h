@@ -9,7 +9,8 @@
 #define PROFILE_VKCONTEXT_CREATE(physDevice, logDevice, queue, cmdBuffer) TracyVkContext(physDevice, logDevice, queue, cmdBuffer)
 #define PROFILE_VKCONTEXT_DESTROY(context) TracyVkDestroy(context)
 #define PROFILE_VKCONTEXT_NAME(context, name, size) TracyVkContextName(context, name, size)
-#define PROFILE_VK_ZONE(context, cmdBuffer, name) TracyVkZone(context, cmdBuffer, name)
+// Zones are skipped for null contexts (e.g. commands recorded by worker device contexts)
+#define PROFILE_VK_ZONE(context, cmdBuffer, name) TracyVkNamedZone(context, ___tracy_gpu_zone, cmdBuffer, name, context != nullptr)
 #define PROFILE_VK_COLLECT(context, cmdBuffer) TracyVkCollect(context, cmdBuffer)
 
 #else
@@ -1,5 +1,6 @@
 ﻿
-#include <set>
+#include <algorithm>
+#include <map>
 #include <string>
 #include <vector>
 #include <vulkan/vk_enum_string_helper.h>
@@ -21,7 +22,9 @@
 
 #include "acceleration_structure_vk.h"
 #include "BSL/logger.h"
+#include "BSL/math.h"
 #include "buffer_vk.h"
+#include "core/global_settings.h"
 #include "core/handle/handle_utils.h"
 #include "core/profiling.h"
 #include "core_vk.h"
@@ -33,6 +36,9 @@
 #include "texture_vk.h"
 #include "uniform_vk.h"
 #include "utils/swap_chain_helpers.h"
+#include "utils/readback_pool.h"
+#include "utils/staging_buffer_pool.h"
+#include "utils/transient_uniform_ring.h"
 
 using namespace BSL;
 
@@ -40,10 +46,15 @@ namespace PHX
 {
 	static const std::vector<const char*> deviceExtensions =
 	{
-		VK_KHR_SWAPCHAIN_EXTENSION_NAME,
 		VK_KHR_SHADER_DRAW_PARAMETERS_EXTENSION_NAME
 	};
 
+	// Only required when presenting to a window, so headless devices don't need to support them
+	static const std::vector<const char*> presentExtensions =
+	{
+		VK_KHR_SWAPCHAIN_EXTENSION_NAME
+	};
+
 	static const std::vector<const char*> rayTracingExtensions =
 	{
 		VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME, // Needed to query extensions below
@@ -119,11 +130,17 @@ namespace PHX
 	{
 		QueueFamilyIndices indices = FindQueueFamilies(device, surface);
 		bool allExtensionsSupported = SupportsAllExtensions(device, deviceExtensions);
-		bool swapChainAdequate = false;
-		if (allExtensionsSupported)
+
+		// Headless devices have no surface to present to
+		bool swapChainAdequate = (surface == VK_NULL_HANDLE);
+		if (allExtensionsSupported && surface != VK_NULL_HANDLE)
 		{
-			SwapChainSupportDetails details = QuerySwapChainSupport(device, surface);
-			swapChainAdequate = !details.formats.empty() && !details.presentModes.empty();
+			allExtensionsSupported = SupportsAllExtensions(device, presentExtensions);
+			if (allExtensionsSupported)
+			{
+				SwapChainSupportDetails details = QuerySwapChainSupport(device, surface);
+				swapChainAdequate = !details.formats.empty() && !details.presentModes.empty();
+			}
 		}
 
 		VkPhysicalDeviceFeatures supportedFeatures;
@@ -142,9 +159,11 @@ namespace PHX
 
 	RenderDeviceVk::RenderDeviceVk(const RenderDeviceCreateInfo& ci) : m_logicalDevice(VK_NULL_HANDLE), m_physicalDevice(VK_NULL_HANDLE),
 		m_physicalDeviceProperties(), m_physicalDeviceFeatures(), m_physicalDeviceMemoryProperties(), m_rayTracingPipelineProperties(), m_descriptorPool(VK_NULL_HANDLE),
-		m_rayTracingSupported(false), m_drawIndirectCountSupported(false), m_pfnCreateRayTracingPipelines(nullptr), m_pfnGetRayTracingShaderGroupHandles(nullptr), m_pfnGetBufferDeviceAddress(nullptr), m_pfnCmdTraceRays(nullptr),
+		m_rayTracingSupported(false), m_drawIndirectCountSupported(false), m_timelineSemaphoreSupported(false), m_asyncComputeSupported(false), m_synchronization2Supported(false), m_dedicatedTransferSupported(false), m_multiDrawIndirectSupported(false), m_transferImageGranularity{ 1, 1, 1 }, m_pfnCreateRayTracingPipelines(nullptr), m_pfnGetRayTracingShaderGroupHandles(nullptr), m_pfnGetBufferDeviceAddress(nullptr), m_pfnCmdTraceRays(nullptr),
 		m_pfnCreateAccelerationStructure(nullptr), m_pfnDestroyAccelerationStructure(nullptr), m_pfnGetAccelerationStructureBuildSizes(nullptr), m_pfnGetAccelerationStructureDeviceAddress(nullptr), 
-		m_pfnCmdBuildAccelerationStructures(nullptr), m_pfnCmdDrawIndexedIndirectCount(nullptr), m_textures(), m_buffers(), m_uniformCollections(), m_deviceContexts(), m_shaders(), m_swapChains(), m_renderGraphs(), m_accelerationStructures()
+		m_pfnCmdBuildAccelerationStructures(nullptr), m_pfnCmdDrawIndexedIndirectCount(nullptr), m_pfnCmdPipelineBarrier2(nullptr), m_pfnCmdSetEvent2(nullptr), m_pfnCmdWaitEvents2(nullptr), m_recordingThreadCount(0), m_objectCacheVersion(0), m_timelineSemaphores(), m_timelineValues(),
+		m_frameEndTimelineType(QUEUE_TYPE::GRAPHICS), m_frameEndTimelineValue(0), m_textures(), m_buffers(), m_uniformCollections(), m_deviceContexts(), m_shaders(), m_swapChains(), m_renderGraphs(), m_accelerationStructures(), m_transientUniformRing(nullptr), m_indirectCommandRing(nullptr), m_readbackPool(nullptr),
+		m_stagingBufferPool(nullptr)
 	{
 		STATUS_CODE res = STATUS_CODE::SUCCESS;
 		const VkSurfaceKHR surface = CoreVk::Get().GetSurface();
@@ -188,6 +207,19 @@ namespace PHX
 		m_framebufferCache = new FramebufferCache();
 		m_renderPassCache = new RenderPassCache(this);
 		m_pipelineCache = new PipelineCache(this);
+		// Dynamic offsets must be aligned for whichever descriptor type a transient uniform ends up bound through
+		const VkPhysicalDeviceLimits& limits = m_physicalDeviceProperties.limits;
+		const u64 uniformRingAlignment = std::max(limits.minUniformBufferOffsetAlignment, limits.minStorageBufferOffsetAlignment);
+		const VkBufferUsageFlags uniformRingUsage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+		m_transientUniformRing = new TransientUniformRing(this, "TransientUniformRing", ci.framesInFlight, ci.transientUniformRingSize, uniformRingUsage, uniformRingAlignment);
+
+		// Indirect commands are only batched with multi-draw indirect, and only need 4 byte aligned offsets
+		if (m_multiDrawIndirectSupported)
+		{
+			m_indirectCommandRing = new TransientUniformRing(this, "IndirectCommandRing", ci.framesInFlight, ci.indirectCommandRingSize, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, 4);
+		}
+		m_readbackPool = new ReadbackPool(this, ci.framesInFlight);
+		m_stagingBufferPool = new StagingBufferPool(this, ci.framesInFlight, ci.stagingRingSize);
 		m_framesInFlight = ci.framesInFlight;
 
 		LogInfo("Successfully constructed Vk device!");
@@ -197,6 +229,10 @@ namespace PHX
 	{
 		vkDeviceWaitIdle(m_logicalDevice);
 
+		SAFE_DEL(m_stagingBufferPool);
+		SAFE_DEL(m_readbackPool);
+		SAFE_DEL(m_indirectCommandRing);
+		SAFE_DEL(m_transientUniformRing);
 		SAFE_DEL(m_pipelineCache);
 		SAFE_DEL(m_renderPassCache);
 		SAFE_DEL(m_framebufferCache);
@@ -220,6 +256,15 @@ namespace PHX
 			fences.clear();
 		}
 
+		for (VkSemaphore& timelineSemaphore : m_timelineSemaphores)
+		{
+			if (timelineSemaphore != VK_NULL_HANDLE)
+			{
+				vkDestroySemaphore(m_logicalDevice, timelineSemaphore, nullptr);
+				timelineSemaphore = VK_NULL_HANDLE;
+			}
+		}
+
 		// Destroy command pools (per queue type, per frame-in-flight)
 		for (u32 q = 0; q < static_cast<u32>(QUEUE_TYPE::COUNT); q++)
 		{
@@ -301,6 +346,48 @@ namespace PHX
 		return HANDLE_UTILS::AllocateHandle(m_textures, pTexture, this, handle);
 	}
 
+	STATUS_CODE RenderDeviceVk::ReallocateAliasedTexture(const TextureBaseCreateInfo& baseCreateInfo, const TextureViewCreateInfo& viewCreateInfo, const TextureSamplerCreateInfo& samplerCreateInfo, VmaAllocation alloc, VkDeviceSize offset, TextureHandle handle)
+	{
+		TextureVk* pOldTexture = m_textures.Get(handle.GetIndex());
+		if (pOldTexture == nullptr)
+		{
+			LogError("Failed to reallocate aliased texture. Handle does not refer to a texture!");
+			return STATUS_CODE::ERR_API;
+		}
+
+		TextureVk* pTexture = new TextureVk(this, baseCreateInfo, viewCreateInfo, samplerCreateInfo, alloc, offset);
+		if (pTexture == nullptr)
+		{
+			LogError("Failed to reallocate aliased texture. Memory allocation failed!");
+			return STATUS_CODE::ERR_INTERNAL;
+		}
+
+		// Framebuffers hold on to the old texture's image views
+		InvalidateFramebuffers(pOldTexture);
+
+		m_textures.Replace(handle.GetIndex(), pTexture);
+		return STATUS_CODE::SUCCESS;
+	}
+
+	STATUS_CODE RenderDeviceVk::ReallocateAliasedBuffer(const BufferCreateInfo& createInfo, VmaAllocation alloc, VkDeviceSize offset, BufferHandle handle)
+	{
+		if (m_buffers.Get(handle.GetIndex()) == nullptr)
+		{
+			LogError("Failed to reallocate aliased buffer. Handle does not refer to a buffer!");
+			return STATUS_CODE::ERR_API;
+		}
+
+		BufferVk* pBuffer = new BufferVk(this, createInfo, alloc, offset);
+		if (pBuffer == nullptr)
+		{
+			LogError("Failed to reallocate aliased buffer. Memory allocation failed!");
+			return STATUS_CODE::ERR_INTERNAL;
+		}
+
+		m_buffers.Replace(handle.GetIndex(), pBuffer);
+		return STATUS_CODE::SUCCESS;
+	}
+
 	STATUS_CODE RenderDeviceVk::AllocateUniformCollection(const UniformCollectionCreateInfo& createInfo, UniformCollectionHandle& handle)
 	{
 		UniformCollectionVk* pUniformCollection = new UniformCollectionVk(this, createInfo);
@@ -397,6 +484,12 @@ namespace PHX
 
 	STATUS_CODE RenderDeviceVk::AllocateSwapChain(const SwapChainCreateInfo& createInfo, SwapChainHandle& handle)
 	{
+		if (CoreVk::Get().GetSurface() == VK_NULL_HANDLE)
+		{
+			LogError("Failed to allocate swap chain. The library was initialized without a window!");
+			return STATUS_CODE::ERR_API;
+		}
+
 		SwapChainVk* pSwapChain = new SwapChainVk(this, createInfo);
 		if (pSwapChain == nullptr)
 		{
@@ -417,6 +510,23 @@ namespace PHX
 		return HANDLE_UTILS::AllocateHandle(m_deviceContexts, pContext, this, handle);
 	}
 
+	STATUS_CODE RenderDeviceVk::AllocateWorkerDeviceContext(const DeviceContextCreateInfo& createInfo, u32 workerIndex, DeviceContextHandle& handle)
+	{
+		if (workerIndex >= m_recordingThreadCount)
+		{
+			LogError("Failed to allocate worker device context. Worker index %u is out of range (expected 0 to %u)", workerIndex, m_recordingThreadCount);
+			return STATUS_CODE::ERR_INTERNAL;
+		}
+
+		DeviceContextVk* pContext = new DeviceContextVk(this, createInfo, workerIndex);
+		if (pContext == nullptr)
+		{
+			LogError("Failed to allocate worker device context. Memory allocation failed!");
+			return STATUS_CODE::ERR_INTERNAL;
+		}
+		return HANDLE_UTILS::AllocateHandle(m_deviceContexts, pContext, this, handle);
+	}
+
 	STATUS_CODE RenderDeviceVk::AllocateAccelerationStructure(const AccelerationStructureCreateInfo& createInfo, AccelerationStructureHandle& handle)
 	{
 		AccelerationStructureVk* pAccelerationStructure = new AccelerationStructureVk(this, createInfo);
@@ -521,6 +631,7 @@ namespace PHX
 	void RenderDeviceVk::DestroyFramebuffer(const FramebufferDescription& desc)
 	{
 		m_framebufferCache->Delete(desc);
+		m_objectCacheVersion++;
 	}
 
 	VkRenderPass RenderDeviceVk::GetOrCreateRenderPass(const RenderPassDescription& desc)
@@ -533,6 +644,7 @@ namespace PHX
 	void RenderDeviceVk::DestroyRenderPass(const RenderPassDescription& desc)
 	{
 		m_renderPassCache->Delete(desc);
+		m_objectCacheVersion++;
 	}
 
 	VkRenderPass RenderDeviceVk::GetRenderPass(const RenderPassDescription& desc) const
@@ -540,11 +652,11 @@ namespace PHX
 		return m_renderPassCache->Find(desc);
 	}
 
-	PipelineVk* RenderDeviceVk::CreateGraphicsPipeline(const GraphicsPipelineDesc& desc, VkRenderPass renderPass)
+	PipelineVk* RenderDeviceVk::CreateGraphicsPipeline(const GraphicsPipelineDesc& desc, VkRenderPass renderPass, u32 subpassIndex)
 	{
 		PROFILE_SCOPE("RenderDeviceVk_CreateGraphicsPipeline");
 
-		PipelineVk* pipeline = m_pipelineCache->FindOrCreate(this, renderPass, desc);
+		PipelineVk* pipeline = m_pipelineCache->FindOrCreate(this, renderPass, subpassIndex, desc);
 		if (pipeline == nullptr)
 		{
 			ASSERT_ALWAYS("Failed to create graphics pipeline!");
@@ -599,9 +711,48 @@ namespace PHX
 			m_framebufferCache->Delete(*iter);
 		}
 
+		m_objectCacheVersion++;
+
 		LogInfo("Invalidated %u backbuffer framebuffer objects!", m_invalidFramebufferDescs.size());
 	}
 
+	void RenderDeviceVk::InvalidateFramebuffers(const TextureVk* pTexture)
+	{
+		std::vector<const FramebufferDescription*> invalidFramebufferDescs;
+
+		const auto cacheBegin = m_framebufferCache->Begin();
+		const auto cacheEnd = m_framebufferCache->End();
+		for (auto iter = cacheBegin; iter != cacheEnd; iter++)
+		{
+			const FramebufferDescription& currDesc = iter->first;
+			for (u32 i = 0; i < currDesc.attachmentCount; i++)
+			{
+				if (currDesc.pAttachments[i].pTexture == pTexture)
+				{
+					invalidFramebufferDescs.push_back(&currDesc);
+					break;
+				}
+			}
+		}
+
+		if (invalidFramebufferDescs.empty())
+		{
+			return;
+		}
+
+		for (auto& iter : invalidFramebufferDescs)
+		{
+			m_framebufferCache->Delete(*iter);
+		}
+
+		m_objectCacheVersion++;
+	}
+
+	u32 RenderDeviceVk::GetObjectCacheVersion() const
+	{
+		return m_objectCacheVersion;
+	}
+
 	VkDevice RenderDeviceVk::GetLogicalDevice() const
 	{
 		return m_logicalDevice;
@@ -622,6 +773,26 @@ namespace PHX
 		return m_descriptorPool;
 	}
 
+	TransientUniformRing* RenderDeviceVk::GetTransientUniformRing() const
+	{
+		return m_transientUniformRing;
+	}
+
+	TransientUniformRing* RenderDeviceVk::GetIndirectCommandRing() const
+	{
+		return m_indirectCommandRing;
+	}
+
+	ReadbackPool* RenderDeviceVk::GetReadbackPool() const
+	{
+		return m_readbackPool;
+	}
+
+	StagingBufferPool* RenderDeviceVk::GetStagingBufferPool() const
+	{
+		return m_stagingBufferPool;
+	}
+
 	VkCommandPool RenderDeviceVk::GetCommandPool(QUEUE_TYPE type, u32 frameIndex) const
 	{
 		PROFILE_SCOPE("RenderDeviceVk_GetCommandPool");
@@ -633,12 +804,36 @@ namespace PHX
 		}
 
 		const auto& pools = m_commandPools[queueIdx];
-		if (frameIndex >= pools.size())
+		const u32 poolIndex = frameIndex * (m_recordingThreadCount + 1);
+		if (poolIndex >= pools.size())
 		{
 			return VK_NULL_HANDLE;
 		}
 
-		return pools[frameIndex];
+		return pools[poolIndex];
+	}
+
+	VkCommandPool RenderDeviceVk::GetWorkerCommandPool(QUEUE_TYPE type, u32 frameIndex, u32 workerIndex) const
+	{
+		u32 queueIdx = static_cast<u32>(type);
+		if (queueIdx >= static_cast<u32>(QUEUE_TYPE::COUNT) || frameIndex >= m_framesInFlight || workerIndex >= m_recordingThreadCount)
+		{
+			return VK_NULL_HANDLE;
+		}
+
+		const auto& pools = m_commandPools[queueIdx];
+		const u32 poolIndex = frameIndex * (m_recordingThreadCount + 1) + workerIndex + 1;
+		if (poolIndex >= pools.size())
+		{
+			return VK_NULL_HANDLE;
+		}
+
+		return pools[poolIndex];
+	}
+
+	u32 RenderDeviceVk::GetRecordingThreadCount() const
+	{
+		return m_recordingThreadCount;
 	}
 
 	VkQueue RenderDeviceVk::GetQueue(QUEUE_TYPE type) const
@@ -658,7 +853,7 @@ namespace PHX
 	{
 		PROFILE_SCOPE("RenderDeviceVk_GetQueueFamilyIndex");
 
-		return m_queueFamilyIndices.GetQueueIndex(type);
+		return m_queueFamilyIndices.GetFamilyIndex(type);
 	}
 
 	VkSemaphore RenderDeviceVk::GetImageAvailableSemaphore(u32 index) const
@@ -683,6 +878,95 @@ namespace PHX
 		return m_queueFences[queueIdx][index];
 	}
 
+	VkSemaphore RenderDeviceVk::GetTimelineSemaphore(QUEUE_TYPE type) const
+	{
+		u32 queueIdx = static_cast<u32>(type);
+		if (queueIdx >= static_cast<u32>(QUEUE_TYPE::COUNT))
+		{
+			LogError("Failed to get timeline semaphore. Queue type is invalid!");
+			return VK_NULL_HANDLE;
+		}
+
+		return m_timelineSemaphores[queueIdx];
+	}
+
+	u64 RenderDeviceVk::AdvanceTimelineValue(QUEUE_TYPE type)
+	{
+		u32 queueIdx = static_cast<u32>(type);
+		ASSERT_MSG(queueIdx < static_cast<u32>(QUEUE_TYPE::COUNT), "Failed to advance timeline value. Queue type is invalid!");
+
+		return ++m_timelineValues[queueIdx];
+	}
+
+	bool RenderDeviceVk::IsTimelineSemaphoreSupported() const
+	{
+		return m_timelineSemaphoreSupported;
+	}
+
+	void RenderDeviceVk::SetFrameEndTimelinePoint(QUEUE_TYPE type, u64 value)
+	{
+		m_frameEndTimelineType = type;
+		m_frameEndTimelineValue = value;
+	}
+
+	bool RenderDeviceVk::GetFrameEndTimelinePoint(QUEUE_TYPE& out_type, u64& out_value) const
+	{
+		out_type = m_frameEndTimelineType;
+		out_value = m_frameEndTimelineValue;
+		return (m_frameEndTimelineValue != 0);
+	}
+
+	bool RenderDeviceVk::IsAsyncComputeSupported() const
+	{
+		return m_asyncComputeSupported;
+	}
+
+	bool RenderDeviceVk::IsSynchronization2Supported() const
+	{
+		return m_synchronization2Supported;
+	}
+
+	bool RenderDeviceVk::IsDedicatedTransferSupported() const
+	{
+		return m_dedicatedTransferSupported;
+	}
+
+	const VkExtent3D& RenderDeviceVk::GetTransferImageGranularity() const
+	{
+		return m_transferImageGranularity;
+	}
+
+	bool RenderDeviceVk::IsTransferImageCopyAligned(const VkOffset3D& offset, const VkExtent3D& extent, const VkExtent3D& mipExtent, u32 blockDim) const
+	{
+		const VkExtent3D& granularity = m_transferImageGranularity;
+		if (granularity.width == 0 || granularity.height == 0 || granularity.depth == 0)
+		{
+			return offset.x == 0 && offset.y == 0 && offset.z == 0 &&
+				extent.width == mipExtent.width && extent.height == mipExtent.height && extent.depth == mipExtent.depth;
+		}
+
+		auto IsAxisAligned = [](i32 offset, u32 extent, u32 mipExtent, u32 granularity)
+		{
+			return (static_cast<u32>(offset) % granularity) == 0 &&
+				((extent % granularity) == 0 || static_cast<u32>(offset) + extent == mipExtent);
+		};
+
+		// Compressed formats count the granularity in texel blocks
+		return IsAxisAligned(offset.x, extent.width, mipExtent.width, granularity.width * blockDim) &&
+			IsAxisAligned(offset.y, extent.height, mipExtent.height, granularity.height * blockDim) &&
+			IsAxisAligned(offset.z, extent.depth, mipExtent.depth, granularity.depth);
+	}
+
+	bool RenderDeviceVk::IsMultiDrawIndirectSupported() const
+	{
+		return m_multiDrawIndirectSupported;
+	}
+
+	const std::vector<u32>& RenderDeviceVk::GetConcurrentQueueFamilies() const
+	{
+		return m_concurrentQueueFamilies;
+	}
+
 	const VkPhysicalDeviceProperties& RenderDeviceVk::GetDeviceProperties() const
 	{
 		return m_physicalDeviceProperties;
@@ -795,28 +1079,77 @@ namespace PHX
 			return STATUS_CODE::ERR_INTERNAL;
 		}
 
-		LogInfo("Selected graphics queue from queue family at index %u", indices.GetQueueIndex(QUEUE_TYPE::GRAPHICS));
-		LogInfo("Selected compute queue from queue family at index %u" , indices.GetQueueIndex(QUEUE_TYPE::COMPUTE ));
-		LogInfo("Selected transfer queue from queue family at index %u", indices.GetQueueIndex(QUEUE_TYPE::TRANSFER));
-		LogInfo("Selected present queue from queue family at index %u" , indices.GetQueueIndex(QUEUE_TYPE::PRESENT ));
+		LogInfo("Selected graphics queue from queue family at index %u", indices.GetFamilyIndex(QUEUE_TYPE::GRAPHICS));
+		LogInfo("Selected compute queue from queue family at index %u" , indices.GetFamilyIndex(QUEUE_TYPE::COMPUTE ));
+		LogInfo("Selected transfer queue from queue family at index %u", indices.GetFamilyIndex(QUEUE_TYPE::TRANSFER));
+		LogInfo("Selected present queue from queue family at index %u" , indices.GetFamilyIndex(QUEUE_TYPE::PRESENT ));
 
-		std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-		std::set<u32> uniqueQueueFamilies = {
-			indices.GetQueueIndex(QUEUE_TYPE::GRAPHICS),
-			indices.GetQueueIndex(QUEUE_TYPE::COMPUTE),
-			indices.GetQueueIndex(QUEUE_TYPE::PRESENT),
-			indices.GetQueueIndex(QUEUE_TYPE::TRANSFER)
-		};
+		// Submitting batches against their producers requires timeline semaphores, otherwise batches are chained one after another
+		m_timelineSemaphoreSupported = IsExtensionSupported(physicalDevice, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+
+		// Async compute uses a second queue from the graphics family, so resources don't need to be transferred between
+		// queue families. Without one (or without timeline semaphores) async compute passes run on the graphics queue
+		const u32 graphicsFamilyIndex = indices.GetFamilyIndex(QUEUE_TYPE::GRAPHICS);
+		u32 queueFamilyCount = 0;
+		vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+		std::vector<VkQueueFamilyProperties> queueFamilyProperties(queueFamilyCount);
+		vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilyProperties.data());
+		m_asyncComputeSupported = m_timelineSemaphoreSupported && (graphicsFamilyIndex < queueFamilyCount) && (queueFamilyProperties[graphicsFamilyIndex].queueCount > 1);
+		if (m_asyncComputeSupported)
+		{
+			indices.SetIndices(QUEUE_TYPE::ASYNC_COMPUTE, graphicsFamilyIndex, 1);
+			LogInfo("Selected async compute queue from queue family at index %u", graphicsFamilyIndex);
+		}
+		else
+		{
+			LogWarning("Async compute is not supported on this device. Async compute passes will run on the graphics queue");
+		}
+
+		// Resources written on one queue family and read on another must either be transferred between the families with
+		// ownership barriers, or be created with VK_SHARING_MODE_CONCURRENT. Uploads are the only work that leaves the graphics
+		// family, so buffers and sampled textures are shared between the graphics and transfer families, see
+		// GetConcurrentQueueFamilies()
+		const u32 transferFamilyIndex = indices.GetFamilyIndex(QUEUE_TYPE::TRANSFER);
+		m_dedicatedTransferSupported = (transferFamilyIndex != graphicsFamilyIndex);
+		m_concurrentQueueFamilies.clear();
+		m_transferImageGranularity = { 1, 1, 1 };
+		if (m_dedicatedTransferSupported)
+		{
+			m_concurrentQueueFamilies.push_back(graphicsFamilyIndex);
+			m_concurrentQueueFamilies.push_back(transferFamilyIndex);
+
+			// Graphics and compute families always copy with a granularity of one texel, DMA families may not
+			u32 queueFamilyCount = 0;
+			vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+			std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+			vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+			m_transferImageGranularity = queueFamilies[transferFamilyIndex].minImageTransferGranularity;
+
+			LogInfo("Transfer queue family image copy granularity is (%u, %u, %u)", m_transferImageGranularity.width, m_transferImageGranularity.height, m_transferImageGranularity.depth);
+		}
+
+		// Number of queues to create from each family, which is one past the highest queue index used from it
+		std::map<u32, u32> queueCountPerFamily;
+		for (u32 i = 0; i < static_cast<u32>(QUEUE_TYPE::COUNT); i++)
+		{
+			const QUEUE_TYPE queueType = static_cast<QUEUE_TYPE>(i);
+			const u32 familyIndex = indices.GetFamilyIndex(queueType);
+			u32& queueCount = queueCountPerFamily[familyIndex];
+			queueCount = Max(queueCount, indices.GetQueueIndex(queueType) + 1);
+		}
 
 		// TODO - Determine priority of the different queue types
-		float queuePriority = 1.0f;
-		for (u32 queueFamily : uniqueQueueFamilies)
+		std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
+		const float queuePriorities[] = { 1.0f, 1.0f };
+		for (const auto& familyQueueCount : queueCountPerFamily)
 		{
+			ASSERT_MSG(familyQueueCount.second <= 2, "Not enough queue priorities for the queues created from queue family %u!", familyQueueCount.first);
+
 			VkDeviceQueueCreateInfo queueCreateInfo{};
 			queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-			queueCreateInfo.queueFamilyIndex = queueFamily;
-			queueCreateInfo.queueCount = 1;
-			queueCreateInfo.pQueuePriorities = &queuePriority;
+			queueCreateInfo.queueFamilyIndex = familyQueueCount.first;
+			queueCreateInfo.queueCount = familyQueueCount.second;
+			queueCreateInfo.pQueuePriorities = queuePriorities;
 			queueCreateInfos.push_back(queueCreateInfo);
 		}
 
@@ -839,15 +1172,38 @@ namespace PHX
 		shaderDrawParamsFeatures.shaderDrawParameters = VK_TRUE;
 		shaderDrawParamsFeatures.pNext = &rtpFeatures;
 
+		VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineSemaphoreFeatures{};
+		timelineSemaphoreFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+		timelineSemaphoreFeatures.timelineSemaphore = m_timelineSemaphoreSupported ? VK_TRUE : VK_FALSE;
+		timelineSemaphoreFeatures.pNext = &shaderDrawParamsFeatures;
+
+		// Barriers with 64-bit stage and access flags, so stage masks can be more precise than with the legacy flags
+		m_synchronization2Supported = IsExtensionSupported(physicalDevice, VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+
+		VkPhysicalDeviceSynchronization2FeaturesKHR synchronization2Features{};
+		synchronization2Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR;
+		synchronization2Features.synchronization2 = m_synchronization2Supported ? VK_TRUE : VK_FALSE;
+		synchronization2Features.pNext = &timelineSemaphoreFeatures;
+
 		VkPhysicalDeviceFeatures2 deviceFeatures{};
 		deviceFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
-		deviceFeatures.pNext = &shaderDrawParamsFeatures;
+		deviceFeatures.pNext = &synchronization2Features;
 		deviceFeatures.features.samplerAnisotropy = VK_TRUE;
 		deviceFeatures.features.geometryShader = VK_TRUE;
 		deviceFeatures.features.tessellationShader = VK_TRUE;
 		deviceFeatures.features.fillModeNonSolid = VK_TRUE;
+		deviceFeatures.features.pipelineStatisticsQuery = m_physicalDeviceFeatures.pipelineStatisticsQuery; // Only used for metrics, so it's enabled whenever it's supported
+
+		// Only used to batch draws, which fall back to individual draw commands without it
+		m_multiDrawIndirectSupported = m_physicalDeviceFeatures.multiDrawIndirect && m_physicalDeviceFeatures.drawIndirectFirstInstance;
+		deviceFeatures.features.multiDrawIndirect = m_multiDrawIndirectSupported ? VK_TRUE : VK_FALSE;
+		deviceFeatures.features.drawIndirectFirstInstance = m_multiDrawIndirectSupported ? VK_TRUE : VK_FALSE;
 
 		std::vector<const char*> enabledExtensions = deviceExtensions;
+		if (surface != VK_NULL_HANDLE)
+		{
+			enabledExtensions.insert(enabledExtensions.end(), presentExtensions.begin(), presentExtensions.end());
+		}
 		if (m_rayTracingSupported)
 		{
 			LogInfo("Ray tracing is supported on this device");
@@ -874,6 +1230,24 @@ namespace PHX
 			LogWarning("Draw indirect count is not supported on this device");
 		}
 
+		if (m_timelineSemaphoreSupported)
+		{
+			enabledExtensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+		}
+		else
+		{
+			LogWarning("Timeline semaphores are not supported on this device. Submission batches will execute serially");
+		}
+
+		if (m_synchronization2Supported)
+		{
+			enabledExtensions.push_back(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+		}
+		else
+		{
+			LogWarning("Synchronization2 is not supported on this device. Falling back to legacy pipeline barriers");
+		}
+
 		VkDeviceCreateInfo createInfo{};
 		createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
 		createInfo.pNext = &deviceFeatures;
@@ -905,11 +1279,40 @@ namespace PHX
 			}
 		}
 
+		// Same as above, the synchronization2 commands are core in Vulkan 1.3
+		if (m_synchronization2Supported)
+		{
+			m_pfnCmdPipelineBarrier2 = (PFN_vkCmdPipelineBarrier2KHR)vkGetDeviceProcAddr(m_logicalDevice, "vkCmdPipelineBarrier2KHR");
+			if (m_pfnCmdPipelineBarrier2 == nullptr)
+			{
+				m_pfnCmdPipelineBarrier2 = (PFN_vkCmdPipelineBarrier2KHR)vkGetDeviceProcAddr(m_logicalDevice, "vkCmdPipelineBarrier2");
+			}
+
+			m_pfnCmdSetEvent2 = (PFN_vkCmdSetEvent2KHR)vkGetDeviceProcAddr(m_logicalDevice, "vkCmdSetEvent2KHR");
+			if (m_pfnCmdSetEvent2 == nullptr)
+			{
+				m_pfnCmdSetEvent2 = (PFN_vkCmdSetEvent2KHR)vkGetDeviceProcAddr(m_logicalDevice, "vkCmdSetEvent2");
+			}
+
+			m_pfnCmdWaitEvents2 = (PFN_vkCmdWaitEvents2KHR)vkGetDeviceProcAddr(m_logicalDevice, "vkCmdWaitEvents2KHR");
+			if (m_pfnCmdWaitEvents2 == nullptr)
+			{
+				m_pfnCmdWaitEvents2 = (PFN_vkCmdWaitEvents2KHR)vkGetDeviceProcAddr(m_logicalDevice, "vkCmdWaitEvents2");
+			}
+
+			if (m_pfnCmdPipelineBarrier2 == nullptr || m_pfnCmdSetEvent2 == nullptr || m_pfnCmdWaitEvents2 == nullptr)
+			{
+				LogWarning("VK_KHR_synchronization2 is supported but its commands could not be loaded! Falling back to legacy pipeline barriers");
+				m_synchronization2Supported = false;
+			}
+		}
+
 		// Get the queues from the logical device
-		vkGetDeviceQueue(m_logicalDevice, indices.GetQueueIndex(QUEUE_TYPE::GRAPHICS), 0, &m_queues[QUEUE_TYPE::GRAPHICS]);
-		vkGetDeviceQueue(m_logicalDevice, indices.GetQueueIndex(QUEUE_TYPE::COMPUTE ), 0, &m_queues[QUEUE_TYPE::COMPUTE ]);
-		vkGetDeviceQueue(m_logicalDevice, indices.GetQueueIndex(QUEUE_TYPE::TRANSFER), 0, &m_queues[QUEUE_TYPE::TRANSFER]);
-		vkGetDeviceQueue(m_logicalDevice, indices.GetQueueIndex(QUEUE_TYPE::PRESENT ), 0, &m_queues[QUEUE_TYPE::PRESENT ]);
+		for (u32 i = 0; i < static_cast<u32>(QUEUE_TYPE::COUNT); i++)
+		{
+			const QUEUE_TYPE queueType = static_cast<QUEUE_TYPE>(i);
+			vkGetDeviceQueue(m_logicalDevice, indices.GetFamilyIndex(queueType), indices.GetQueueIndex(queueType), &m_queues[queueType]);
+		}
 
 		m_queueFamilyIndices = indices;
 
@@ -944,6 +1347,8 @@ namespace PHX
 		poolSizes.push_back({ VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, numImageSamplers });
 		poolSizes.push_back({ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, numStorageBuffers });
 		poolSizes.push_back({ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, numStorageImages });
+		poolSizes.push_back({ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, numUniformBuffers });
+		poolSizes.push_back({ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, numStorageBuffers });
 
 		if (m_rayTracingSupported)
 		{
@@ -970,6 +1375,9 @@ namespace PHX
 	{
 		STATUS_CODE res = STATUS_CODE::SUCCESS;
 
+		// Command pools can't be used by multiple threads at the same time, so every recording thread gets its own
+		m_recordingThreadCount = GetSettings().recordingThreadCount;
+
 		res = AllocateCommandPool_Helper(QUEUE_TYPE::GRAPHICS, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, framesInFlight);
 		if (res != STATUS_CODE::SUCCESS)
 		{
@@ -982,6 +1390,12 @@ namespace PHX
 			return res;
 		}
 
+		res = AllocateCommandPool_Helper(QUEUE_TYPE::ASYNC_COMPUTE, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, framesInFlight);
+		if (res != STATUS_CODE::SUCCESS)
+		{
+			return res;
+		}
+
 		res = AllocateCommandPool_Helper(QUEUE_TYPE::TRANSFER, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, framesInFlight);
 		if (res != STATUS_CODE::SUCCESS)
 		{
@@ -993,7 +1407,7 @@ namespace PHX
 
 	STATUS_CODE RenderDeviceVk::AllocateCommandPool_Helper(QUEUE_TYPE type, VkCommandPoolCreateFlags flags, u32 framesInFlight)
 	{
-		u32 queueFamilyIndex = m_queueFamilyIndices.GetQueueIndex(type);
+		u32 queueFamilyIndex = m_queueFamilyIndices.GetFamilyIndex(type);
 		if (!m_queueFamilyIndices.IsValid({ queueFamilyIndex, 0 }))
 		{
 			LogError("Failed to allocate command pool of type %u! Queue family index is not valid", static_cast<u32>(type));
@@ -1002,19 +1416,20 @@ namespace PHX
 
 		u32 queueIndex = static_cast<u32>(type);
 		auto& pools = m_commandPools[queueIndex];
-		pools.resize(framesInFlight);
+		const u32 poolsPerFrame = m_recordingThreadCount + 1;
+		pools.resize(framesInFlight * poolsPerFrame, VK_NULL_HANDLE);
 
 		VkCommandPoolCreateInfo poolInfo{};
 		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
 		poolInfo.flags = flags;
 		poolInfo.queueFamilyIndex = queueFamilyIndex;
 
-		for (u32 i = 0; i < framesInFlight; i++)
+		for (u32 i = 0; i < static_cast<u32>(pools.size()); i++)
 		{
 			VkResult res = vkCreateCommandPool(GetLogicalDevice(), &poolInfo, nullptr, &pools[i]);
 			if (res != VK_SUCCESS)
 			{
-				LogError("Failed to create command pool of type %u for frame %u! Got error: \"%s\"", static_cast<u32>(type), i, string_VkResult(res));
+				LogError("Failed to create command pool of type %u for frame %u! Got error: \"%s\"", static_cast<u32>(type), i / poolsPerFrame, string_VkResult(res));
 				return STATUS_CODE::ERR_INTERNAL;
 			}
 		}
@@ -1037,8 +1452,8 @@ namespace PHX
 
 		m_imageAvailableSemaphores.resize(framesInFlight);
 
-		// Only GRAPHICS, COMPUTE, and TRANSFER queues need fences
-		const QUEUE_TYPE fencedQueues[] = { QUEUE_TYPE::GRAPHICS, QUEUE_TYPE::COMPUTE, QUEUE_TYPE::TRANSFER };
+		// Only GRAPHICS, COMPUTE, ASYNC_COMPUTE and TRANSFER queues need fences
+		const QUEUE_TYPE fencedQueues[] = { QUEUE_TYPE::GRAPHICS, QUEUE_TYPE::COMPUTE, QUEUE_TYPE::ASYNC_COMPUTE, QUEUE_TYPE::TRANSFER };
 		for (QUEUE_TYPE queueType : fencedQueues)
 		{
 			m_queueFences[static_cast<u32>(queueType)].resize(framesInFlight);
@@ -1072,6 +1487,35 @@ namespace PHX
 			}
 		}
 
+		// PER-QUEUE TIMELINE SEMAPHORES
+		if (m_timelineSemaphoreSupported)
+		{
+			VkSemaphoreTypeCreateInfoKHR semaphoreTypeCI{};
+			semaphoreTypeCI.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+			semaphoreTypeCI.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+			semaphoreTypeCI.initialValue = 0;
+
+			VkSemaphoreCreateInfo timelineSemaphoreCI{};
+			timelineSemaphoreCI.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+			timelineSemaphoreCI.pNext = &semaphoreTypeCI;
+
+			for (u32 queueIndex = 0; queueIndex < static_cast<u32>(QUEUE_TYPE::COUNT); queueIndex++)
+			{
+				if (!NeedsSynchronization(static_cast<QUEUE_TYPE>(queueIndex)))
+				{
+					continue;
+				}
+
+				VkResult res = vkCreateSemaphore(m_logicalDevice, &timelineSemaphoreCI, nullptr, &(m_timelineSemaphores[queueIndex]));
+				if (res != VK_SUCCESS)
+				{
+					LogError("Failed to create timeline semaphore! Got error: \"%s\"", string_VkResult(res));
+					return STATUS_CODE::ERR_INTERNAL;
+				}
+				m_timelineValues[queueIndex] = 0;
+			}
+		}
+
 		return STATUS_CODE::SUCCESS;
 	}
 
@@ -1253,6 +1697,39 @@ namespace PHX
 		m_pfnCmdDrawIndexedIndirectCount(commandBuffer, argsBuffer, argsOffset, countBuffer, countOffset, maxDrawCount, stride);
 	}
 
+	void RenderDeviceVk::CmdPipelineBarrier2(VkCommandBuffer commandBuffer, const VkDependencyInfoKHR* pDependencyInfo)
+	{
+		if (m_pfnCmdPipelineBarrier2 == nullptr)
+		{
+			LogError("Failed to call vkCmdPipelineBarrier2. Function pointer is null!");
+			return;
+		}
+
+		m_pfnCmdPipelineBarrier2(commandBuffer, pDependencyInfo);
+	}
+
+	void RenderDeviceVk::CmdSetEvent2(VkCommandBuffer commandBuffer, VkEvent event, const VkDependencyInfoKHR* pDependencyInfo)
+	{
+		if (m_pfnCmdSetEvent2 == nullptr)
+		{
+			LogError("Failed to call vkCmdSetEvent2. Function pointer is null!");
+			return;
+		}
+
+		m_pfnCmdSetEvent2(commandBuffer, event, pDependencyInfo);
+	}
+
+	void RenderDeviceVk::CmdWaitEvents2(VkCommandBuffer commandBuffer, u32 eventCount, const VkEvent* pEvents, const VkDependencyInfoKHR* pDependencyInfos)
+	{
+		if (m_pfnCmdWaitEvents2 == nullptr)
+		{
+			LogError("Failed to call vkCmdWaitEvents2. Function pointer is null!");
+			return;
+		}
+
+		m_pfnCmdWaitEvents2(commandBuffer, eventCount, pEvents, pDependencyInfos);
+	}
+
 	PipelineVk* RenderDeviceVk::CreateRayTracingPipeline(const RayTracingPipelineDesc& desc)
 	{
 		PROFILE_SCOPE("RenderDeviceVk_CreateRayTracingPipeline");
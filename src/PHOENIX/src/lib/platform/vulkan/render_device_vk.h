@@ -2,6 +2,7 @@
 
 #include <array>
 #include <unordered_map>
+#include <vector>
 #include <vma/vk_mem_alloc.h>
 #include <vulkan/vulkan.h>
 
@@ -28,6 +29,9 @@ namespace PHX
 	class UniformCollectionVk;
 	class ShaderVk;
 	class SwapChainVk;
+	class TransientUniformRing;
+	class ReadbackPool;
+	class StagingBufferPool;
 
 	class RenderDeviceVk : public IRenderDevice
 	{
@@ -52,6 +56,16 @@ namespace PHX
 		STATUS_CODE AllocateDeviceContext(const DeviceContextCreateInfo& createInfo, DeviceContextHandle& handle) override;
 		STATUS_CODE AllocateAccelerationStructure(const AccelerationStructureCreateInfo& createInfo, AccelerationStructureHandle& handle) override;
 
+		// Allocates a device context which records render graph passes on the worker thread at the given index. Worker
+		// device contexts use that worker's command pools, and never submit their command buffers themselves
+		STATUS_CODE AllocateWorkerDeviceContext(const DeviceContextCreateInfo& createInfo, u32 workerIndex, DeviceContextHandle& handle);
+
+		// Re-creates the object behind an existing handle in existing memory, at the given offset. Existing handles remain
+		// valid and resolve to the new object, similar to ReloadShader(). Used to alias transient render graph resources. If
+		// the allocation is null, the new object gets its own memory instead
+		STATUS_CODE ReallocateAliasedTexture(const TextureBaseCreateInfo& baseCreateInfo, const TextureViewCreateInfo& viewCreateInfo, const TextureSamplerCreateInfo& samplerCreateInfo, VmaAllocation alloc, VkDeviceSize offset, TextureHandle handle);
+		STATUS_CODE ReallocateAliasedBuffer(const BufferCreateInfo& createInfo, VmaAllocation alloc, VkDeviceSize offset, BufferHandle handle);
+
 		STATUS_CODE WaitIdle() override;
 
 		// Shader hot reloading
@@ -79,7 +93,7 @@ namespace PHX
 		void DestroyRenderPass(const RenderPassDescription& desc);
 		VkRenderPass GetRenderPass(const RenderPassDescription& desc) const;
 
-		PipelineVk* CreateGraphicsPipeline(const GraphicsPipelineDesc& desc, VkRenderPass renderPass);
+		PipelineVk* CreateGraphicsPipeline(const GraphicsPipelineDesc& desc, VkRenderPass renderPass, u32 subpassIndex = 0);
 		void DestroyGraphicsPipeline(const GraphicsPipelineDesc& desc);
 
 		PipelineVk* CreateComputePipeline(const ComputePipelineDesc& desc);
@@ -92,17 +106,77 @@ namespace PHX
 		// This is used to clean up old framebuffers after a window resize, for example
 		void InvalidateBackbufferFramebuffers();
 
+		// Removes all framebuffer entries in the cache which use the given texture as an attachment. Must be
+		// called before the texture object is destroyed or replaced
+		void InvalidateFramebuffers(const TextureVk* pTexture);
+
+		// Incremented every time a framebuffer or render pass is destroyed. Anything holding on to
+		// objects returned by the caches above across frames must drop them when this value changes
+		u32 GetObjectCacheVersion() const;
+
+		// Persistently mapped ring that transient uniforms of every device context are allocated from. Each frame in flight
+		// has its own region, which is reset by the device context waiting on that frame's fence
+		TransientUniformRing* GetTransientUniformRing() const;
+
+		// Same as the transient uniform ring, but only used for the indirect commands of batched draws, so a large batch
+		// can't take up the memory uniform uploads need. Null if multi-draw indirect isn't supported
+		TransientUniformRing* GetIndirectCommandRing() const;
+
+		// Host-cached buffers that readbacks of every device context are copied into. Readbacks complete when the device context
+		// with the readback's frame index waits on that frame's fence
+		ReadbackPool* GetReadbackPool() const;
+
+		// Staging memory uploads of every device context are sub-allocated from. Allocations are reclaimed when the device
+		// context with the allocation's frame index waits on that frame's fence
+		StagingBufferPool* GetStagingBufferPool() const;
+
 		// Getters
 		VkDevice GetLogicalDevice() const;
 		VkPhysicalDevice GetPhysicalDevice() const;
 		VmaAllocator GetAllocator() const;
 		VkDescriptorPool GetDescriptorPool() const;
 		VkCommandPool GetCommandPool(QUEUE_TYPE type, u32 frameIndex) const;
+		VkCommandPool GetWorkerCommandPool(QUEUE_TYPE type, u32 frameIndex, u32 workerIndex) const;
+		u32 GetRecordingThreadCount() const;
 		VkQueue GetQueue(QUEUE_TYPE type) const;
 		u32 GetQueueFamilyIndex(QUEUE_TYPE type) const;
 		VkSemaphore GetImageAvailableSemaphore(u32 index) const;
 		VkFence GetQueueFence(QUEUE_TYPE type, u32 index) const;
 
+		// Timeline semaphores, one per queue type. Every submission batch signals the next value of its queue type's
+		// semaphore, so consumers on other queues can wait on exactly the batches they depend on. Values keep increasing
+		// across frames. Returns VK_NULL_HANDLE if timeline semaphores are not supported
+		VkSemaphore GetTimelineSemaphore(QUEUE_TYPE type) const;
+		u64 AdvanceTimelineValue(QUEUE_TYPE type);
+		bool IsTimelineSemaphoreSupported() const;
+
+		// Point on the timeline semaphores at which the last submitted frame completes. Returns false if no frame has been submitted
+		void SetFrameEndTimelinePoint(QUEUE_TYPE type, u64 value);
+		bool GetFrameEndTimelinePoint(QUEUE_TYPE& out_type, u64& out_value) const;
+
+		// True if ASYNC_COMPUTE maps to a different queue than GRAPHICS, so async compute passes can overlap graphics work
+		bool IsAsyncComputeSupported() const;
+
+		// True if barriers can be recorded with VK_KHR_synchronization2 (64-bit stage and access flags)
+		bool IsSynchronization2Supported() const;
+
+		// True if TRANSFER maps to a different queue family than GRAPHICS (usually a DMA engine), so uploads can overlap
+		// rendering. Only resources created with VK_SHARING_MODE_CONCURRENT may be used on the transfer queue then
+		bool IsDedicatedTransferSupported() const;
+
+		// Granularity of image copies on the transfer queue, in texels (texel blocks for compressed formats). Copies which
+		// aren't aligned to it, other than those reaching the edge of the mip level, must be recorded on the graphics queue.
+		// (0, 0, 0) only allows copies of whole mip levels
+		const VkExtent3D& GetTransferImageGranularity() const;
+		bool IsTransferImageCopyAligned(const VkOffset3D& offset, const VkExtent3D& extent, const VkExtent3D& mipExtent, u32 blockDim) const;
+
+		// True if indirect draws can issue more than one draw, with a non-zero first instance
+		bool IsMultiDrawIndirectSupported() const;
+
+		// Queue families that resources created with VK_SHARING_MODE_CONCURRENT must list. Empty if there is no dedicated
+		// transfer queue family, in which case every resource is created with VK_SHARING_MODE_EXCLUSIVE
+		const std::vector<u32>& GetConcurrentQueueFamilies() const;
+
 		// Device info
 		const VkPhysicalDeviceProperties& GetDeviceProperties() const;
 		const VkPhysicalDeviceFeatures& GetDeviceFeatures() const;
@@ -118,6 +192,11 @@ namespace PHX
 		// Draw indirect count wrapper (VK_KHR_draw_indirect_count extension)
 		void CmdDrawIndexedIndirectCount(VkCommandBuffer commandBuffer, VkBuffer argsBuffer, VkDeviceSize argsOffset, VkBuffer countBuffer, VkDeviceSize countOffset, u32 maxDrawCount, u32 stride);
 
+		// Pipeline barrier and event wrappers (VK_KHR_synchronization2 extension)
+		void CmdPipelineBarrier2(VkCommandBuffer commandBuffer, const VkDependencyInfoKHR* pDependencyInfo);
+		void CmdSetEvent2(VkCommandBuffer commandBuffer, VkEvent event, const VkDependencyInfoKHR* pDependencyInfo);
+		void CmdWaitEvents2(VkCommandBuffer commandBuffer, u32 eventCount, const VkEvent* pEvents, const VkDependencyInfoKHR* pDependencyInfos);
+
 		// Acceleration structure Vulkan wrappers around VK extension function pointers. 
 		// If ray tracing is unsupported, these result in no-ops
 		VkResult CreateAccelerationStructureKHR(const VkAccelerationStructureCreateInfoKHR* pCreateInfo, VkAccelerationStructureKHR* pAccelerationStructure);
@@ -154,6 +233,13 @@ namespace PHX
 		u32 m_framesInFlight;
 		bool m_rayTracingSupported;
 		bool m_drawIndirectCountSupported;
+		bool m_timelineSemaphoreSupported;
+		bool m_asyncComputeSupported;
+		bool m_synchronization2Supported;
+		bool m_dedicatedTransferSupported;
+		bool m_multiDrawIndirectSupported;
+		std::vector<u32> m_concurrentQueueFamilies;
+		VkExtent3D m_transferImageGranularity;
 
 		// Physical device cache
 		VkPhysicalDeviceProperties m_physicalDeviceProperties;
@@ -177,22 +263,35 @@ namespace PHX
 		// Draw indirect count function pointer (VK_KHR_draw_indirect_count)
 		PFN_vkCmdDrawIndexedIndirectCount m_pfnCmdDrawIndexedIndirectCount;
 
+		// Pipeline barrier and event function pointers (VK_KHR_synchronization2)
+		PFN_vkCmdPipelineBarrier2KHR m_pfnCmdPipelineBarrier2;
+		PFN_vkCmdSetEvent2KHR m_pfnCmdSetEvent2;
+		PFN_vkCmdWaitEvents2KHR m_pfnCmdWaitEvents2;
+
 		// Descriptor pool
 		VkDescriptorPool m_descriptorPool;
 
 		// Command pools (per queue type, per frame-in-flight)
+		// Every frame in flight has one command pool for the device context, followed by one per recording thread
 		std::array<std::vector<VkCommandPool>, static_cast<size_t>(QUEUE_TYPE::COUNT)> m_commandPools;
+		u32 m_recordingThreadCount;
 
 		// Object caches
 		FramebufferCache* m_framebufferCache;
 		RenderPassCache* m_renderPassCache;
 		PipelineCache* m_pipelineCache;
+		u32 m_objectCacheVersion;
 
 		// Sync objects
 		std::vector<VkSemaphore> m_imageAvailableSemaphores;
 
 		std::array<std::vector<VkFence>, static_cast<size_t>(QUEUE_TYPE::COUNT)> m_queueFences;
 
+		std::array<VkSemaphore, static_cast<size_t>(QUEUE_TYPE::COUNT)> m_timelineSemaphores;
+		std::array<u64, static_cast<size_t>(QUEUE_TYPE::COUNT)> m_timelineValues;
+		QUEUE_TYPE m_frameEndTimelineType;
+		u64 m_frameEndTimelineValue;
+
 		// Resource objects
 		HandleList<TextureVk> m_textures;
 		HandleList<BufferVk> m_buffers;
@@ -202,6 +301,11 @@ namespace PHX
 		HandleList<SwapChainVk> m_swapChains; // Possibly support multiple windows?
 		HandleList<RenderGraphVk> m_renderGraphs;
 		HandleList<AccelerationStructureVk> m_accelerationStructures;
+
+		TransientUniformRing* m_transientUniformRing;
+		TransientUniformRing* m_indirectCommandRing;
+		ReadbackPool* m_readbackPool;
+		StagingBufferPool* m_stagingBufferPool;
 	};
 
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 ﻿
 #include <algorithm>
+#include <chrono>
 #include <cstdio>
+#include <cstring>
 #include <sstream>
 #include <vulkan/vk_enum_string_helper.h>
 
@@ -18,11 +20,16 @@
 #include "core/profiling.h"
 #include "device_context_vk.h"
 #include "render_device_vk.h"
+#include "shader_vk.h"
 #include "swap_chain_vk.h"
 #include "texture_vk.h"
 #include "utils/attachment_type_converter.h"
 #include "utils/cache_utils.h"
+#include "utils/readback_pool.h"
 #include "utils/render_graph_type_converter.h"
+#include "utils/shader_type_converter.h"
+#include "utils/transient_resource_pool.h"
+#include "utils/worker_pool.h"
 
 // Render graph inspired from:
 // https://poniesandlight.co.uk/reflect/island_rendergraph_1/
@@ -34,6 +41,62 @@ namespace PHX
 {
 	static const char* s_pReservedDepthBufferName = "INTERNAL_depthbuffer";
 	static constexpr u32 s_invalidRenderPassIndex = U32_MAX;
+	static constexpr u32 s_maxBakedRenderGraphs = 16;
+	static constexpr u32 s_maxTimedPassCount = 128; // Per frame in flight
+	static constexpr u32 s_minPhysicalResourceTableSize = 64; // Power of two
+
+	// Pipeline statistics gathered per pass. Results are written in order of the bits, which matches PassMetrics
+	static constexpr VkQueryPipelineStatisticFlags s_passPipelineStatistics =
+		VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+		VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+		VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT |
+		VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+	static constexpr u32 s_passPipelineStatisticCount = 4;
+
+	static bool IsEntireTexture(const TextureSubresourceRange& range)
+	{
+		return range.baseMipLevel == 0 && range.mipLevelCount == REMAINING_SUBRESOURCES &&
+			range.baseArrayLayer == 0 && range.arrayLayerCount == REMAINING_SUBRESOURCES;
+	}
+
+	// Clamps the range to the texture. Ranges covering the entire texture are returned as the default range,
+	// so the same subresources are always described by the same range
+	static TextureSubresourceRange ClampSubresourceRange(TextureHandle texture, const TextureSubresourceRange& range)
+	{
+		const u32 mipLevels = texture.GetMipLevels();
+		const u32 arrayLayers = texture.GetArrayLayers();
+
+		TextureSubresourceRange clampedRange{};
+		clampedRange.baseMipLevel = std::min(range.baseMipLevel, mipLevels - 1);
+		clampedRange.mipLevelCount = std::min(range.mipLevelCount, mipLevels - clampedRange.baseMipLevel);
+		clampedRange.baseArrayLayer = std::min(range.baseArrayLayer, arrayLayers - 1);
+		clampedRange.arrayLayerCount = std::min(range.arrayLayerCount, arrayLayers - clampedRange.baseArrayLayer);
+
+		if (clampedRange.baseMipLevel == 0 && clampedRange.mipLevelCount == mipLevels && clampedRange.baseArrayLayer == 0 && clampedRange.arrayLayerCount == arrayLayers)
+		{
+			return {};
+		}
+		return clampedRange;
+	}
+
+	// Returns true if the ranges share any subresource. Counts may be REMAINING_SUBRESOURCES
+	static bool SubresourceRangesOverlap(const TextureSubresourceRange& a, const TextureSubresourceRange& b)
+	{
+		const auto IntervalsOverlap = [](u32 baseA, u32 countA, u32 baseB, u32 countB)
+		{
+			return static_cast<u64>(baseA) < static_cast<u64>(baseB) + countB && static_cast<u64>(baseB) < static_cast<u64>(baseA) + countA;
+		};
+
+		return IntervalsOverlap(a.baseMipLevel, a.mipLevelCount, b.baseMipLevel, b.mipLevelCount) &&
+			IntervalsOverlap(a.baseArrayLayer, a.arrayLayerCount, b.baseArrayLayer, b.arrayLayerCount);
+	}
+
+	// Size of the mip level rendered to by an attachment using the given range
+	static void CalculateAttachmentExtent(const TextureVk* pTexture, const TextureSubresourceRange& range, u32& out_width, u32& out_height)
+	{
+		out_width = Max(pTexture->GetWidth() >> range.baseMipLevel, 1u);
+		out_height = Max(pTexture->GetHeight() >> range.baseMipLevel, 1u);
+	}
 
 	static u64 HashResource(Handle resource, const RESOURCE_TYPE& type)
 	{
@@ -44,6 +107,58 @@ namespace PHX
 		return static_cast<u64>(seed);
 	}
 
+	// Ranges covering the entire texture share the ID of the texture, so they're the same physical resource
+	static u64 HashResource(Handle resource, const RESOURCE_TYPE& type, const TextureSubresourceRange& range)
+	{
+		size_t seed = static_cast<size_t>(HashResource(resource, type));
+		if (!IsEntireTexture(range))
+		{
+			HashCombine(seed, range.baseMipLevel);
+			HashCombine(seed, range.mipLevelCount);
+			HashCombine(seed, range.baseArrayLayer);
+			HashCombine(seed, range.arrayLayerCount);
+		}
+
+		return static_cast<u64>(seed);
+	}
+
+	static const Barrier* FindBarrier(const ResourceBarrierList& barriers, u64 resourceID)
+	{
+		for (const ResourceBarrier& resourceBarrier : barriers)
+		{
+			if (resourceBarrier.resourceID == resourceID)
+			{
+				return &resourceBarrier.barrier;
+			}
+		}
+
+		return nullptr;
+	}
+
+	// Adds the barrier, unless the resource already has one
+	static void InsertBarrier(ResourceBarrierList& barriers, u64 resourceID, const Barrier& barrier)
+	{
+		if (FindBarrier(barriers, resourceID) == nullptr)
+		{
+			barriers.push_back({ resourceID, barrier });
+		}
+	}
+
+	// Adds the barrier, or replaces the one the resource already has
+	static void SetBarrier(ResourceBarrierList& barriers, u64 resourceID, const Barrier& barrier)
+	{
+		for (ResourceBarrier& resourceBarrier : barriers)
+		{
+			if (resourceBarrier.resourceID == resourceID)
+			{
+				resourceBarrier.barrier = barrier;
+				return;
+			}
+		}
+
+		barriers.push_back({ resourceID, barrier });
+	}
+
 	static QUEUE_TYPE ConvertPassTypeToQueueType(PASS_TYPE passType)
 	{
 		switch (passType)
@@ -138,6 +253,12 @@ namespace PHX
 				}
 				case RESOURCE_TYPE::TEXTURE:
 				{
+					if (usage.isInputAttachment)
+					{
+						flags |= VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+						break;
+					}
+
 					// attachmentType distinguishes attachment reads (LOAD-op dual-registered
 					// inputs) from shader sampled reads (SetTextureInput with INVALID).
 					switch (usage.attachmentType)
@@ -261,7 +382,19 @@ namespace PHX
 		return flags;
 	}
 
-	static VkPipelineStageFlags CalculateResourcePipelineStageFlags(PASS_TYPE passType, VkAccessFlags accessFlag, bool isSrcFlag)
+	static u32 CountStageBits(VkPipelineStageFlags flags)
+	{
+		u32 count = 0;
+		for (; flags != 0; flags &= (flags - 1))
+		{
+			count++;
+		}
+		return count;
+	}
+
+	// shaderStageMask holds the stages of the pass' shaders which access resources, or 0 if they're unknown. Shader accesses
+	// are then assumed to happen in the vertex and fragment shaders
+	static VkPipelineStageFlags CalculateResourcePipelineStageFlags(PASS_TYPE passType, VkAccessFlags accessFlag, bool isSrcFlag, VkPipelineStageFlags shaderStageMask)
 	{
 		if (accessFlag == 0)
 		{
@@ -290,8 +423,14 @@ namespace PHX
 			}
 			if (accessFlag & VK_ACCESS_UNIFORM_READ_BIT)
 			{
-				// TODO - Determine proper shader stage
-				flags |= (isSrcFlag ? VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+				if (shaderStageMask != 0)
+				{
+					flags |= shaderStageMask;
+				}
+				else
+				{
+					flags |= (isSrcFlag ? VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+				}
 			}
 			if (accessFlag & VK_ACCESS_INPUT_ATTACHMENT_READ_BIT)
 			{
@@ -299,11 +438,16 @@ namespace PHX
 			}
 			if (accessFlag & (VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT))
 			{
-				// TODO - Find a way to tell which shader is writing to the resource so we don't have to include
-				//        all the shader flags. For now, we're only covering vertex and fragment shaders, but realistically
-				//        this should cover more shader types like geometry, tesselation, etc but I don't want to
-				//        guard against all of them here
-				flags |= (VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+				// Resources aren't tied to shader bindings, so every shader stage of the pass which accesses any
+				// resource is included. Without reflection, only vertex and fragment shaders are covered
+				if (shaderStageMask != 0)
+				{
+					flags |= shaderStageMask;
+				}
+				else
+				{
+					flags |= (VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+				}
 			}
 			if (accessFlag & VK_ACCESS_INDIRECT_COMMAND_READ_BIT)
 			{
@@ -401,6 +545,13 @@ namespace PHX
 			{
 			case PASS_TYPE::GRAPHICS:
 			{
+				if (usage.isInputAttachment)
+				{
+					// Input attachments are read-only for the subpass that reads them
+					const bool isDepthStencil = (usage.attachmentType != ATTACHMENT_TYPE::COLOR);
+					return isDepthStencil ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+				}
+
 				switch (usage.attachmentType)
 				{
 				case ATTACHMENT_TYPE::COLOR:
@@ -498,25 +649,71 @@ namespace PHX
 
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-	RenderPassVk::RenderPassVk(const char* name, PASS_TYPE passType, u32 index, RegisterResourceCallbackFn registerResourceCallback) : 
-		m_passType(passType), m_registerResourceCallback(registerResourceCallback), m_index(index)
+	RenderPassVk::RenderPassVk(RenderGraphVk* pRenderGraph) : m_pRenderGraph(pRenderGraph), m_index(0), m_isAsyncCompute(false), m_isRootPass(false), m_usesExclusiveTextures(false),
+		m_shaderStageMask(0), m_passType(PASS_TYPE::GRAPHICS), m_countedStorageCapacity(0)
+	{
+		ASSERT_PTR(m_pRenderGraph);
+	}
+
+	RenderPassVk::~RenderPassVk()
 	{
-		ASSERT_MSG(m_registerResourceCallback != nullptr, "Register resource callback is null");
+		m_inputResources.Clear();
+		m_outputResources.Clear();
+		m_inputAttachments.Clear();
+	}
 
+	void RenderPassVk::Reset(const char* name, PASS_TYPE passType, u32 index)
+	{
 		m_name = HashCRC32(name);
 
 #if defined(PHX_DEBUG)
 		m_debugName = name;
 #endif
+
+		m_inputResources.Clear();
+		m_outputResources.Clear();
+		m_inputAttachments.Clear();
+		m_execCallback = nullptr;
+		m_index = index;
+		m_isAsyncCompute = false;
+		m_isRootPass = false;
+		m_usesExclusiveTextures = false;
+		m_shaderStageMask = 0;
+
+		graphicsDesc = GraphicsPipelineDesc{};
+		computeDesc = ComputePipelineDesc{};
+		rayTracingDesc = RayTracingPipelineDesc{};
+		m_passType = passType;
+
+		m_dependencyInfos.clear();
+		m_inputBarriers.clear();
+		m_outputBarriers.clear();
+		m_resourceUsageIndices.clear();
+
+		SetRefCount(0);
 	}
 
-	RenderPassVk::~RenderPassVk()
+	size_t RenderPassVk::GetStorageCapacity() const
 	{
-		m_inputResources.reset();
-		m_outputResources.reset();
+		size_t capacity = m_inputResources.GetCapacityBytes() + m_outputResources.GetCapacityBytes() + m_inputAttachments.GetCapacityBytes();
+		capacity += m_dependencyInfos.capacity() * sizeof(DependencyInfo);
+		for (const DependencyInfo& dependencyInfo : m_dependencyInfos)
+		{
+			capacity += dependencyInfo.resources.GetCapacityBytes();
+		}
+		capacity += m_inputBarriers.capacity() * sizeof(ResourceBarrier);
+		capacity += m_outputBarriers.capacity() * sizeof(ResourceBarrier);
+		capacity += m_resourceUsageIndices.capacity() * sizeof(ResourceUsageIndex);
+
+		return capacity;
 	}
 
 	void RenderPassVk::SetTextureInput(TextureHandle texture)
+	{
+		SetTextureInput(texture, {});
+	}
+
+	void RenderPassVk::SetTextureInput(TextureHandle texture, const TextureSubresourceRange& range)
 	{
 		ResourceUsage usage{};
 		usage.io = RESOURCE_IO::INPUT;
@@ -527,8 +724,8 @@ namespace PHX
 		usage.storeOp = ATTACHMENT_STORE_OP::IGNORE;
 		usage.loadOp = ATTACHMENT_LOAD_OP::LOAD;
 
-		const ResourceIndex resourceIndex = m_registerResourceCallback(texture, RESOURCE_TYPE::TEXTURE, usage);
-		m_inputResources.set(resourceIndex);
+		const ResourceIndex resourceIndex = m_pRenderGraph->RegisterResource(texture, RESOURCE_TYPE::TEXTURE, usage, ClampSubresourceRange(texture, range));
+		m_inputResources.Set(resourceIndex);
 	}
 
 	void RenderPassVk::SetBufferInput(BufferHandle buffer)
@@ -543,8 +740,8 @@ namespace PHX
 		usage.storeOp = ATTACHMENT_STORE_OP::INVALID;
 		usage.loadOp = ATTACHMENT_LOAD_OP::INVALID;
 
-		const ResourceIndex resourceIndex = m_registerResourceCallback(buffer, RESOURCE_TYPE::BUFFER, usage);
-		m_inputResources.set(resourceIndex);
+		const ResourceIndex resourceIndex = m_pRenderGraph->RegisterResource(buffer, RESOURCE_TYPE::BUFFER, usage);
+		m_inputResources.Set(resourceIndex);
 	}
 
 	void RenderPassVk::SetUniformInput(UniformCollectionHandle uniformCollection)
@@ -559,8 +756,8 @@ namespace PHX
 		usage.storeOp = ATTACHMENT_STORE_OP::INVALID;
 		usage.loadOp = ATTACHMENT_LOAD_OP::INVALID;
 
-		const ResourceIndex resourceIndex = m_registerResourceCallback(uniformCollection, RESOURCE_TYPE::UNIFORM, usage);
-		m_inputResources.set(resourceIndex);
+		const ResourceIndex resourceIndex = m_pRenderGraph->RegisterResource(uniformCollection, RESOURCE_TYPE::UNIFORM, usage);
+		m_inputResources.Set(resourceIndex);
 	}
 
 	void RenderPassVk::SetAccelerationStructureInput(AccelerationStructureHandle accelerationStructure)
@@ -574,8 +771,33 @@ namespace PHX
 		usage.storeOp = ATTACHMENT_STORE_OP::INVALID;
 		usage.loadOp = ATTACHMENT_LOAD_OP::INVALID;
 
-		const ResourceIndex resourceIndex = m_registerResourceCallback(accelerationStructure, RESOURCE_TYPE::ACCELERATION_STRUCTURE, usage);
-		m_inputResources.set(resourceIndex);
+		const ResourceIndex resourceIndex = m_pRenderGraph->RegisterResource(accelerationStructure, RESOURCE_TYPE::ACCELERATION_STRUCTURE, usage);
+		m_inputResources.Set(resourceIndex);
+	}
+
+	void RenderPassVk::SetInputAttachment(TextureHandle texture)
+	{
+		if (m_passType != PASS_TYPE::GRAPHICS)
+		{
+#if defined(PHX_DEBUG)
+			LogError("Failed to set input attachment for render pass \"%s\". Input attachments are only supported in graphics passes!", m_debugName);
+#else
+			LogError("Failed to set input attachment. Input attachments are only supported in graphics passes!");
+#endif
+			return;
+		}
+
+		ResourceUsage usage{};
+		usage.io = RESOURCE_IO::INPUT;
+		usage.passIndex = m_index;
+		usage.attachmentType = CalculateAttachmentType(texture); // Only used to pick the read-only layout
+		usage.storeOp = ATTACHMENT_STORE_OP::IGNORE;
+		usage.loadOp = ATTACHMENT_LOAD_OP::LOAD;
+		usage.isInputAttachment = true;
+
+		const ResourceIndex resourceIndex = m_pRenderGraph->RegisterResource(texture, RESOURCE_TYPE::TEXTURE, usage);
+		m_inputResources.Set(resourceIndex);
+		m_inputAttachments.Set(resourceIndex);
 	}
 
 	void RenderPassVk::SetColorOutput(TextureHandle texture)
@@ -595,8 +817,8 @@ namespace PHX
 		usage.clearValue.depthStencil.depthClear = 1.0f;
 		usage.clearValue.depthStencil.stencilClear = 0;
 
-		const ResourceIndex resourceIndex = m_registerResourceCallback(texture, RESOURCE_TYPE::TEXTURE, usage);
-		m_outputResources.set(resourceIndex);
+		const ResourceIndex resourceIndex = m_pRenderGraph->RegisterResource(texture, RESOURCE_TYPE::TEXTURE, usage);
+		m_outputResources.Set(resourceIndex);
 	}
 
 	void RenderPassVk::SetDepthStencilOutput(TextureHandle texture)
@@ -609,8 +831,8 @@ namespace PHX
 		usage.storeOp = ATTACHMENT_STORE_OP::STORE;
 		usage.loadOp = ATTACHMENT_LOAD_OP::CLEAR;
 
-		const ResourceIndex resourceIndex = m_registerResourceCallback(texture, RESOURCE_TYPE::TEXTURE, usage);
-		m_outputResources.set(resourceIndex);
+		const ResourceIndex resourceIndex = m_pRenderGraph->RegisterResource(texture, RESOURCE_TYPE::TEXTURE, usage);
+		m_outputResources.Set(resourceIndex);
 	}
 
 	void RenderPassVk::SetResolveOutput(TextureHandle texture)
@@ -623,13 +845,33 @@ namespace PHX
 		usage.storeOp = ATTACHMENT_STORE_OP::STORE;
 		usage.loadOp = ATTACHMENT_LOAD_OP::CLEAR;
 
-		const ResourceIndex resourceIndex = m_registerResourceCallback(texture, RESOURCE_TYPE::TEXTURE, usage);
-		m_outputResources.set(resourceIndex);
+		const ResourceIndex resourceIndex = m_pRenderGraph->RegisterResource(texture, RESOURCE_TYPE::TEXTURE, usage);
+		m_outputResources.Set(resourceIndex);
 	}
 
 
 	void RenderPassVk::SetTextureOutput(TextureHandle texture, ATTACHMENT_LOAD_OP loadOp, ATTACHMENT_STORE_OP storeOp, ClearValues clearValue)
 	{
+		SetTextureOutput(texture, {}, loadOp, storeOp, clearValue);
+	}
+
+	void RenderPassVk::SetTextureOutput(TextureHandle texture, const TextureSubresourceRange& range, ATTACHMENT_LOAD_OP loadOp, ATTACHMENT_STORE_OP storeOp, ClearValues clearValue)
+	{
+		const TextureSubresourceRange clampedRange = ClampSubresourceRange(texture, range);
+		if (m_passType == PASS_TYPE::GRAPHICS && !IsEntireTexture(clampedRange))
+		{
+			// Framebuffers reference a single image view per attachment, so the range must match one of the texture's views
+			if (texture.GetViewScope() != VIEW_SCOPE::PER_MIP || clampedRange.mipLevelCount != 1 || clampedRange.baseArrayLayer != 0 || clampedRange.arrayLayerCount != texture.GetArrayLayers())
+			{
+#if defined(PHX_DEBUG)
+				LogError("Failed to set texture output for render pass \"%s\". Graphics passes can only render to a single mip level of every array layer, of a texture with per-mip views!", m_debugName);
+#else
+				LogError("Failed to set texture output. Graphics passes can only render to a single mip level of every array layer, of a texture with per-mip views!");
+#endif
+				return;
+			}
+		}
+
 		const ATTACHMENT_TYPE attachmentType = CalculateAttachmentType(texture);
 
 		ResourceUsage usage{};
@@ -640,8 +882,8 @@ namespace PHX
 		usage.loadOp = loadOp;
 		usage.clearValue = clearValue;
 
-		const ResourceIndex resourceIndex = m_registerResourceCallback(texture, RESOURCE_TYPE::TEXTURE, usage);
-		m_outputResources.set(resourceIndex);
+		const ResourceIndex resourceIndex = m_pRenderGraph->RegisterResource(texture, RESOURCE_TYPE::TEXTURE, usage, clampedRange);
+		m_outputResources.Set(resourceIndex);
 
 		// LOAD-op outputs also read from the attachment (read-modify-write). Register an input so the render graph
 		// handles the read half naturally
@@ -656,8 +898,8 @@ namespace PHX
 			inputUsage.loadOp = ATTACHMENT_LOAD_OP::LOAD;
 			inputUsage.clearValue = {};
 
-			m_registerResourceCallback(texture, RESOURCE_TYPE::TEXTURE, inputUsage);
-			m_inputResources.set(resourceIndex); // Same physical resource index
+			m_pRenderGraph->RegisterResource(texture, RESOURCE_TYPE::TEXTURE, inputUsage, clampedRange);
+			m_inputResources.Set(resourceIndex); // Same physical resource index
 		}
 	}
 
@@ -673,8 +915,8 @@ namespace PHX
 		usage.storeOp = ATTACHMENT_STORE_OP::INVALID;
 		usage.loadOp = ATTACHMENT_LOAD_OP::INVALID;
 
-		const ResourceIndex resourceIndex = m_registerResourceCallback(buffer, RESOURCE_TYPE::BUFFER, usage);
-		m_outputResources.set(resourceIndex);
+		const ResourceIndex resourceIndex = m_pRenderGraph->RegisterResource(buffer, RESOURCE_TYPE::BUFFER, usage);
+		m_outputResources.Set(resourceIndex);
 	}
 
 	void RenderPassVk::SetAccelerationStructureOutput(AccelerationStructureHandle accelerationStructure)
@@ -688,8 +930,8 @@ namespace PHX
 		usage.storeOp = ATTACHMENT_STORE_OP::INVALID;
 		usage.loadOp = ATTACHMENT_LOAD_OP::INVALID;
 
-		const ResourceIndex resourceIndex = m_registerResourceCallback(accelerationStructure, RESOURCE_TYPE::ACCELERATION_STRUCTURE, usage);
-		m_outputResources.set(resourceIndex);
+		const ResourceIndex resourceIndex = m_pRenderGraph->RegisterResource(accelerationStructure, RESOURCE_TYPE::ACCELERATION_STRUCTURE, usage);
+		m_outputResources.Set(resourceIndex);
 	}
 
 	void RenderPassVk::SetPipelineDescription(const GraphicsPipelineDesc& graphicsPipelineDesc)
@@ -745,11 +987,36 @@ namespace PHX
 		m_execCallback = callback;
 	}
 
+	void RenderPassVk::SetAsyncCompute(bool asyncCompute)
+	{
+		if (m_passType != PASS_TYPE::COMPUTE)
+		{
+#if defined(PHX_DEBUG)
+			LogError("Failed to set async compute for render pass \"%s\". Async compute is only supported in compute passes!", m_debugName);
+#else
+			LogError("Failed to set async compute. Async compute is only supported in compute passes!");
+#endif
+			return;
+		}
+
+		m_isAsyncCompute = asyncCompute;
+	}
+
+	void RenderPassVk::MarkAsRoot()
+	{
+		m_isRootPass = true;
+	}
+
 	//--------------------------------------------------------------------------------------------
 
-	RenderGraphVk::RenderGraphVk(RenderDeviceVk* pRenderDevice) : m_pRenderDevice(nullptr), m_deviceContextHandles(), m_currentFrameGraphHash(0), m_uniqueVisualizationHashes(),
-		m_frameInFlightIndex(0), m_frameNumber(0), m_reservedDepthBufferNameCRC(HashCRC32(s_pReservedDepthBufferName)), m_presentResID(0), m_didExecuteWork(false),
-		m_metrics(), m_queryPool(VK_NULL_HANDLE), m_timestampPeriod(0.0f)
+	RenderGraphVk::RenderGraphVk(RenderDeviceVk* pRenderDevice) : m_pRenderDevice(nullptr), m_pTransientResourcePool(nullptr), m_deviceContextHandles(), m_pWorkerPool(nullptr),
+		m_workerDeviceContextHandles(), m_workerMetrics(), m_parallelRecordedPasses(), m_renderPassPool(), m_usedRenderPassCount(0), m_passBatchIndices(),
+		m_producerBatchIndices(), m_clearValues(), m_transientLifetimes(), m_workerContexts(), m_workerResults(), m_frameStorageGrowths(0), m_countedStorageCapacity(0),
+		m_splitBarrierEvents(), m_removedStageBits(0), m_currentFrameGraphHash(0), m_uniqueVisualizationHashes(),
+		m_frameInFlightIndex(0), m_frameNumber(0), m_reservedDepthBufferNameCRC(HashCRC32(s_pReservedDepthBufferName)), m_presentResID(0),
+		m_hasSubresourceRanges(false), m_overlappingResources(), m_bakedRenderGraphs(), m_bakeKey(), m_pCurrentBakedRenderGraph(nullptr), m_needsBakedStateRestore(false), m_objectCacheVersion(0), m_bakeCacheHits(0), m_bakeCacheMisses(0),
+		m_metrics(), m_queryPool(VK_NULL_HANDLE), m_timestampPeriod(0.0f), m_passTimestampQueryPool(VK_NULL_HANDLE), m_passStatisticsQueryPool(VK_NULL_HANDLE),
+		m_passMetrics(), m_passMetricNames(), m_queryRing(), m_queryRingIndex(0)
 	{
 		if (pRenderDevice == nullptr)
 		{
@@ -776,16 +1043,45 @@ namespace PHX
 			m_deviceContextHandles.push_back(deviceContext);
 		}
 
+		// Worker device contexts for parallel recording. Each worker records with its own command pools
+		const u32 recordingThreadCount = m_pRenderDevice->GetRecordingThreadCount();
+		if (recordingThreadCount > 0)
+		{
+			for (u32 i = 0; i < framesInFlight; i++)
+			{
+				for (u32 workerIndex = 0; workerIndex < recordingThreadCount; workerIndex++)
+				{
+					DeviceContextCreateInfo deviceContextCI{};
+					deviceContextCI.assignedFrameIndex = i;
+
+					DeviceContextHandle deviceContext;
+					STATUS_CODE res = m_pRenderDevice->AllocateWorkerDeviceContext(deviceContextCI, workerIndex, deviceContext);
+					if (res != STATUS_CODE::SUCCESS)
+					{
+						LogError("Failed to construct render graph. Worker device context creation failed!");
+						return;
+					}
+					m_workerDeviceContextHandles.push_back(deviceContext);
+				}
+			}
+
+			m_workerMetrics.resize(recordingThreadCount);
+			m_pWorkerPool = new WorkerPool(recordingThreadCount);
+		}
+
+		m_pTransientResourcePool = new TransientResourcePool(m_pRenderDevice);
+
 		// Create timestamp query pool for GPU frame time metrics
 		if (GetSettings().gatherMetrics)
 		{
 			m_timestampPeriod = static_cast<float>(m_pRenderDevice->GetDeviceProperties().limits.timestampPeriod);
+			m_queryRing.resize(framesInFlight + 1);
+			const u32 queryRingSize = static_cast<u32>(m_queryRing.size());
 
 			VkQueryPoolCreateInfo queryPoolCI{};
 			queryPoolCI.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
-			// TODO: Look into using VK_QUERY_TYPE_PIPELINE_STATISTICS for pipeline stats (vertex shader invocations, clipping primitives, etc.)
 			queryPoolCI.queryType = VK_QUERY_TYPE_TIMESTAMP;
-			queryPoolCI.queryCount = framesInFlight * 2; // 2 queries per frame-in-flight (begin + end)
+			queryPoolCI.queryCount = queryRingSize * 2; // 2 queries per query ring slot (begin + end)
 
 			VkResult vkRes = vkCreateQueryPool(m_pRenderDevice->GetLogicalDevice(), &queryPoolCI, nullptr, &m_queryPool);
 			if (vkRes != VK_SUCCESS)
@@ -793,98 +1089,185 @@ namespace PHX
 				LogError("Failed to create timestamp query pool for metrics. Got error: \"%s\"", string_VkResult(vkRes));
 				m_queryPool = VK_NULL_HANDLE;
 			}
+
+			// Per-pass timestamps, 2 queries per pass (begin + end)
+			VkQueryPoolCreateInfo passQueryPoolCI{};
+			passQueryPoolCI.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+			passQueryPoolCI.queryType = VK_QUERY_TYPE_TIMESTAMP;
+			passQueryPoolCI.queryCount = queryRingSize * s_maxTimedPassCount * 2;
+
+			vkRes = vkCreateQueryPool(m_pRenderDevice->GetLogicalDevice(), &passQueryPoolCI, nullptr, &m_passTimestampQueryPool);
+			if (vkRes != VK_SUCCESS)
+			{
+				LogError("Failed to create pass timestamp query pool for metrics. Got error: \"%s\"", string_VkResult(vkRes));
+				m_passTimestampQueryPool = VK_NULL_HANDLE;
+			}
+
+			// Per-pass pipeline statistics, 1 query per pass
+			if (GetSettings().gatherPipelineStatistics)
+			{
+				if (m_pRenderDevice->GetDeviceFeatures().pipelineStatisticsQuery)
+				{
+					passQueryPoolCI.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+					passQueryPoolCI.queryCount = queryRingSize * s_maxTimedPassCount;
+					passQueryPoolCI.pipelineStatistics = s_passPipelineStatistics;
+
+					vkRes = vkCreateQueryPool(m_pRenderDevice->GetLogicalDevice(), &passQueryPoolCI, nullptr, &m_passStatisticsQueryPool);
+					if (vkRes != VK_SUCCESS)
+					{
+						LogError("Failed to create pipeline statistics query pool for metrics. Got error: \"%s\"", string_VkResult(vkRes));
+						m_passStatisticsQueryPool = VK_NULL_HANDLE;
+					}
+				}
+				else
+				{
+					LogWarning("Pipeline statistics were requested, but the device doesn't support pipeline statistics queries. Ignoring");
+				}
+			}
 		}
 	}
 
 	RenderGraphVk::~RenderGraphVk()
 	{
+		SAFE_DEL(m_pWorkerPool);
+		m_workerDeviceContextHandles.clear();
 		m_deviceContextHandles.clear();
-		m_registeredRenderPasses.DeleteAll();
+
+		m_registeredRenderPasses.Clear();
+		for (RenderPassVk* pRenderPass : m_renderPassPool)
+		{
+			SAFE_DEL(pRenderPass);
+		}
+		m_renderPassPool.clear();
+
+		// Transient resources may still be in use by frames in flight
+		if (m_pTransientResourcePool != nullptr)
+		{
+			m_pRenderDevice->WaitIdle();
+			SAFE_DEL(m_pTransientResourcePool);
+		}
 
 		if (m_queryPool != VK_NULL_HANDLE)
 		{
 			vkDestroyQueryPool(m_pRenderDevice->GetLogicalDevice(), m_queryPool, nullptr);
 			m_queryPool = VK_NULL_HANDLE;
 		}
+
+		if (m_passTimestampQueryPool != VK_NULL_HANDLE)
+		{
+			vkDestroyQueryPool(m_pRenderDevice->GetLogicalDevice(), m_passTimestampQueryPool, nullptr);
+			m_passTimestampQueryPool = VK_NULL_HANDLE;
+		}
+
+		if (m_passStatisticsQueryPool != VK_NULL_HANDLE)
+		{
+			vkDestroyQueryPool(m_pRenderDevice->GetLogicalDevice(), m_passStatisticsQueryPool, nullptr);
+			m_passStatisticsQueryPool = VK_NULL_HANDLE;
+		}
 	}
 
 	STATUS_CODE RenderGraphVk::BeginFrame(SwapChainHandle swapChain)
 	{
-		PROFILE_SCOPE("RenderGraphVk_BeginFrame");
-
 		if (!swapChain.IsValid())
 		{
 			LogError("Failed to begin frame. Swap chain handle is invalid!");
 			return STATUS_CODE::ERR_API;
 		}
 
-		STATUS_CODE res = STATUS_CODE::SUCCESS;
+		SwapChainVk* swapChainVk = static_cast<SwapChainVk*>(m_pRenderDevice->ResolveHandle(swapChain));
+		ASSERT_PTR(swapChainVk);
+
+		return BeginFrameInternal(swapChainVk);
+	}
+
+	STATUS_CODE RenderGraphVk::EndFrame(SwapChainHandle swapChain)
+	{
+		if (!swapChain.IsValid())
+		{
+			LogError("Failed to end frame. Swap chain handle is invalid!");
+			return STATUS_CODE::ERR_API;
+		}
 
 		SwapChainVk* swapChainVk = static_cast<SwapChainVk*>(m_pRenderDevice->ResolveHandle(swapChain));
 		ASSERT_PTR(swapChainVk);
 
+		return EndFrameInternal(swapChainVk);
+	}
+
+	STATUS_CODE RenderGraphVk::BeginFrame()
+	{
+		return BeginFrameInternal(nullptr);
+	}
+
+	STATUS_CODE RenderGraphVk::EndFrame()
+	{
+		return EndFrameInternal(nullptr);
+	}
+
+	STATUS_CODE RenderGraphVk::BeginFrameInternal(SwapChainVk* pSwapChain)
+	{
+		PROFILE_SCOPE("RenderGraphVk_BeginFrame");
+
+		STATUS_CODE res = STATUS_CODE::SUCCESS;
+
 		DeviceContextVk* pDeviceContext = static_cast<DeviceContextVk*>(GetCurrentDeviceContext());
 		ASSERT_PTR(pDeviceContext);
 
-		// Metrics
+		// Reset all per-frame metrics to default values
 		if (GetSettings().gatherMetrics)
 		{
-			// Reset all per-frame metrics to default values
 			m_metrics = Metrics{};
+		}
 
-			// Read back timestamp query results from the previous frame.
-			// Guarded by m_didExecuteWork so that we can safely wait on
-			// the query results if work was submitted, otherwise no waiting is done
-			const bool canQueryResults = m_queryPool != VK_NULL_HANDLE && m_frameNumber > 0;
-			if (m_didExecuteWork && canQueryResults)
-			{
-				PROFILE_SCOPE("RenderGraphVk_BeginFrame_GatherMetrics");
+		res = pDeviceContext->BeginFrame(pSwapChain);
+		if (res != STATUS_CODE::SUCCESS)
+		{
+			LogError("Failed to begin frame. Device context could not begin frame!");
+			return res;
+		}
 
-				u32 prevFrameIndex = (m_frameInFlightIndex == 0) ? (m_pRenderDevice->GetFramesInFlight() - 1) : (m_frameInFlightIndex - 1);
-				u64 timestamps[2] = { 0, 0 };
-				VkResult vkRes = vkGetQueryPoolResults(
-					m_pRenderDevice->GetLogicalDevice(),
-					m_queryPool,
-					prevFrameIndex * 2,
-					2,
-					sizeof(timestamps),
-					timestamps,
-					sizeof(u64),
-					VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+		// Worker device contexts recorded into the batches of the device context, so its fence wait covers them as well
+		if (m_pWorkerPool != nullptr)
+		{
+			const u32 workerCount = m_pWorkerPool->GetWorkerCount();
+			for (u32 workerIndex = 0; workerIndex < workerCount; workerIndex++)
+			{
+				DeviceContextVk* pWorkerContext = static_cast<DeviceContextVk*>(HANDLE_UTILS::ResolveHandle(m_workerDeviceContextHandles[m_frameInFlightIndex * workerCount + workerIndex]));
+				ASSERT_PTR(pWorkerContext);
 
-				if (vkRes == VK_SUCCESS)
+				res = pWorkerContext->BeginWorkerFrame();
+				if (res != STATUS_CODE::SUCCESS)
 				{
-					u64 diff = timestamps[1] - timestamps[0];
-					m_metrics.gpuFrameTime = static_cast<float>(diff) * m_timestampPeriod / 1e6f;
+					LogError("Failed to begin frame. Worker device context could not begin frame!");
+					return res;
 				}
 			}
 		}
 
-		res = pDeviceContext->BeginFrame(swapChainVk);
-		if (res != STATUS_CODE::SUCCESS)
+		// Only safe once the device context has waited for the frame that previously used it
+		m_pTransientResourcePool->BeginFrame(m_frameNumber);
+
+		// Same goes for the queries of that frame
+		if (GetSettings().gatherMetrics && !m_queryRing.empty())
 		{
-			LogError("Failed to begin frame. Device context could not begin frame!");
-			return res;
-		}
+			ReadQueryResults();
+
+			m_queryRingIndex = m_frameNumber % static_cast<u32>(m_queryRing.size());
 
-		m_didExecuteWork = false;
+			QueryRingSlot& slot = m_queryRing[m_queryRingIndex];
+			slot.passQueryRecords.clear();
+			slot.frameNumber = m_frameNumber;
+			slot.hasQueries = false;
+			slot.isPending = false;
+		}
 
 		return res;
 	}
 
-	STATUS_CODE RenderGraphVk::EndFrame(SwapChainHandle swapChain)
+	STATUS_CODE RenderGraphVk::EndFrameInternal(SwapChainVk* pSwapChain)
 	{
 		PROFILE_SCOPE("RenderGraphVk_EndFrame");
 
-		if (!swapChain.IsValid())
-		{
-			LogError("Failed to begin frame. Swap chain handle is invalid!");
-			return STATUS_CODE::ERR_API;
-		}
-
-		SwapChainVk* swapChainVk = static_cast<SwapChainVk*>(m_pRenderDevice->ResolveHandle(swapChain));
-		ASSERT_PTR(swapChainVk);
-
 		STATUS_CODE res = STATUS_CODE::SUCCESS;
 
 		DeviceContextVk* pDeviceContext = static_cast<DeviceContextVk*>(GetCurrentDeviceContext());
@@ -897,24 +1280,29 @@ namespace PHX
 			pDeviceContext->WriteEndTimestamp();
 		}
 
-		res = pDeviceContext->EndFrame(swapChainVk);
+		res = pDeviceContext->EndFrame(pSwapChain);
 		if (res != STATUS_CODE::SUCCESS)
 		{
 			LogError("Failed to end frame #%u. Device context could not flush!", m_frameNumber);
 		}
 
-		// Present
+		// Present. Headless frames are done once their work is submitted
 		if (res == STATUS_CODE::SUCCESS && pDeviceContext->WasWorkFlushed())
 		{
-			res = swapChainVk->Present();
-			if (res != STATUS_CODE::SUCCESS)
+			if (pSwapChain != nullptr)
 			{
-				LogError("Failed to end frame #%u. Swap chain present failed!", m_frameNumber);
+				res = pSwapChain->Present();
+				if (res != STATUS_CODE::SUCCESS)
+				{
+					LogError("Failed to end frame #%u. Swap chain present failed!", m_frameNumber);
+				}
 			}
-			else
+
+			if (res == STATUS_CODE::SUCCESS && !m_queryRing.empty())
 			{
-				// Cache work submitted so next frame can use this information
-				m_didExecuteWork = true;
+				// The frame's queries only get results once the frame is submitted
+				QueryRingSlot& slot = m_queryRing[m_queryRingIndex];
+				slot.isPending = slot.hasQueries;
 			}
 		}
 
@@ -922,10 +1310,17 @@ namespace PHX
 		m_frameInFlightIndex = (m_frameInFlightIndex + 1) % m_pRenderDevice->GetFramesInFlight();
 		m_frameNumber++;
 
-		m_registeredRenderPasses.DeleteAll();
+		// Render passes are kept in the pool for the next frame
+		m_registeredRenderPasses.Clear();
+		m_usedRenderPassCount = 0;
+		m_frameStorageGrowths = 0;
+		m_pCurrentBakedRenderGraph = nullptr;
+		m_needsBakedStateRestore = false;
 
 		m_resourceUsages.clear();
 		m_physicalResources.clear();
+		std::fill(m_physicalResourceIndices.begin(), m_physicalResourceIndices.end(), PhysicalResourceIndex{ 0, MAX_REGISTERED_RESOURCES });
+		m_hasSubresourceRanges = false;
 
 		PROFILE_LOOP("Frame");
 
@@ -934,12 +1329,18 @@ namespace PHX
 
 	STATUS_CODE RenderGraphVk::RegisterPass(const char* passName, PASS_TYPE passType, RenderPassHandle& renderPass)
 	{
-		// TODO - Reconcile with HANDLE_UTILS functions
-		auto registerResourceFuncPtr = std::bind(&RenderGraphVk::RegisterResource, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
+		// Render passes registered in previous frames are reused, so the pool only grows when a frame registers more
+		// passes than any frame before it
+		if (m_usedRenderPassCount == static_cast<u32>(m_renderPassPool.size()))
+		{
+			m_renderPassPool.push_back(new RenderPassVk(this));
+			m_frameStorageGrowths++;
+		}
 
-		RenderPassVk* newRenderPass = new RenderPassVk(passName, passType, 0u, registerResourceFuncPtr);
+		// TODO - Reconcile with HANDLE_UTILS functions
+		RenderPassVk* newRenderPass = m_renderPassPool[m_usedRenderPassCount++];
 		const u32 passIndex = m_registeredRenderPasses.Allocate(newRenderPass);
-		newRenderPass->m_index = passIndex;
+		newRenderPass->Reset(passName, passType, passIndex);
 
 		// NOTE - Manually call PopulateHandle() from HandleAccessor vs using HANDLE_UTILS, 
 		// since that inserts an InterfaceT pointer into an array
@@ -947,209 +1348,201 @@ namespace PHX
 		return STATUS_CODE::SUCCESS;
 	}
 
-	STATUS_CODE RenderGraphVk::Bake(SwapChainHandle swapChain)
+	STATUS_CODE RenderGraphVk::CreateTransientTexture(const TextureBaseCreateInfo& baseCreateInfo, const TextureViewCreateInfo& viewCreateInfo, const TextureSamplerCreateInfo& samplerCreateInfo, TextureHandle& texture)
 	{
-		PROFILE_SCOPE("RenderGraphVk_Bake");
+		return m_pTransientResourcePool->AcquireTexture(baseCreateInfo, viewCreateInfo, samplerCreateInfo, texture);
+	}
 
-		STATUS_CODE res = STATUS_CODE::SUCCESS;
+	STATUS_CODE RenderGraphVk::CreateTransientBuffer(const BufferCreateInfo& createInfo, BufferHandle& buffer)
+	{
+		return m_pTransientResourcePool->AcquireBuffer(createInfo, buffer);
+	}
 
+	STATUS_CODE RenderGraphVk::Bake(SwapChainHandle swapChain)
+	{
 		// Resolve the current swapchain image and compute its resource ID.
 		// All passes writing the swapchain target this same handle for the current frame.
 		TextureHandle currentImage = swapChain.GetCurrentImage();
 		m_presentResID = HashResource(currentImage, RESOURCE_TYPE::TEXTURE);
 
-		// Create the render graph tree using the following steps:
-		// 1. Find the render pass that owns presentation (last pass writing to the swapchain image)
-		u32 finalRPIndex = FindPresentRenderPassIndex(m_presentResID);
-		if (finalRPIndex == s_invalidRenderPassIndex)
-		{
-			LogError("Failed to bake render graph. No render pass writes to the swapchain image!");
-			return STATUS_CODE::ERR_INTERNAL;
-		}
-		
-		// 2. Once that render pass is found, build the dependency tree
-		BuildDependencyTree(finalRPIndex);
+		return BakeInternal();
+	}
 
-		// 3. [TRIMMING] Accumulate all contributing render passes into a separate container for the render graph. This is done so that
-		//               all non-contributing passes are indirectly trimmed
-		std::vector<u32> activeRenderPassIndices;
-		activeRenderPassIndices.reserve(m_registeredRenderPasses.Size());
-		FindActivePasses(finalRPIndex, activeRenderPassIndices);
+	STATUS_CODE RenderGraphVk::Bake()
+	{
+		// Nothing is presented, so no pass owns presentation
+		m_presentResID = 0;
 
-		CalculateResourceBarriers(activeRenderPassIndices, finalRPIndex);
+		return BakeInternal();
+	}
 
-		// 4. [COMBINATION] Combine as many separate render passes into one for optimal GPU usage
-		// TODO
-		
-		// Now that the render graph has been generated, run through it and perform the following steps for each render pass:
-		// 1. Declare the resources that will get used in the device context
-		// 2. Insert resource barriers and/or perform layout transitions as necessary
-		// 3. Call the execute callback and pass in the device context
-		std::reverse(activeRenderPassIndices.begin(), activeRenderPassIndices.end());
+	STATUS_CODE RenderGraphVk::BakeInternal()
+	{
+		PROFILE_SCOPE("RenderGraphVk_Bake");
 
-		DeviceContextVk* pDeviceContext = static_cast<DeviceContextVk*>(GetCurrentDeviceContext());
-		DeviceContextHandle deviceContext = GetCurrentDeviceContextHandle();
+		STATUS_CODE res = STATUS_CODE::SUCCESS;
 
-		// Inject metrics pointer and query pool so draw/uniform stats are accumulated during pass execution
-		// and GPU timestamps bracket the entire frame's command buffer workload
-		if (GetSettings().gatherMetrics)
+		const auto bakeStartTime = std::chrono::high_resolution_clock::now();
+
+		// Baked render graphs hold on to render pass and framebuffer objects from the render device's
+		// caches, so they're all discarded whenever any of those objects are destroyed (e.g. on resize)
+		const u32 objectCacheVersion = m_pRenderDevice->GetObjectCacheVersion();
+		if (objectCacheVersion != m_objectCacheVersion)
 		{
-			pDeviceContext->SetMetricsPointer(&m_metrics);
-			if (m_queryPool != VK_NULL_HANDLE)
-			{
-				pDeviceContext->SetQueryPool(m_queryPool, m_frameInFlightIndex * 2);
-			}
+			m_bakedRenderGraphs.clear();
+			m_objectCacheVersion = objectCacheVersion;
 		}
 
-		for (u32 activeRenderPassIndex : activeRenderPassIndices)
+		BuildBakeKey(m_bakeKey);
+
+		size_t bakeKeyHash = 0;
+		for (u64 keyWord : m_bakeKey)
 		{
-			const RenderPassVk& currRenderPass = *m_registeredRenderPasses.Get(activeRenderPassIndex);
+			HashCombine(bakeKeyHash, keyWord);
+		}
 
-			// Before calling execution callback, insert all barriers required by the render pass
-			res = InsertResourceBarriers(currRenderPass);
-			if (res != STATUS_CODE::SUCCESS)
-			{
-				LogError("Failed to bake render graph. Could not insert dependency barriers!");
-				return res;
-			}
+		auto bakedIter = m_bakedRenderGraphs.find(bakeKeyHash);
+		if (bakedIter != m_bakedRenderGraphs.end() && bakedIter->second.key != m_bakeKey)
+		{
+			// A different render graph with the same hash. Bake this one from scratch and let it take over the entry
+			m_bakedRenderGraphs.erase(bakedIter);
+			bakedIter = m_bakedRenderGraphs.end();
+		}
 
-			// Insert a label for GPU operations
+		if (bakedIter != m_bakedRenderGraphs.end())
+		{
+			// Same render graph as a previous frame, replay it
+			m_bakeCacheHits++;
+			m_needsBakedStateRestore = true;
+		}
+		else
+		{
+			m_bakeCacheMisses++;
+			m_needsBakedStateRestore = false;
+
+			// Create the render graph tree using the following steps:
+			// 1. Find the root render passes: the one that owns presentation (last pass writing to the swapchain image)
+			//    and the ones marked as root
+			const u32 finalRPIndex = (m_presentResID != 0) ? FindPresentRenderPassIndex(m_presentResID) : s_invalidRenderPassIndex;
+			if (m_presentResID != 0 && finalRPIndex == s_invalidRenderPassIndex)
 			{
-				const QUEUE_TYPE passQueueType = ConvertPassTypeToQueueType(currRenderPass.m_passType);
-#if defined(PHX_DEBUG)
-				const char* passName = currRenderPass.m_debugName;
-#else
-				const char* passName = "UnnamedPass";
-#endif
-				pDeviceContext->BeginLabel(passQueueType, passName);
+				LogError("Failed to bake render graph. No render pass writes to the swapchain image!");
+				return STATUS_CODE::ERR_INTERNAL;
 			}
 
-			switch (currRenderPass.m_passType)
+			std::vector<u32> rootRenderPassIndices;
+			FindRootPasses(finalRPIndex, rootRenderPassIndices);
+			if (rootRenderPassIndices.empty())
 			{
-				case PASS_TYPE::GRAPHICS:
-				{
-					// Get or create render pass (refers to internal cache)
-					VkRenderPass renderPassVk = CreateRenderPass(currRenderPass);
-		
-					// Get or create framebuffer from render device (refers to internal cache)
-					// isBackbuffer: true if this pass writes the swapchain image (triggers resize invalidation)
-					const bool isBackbuffer = PassWritesResource(currRenderPass.m_index, m_presentResID);
-					FramebufferVk* pFramebuffer = CreateFramebuffer(currRenderPass, renderPassVk, isBackbuffer);
-
-					// Build per-attachment clear values from each output's ResourceUsage.clearValue
-					std::vector<ClearValues> clearValues;
-					TraverseRenderPassOutputs(currRenderPass.m_index, [&](const RenderResource& resource)
-					{
-						if (resource.type != RESOURCE_TYPE::TEXTURE)
-						{
-							return;
-						}
-						const ResourceUsage* usage = GetResourceUsageFromPass(currRenderPass, resource.resourceID);
-						if (usage != nullptr)
-						{
-							clearValues.push_back(usage->clearValue);
-						}
-					});
+				LogError("Failed to bake headless render graph. No render pass was marked as root!");
+				return STATUS_CODE::ERR_API;
+			}
 
-					res = pDeviceContext->BeginRenderPass(renderPassVk, pFramebuffer, clearValues.data(), static_cast<u32>(clearValues.size()));
-					if (res != STATUS_CODE::SUCCESS)
-					{
-						LogError("Failed to bake render pass. Device context could not begin render pass!");
-						return res;
-					}
+			// 2. Once those render passes are found, build the dependency tree. Passes using overlapping subresource ranges
+			//    of the same texture depend on each other just like passes using the same resource
+			FindOverlappingResources();
+			BuildDependencyTree(rootRenderPassIndices);
 
-					// Determine if this pass has a pipeline description. Clear-only passes
-					// register as graphics passes with texture outputs but no shaders, so they only need the
-					// render pass begin/end to perform attachment clears.
-					const bool hasPipeline = (currRenderPass.graphicsDesc.shaderCount > 0 && currRenderPass.graphicsDesc.pShaders != nullptr);
+			// 3. [TRIMMING] Accumulate all contributing render passes into a separate container for the render graph. This is done so that
+			//               all non-contributing passes are indirectly trimmed
+			std::vector<u32> activeRenderPassIndices;
+			activeRenderPassIndices.reserve(m_registeredRenderPasses.Size());
+			FindActivePasses(rootRenderPassIndices, activeRenderPassIndices);
 
-					if (hasPipeline)
-					{
-						PipelineVk* pPipeline = CreatePipeline(currRenderPass, renderPassVk);
-						pDeviceContext->SetContextualPipeline(pPipeline);
-					}
+			CalculateResourceBarriers(activeRenderPassIndices, finalRPIndex);
 
-					CallExecutionCallback(currRenderPass, deviceContext);
+			std::reverse(activeRenderPassIndices.begin(), activeRenderPassIndices.end());
 
-					if (hasPipeline)
-					{
-						pDeviceContext->ResetContextualPipeline();
-					}
+			// 4. [COMBINATION] Combine as many separate render passes into one for optimal GPU usage. Merged passes become
+			//                  subpasses, so their attachments can stay in tile memory instead of round-tripping through VRAM
+			std::vector<u32> firstSubpasses;
+			CombineRenderPasses(activeRenderPassIndices, firstSubpasses);
 
-					res = pDeviceContext->EndRenderPass();
-					if (res != STATUS_CODE::SUCCESS)
+			// Keep the cache bounded. Render graphs which alternate between a handful of shapes (e.g. one per
+			// swapchain image) stay well below the limit, so the one that went unused the longest is evicted
+			if (m_bakedRenderGraphs.size() >= s_maxBakedRenderGraphs)
+			{
+				auto lruIter = m_bakedRenderGraphs.begin();
+				for (auto iter = m_bakedRenderGraphs.begin(); iter != m_bakedRenderGraphs.end(); iter++)
+				{
+					if (iter->second.lastUsedFrame < lruIter->second.lastUsedFrame)
 					{
-						LogError("Failed to bake render graph. Device context could not end render pass!");
-						return res;
+						lruIter = iter;
 					}
-
-					// Update the layout of the render pass' textures to reflect the implicit 
-					// layout transition from the render pass
-					UpdateTextureLayouts(activeRenderPassIndex);
-
-					break;
 				}
-				case PASS_TYPE::COMPUTE:
-				{
-					// Get or create pipeline from render device (refes to internal cache)
-					// NOTE - The render pass isn't used for compute pipeline creation, so it can
-					// be ignored by passing in VK_NULL_HANDLE
-					PipelineVk* pPipeline = CreatePipeline(currRenderPass, VK_NULL_HANDLE);
+				m_bakedRenderGraphs.erase(lruIter);
+			}
 
-					pDeviceContext->SetContextualPipeline(pPipeline);
-					CallExecutionCallback(currRenderPass, deviceContext);
-					pDeviceContext->ResetContextualPipeline();
+			// Baking from scratch allocates the new cache entry along with its scratch containers
+			bakedIter = m_bakedRenderGraphs.emplace(bakeKeyHash, BakedRenderGraph{}).first;
+			bakedIter->second.key = m_bakeKey;
+			m_frameStorageGrowths++;
+			BuildBakedRenderGraph(activeRenderPassIndices, firstSubpasses, bakedIter->second);
+			bakedIter->second.removedStageBits = m_removedStageBits;
 
-					break;
-				}
-				case PASS_TYPE::TRANSFER:
-				{
-					// Transfer-only passes do not use a pipeline
-					CallExecutionCallback(currRenderPass, deviceContext);
+			// Hash the state of the render graph after baking
+			bakedIter->second.graphHash = HashState();
+		}
 
-					break;
-				}
-				case PASS_TYPE::RAY_TRACING:
-				{
-					// Get or create pipeline from render device
-					// NOTE - The render pass isn't used for ray tracing pipeline creation, so it can
-					// be ignored by passing in VK_NULL_HANDLE
-					PipelineVk* pPipeline = CreatePipeline(currRenderPass, VK_NULL_HANDLE);
+		BakedRenderGraph& bakedRenderGraph = bakedIter->second;
+		bakedRenderGraph.lastUsedFrame = m_frameNumber;
+		m_pCurrentBakedRenderGraph = &bakedRenderGraph;
+		m_currentFrameGraphHash = bakedRenderGraph.graphHash;
 
-					pDeviceContext->SetContextualPipeline(pPipeline);
-					CallExecutionCallback(currRenderPass, deviceContext);
-					pDeviceContext->ResetContextualPipeline();
+		res = PlaceTransientResources(bakedRenderGraph);
+		if (res != STATUS_CODE::SUCCESS)
+		{
+			LogError("Failed to bake render graph. Could not place transient resources!");
+			m_pCurrentBakedRenderGraph = nullptr;
+			m_bakedRenderGraphs.erase(bakedIter);
+			return res;
+		}
 
-					// Update the layout of the render pass' textures to reflect the implicit
-					// layout transition from the render pass
-					UpdateTextureLayouts(activeRenderPassIndex);
+		const std::chrono::duration<float, std::milli> bakeTime = std::chrono::high_resolution_clock::now() - bakeStartTime;
 
-					break;
-				}
-				case PASS_TYPE::AS_BUILD:
-				{
-					// AS build passes do not use a pipeline or render pass — just execute the callback
-					CallExecutionCallback(currRenderPass, deviceContext);
+		DeviceContextVk* pDeviceContext = static_cast<DeviceContextVk*>(GetCurrentDeviceContext());
 
-					break;
-				}
+		// Inject metrics pointer and query pool so draw/uniform stats are accumulated during pass execution
+		// and GPU timestamps bracket the entire frame's command buffer workload
+		if (GetSettings().gatherMetrics)
+		{
+			pDeviceContext->SetMetricsPointer(&m_metrics);
+			if (m_queryPool != VK_NULL_HANDLE)
+			{
+				pDeviceContext->SetQueryPool(m_queryPool, m_queryRingIndex * 2);
 			}
 
-			// End the label for this pass
-			pDeviceContext->EndLabel(ConvertPassTypeToQueueType(currRenderPass.m_passType));
+			if (!m_queryRing.empty())
+			{
+				m_queryRing[m_queryRingIndex].hasQueries = true;
+			}
 		}
 
+		res = ExecuteBakedRenderGraph(bakedRenderGraph);
 
 		// Clear metrics pointer after pass execution
 		if (GetSettings().gatherMetrics)
 		{
 			pDeviceContext->ResetMetricsPointer();
-			m_metrics.passCount = static_cast<u32>(activeRenderPassIndices.size());
+			m_metrics.passCount = static_cast<u32>(bakedRenderGraph.passes.size());
+			m_metrics.bakeCacheHits = m_bakeCacheHits;
+			m_metrics.bakeCacheMisses = m_bakeCacheMisses;
+			m_metrics.bakeTime = bakeTime.count();
+			m_metrics.removedStageBits = bakedRenderGraph.removedStageBits;
+			m_metrics.transientMemoryBytes = m_pTransientResourcePool->GetAllocatedBytes();
+			m_metrics.transientMemoryUnaliasedBytes = m_pTransientResourcePool->GetUnaliasedBytes();
+
+			CountFrameStorageGrowths();
+			m_metrics.frameStorageGrowths = m_frameStorageGrowths;
 		}
 
-		// Hash the state of the render graph after baking
-		// and store it in the map
-		m_currentFrameGraphHash = HashState();
+		if (res != STATUS_CODE::SUCCESS)
+		{
+			// Don't replay a render graph that failed to execute, bake it from scratch next time instead
+			m_needsBakedStateRestore = false;
+			m_pCurrentBakedRenderGraph = nullptr;
+			m_bakedRenderGraphs.erase(bakedIter);
+		}
 
 		return res;
 	}
@@ -1175,10 +1568,18 @@ namespace PHX
 		m_metrics.uniformCollectionCount = m_pRenderDevice->GetUniformCollectionCount();
 		m_metrics.accelerationStructureCount = m_pRenderDevice->GetAccelerationStructureCount();
 		m_metrics.allocatedMemoryBytes = m_pRenderDevice->GetAllocatedMemoryBytes();
+		m_metrics.stagingMemoryBytes = m_pRenderDevice->GetStagingBufferPool()->GetAllocatedBytes();
+		m_metrics.peakStagingMemoryBytes = m_pRenderDevice->GetStagingBufferPool()->GetPeakAllocatedBytes();
 
 		return m_metrics;
 	}
 
+	const PassMetrics* RenderGraphVk::GetPassMetrics(u32& out_passCount) const
+	{
+		out_passCount = static_cast<u32>(m_passMetrics.size());
+		return m_passMetrics.empty() ? nullptr : m_passMetrics.data();
+	}
+
 	STATUS_CODE RenderGraphVk::GenerateVisualization(const char* fileName, bool generateIfUnique)
 	{
 		if (fileName == nullptr)
@@ -1203,6 +1604,13 @@ namespace PHX
 			}
 		}
 
+		// Render passes replayed from a baked render graph never had their dependencies or barriers calculated
+		if (m_needsBakedStateRestore && m_pCurrentBakedRenderGraph != nullptr)
+		{
+			RestoreBakedRenderGraph(*m_pCurrentBakedRenderGraph);
+			m_needsBakedStateRestore = false;
+		}
+
 		// Builds a verbose barrier tooltip (stage + access masks) shown on hover in SVG output
 		auto buildBarrierTooltip = [&](const Barrier& barrier) -> std::string
 		{
@@ -1264,11 +1672,19 @@ namespace PHX
 		dot << "\tedge [fontname=\"Helvetica\", fontsize=9, arrowsize=0.8];\n\n";
 
 		// Gather active passes to mark trimmed passes
-		const u32 finalRPIndex = FindPresentRenderPassIndex(m_presentResID);
-		ASSERT(finalRPIndex != s_invalidRenderPassIndex);
+		const u32 finalRPIndex = (m_presentResID != 0) ? FindPresentRenderPassIndex(m_presentResID) : s_invalidRenderPassIndex;
+		std::vector<u32> rootPasses;
+		FindRootPasses(finalRPIndex, rootPasses);
+		ASSERT(!rootPasses.empty());
 		std::vector<u32> activePasses;
 		activePasses.reserve(m_registeredRenderPasses.Size());
-		FindActivePasses(finalRPIndex, activePasses);
+		FindActivePasses(rootPasses, activePasses);
+
+		std::vector<bool> isActivePass(m_registeredRenderPasses.Size(), false);
+		for (u32 passIndex : activePasses)
+		{
+			isActivePass[passIndex] = true;
+		}
 
 		// ---- Render pass nodes (rounded boxes, colored by bind point) ----
 		dot << "\t// Render passes\n";
@@ -1281,16 +1697,7 @@ namespace PHX
 			}
 
 			// Determine if this pass is trimmed
-			// TODO - slow
-			bool isTrimmed = true;
-			for (u32 j = 0; j < activePasses.size(); j++)
-			{
-				if (activePasses[j] == pRenderPass->m_index)
-				{
-					isTrimmed = false;
-					break;
-				}
-			}
+			const bool isTrimmed = !isActivePass[pRenderPass->m_index];
 
 #if defined(PHX_DEBUG)
 			const char* passName = pRenderPass->m_debugName;
@@ -1321,12 +1728,42 @@ namespace PHX
 			dot << "\tpass" << pRenderPass->m_index
 				<< " [shape=box, style=\"filled,rounded\", fontcolor=\"" << COLOR_TEXT_PRIMARY << "\", margin=\"0.25,0.14\""
 				<< ", fillcolor=\"" << fillColor << "\"";
-			if (isFinalPass)  dot << ", penwidth=3, color=\"" << HUE_RED << "\"";
-			else              dot << ", penwidth=1, color=\"" << COLOR_BORDER_DEFAULT << "\"";
+			if (isFinalPass)                     dot << ", penwidth=3, color=\"" << HUE_RED << "\"";
+			else if (pRenderPass->m_isRootPass)  dot << ", penwidth=3, color=\"" << COLOR_TEXT_PRIMARY << "\"";
+			else                                 dot << ", penwidth=1, color=\"" << COLOR_BORDER_DEFAULT << "\"";
 
 			dot << ", label=<<b>" << passName << "</b><br/><font point-size=\"9\">" << passTypeStr;
-			if (isFinalPass)  dot << " &#8226; FINAL";
-			dot << "</font>>];\n";
+			if (isFinalPass)                     dot << " &#8226; FINAL";
+			else if (pRenderPass->m_isRootPass)  dot << " &#8226; ROOT";
+			dot << "</font>";
+
+			// Annotate the pass with its latest GPU metrics, if it was timed
+			auto passMetricsIter = std::find_if(m_passMetrics.begin(), m_passMetrics.end(), [&](const PassMetrics& passMetrics)
+			{
+				return strcmp(passMetrics.name, passName) == 0;
+			});
+			if (!isTrimmed && passMetricsIter != m_passMetrics.end())
+			{
+				char gpuTimeStr[32];
+				snprintf(gpuTimeStr, sizeof(gpuTimeStr), "%.3f ms", passMetricsIter->gpuTime);
+
+				dot << "<br/><font point-size=\"8\" color=\"" << COLOR_TEXT_SECONDARY << "\">" << gpuTimeStr;
+				if (passMetricsIter->hasPipelineStatistics)
+				{
+					if (pRenderPass->m_passType == PASS_TYPE::GRAPHICS)
+					{
+						dot << "<br/>VS " << passMetricsIter->vertexShaderInvocations << " &#8226; prims " << passMetricsIter->clippingPrimitives
+							<< " &#8226; FS " << passMetricsIter->fragmentShaderInvocations;
+					}
+					else
+					{
+						dot << "<br/>CS " << passMetricsIter->computeShaderInvocations;
+					}
+				}
+				dot << "</font>";
+			}
+
+			dot << ">];\n";
 		}
 
 		dot << "\n";
@@ -1409,16 +1846,7 @@ namespace PHX
 			}
 
 			// Determine if this pass is trimmed
-			// TODO - slow
-			bool isTrimmed = true;
-			for (u32 j = 0; j < activePasses.size(); j++)
-			{
-				if (activePasses[j] == pRenderPass->m_index)
-				{
-					isTrimmed = false;
-					break;
-				}
-			}
+			const bool isTrimmed = !isActivePass[pRenderPass->m_index];
 
 			const std::string passNode = "pass" + std::to_string(pRenderPass->m_index);
 
@@ -1429,10 +1857,10 @@ namespace PHX
 
 				std::string label;
 				std::string tooltip;
-				auto barrierIter = pRenderPass->m_inputBarriers.find(resource.resourceID);
-				if (barrierIter != pRenderPass->m_inputBarriers.end())
+				const Barrier* pBarrier = FindBarrier(pRenderPass->m_inputBarriers, resource.resourceID);
+				if (pBarrier != nullptr)
 				{
-					const Barrier& barrier = barrierIter->second;
+					const Barrier& barrier = *pBarrier;
 					if (resource.type == RESOURCE_TYPE::TEXTURE)
 					{
 						label = RG_UTILS::ShortImageLayout(barrier.oldLayout) + "\\n-> " + RG_UTILS::ShortImageLayout(barrier.newLayout);
@@ -1454,10 +1882,10 @@ namespace PHX
 
 				std::string label;
 				std::string tooltip;
-				auto barrierIter = pRenderPass->m_outputBarriers.find(resource.resourceID);
-				if (barrierIter != pRenderPass->m_outputBarriers.end())
+				const Barrier* pBarrier = FindBarrier(pRenderPass->m_outputBarriers, resource.resourceID);
+				if (pBarrier != nullptr)
 				{
-					const Barrier& barrier = barrierIter->second;
+					const Barrier& barrier = *pBarrier;
 					if (resource.type == RESOURCE_TYPE::TEXTURE)
 					{
 						label = "-> " + RG_UTILS::ShortImageLayout(barrier.newLayout);
@@ -1487,6 +1915,7 @@ namespace PHX
 		dot << "\t\t<TR><TD BGCOLOR=\"" << ShiftColor(HUE_PURPLE, SHADE_BRIGHT) << "\" WIDTH=\"24\"> </TD><TD ALIGN=\"LEFT\">Ray tracing pass</TD></TR>\n";
 		dot << "\t\t<TR><TD BGCOLOR=\"" << ShiftColor(HUE_TEAL,   SHADE_BRIGHT) << "\" WIDTH=\"24\"> </TD><TD ALIGN=\"LEFT\">AS build pass</TD></TR>\n";
 		dot << "\t\t<TR><TD BGCOLOR=\"" << HUE_GREY                       << "\" WIDTH=\"24\"> </TD><TD ALIGN=\"LEFT\">Trimmed pass (not executed)</TD></TR>\n";
+		dot << "\t\t<TR><TD BGCOLOR=\"" << COLOR_PANEL_FILL << "\" BORDER=\"3\" COLOR=\"" << COLOR_TEXT_PRIMARY << "\" WIDTH=\"24\"> </TD><TD ALIGN=\"LEFT\">Root pass (never trimmed)</TD></TR>\n";
 
 		dot << "\t\t<TR><TD COLSPAN=\"2\"><FONT POINT-SIZE=\"10\"><B>Resources</B></FONT></TD></TR>\n";
 		dot << "\t\t<TR><TD BGCOLOR=\"" << ShiftColor(HUE_BLUE,   SHADE_DARK) << "\" BORDER=\"1\" COLOR=\"" << HUE_BLUE   << "\" WIDTH=\"24\"> </TD><TD ALIGN=\"LEFT\">Texture</TD></TR>\n";
@@ -1600,268 +2029,1575 @@ namespace PHX
 		}
 	}
 
-	VkRenderPass RenderGraphVk::CreateRenderPass(const RenderPassVk& renderPass)
+	VkRenderPass RenderGraphVk::CreateRenderPass(const BakedRenderPass* pSubpasses, u32 subpassCount)
 	{
 		PROFILE_SCOPE("RenderGraphVk_CreateRenderPass");
 
-		RenderPassDescription renderPassDesc{};
-		renderPassDesc.attachments.reserve(renderPass.m_outputResources.size());
-		renderPassDesc.subpasses.reserve(1); // TODO - Support multiple subpasses
-
-		SubpassDescription subpassDesc{};
-		subpassDesc.bindPoint = RG_UTILS::ConvertPassTypeToBindPoint(renderPass.m_passType);
+		const BakedRenderPass& firstSubpass = pSubpasses[0];
+		const u32 attachmentCount = static_cast<u32>(firstSubpass.attachments.size());
 
-		// Incremented every iteration of TraverseRenderPassOutputs below
-		u32 localResourceIndex = 0;
+		RenderPassDescription renderPassDesc{};
+		renderPassDesc.attachments.resize(attachmentCount);
+		renderPassDesc.subpasses.resize(subpassCount);
 
-		TraverseRenderPassOutputs(renderPass.m_index, [&](const RenderResource& outputResource)
+		auto FindAttachmentIndex = [&](ResourceIndex resourceIndex) -> u32
 		{
-			if (outputResource.type != RESOURCE_TYPE::TEXTURE)
+			for (u32 i = 0; i < attachmentCount; i++)
 			{
-				// Ignore any non-texture output resources
-				return;
+				if (firstSubpass.attachments[i] == resourceIndex)
+				{
+					return i;
+				}
 			}
+			return U32_MAX;
+		};
 
-			TextureVk* pTexture = ResolveTexture(outputResource);
+		// Attachments start off in whatever layout they're currently in, and follow the implicit layout
+		// transitions of every subpass to find the layout they're left in at the end of the render pass
+		std::vector<bool> isReferenced(attachmentCount, false);
+		std::vector<bool> isWritten(attachmentCount, false);
+		for (u32 i = 0; i < attachmentCount; i++)
+		{
+			const RenderResource& attachment = m_physicalResources[firstSubpass.attachments[i]];
+			TextureVk* pTexture = ResolveTexture(attachment);
 			ASSERT_PTR(pTexture);
 
-			AttachmentDescription attDesc{};
+			AttachmentDescription& attDesc = renderPassDesc.attachments[i];
 			attDesc.pTexture = pTexture;
-
-			const ResourceUsage* resourceUsage = GetResourceUsageFromPass(renderPass, outputResource.resourceID);
-			if (resourceUsage == nullptr)
+			attDesc.initialLayout = pTexture->GetLayout(pTexture->GetSubresourceRange(attachment.subresourceRange));
+			if (attDesc.initialLayout == VK_IMAGE_LAYOUT_MAX_ENUM)
 			{
-				ASSERT_ALWAYS("Failed to create render pass. Render pass uses physical resource but has no usage for it?");
-				return;
+				// The array layers of the attachment's mip level are in different layouts. Their contents are discarded
+				LogWarning("Attachment \"%s\" is in multiple layouts at the start of the render pass. Its contents will be undefined!", GetResourceName(attachment));
+				attDesc.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 			}
+			attDesc.finalLayout = attDesc.initialLayout;
+		}
 
-			// Use the pre-computed barrier information as a sub-pass dependency in this case
-			auto iter = renderPass.m_outputBarriers.find(outputResource.resourceID);
-			if (iter == renderPass.m_outputBarriers.end())
-			{
-				// If we can't find any output barriers and the render pass didn't get trimmed, this
-				// means that it's the backbuffer pass since no other pass depends on it
-				ASSERT_ALWAYS("Failed to find output barrier for render pass?");
-			}
-			else
-			{
-				const Barrier& outputBarrier = iter->second;
+		for (u32 subpassIndex = 0; subpassIndex < subpassCount; subpassIndex++)
+		{
+			const BakedRenderPass& bakedSubpass = pSubpasses[subpassIndex];
+			const RenderPassVk& renderPass = *m_registeredRenderPasses.Get(bakedSubpass.passIndex);
 
-				attDesc.initialLayout = pTexture->GetLayout();
-				attDesc.layout = outputBarrier.oldLayout;
-				attDesc.finalLayout = outputBarrier.newLayout;
+			SubpassDescription& subpassDesc = renderPassDesc.subpasses[subpassIndex];
+			subpassDesc.bindPoint = RG_UTILS::ConvertPassTypeToBindPoint(renderPass.m_passType);
 
-				subpassDesc.srcAccessMask |= outputBarrier.srcAccessMask;
-				subpassDesc.dstAccessMask |= outputBarrier.dstAccessMask;
-				subpassDesc.srcStageMask |= outputBarrier.srcStageMask;
-				subpassDesc.dstStageMask |= outputBarrier.dstStageMask;
+			for (const BakedLayoutTransition& inputLayout : bakedSubpass.inputAttachmentLayouts)
+			{
+				const u32 attachmentIndex = FindAttachmentIndex(inputLayout.resourceIndex);
+				ASSERT_MSG(attachmentIndex != U32_MAX, "Input attachment is not an attachment of the render pass?");
 
-				switch (resourceUsage->attachmentType)
+				AttachmentDescription& attDesc = renderPassDesc.attachments[attachmentIndex];
+				if (!isReferenced[attachmentIndex])
 				{
-				case ATTACHMENT_TYPE::COLOR:
-				{
-					attDesc.loadOp = ATT_UTILS::ConvertLoadOp(resourceUsage->loadOp);
-					attDesc.storeOp = ATT_UTILS::ConvertStoreOp(resourceUsage->storeOp);
-
-					subpassDesc.colorAttachmentIndices.push_back(localResourceIndex);
-					break;
+					// Produced before the render pass, so the contents must be preserved
+					attDesc.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+					attDesc.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+					attDesc.layout = inputLayout.layout;
+					isReferenced[attachmentIndex] = true;
 				}
-				case ATTACHMENT_TYPE::DEPTH:
-				{
-					attDesc.loadOp = ATT_UTILS::ConvertLoadOp(resourceUsage->loadOp);
-					attDesc.storeOp = ATT_UTILS::ConvertStoreOp(resourceUsage->storeOp);
 
-					ASSERT_MSG(subpassDesc.depthStencilAttachmentIndex == -1, "Already assigned the depth stencil attachment index!");
-					subpassDesc.depthStencilAttachmentIndex = localResourceIndex;
-					break;
-				}
-				case ATTACHMENT_TYPE::STENCIL:
+				subpassDesc.inputAttachments.push_back({ attachmentIndex, inputLayout.layout });
+				attDesc.finalLayout = inputLayout.layout;
+			}
+
+			TraverseRenderPassOutputs(renderPass.m_index, [&](const RenderResource& outputResource)
+			{
+				if (outputResource.type != RESOURCE_TYPE::TEXTURE)
 				{
-					attDesc.stencilLoadOp = ATT_UTILS::ConvertLoadOp(resourceUsage->loadOp);
-					attDesc.stencilStoreOp = ATT_UTILS::ConvertStoreOp(resourceUsage->storeOp);
+					// Ignore any non-texture output resources
+					return;
+				}
 
-					ASSERT_MSG(subpassDesc.depthStencilAttachmentIndex == -1, "Already assigned the depth stencil attachment index!");
-					subpassDesc.depthStencilAttachmentIndex = localResourceIndex;
-					break;
+				const u32 attachmentIndex = FindAttachmentIndex(GetPhysicalResourceIndex(outputResource.resourceID));
+				if (attachmentIndex == U32_MAX)
+				{
+					ASSERT_ALWAYS("Failed to create render pass. Render pass output is not an attachment of the render pass?");
+					return;
 				}
-				case ATTACHMENT_TYPE::DEPTH_STENCIL:
+
+				const ResourceUsage* resourceUsage = GetResourceUsageFromPass(renderPass, outputResource.resourceID);
+				if (resourceUsage == nullptr)
 				{
-					// TODO - Should this be considered a stencil or regular load/store op?
-					attDesc.loadOp = ATT_UTILS::ConvertLoadOp(resourceUsage->loadOp);
-					attDesc.storeOp = ATT_UTILS::ConvertStoreOp(resourceUsage->storeOp);
+					ASSERT_ALWAYS("Failed to create render pass. Render pass uses physical resource but has no usage for it?");
+					return;
+				}
 
-					ASSERT_MSG(subpassDesc.depthStencilAttachmentIndex == -1, "Already assigned the depth stencil attachment index!");
-					subpassDesc.depthStencilAttachmentIndex = localResourceIndex;
-					break;
+				AttachmentDescription& attDesc = renderPassDesc.attachments[attachmentIndex];
+
+				// Use the pre-computed barrier information as a sub-pass dependency in this case
+				const Barrier* pOutputBarrier = FindBarrier(renderPass.m_outputBarriers, outputResource.resourceID);
+				if (pOutputBarrier == nullptr)
+				{
+					// If we can't find any output barriers and the render pass didn't get trimmed, this
+					// means that it's the backbuffer pass since no other pass depends on it
+					ASSERT_ALWAYS("Failed to find output barrier for render pass?");
 				}
-				case ATTACHMENT_TYPE::RESOLVE:
+				else
 				{
-					attDesc.loadOp = ATT_UTILS::ConvertLoadOp(resourceUsage->loadOp);
-					attDesc.storeOp = ATT_UTILS::ConvertStoreOp(resourceUsage->storeOp);
+					const Barrier& outputBarrier = *pOutputBarrier;
 
-					ASSERT_MSG(subpassDesc.resolveAttachmentIndex == -1, "Already assigned the resolve attachment index!");
-					subpassDesc.resolveAttachmentIndex = localResourceIndex;
-					break;
+					attDesc.layout = outputBarrier.oldLayout;
+
+					subpassDesc.srcAccessMask |= outputBarrier.srcAccessMask;
+					subpassDesc.dstAccessMask |= outputBarrier.dstAccessMask;
+					subpassDesc.srcStageMask |= outputBarrier.srcStageMask;
+					subpassDesc.dstStageMask |= outputBarrier.dstStageMask;
+
+					// The load op is taken from the first subpass that uses the attachment, and the store op from the last one that writes to it
+					const bool isFirstUse = !isReferenced[attachmentIndex];
+					switch (resourceUsage->attachmentType)
+					{
+					case ATTACHMENT_TYPE::COLOR:
+					{
+						attDesc.loadOp = isFirstUse ? ATT_UTILS::ConvertLoadOp(resourceUsage->loadOp) : attDesc.loadOp;
+						attDesc.storeOp = ATT_UTILS::ConvertStoreOp(resourceUsage->storeOp);
+
+						subpassDesc.colorAttachmentIndices.push_back(attachmentIndex);
+						break;
+					}
+					case ATTACHMENT_TYPE::DEPTH:
+					{
+						attDesc.loadOp = isFirstUse ? ATT_UTILS::ConvertLoadOp(resourceUsage->loadOp) : attDesc.loadOp;
+						attDesc.storeOp = ATT_UTILS::ConvertStoreOp(resourceUsage->storeOp);
+
+						ASSERT_MSG(subpassDesc.depthStencilAttachmentIndex == -1, "Already assigned the depth stencil attachment index!");
+						subpassDesc.depthStencilAttachmentIndex = attachmentIndex;
+						break;
+					}
+					case ATTACHMENT_TYPE::STENCIL:
+					{
+						attDesc.stencilLoadOp = isFirstUse ? ATT_UTILS::ConvertLoadOp(resourceUsage->loadOp) : attDesc.stencilLoadOp;
+						attDesc.stencilStoreOp = ATT_UTILS::ConvertStoreOp(resourceUsage->storeOp);
+
+						ASSERT_MSG(subpassDesc.depthStencilAttachmentIndex == -1, "Already assigned the depth stencil attachment index!");
+						subpassDesc.depthStencilAttachmentIndex = attachmentIndex;
+						break;
+					}
+					case ATTACHMENT_TYPE::DEPTH_STENCIL:
+					{
+						// TODO - Should this be considered a stencil or regular load/store op?
+						attDesc.loadOp = isFirstUse ? ATT_UTILS::ConvertLoadOp(resourceUsage->loadOp) : attDesc.loadOp;
+						attDesc.storeOp = ATT_UTILS::ConvertStoreOp(resourceUsage->storeOp);
+
+						ASSERT_MSG(subpassDesc.depthStencilAttachmentIndex == -1, "Already assigned the depth stencil attachment index!");
+						subpassDesc.depthStencilAttachmentIndex = attachmentIndex;
+						break;
+					}
+					case ATTACHMENT_TYPE::RESOLVE:
+					{
+						attDesc.loadOp = isFirstUse ? ATT_UTILS::ConvertLoadOp(resourceUsage->loadOp) : attDesc.loadOp;
+						attDesc.storeOp = ATT_UTILS::ConvertStoreOp(resourceUsage->storeOp);
+
+						ASSERT_MSG(subpassDesc.resolveAttachmentIndex == -1, "Already assigned the resolve attachment index!");
+						subpassDesc.resolveAttachmentIndex = attachmentIndex;
+						break;
+					}
+					}
 				}
+
+				isReferenced[attachmentIndex] = true;
+				isWritten[attachmentIndex] = true;
+			});
+
+			for (const BakedLayoutTransition& layoutTransition : bakedSubpass.layoutTransitions)
+			{
+				const u32 attachmentIndex = FindAttachmentIndex(layoutTransition.resourceIndex);
+				if (attachmentIndex != U32_MAX)
+				{
+					renderPassDesc.attachments[attachmentIndex].finalLayout = layoutTransition.layout;
 				}
 			}
 
-			renderPassDesc.attachments.push_back(attDesc);
+			// Dependencies on earlier subpasses replace the barriers that would otherwise be inserted between the passes
+			for (const DependencyInfo& dependencyInfo : renderPass.m_dependencyInfos)
+			{
+				for (u32 srcSubpassIndex = 0; srcSubpassIndex < subpassIndex; srcSubpassIndex++)
+				{
+					if (pSubpasses[srcSubpassIndex].passIndex != dependencyInfo.renderPass->m_index)
+					{
+						continue;
+					}
+
+					SubpassDependencyDescription dependencyDesc{};
+					dependencyDesc.srcSubpass = srcSubpassIndex;
+					dependencyDesc.dstSubpass = subpassIndex;
+					TraverseResources(dependencyInfo.resources, [&](const RenderResource& resource)
+					{
+						const Barrier* pInputBarrier = FindBarrier(renderPass.m_inputBarriers, resource.resourceID);
+						if (pInputBarrier != nullptr)
+						{
+							const Barrier& inputBarrier = *pInputBarrier;
+							dependencyDesc.srcAccessMask |= inputBarrier.srcAccessMask;
+							dependencyDesc.dstAccessMask |= inputBarrier.dstAccessMask;
+							dependencyDesc.srcStageMask |= inputBarrier.srcStageMask;
+							dependencyDesc.dstStageMask |= inputBarrier.dstStageMask;
+						}
+					});
 
-			localResourceIndex++;
-		});
+					renderPassDesc.dependencies.push_back(dependencyDesc);
+				}
+			}
+		}
 
-		renderPassDesc.subpasses.push_back(subpassDesc); // TODO - Support multiple subpasses
+		for (u32 i = 0; i < attachmentCount; i++)
+		{
+			AttachmentDescription& attDesc = renderPassDesc.attachments[i];
+			if (firstSubpass.discardedAttachments.Test(firstSubpass.attachments[i]))
+			{
+				// Nothing reads the attachment after the render pass, so it never has to leave tile memory
+				attDesc.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+				attDesc.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+			}
+			else if (!isWritten[i])
+			{
+				// Only read through input attachments. Store the contents anyway, since DONT_CARE would leave them undefined
+				attDesc.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+				attDesc.stencilStoreOp = VK_ATTACHMENT_STORE_OP_STORE;
+			}
+		}
 
 		// May return cached render pass if a match is found
 		VkRenderPass renderPassVk = m_pRenderDevice->GetOrCreateRenderPass(renderPassDesc);
 		return renderPassVk;
 	}
 
-	FramebufferVk* RenderGraphVk::CreateFramebuffer(const RenderPassVk& renderPass, VkRenderPass renderPassVk, bool isBackBuffer)
+	FramebufferVk* RenderGraphVk::CreateFramebuffer(const BakedRenderPass& firstSubpass, VkRenderPass renderPassVk, bool isBackBuffer)
 	{
 		PROFILE_SCOPE("RenderGraphVk_CreateFramebuffer");
 
 		std::vector<FramebufferAttachmentDesc> attachments;
-		attachments.reserve(renderPass.m_outputResources.size());
+		attachments.reserve(firstSubpass.attachments.size());
 
 		u32 maxWidth = 0;
 		u32 maxHeight = 0;
-		TraverseRenderPassOutputs(renderPass.m_index, [&](const RenderResource& outputResource)
+		for (u32 i = 0; i < static_cast<u32>(firstSubpass.attachments.size()); i++)
 		{
-			if (outputResource.type != RESOURCE_TYPE::TEXTURE)
-			{
-				return;
-			}
-
-			TextureVk* pAttachmentTex = ResolveTexture(outputResource);
+			const RenderResource& attachment = m_physicalResources[firstSubpass.attachments[i]];
+			TextureVk* pAttachmentTex = ResolveTexture(attachment);
 			if (pAttachmentTex == nullptr)
 			{
+				const RenderPassVk& renderPass = *m_registeredRenderPasses.Get(firstSubpass.passIndex);
 #if defined(PHX_DEBUG)
-				LogError("Failed to create framebuffer for render pass \"%s\"! Output texture resource does not have a valid texture pointer", renderPass.m_debugName);
+				LogError("Failed to create framebuffer for render pass \"%s\"! Attachment does not have a valid texture pointer", renderPass.m_debugName);
 #else
 				// TODO - Maybe create crc database and convert crc to string for log message?
-				LogError("Failed to create framebuffer for render pass \"%X\"! Output texture resource does not have a valid texture pointer", renderPass.m_name);
+				LogError("Failed to create framebuffer for render pass \"%X\"! Attachment does not have a valid texture pointer", renderPass.m_name);
 #endif
-				return;
+				continue;
 			}
 
-			const ResourceUsage* resourceUsage = GetResourceUsageFromPass(renderPass, outputResource.resourceID);
-			if (resourceUsage == nullptr)
-			{
-				ASSERT_ALWAYS("Failed to create framebuffer. Render pass uses physical resource but has no usage for it?");
-				return;
+			// Usage of the first subpass that uses the attachment
+			const ResourceUsage& resourceUsage = m_resourceUsages[firstSubpass.clearValueUsageIndices[i]];
+
+			FramebufferAttachmentDesc desc;
+			desc.pTexture = pAttachmentTex;
+			desc.mipTarget = (pAttachmentTex->GetViewScope() == VIEW_SCOPE::PER_MIP) ? attachment.subresourceRange.baseMipLevel : 0;
+			desc.type = resourceUsage.attachmentType;
+			desc.storeOp = resourceUsage.storeOp;
+			desc.loadOp = resourceUsage.loadOp;
+
+			attachments.push_back(desc);
+
+			u32 width = 0;
+			u32 height = 0;
+			CalculateAttachmentExtent(pAttachmentTex, attachment.subresourceRange, width, height);
+			maxWidth = Max(maxWidth, width);
+			maxHeight = Max(maxHeight, height);
+		}
+
+		FramebufferDescription framebufferCI{};
+		framebufferCI.width = maxWidth; // TODO - Revisit
+		framebufferCI.height = maxHeight; // TODO - Revisit
+		framebufferCI.layers = 1;
+		framebufferCI.pAttachments = attachments.data();
+		framebufferCI.attachmentCount = static_cast<u32>(attachments.size());
+		framebufferCI.renderPass = renderPassVk;
+		framebufferCI.isBackbuffer = isBackBuffer;
+		FramebufferVk* pFramebuffer = m_pRenderDevice->CreateFramebuffer(framebufferCI);
+		return pFramebuffer;
+	}
+
+	PipelineVk* RenderGraphVk::CreatePipeline(const RenderPassVk& renderPass, VkRenderPass renderPassVk, u32 subpassIndex)
+	{
+		PROFILE_SCOPE("RenderGraphVk_CreatePipeline");
+
+		PipelineVk* pipeline = nullptr;
+
+		PASS_TYPE renderPassBindPoint = renderPass.m_passType;
+		switch (renderPassBindPoint)
+		{
+		case PASS_TYPE::GRAPHICS:
+		{
+			pipeline = m_pRenderDevice->CreateGraphicsPipeline(renderPass.graphicsDesc, renderPassVk, subpassIndex);
+			break;
+		}
+		case PASS_TYPE::COMPUTE:
+		{
+			pipeline = m_pRenderDevice->CreateComputePipeline(renderPass.computeDesc);
+			break;
+		}
+		case PASS_TYPE::RAY_TRACING:
+		{
+			pipeline = m_pRenderDevice->CreateRayTracingPipeline(renderPass.rayTracingDesc);
+			break;
+		}
+		case PASS_TYPE::TRANSFER:
+		case PASS_TYPE::AS_BUILD:
+		{
+			// Transfer and AS build passes do not use pipelines
+			break;
+		}
+		default:
+		{
+			ASSERT_ALWAYS("Unknown pass type!");
+			break;
+		}
+		}
+
+		return pipeline;
+	}
+
+	ResourceIndex RenderGraphVk::RegisterResource(Handle resource, RESOURCE_TYPE type, const ResourceUsage& usage, const TextureSubresourceRange& subresourceRange)
+	{
+		const u64 resourceID = HashResource(resource, type, subresourceRange);
+		ResourceIndex physicalResourceIndex = GetPhysicalResourceIndex(resourceID);
+
+		if (physicalResourceIndex == MAX_REGISTERED_RESOURCES)
+		{
+			// Couldn't find existing physical resource, create one instead
+			const size_t numPhysicalResources = m_physicalResources.size();
+			if (numPhysicalResources >= MAX_REGISTERED_RESOURCES)
+			{
+				LogError("Failed to register resource. Physical resource limit (%u) reached!", MAX_REGISTERED_RESOURCES);
+				return 0;
+			}
+
+			// TODO - Defer physical resource creation until baking?
+			RenderResource newPhysicalResource{};
+			newPhysicalResource.handle = resource;
+			newPhysicalResource.resourceID = resourceID;
+			newPhysicalResource.type = type;
+			newPhysicalResource.subresourceRange = subresourceRange;
+			m_hasSubresourceRanges |= !IsEntireTexture(subresourceRange);
+
+			physicalResourceIndex = static_cast<ResourceIndex>(numPhysicalResources);
+			m_physicalResources.push_back(newPhysicalResource);
+			InsertPhysicalResourceIndex(resourceID, physicalResourceIndex);
+		}
+
+		// Create logical resource
+		ResourceUsage newUsage = usage;
+		newUsage.resourceID = resourceID;
+		m_resourceUsages.push_back(newUsage);
+
+		// Only the first usage of a resource is indexed per pass, which is the one GetResourceUsageFromPass() 
+		// returns (e.g. the output half of a LOAD-op attachment, rather than the input half)
+		RenderPassVk* pRenderPass = m_registeredRenderPasses.Get(usage.passIndex);
+		if (pRenderPass != nullptr)
+		{
+			const u32 usageIndex = static_cast<u32>(m_resourceUsages.size() - 1);
+			if (GetResourceUsageFromPass(*pRenderPass, resourceID) == nullptr)
+			{
+				pRenderPass->m_resourceUsageIndices.push_back({ resourceID, usageIndex });
+			}
+
+			if (type == RESOURCE_TYPE::TEXTURE && pRenderPass->m_passType == PASS_TYPE::TRANSFER && !pRenderPass->m_usesExclusiveTextures)
+			{
+				const TextureVk* pTexture = ResolveTexture(m_physicalResources[physicalResourceIndex]);
+				// Copies of sub-regions on a transfer queue family with a coarse copy granularity would have to move to the graphics
+				// queue, which the pass' synchronization doesn't account for, so such passes stay on the graphics queue as well
+				const VkExtent3D& granularity = m_pRenderDevice->GetTransferImageGranularity();
+				const bool hasUnitGranularity = (granularity.width == 1 && granularity.height == 1 && granularity.depth == 1);
+				pRenderPass->m_usesExclusiveTextures = (pTexture == nullptr || !pTexture->IsConcurrent() || !hasUnitGranularity);
+			}
+		}
+
+		return physicalResourceIndex;
+	}
+
+	void RenderGraphVk::FindOverlappingResources()
+	{
+		PROFILE_SCOPE("RenderGraphVk_FindOverlappingResources");
+
+		m_overlappingResources.resize(m_physicalResources.size());
+		for (std::vector<ResourceIndex>& overlappingResources : m_overlappingResources)
+		{
+			overlappingResources.clear();
+		}
+
+		// Every texture is a single physical resource unless it's used with subresource ranges
+		if (!m_hasSubresourceRanges)
+		{
+			return;
+		}
+
+		for (u32 i = 0; i < static_cast<u32>(m_physicalResources.size()); i++)
+		{
+			const RenderResource& resource = m_physicalResources[i];
+			if (resource.type != RESOURCE_TYPE::TEXTURE)
+			{
+				continue;
+			}
+
+			for (u32 j = i + 1; j < static_cast<u32>(m_physicalResources.size()); j++)
+			{
+				const RenderResource& otherResource = m_physicalResources[j];
+				if (otherResource.type == RESOURCE_TYPE::TEXTURE && otherResource.handle == resource.handle &&
+					SubresourceRangesOverlap(resource.subresourceRange, otherResource.subresourceRange))
+				{
+					m_overlappingResources[i].push_back(static_cast<ResourceIndex>(j));
+					m_overlappingResources[j].push_back(static_cast<ResourceIndex>(i));
+				}
+			}
+		}
+	}
+
+	const ResourceUsage* RenderGraphVk::GetOverlappingResourceUsageFromPass(const RenderPassVk& renderPass, ResourceIndex resourceIndex, u64& out_resourceID) const
+	{
+		out_resourceID = m_physicalResources[resourceIndex].resourceID;
+		const ResourceUsage* pUsage = GetResourceUsageFromPass(renderPass, out_resourceID);
+		if (pUsage != nullptr)
+		{
+			return pUsage;
+		}
+
+		for (ResourceIndex overlappingIndex : m_overlappingResources[resourceIndex])
+		{
+			out_resourceID = m_physicalResources[overlappingIndex].resourceID;
+			pUsage = GetResourceUsageFromPass(renderPass, out_resourceID);
+			if (pUsage != nullptr)
+			{
+				return pUsage;
+			}
+		}
+
+		return nullptr;
+	}
+
+	void RenderGraphVk::CombineRenderPasses(const std::vector<u32>& activeRenderPasses, std::vector<u32>& out_firstSubpasses)
+	{
+		PROFILE_SCOPE("RenderGraphVk_CombineRenderPasses");
+
+		out_firstSubpasses.resize(activeRenderPasses.size());
+
+		// State of the render pass currently being merged into
+		u32 firstSubpass = 0;
+		ResourceIndexBitset renderPassAttachments;
+		ResourceIndexBitset renderPassOutputs;
+		ResourceIndexBitset renderPassNonAttachments; // Resources used by the merged passes through anything but attachments
+		const TextureVk* pReferenceAttachment = nullptr;
+		u32 referenceWidth = 0;
+		u32 referenceHeight = 0;
+
+		for (u32 i = 0; i < static_cast<u32>(activeRenderPasses.size()); i++)
+		{
+			const RenderPassVk& renderPass = *m_registeredRenderPasses.Get(activeRenderPasses[i]);
+			const ResourceIndexBitset attachments = GetRenderPassAttachments(renderPass);
+			const ResourceIndexBitset nonAttachments = (renderPass.m_inputResources | renderPass.m_outputResources).Difference(attachments);
+
+			bool canMerge = (i > 0) && (renderPass.m_passType == PASS_TYPE::GRAPHICS) &&
+				(m_registeredRenderPasses.Get(activeRenderPasses[i - 1])->m_passType == PASS_TYPE::GRAPHICS);
+
+			// Merging is only worth it if the pass reads an attachment of the render pass at the same pixel
+			canMerge = canMerge && renderPass.m_inputAttachments.Intersects(renderPassOutputs);
+
+			// Attachments can't also be sampled or written to as storage images within the same render pass
+			canMerge = canMerge && !attachments.Intersects(renderPassNonAttachments) && !nonAttachments.Intersects(renderPassAttachments);
+
+			// Every dependency on the passes that were already merged must go through attachments
+			if (canMerge)
+			{
+				for (const DependencyInfo& dependencyInfo : renderPass.m_dependencyInfos)
+				{
+					bool isMergedDependency = false;
+					for (u32 j = firstSubpass; j < i; j++)
+					{
+						isMergedDependency |= (activeRenderPasses[j] == dependencyInfo.renderPass->m_index);
+					}
+
+					if (isMergedDependency && dependencyInfo.resources.Difference(attachments).Any())
+					{
+						canMerge = false;
+						break;
+					}
+				}
+			}
+
+			// All attachments of a framebuffer must have the same dimensions. Attachments sharing subresources with other
+			// ranges of the same texture can't be told apart by the checks above, so they're never merged
+			if (canMerge)
+			{
+				TraverseResources(attachments, [&](const RenderResource& resource)
+				{
+					const TextureVk* pTexture = ResolveTexture(resource);
+					if (pTexture == nullptr || pReferenceAttachment == nullptr ||
+						pTexture->GetSampleCount() != pReferenceAttachment->GetSampleCount() ||
+						!m_overlappingResources[GetPhysicalResourceIndex(resource.resourceID)].empty())
+					{
+						canMerge = false;
+						return;
+					}
+
+					u32 width = 0;
+					u32 height = 0;
+					CalculateAttachmentExtent(pTexture, resource.subresourceRange, width, height);
+					canMerge = canMerge && (width == referenceWidth) && (height == referenceHeight);
+				});
+			}
+
+			if (!canMerge)
+			{
+				// Start a new render pass
+				firstSubpass = i;
+				renderPassAttachments.Clear();
+				renderPassOutputs.Clear();
+				renderPassNonAttachments.Clear();
+				pReferenceAttachment = nullptr;
+			}
+
+			out_firstSubpasses[i] = firstSubpass;
+			renderPassAttachments |= attachments;
+			renderPassOutputs |= attachments.Difference(renderPass.m_inputAttachments);
+			renderPassNonAttachments |= nonAttachments;
+
+			if (pReferenceAttachment == nullptr)
+			{
+				TraverseResources(attachments, [&](const RenderResource& resource)
+				{
+					if (pReferenceAttachment == nullptr)
+					{
+						pReferenceAttachment = ResolveTexture(resource);
+						if (pReferenceAttachment != nullptr)
+						{
+							CalculateAttachmentExtent(pReferenceAttachment, resource.subresourceRange, referenceWidth, referenceHeight);
+						}
+					}
+				});
+			}
+		}
+	}
+
+	ResourceIndexBitset RenderGraphVk::GetRenderPassAttachments(const RenderPassVk& renderPass) const
+	{
+		ResourceIndexBitset attachments;
+		if (renderPass.m_passType != PASS_TYPE::GRAPHICS)
+		{
+			return attachments;
+		}
+
+		attachments = renderPass.m_inputAttachments;
+		renderPass.m_outputResources.ForEachSetBit([&](u32 resourceIndex)
+		{
+			if (m_physicalResources[resourceIndex].type == RESOURCE_TYPE::TEXTURE)
+			{
+				attachments.Set(resourceIndex);
+			}
+		});
+		return attachments;
+	}
+
+	bool RenderGraphVk::IsAsyncComputePass(const RenderPassVk& renderPass) const
+	{
+		return renderPass.m_isAsyncCompute && (renderPass.m_passType == PASS_TYPE::COMPUTE) && m_pRenderDevice->IsAsyncComputeSupported();
+	}
+
+	QUEUE_TYPE RenderGraphVk::GetPassQueueType(const RenderPassVk& renderPass) const
+	{
+		// Transfer passes only leave the graphics queue if there's a dedicated transfer queue family, and every texture they
+		// touch is shared with it. Attachments are never shared, so e.g. copies into render targets stay on the graphics queue
+		const QUEUE_TYPE queueType = ConvertPassTypeToQueueType(renderPass.m_passType);
+		if (queueType == QUEUE_TYPE::TRANSFER && (!m_pRenderDevice->IsDedicatedTransferSupported() || renderPass.m_usesExclusiveTextures))
+		{
+			return QUEUE_TYPE::GRAPHICS;
+		}
+
+		return queueType;
+	}
+
+	bool RenderGraphVk::IsCrossQueueFamilyDependency(const RenderPassVk& srcRenderPass, const RenderPassVk& dstRenderPass) const
+	{
+		return m_pRenderDevice->GetQueueFamilyIndex(GetPassQueueType(srcRenderPass)) != m_pRenderDevice->GetQueueFamilyIndex(GetPassQueueType(dstRenderPass));
+	}
+
+	void RenderGraphVk::BuildBakedRenderGraph(const std::vector<u32>& activeRenderPasses, const std::vector<u32>& firstSubpasses, BakedRenderGraph& out_bakedRenderGraph)
+	{
+		PROFILE_SCOPE("RenderGraphVk_BuildBakedRenderGraph");
+
+		const u32 activeRenderPassCount = static_cast<u32>(activeRenderPasses.size());
+
+		// Position of the last pass of the render pass every pass is merged into
+		std::vector<u32> lastSubpasses(activeRenderPassCount);
+		for (u32 i = activeRenderPassCount; i > 0; i--)
+		{
+			const u32 passPosition = i - 1;
+			const bool isLastSubpass = (i == activeRenderPassCount) || (firstSubpasses[i] != firstSubpasses[passPosition]);
+			lastSubpasses[passPosition] = isLastSubpass ? passPosition : lastSubpasses[i];
+		}
+
+		// Maps a physical resource index to its transient lifetime, if it's a transient resource
+		std::vector<u32> transientLifetimeIndices(m_physicalResources.size(), U32_MAX);
+
+		// Transient resources used by async compute passes. Passes on other queues may run at the same time, so these
+		// can't share memory with any other transient resource
+		ResourceIndexBitset asyncTransients;
+
+		// Position of every active pass in the execution order, indexed by the pass' registered index
+		std::vector<u32> activePositions(m_registeredRenderPasses.Size(), U32_MAX);
+		for (u32 i = 0; i < activeRenderPassCount; i++)
+		{
+			activePositions[activeRenderPasses[i]] = i;
+		}
+
+		// Split barriers are signaled and waited on with the synchronization2 event commands
+		const bool canSplitBarriers = m_pRenderDevice->IsSynchronization2Supported();
+
+		out_bakedRenderGraph.passes.resize(activeRenderPassCount);
+		for (u32 i = 0; i < activeRenderPassCount; i++)
+		{
+			const RenderPassVk& renderPass = *m_registeredRenderPasses.Get(activeRenderPasses[i]);
+			BakedRenderPass& bakedPass = out_bakedRenderGraph.passes[i];
+			bakedPass.passIndex = renderPass.m_index;
+
+			// Barriers and attachments of merged passes are held by the first subpass, since nothing can be
+			// recorded between the subpasses of a render pass
+			const u32 firstSubpass = firstSubpasses[i];
+			BakedRenderPass& bakedFirstSubpass = out_bakedRenderGraph.passes[firstSubpass];
+			bakedPass.subpassIndex = i - firstSubpass;
+			bakedPass.subpassCount = lastSubpasses[i] - firstSubpass + 1;
+
+			const ResourceIndexBitset attachments = GetRenderPassAttachments(renderPass);
+
+			// Resources this pass depends on from passes merged into the same render pass. These are synchronized
+			// through subpass dependencies instead
+			ResourceIndexBitset subpassDependencyResources;
+			for (const DependencyInfo& dependencyInfo : renderPass.m_dependencyInfos)
+			{
+				for (u32 j = firstSubpass; j < i; j++)
+				{
+					if (activeRenderPasses[j] == dependencyInfo.renderPass->m_index)
+					{
+						subpassDependencyResources |= dependencyInfo.resources;
+					}
+				}
+			}
+
+			(renderPass.m_inputResources | renderPass.m_outputResources).ForEachSetBit([&](u32 resourceIndex)
+			{
+				if (!m_pTransientResourcePool->IsTransient(m_physicalResources[resourceIndex].handle))
+				{
+					return;
+				}
+
+				// Lifetimes span entire render passes, since all attachments of a render pass are in use at the same time. Every
+				// subresource range of a texture shares the lifetime of the texture
+				const bool isAttachment = attachments.Test(resourceIndex);
+				u32& lifetimeIndex = transientLifetimeIndices[resourceIndex];
+				if (lifetimeIndex == U32_MAX && m_hasSubresourceRanges)
+				{
+					for (u32 j = 0; j < static_cast<u32>(out_bakedRenderGraph.transientLifetimes.size()); j++)
+					{
+						if (m_physicalResources[out_bakedRenderGraph.transientLifetimes[j].resourceIndex].handle == m_physicalResources[resourceIndex].handle)
+						{
+							lifetimeIndex = j;
+							break;
+						}
+					}
+				}
+
+				if (lifetimeIndex == U32_MAX)
+				{
+					lifetimeIndex = static_cast<u32>(out_bakedRenderGraph.transientLifetimes.size());
+					out_bakedRenderGraph.transientLifetimes.push_back({ static_cast<ResourceIndex>(resourceIndex), firstSubpass, lastSubpasses[i], isAttachment });
+					bakedFirstSubpass.transientFirstUses.push_back(static_cast<ResourceIndex>(resourceIndex));
+				}
+
+				BakedTransientLifetime& lifetime = out_bakedRenderGraph.transientLifetimes[lifetimeIndex];
+				lifetime.isAttachmentOnly = lifetime.isAttachmentOnly && isAttachment && (lifetime.firstUse == firstSubpass);
+				lifetime.lastUse = lastSubpasses[i];
+
+				if (IsAsyncComputePass(renderPass))
+				{
+					asyncTransients.Set(lifetime.resourceIndex);
+				}
+			});
+
+			for (const ResourceBarrier& resourceBarrier : renderPass.m_inputBarriers)
+			{
+				const u64 resourceID = resourceBarrier.resourceID;
+				const ResourceIndex resourceIndex = GetPhysicalResourceIndex(resourceID);
+				if (renderPass.m_passType == PASS_TYPE::GRAPHICS)
+				{
+					// HACK! We prevent barriers from being inserted for output textures that
+					// belong to a graphics pass. This is because the render pass implicitly performs
+					// these transitions, so we save work and also it's not possible to insert an explicit
+					// barrier to transition the backbuffer layout, so we must rely on the render pass implicit
+					// transitions anyway. I think ideally this logic would get moved to the CalculateResourceBarriers()
+					// function so that the barriers are never created to begin with
+					if (!RequiresExplicitResourceBarrier(renderPass, resourceID) || subpassDependencyResources.Test(resourceIndex))
+					{
+						continue;
+					}
+				}
+
+				const u32 signalPosition = canSplitBarriers ?
+					FindSplitBarrierSignalPosition(activeRenderPasses, activePositions, lastSubpasses, renderPass, firstSubpass, resourceIndex) : U32_MAX;
+				if (signalPosition == U32_MAX)
+				{
+					bakedFirstSubpass.barriers.push_back({ resourceIndex, resourceBarrier.barrier });
+					continue;
+				}
+
+				// All barriers between the same pair of passes share an event
+				u32 splitBarrierIndex = U32_MAX;
+				for (u32 waitIndex : bakedFirstSubpass.splitBarrierWaits)
+				{
+					if (out_bakedRenderGraph.splitBarriers[waitIndex].signalPosition == signalPosition)
+					{
+						splitBarrierIndex = waitIndex;
+						break;
+					}
+				}
+
+				if (splitBarrierIndex == U32_MAX)
+				{
+					splitBarrierIndex = static_cast<u32>(out_bakedRenderGraph.splitBarriers.size());
+					out_bakedRenderGraph.splitBarriers.push_back({ signalPosition, firstSubpass, {} });
+					out_bakedRenderGraph.passes[signalPosition].splitBarrierSignals.push_back(splitBarrierIndex);
+					bakedFirstSubpass.splitBarrierWaits.push_back(splitBarrierIndex);
+				}
+
+				out_bakedRenderGraph.splitBarriers[splitBarrierIndex].barriers.push_back({ resourceIndex, resourceBarrier.barrier });
+			}
+
+			// Only graphics and ray tracing passes perform implicit layout transitions
+			if (renderPass.m_passType == PASS_TYPE::GRAPHICS || renderPass.m_passType == PASS_TYPE::RAY_TRACING)
+			{
+				for (const ResourceBarrier& resourceBarrier : renderPass.m_outputBarriers)
+				{
+					const ResourceIndex resourceIndex = GetPhysicalResourceIndex(resourceBarrier.resourceID);
+					if (m_physicalResources[resourceIndex].type == RESOURCE_TYPE::TEXTURE)
+					{
+						bakedPass.layoutTransitions.push_back({ resourceIndex, resourceBarrier.barrier.newLayout });
+					}
+				}
+			}
+
+			if (renderPass.m_passType == PASS_TYPE::GRAPHICS)
+			{
+				// Per-attachment clear values come from each output's ResourceUsage.clearValue, which may
+				// change every frame without changing the render graph. Keep track of the usage instead
+				auto AddAttachment = [&](const RenderResource& resource)
+				{
+					const ResourceIndex resourceIndex = GetPhysicalResourceIndex(resource.resourceID);
+					std::vector<ResourceIndex>& renderPassAttachments = bakedFirstSubpass.attachments;
+					if (std::find(renderPassAttachments.begin(), renderPassAttachments.end(), resourceIndex) != renderPassAttachments.end())
+					{
+						return;
+					}
+
+					const ResourceUsage* usage = GetResourceUsageFromPass(renderPass, resource.resourceID);
+					if (usage != nullptr)
+					{
+						renderPassAttachments.push_back(resourceIndex);
+						bakedFirstSubpass.clearValueUsageIndices.push_back(static_cast<u32>(usage - m_resourceUsages.data()));
+					}
+				};
+
+				TraverseRenderPassOutputs(renderPass.m_index, [&](const RenderResource& resource)
+				{
+					if (resource.type == RESOURCE_TYPE::TEXTURE)
+					{
+						AddAttachment(resource);
+					}
+				});
+
+				TraverseResources(renderPass.m_inputAttachments, [&](const RenderResource& resource)
+				{
+					AddAttachment(resource);
+
+					const ResourceUsage* usage = GetResourceUsageFromPass(renderPass, resource.resourceID);
+					ASSERT_PTR(usage); // Should never be null
+					bakedPass.inputAttachmentLayouts.push_back({ GetPhysicalResourceIndex(resource.resourceID), CalculateResourceImageLayout(*usage, PASS_TYPE::GRAPHICS) });
+				});
+
+				// isBackbuffer: true if this pass writes the swapchain image (triggers resize invalidation)
+				bakedFirstSubpass.isBackbuffer |= PassWritesResource(renderPass.m_index, m_presentResID);
+			}
+
+			bakedPass.dependencies.reserve(renderPass.m_dependencyInfos.size());
+			for (const DependencyInfo& dependencyInfo : renderPass.m_dependencyInfos)
+			{
+				bakedPass.dependencies.push_back({ dependencyInfo.renderPass->m_index, dependencyInfo.resources });
+			}
+			bakedPass.inputBarriers = renderPass.m_inputBarriers;
+			bakedPass.outputBarriers = renderPass.m_outputBarriers;
+		}
+
+		for (BakedTransientLifetime& lifetime : out_bakedRenderGraph.transientLifetimes)
+		{
+			if (asyncTransients.Test(lifetime.resourceIndex))
+			{
+				lifetime.firstUse = 0;
+				lifetime.lastUse = activeRenderPassCount - 1;
+				lifetime.isAttachmentOnly = false;
+			}
+		}
+
+		// Transient attachments that never leave their render pass don't need to be stored
+		for (const BakedTransientLifetime& lifetime : out_bakedRenderGraph.transientLifetimes)
+		{
+			if (lifetime.isAttachmentOnly)
+			{
+				out_bakedRenderGraph.passes[lifetime.firstUse].discardedAttachments.Set(lifetime.resourceIndex);
+			}
+		}
+	}
+
+	STATUS_CODE RenderGraphVk::ExecuteBakedRenderGraph(BakedRenderGraph& bakedRenderGraph)
+	{
+		PROFILE_SCOPE("RenderGraphVk_ExecuteBakedRenderGraph");
+
+		if (m_pWorkerPool != nullptr)
+		{
+			return ExecuteBakedRenderGraphParallel(bakedRenderGraph);
+		}
+
+		STATUS_CODE res = STATUS_CODE::SUCCESS;
+
+		DeviceContextVk* pDeviceContext = static_cast<DeviceContextVk*>(GetCurrentDeviceContext());
+		DeviceContextHandle deviceContext = GetCurrentDeviceContextHandle();
+
+		// Now that the render graph has been baked, run through it and perform the following steps for each render pass:
+		// 1. Declare the resources that will get used in the device context
+		// 2. Insert resource barriers and/or perform layout transitions as necessary
+		// 3. Call the execute callback and pass in the device context
+		// Merged graphics passes are recorded as consecutive subpasses, so only their first subpass inserts barriers
+		std::vector<ClearValues>& clearValues = m_clearValues;
+		const BakedRenderPass* pFirstSubpass = nullptr; // First subpass of the render pass currently being recorded
+
+		// Submission batch every pass is recorded into, indexed by the pass' registered index. Batches only wait on
+		// the batches of the passes they depend on, so passes on different queues can overlap
+		std::vector<u32>& passBatchIndices = m_passBatchIndices;
+		std::vector<u32>& producerBatchIndices = m_producerBatchIndices;
+		passBatchIndices.assign(m_registeredRenderPasses.Size(), U32_MAX);
+
+		m_splitBarrierEvents.assign(bakedRenderGraph.splitBarriers.size(), VK_NULL_HANDLE);
+
+		for (u32 position = 0; position < static_cast<u32>(bakedRenderGraph.passes.size()); position++)
+		{
+			BakedRenderPass& bakedPass = bakedRenderGraph.passes[position];
+			const RenderPassVk& currRenderPass = *m_registeredRenderPasses.Get(bakedPass.passIndex);
+
+			res = PreparePassBatch(bakedPass, passBatchIndices, producerBatchIndices);
+			if (res != STATUS_CODE::SUCCESS)
+			{
+				return res;
+			}
+
+			// Before calling execution callback, insert all barriers required by the render pass
+			res = InsertPassBarriers(bakedRenderGraph, bakedPass);
+			if (res != STATUS_CODE::SUCCESS)
+			{
+				pDeviceContext->SetAsyncCompute(false);
+				pDeviceContext->SetTransferOnGraphicsQueue(false);
+				return res;
+			}
+
+			// Queries can't be reset inside a render pass, so the first subpass resets the queries of all subpasses
+			if (currRenderPass.m_passType != PASS_TYPE::GRAPHICS || bakedPass.subpassIndex == 0)
+			{
+				ResetPassQueries(pDeviceContext, currRenderPass, bakedPass, position);
+			}
+
+			// Insert a label for GPU operations
+			{
+				const QUEUE_TYPE passQueueType = GetPassQueueType(currRenderPass);
+#if defined(PHX_DEBUG)
+				const char* passName = currRenderPass.m_debugName;
+#else
+				const char* passName = "UnnamedPass";
+#endif
+				pDeviceContext->BeginLabel(passQueueType, passName);
+			}
+
+			switch (currRenderPass.m_passType)
+			{
+				case PASS_TYPE::GRAPHICS:
+				{
+					if (bakedPass.subpassIndex == 0)
+					{
+						pFirstSubpass = &bakedPass;
+
+						// The render pass and framebuffer are only looked up the first time a baked pass executes. Both depend on
+						// the texture layouts at this point of the frame, so they can't be looked up ahead of time when baking
+						if (bakedPass.renderPass == VK_NULL_HANDLE)
+						{
+							// Get or create render pass (refers to internal cache)
+							bakedPass.renderPass = CreateRenderPass(&bakedPass, bakedPass.subpassCount);
+
+							// Get or create framebuffer from render device (refers to internal cache)
+							bakedPass.pFramebuffer = CreateFramebuffer(bakedPass, bakedPass.renderPass, bakedPass.isBackbuffer);
+						}
+
+						clearValues.clear();
+						for (u32 usageIndex : bakedPass.clearValueUsageIndices)
+						{
+							clearValues.push_back(m_resourceUsages[usageIndex].clearValue);
+						}
+
+						res = pDeviceContext->BeginRenderPass(bakedPass.renderPass, bakedPass.pFramebuffer, clearValues.data(), static_cast<u32>(clearValues.size()));
+						if (res != STATUS_CODE::SUCCESS)
+						{
+							LogError("Failed to bake render pass. Device context could not begin render pass!");
+							return res;
+						}
+					}
+					else
+					{
+						res = pDeviceContext->NextSubpass();
+						if (res != STATUS_CODE::SUCCESS)
+						{
+							LogError("Failed to bake render graph. Device context could not advance to the next subpass!");
+							return res;
+						}
+					}
+					ASSERT_PTR(pFirstSubpass);
+
+					// Input attachments are bound through uniform collections, which write the texture's current layout
+					for (const BakedLayoutTransition& inputAttachmentLayout : bakedPass.inputAttachmentLayouts)
+					{
+						const RenderResource& resource = m_physicalResources[inputAttachmentLayout.resourceIndex];
+						TextureVk* pTexture = ResolveTexture(resource);
+						ASSERT_PTR(pTexture);
+
+						pTexture->SetLayout(inputAttachmentLayout.layout, pTexture->GetSubresourceRange(resource.subresourceRange));
+					}
+
+					// Determine if this pass has a pipeline description. Clear-only passes
+					// register as graphics passes with texture outputs but no shaders, so they only need the
+					// render pass begin/end to perform attachment clears.
+					const bool hasPipeline = (currRenderPass.graphicsDesc.shaderCount > 0 && currRenderPass.graphicsDesc.pShaders != nullptr);
+
+					if (hasPipeline)
+					{
+						PipelineVk* pPipeline = CreatePipeline(currRenderPass, pFirstSubpass->renderPass, bakedPass.subpassIndex);
+						pDeviceContext->SetContextualPipeline(pPipeline);
+					}
+
+					BeginPassQueries(pDeviceContext, currRenderPass, position);
+					CallExecutionCallback(currRenderPass, deviceContext);
+					EndPassQueries(pDeviceContext, currRenderPass, position);
+
+					if (hasPipeline)
+					{
+						pDeviceContext->ResetContextualPipeline();
+					}
+
+					// Update the layout of the render pass' textures to reflect the implicit 
+					// layout transition from the render pass
+					UpdateTextureLayouts(bakedPass);
+
+					if (bakedPass.subpassIndex + 1 == bakedPass.subpassCount)
+					{
+						res = pDeviceContext->EndRenderPass();
+						if (res != STATUS_CODE::SUCCESS)
+						{
+							LogError("Failed to bake render graph. Device context could not end render pass!");
+							return res;
+						}
+					}
+
+					break;
+				}
+				case PASS_TYPE::COMPUTE:
+				{
+					// Get or create pipeline from render device (refes to internal cache)
+					// NOTE - The render pass isn't used for compute pipeline creation, so it can
+					// be ignored by passing in VK_NULL_HANDLE
+					PipelineVk* pPipeline = CreatePipeline(currRenderPass, VK_NULL_HANDLE, 0);
+
+					pDeviceContext->SetContextualPipeline(pPipeline);
+					BeginPassQueries(pDeviceContext, currRenderPass, position);
+					CallExecutionCallback(currRenderPass, deviceContext);
+					EndPassQueries(pDeviceContext, currRenderPass, position);
+					pDeviceContext->ResetContextualPipeline();
+
+					break;
+				}
+				case PASS_TYPE::TRANSFER:
+				{
+					// Transfer-only passes do not use a pipeline
+					BeginPassQueries(pDeviceContext, currRenderPass, position);
+					CallExecutionCallback(currRenderPass, deviceContext);
+					EndPassQueries(pDeviceContext, currRenderPass, position);
+
+					break;
+				}
+				case PASS_TYPE::RAY_TRACING:
+				{
+					// Get or create pipeline from render device
+					// NOTE - The render pass isn't used for ray tracing pipeline creation, so it can
+					// be ignored by passing in VK_NULL_HANDLE
+					PipelineVk* pPipeline = CreatePipeline(currRenderPass, VK_NULL_HANDLE, 0);
+
+					pDeviceContext->SetContextualPipeline(pPipeline);
+					BeginPassQueries(pDeviceContext, currRenderPass, position);
+					CallExecutionCallback(currRenderPass, deviceContext);
+					EndPassQueries(pDeviceContext, currRenderPass, position);
+					pDeviceContext->ResetContextualPipeline();
+
+					// Update the layout of the render pass' textures to reflect the implicit
+					// layout transition from the render pass
+					UpdateTextureLayouts(bakedPass);
+
+					break;
+				}
+				case PASS_TYPE::AS_BUILD:
+				{
+					// AS build passes do not use a pipeline or render pass — just execute the callback
+					BeginPassQueries(pDeviceContext, currRenderPass, position);
+					CallExecutionCallback(currRenderPass, deviceContext);
+					EndPassQueries(pDeviceContext, currRenderPass, position);
+
+					break;
+				}
+			}
+
+			// End the label for this pass
+			pDeviceContext->EndLabel(GetPassQueueType(currRenderPass));
+			AddPassQueryRecord(currRenderPass, position);
+
+			res = SignalSplitBarriers(bakedRenderGraph, bakedPass);
+			pDeviceContext->SetAsyncCompute(false);
+			pDeviceContext->SetTransferOnGraphicsQueue(false);
+			if (res != STATUS_CODE::SUCCESS)
+			{
+				return res;
+			}
+		}
+
+		return res;
+	}
+
+	STATUS_CODE RenderGraphVk::ExecuteBakedRenderGraphParallel(BakedRenderGraph& bakedRenderGraph)
+	{
+		PROFILE_SCOPE("RenderGraphVk_ExecuteBakedRenderGraphParallel");
+
+		STATUS_CODE res = STATUS_CODE::SUCCESS;
+
+		DeviceContextVk* pDeviceContext = static_cast<DeviceContextVk*>(GetCurrentDeviceContext());
+		const u32 workerCount = m_pWorkerPool->GetWorkerCount();
+
+		std::vector<DeviceContextVk*>& workerContexts = m_workerContexts;
+		workerContexts.assign(workerCount, nullptr);
+		for (u32 workerIndex = 0; workerIndex < workerCount; workerIndex++)
+		{
+			workerContexts[workerIndex] = static_cast<DeviceContextVk*>(HANDLE_UTILS::ResolveHandle(m_workerDeviceContextHandles[m_frameInFlightIndex * workerCount + workerIndex]));
+			ASSERT_PTR(workerContexts[workerIndex]);
+		}
+
+		std::vector<u32>& passBatchIndices = m_passBatchIndices;
+		std::vector<u32>& producerBatchIndices = m_producerBatchIndices;
+		passBatchIndices.assign(m_registeredRenderPasses.Size(), U32_MAX);
+
+		m_splitBarrierEvents.assign(bakedRenderGraph.splitBarriers.size(), VK_NULL_HANDLE);
+
+		// 1. Walk the passes in execution order on this thread. Everything that depends on the state of the previous
+		// passes is done here: submission batches, barriers, texture layouts and render pass objects. Every render pass
+		// or non-graphics pass gets a worker command buffer, which the barriers are recorded into before the worker
+		// records the pass itself
+		m_parallelRecordedPasses.resize(bakedRenderGraph.passes.size());
+		u32 unitCount = 0;
+		for (u32 i = 0; i < static_cast<u32>(bakedRenderGraph.passes.size()); i++)
+		{
+			BakedRenderPass& bakedPass = bakedRenderGraph.passes[i];
+			const RenderPassVk& currRenderPass = *m_registeredRenderPasses.Get(bakedPass.passIndex);
+			const bool isFirstSubpass = (currRenderPass.m_passType != PASS_TYPE::GRAPHICS || bakedPass.subpassIndex == 0);
+
+			ParallelRecordedPass& recordedPass = m_parallelRecordedPasses[i];
+			recordedPass.pBakedPass = &bakedPass;
+			recordedPass.position = i;
+			recordedPass.pPipeline = nullptr;
+			recordedPass.clearValues.clear();
+			recordedPass.textureLayouts.clear();
+
+			// Subpasses are recorded into the command buffer of their render pass, so they're kept in its batch
+			if (!isFirstSubpass)
+			{
+				const ParallelRecordedPass& prevRecordedPass = m_parallelRecordedPasses[i - 1];
+				recordedPass.pFirstSubpass = prevRecordedPass.pFirstSubpass;
+				recordedPass.cmdBuffer = prevRecordedPass.cmdBuffer;
+				recordedPass.workerIndex = prevRecordedPass.workerIndex;
+				pDeviceContext->SetRecordingTarget(recordedPass.cmdBuffer);
+			}
+
+			res = PreparePassBatch(bakedPass, passBatchIndices, producerBatchIndices);
+			if (res != STATUS_CODE::SUCCESS)
+			{
+				pDeviceContext->ResetRecordingTarget();
+				return res;
+			}
+
+			if (isFirstSubpass)
+			{
+				recordedPass.pFirstSubpass = &bakedPass;
+				recordedPass.workerIndex = unitCount % workerCount;
+				unitCount++;
+
+				res = pDeviceContext->AppendWorkerCommandBuffer(workerContexts[recordedPass.workerIndex], recordedPass.cmdBuffer);
+				if (res != STATUS_CODE::SUCCESS)
+				{
+					LogError("Failed to bake render graph. Could not get command buffer for worker %u!", recordedPass.workerIndex);
+					pDeviceContext->SetAsyncCompute(false);
+					pDeviceContext->SetTransferOnGraphicsQueue(false);
+					return res;
+				}
+			}
+
+			res = InsertPassBarriers(bakedRenderGraph, bakedPass);
+			if (res == STATUS_CODE::SUCCESS && isFirstSubpass)
+			{
+				ResetPassQueries(pDeviceContext, currRenderPass, bakedPass, i);
+			}
+			pDeviceContext->ResetRecordingTarget();
+			pDeviceContext->SetAsyncCompute(false);
+			pDeviceContext->SetTransferOnGraphicsQueue(false);
+			if (res != STATUS_CODE::SUCCESS)
+			{
+				return res;
+			}
+
+			switch (currRenderPass.m_passType)
+			{
+				case PASS_TYPE::GRAPHICS:
+				{
+					if (bakedPass.subpassIndex == 0)
+					{
+						if (bakedPass.renderPass == VK_NULL_HANDLE)
+						{
+							bakedPass.renderPass = CreateRenderPass(&bakedPass, bakedPass.subpassCount);
+							bakedPass.pFramebuffer = CreateFramebuffer(bakedPass, bakedPass.renderPass, bakedPass.isBackbuffer);
+						}
+
+						for (u32 usageIndex : bakedPass.clearValueUsageIndices)
+						{
+							recordedPass.clearValues.push_back(m_resourceUsages[usageIndex].clearValue);
+						}
+					}
+
+					for (const BakedLayoutTransition& inputAttachmentLayout : bakedPass.inputAttachmentLayouts)
+					{
+						const RenderResource& resource = m_physicalResources[inputAttachmentLayout.resourceIndex];
+						TextureVk* pTexture = ResolveTexture(resource);
+						ASSERT_PTR(pTexture);
+
+						pTexture->SetLayout(inputAttachmentLayout.layout, pTexture->GetSubresourceRange(resource.subresourceRange));
+					}
+
+					const bool hasPipeline = (currRenderPass.graphicsDesc.shaderCount > 0 && currRenderPass.graphicsDesc.pShaders != nullptr);
+					if (hasPipeline)
+					{
+						recordedPass.pPipeline = CreatePipeline(currRenderPass, recordedPass.pFirstSubpass->renderPass, bakedPass.subpassIndex);
+					}
+
+					break;
+				}
+				case PASS_TYPE::COMPUTE:
+				case PASS_TYPE::RAY_TRACING:
+				{
+					recordedPass.pPipeline = CreatePipeline(currRenderPass, VK_NULL_HANDLE, 0);
+					break;
+				}
+				case PASS_TYPE::TRANSFER:
+				case PASS_TYPE::AS_BUILD:
+				{
+					break;
+				}
+			}
+
+			// The worker records the pass after later passes have changed the layouts, so the layouts the pass' textures
+			// have now are handed to it. Every subresource is captured, not just the pass' ranges, since the worker must
+			// never read the layouts the main thread keeps changing
+			TraverseResourceCallbackFn snapshotLayout = [&](const RenderResource& resource)
+			{
+				if (resource.type == RESOURCE_TYPE::TEXTURE)
+				{
+					const TextureVk* pTexture = ResolveTexture(resource);
+					if (pTexture == nullptr)
+					{
+						return;
+					}
+
+					// Several subresource ranges of the same texture may be used by the pass
+					for (const TextureVk::LayoutOverride& layoutOverride : recordedPass.textureLayouts)
+					{
+						if (layoutOverride.pTexture == pTexture)
+						{
+							return;
+						}
+					}
+
+					pTexture->ForEachLayoutRange(pTexture->GetSubresourceRange(), [&](const VkImageSubresourceRange& subrange, VkImageLayout layout)
+					{
+						recordedPass.textureLayouts.push_back({ pTexture, subrange, layout });
+					});
+				}
+			};
+			TraverseRenderPassInputs(bakedPass.passIndex, snapshotLayout);
+			TraverseRenderPassOutputs(bakedPass.passIndex, snapshotLayout);
+
+			// The worker writes the pass' queries, so they're recorded here in execution order
+			AddPassQueryRecord(currRenderPass, i);
+
+			if (currRenderPass.m_passType == PASS_TYPE::GRAPHICS || currRenderPass.m_passType == PASS_TYPE::RAY_TRACING)
+			{
+				UpdateTextureLayouts(bakedPass);
+			}
+
+			// Events are signaled from a command buffer of this thread, which goes into the batch right after the worker's
+			// command buffer. Costs an extra command buffer, but keeps the workers unaware of split barriers
+			if (!bakedPass.splitBarrierSignals.empty())
+			{
+				pDeviceContext->SetAsyncCompute(IsAsyncComputePass(currRenderPass));
+				res = SignalSplitBarriers(bakedRenderGraph, bakedPass);
+				pDeviceContext->SetAsyncCompute(false);
+				pDeviceContext->SetTransferOnGraphicsQueue(false);
+				if (res != STATUS_CODE::SUCCESS)
+				{
+					return res;
+				}
+			}
+		}
+
+		// 2. Record the passes on the worker threads. Each worker goes through the passes assigned to it in execution
+		// order, so the subpasses of a render pass are recorded in order as well
+		const bool gatherMetrics = GetSettings().gatherMetrics;
+		std::vector<STATUS_CODE>& workerResults = m_workerResults;
+		workerResults.assign(workerCount, STATUS_CODE::SUCCESS);
+		for (u32 workerIndex = 0; workerIndex < workerCount; workerIndex++)
+		{
+			if (gatherMetrics)
+			{
+				m_workerMetrics[workerIndex] = Metrics{};
+				workerContexts[workerIndex]->SetMetricsPointer(&m_workerMetrics[workerIndex]);
+			}
+		}
+
+		// Only captures the render graph, so the job fits in the small buffer of std::function and doesn't allocate
+		m_pWorkerPool->Run([this](u32 workerIndex)
+		{
+			const u32 workerCount = m_pWorkerPool->GetWorkerCount();
+			const DeviceContextHandle& workerContext = m_workerDeviceContextHandles[m_frameInFlightIndex * workerCount + workerIndex];
+			for (ParallelRecordedPass& recordedPass : m_parallelRecordedPasses)
+			{
+				if (recordedPass.workerIndex != workerIndex)
+				{
+					continue;
+				}
+
+				m_workerResults[workerIndex] = RecordParallelPass(recordedPass, m_workerContexts[workerIndex], workerContext);
+				if (m_workerResults[workerIndex] != STATUS_CODE::SUCCESS)
+				{
+					break;
+				}
+			}
+		});
+
+		for (u32 workerIndex = 0; workerIndex < workerCount; workerIndex++)
+		{
+			if (gatherMetrics)
+			{
+				workerContexts[workerIndex]->ResetMetricsPointer();
+
+				const Metrics& workerMetrics = m_workerMetrics[workerIndex];
+				m_metrics.drawCalls += workerMetrics.drawCalls;
+				m_metrics.vertices += workerMetrics.vertices;
+				m_metrics.indices += workerMetrics.indices;
+				m_metrics.triangles += workerMetrics.triangles;
+				m_metrics.uniformUpdates += workerMetrics.uniformUpdates;
+				m_metrics.skippedStateCommands += workerMetrics.skippedStateCommands;
+				m_metrics.barrierCommands += workerMetrics.barrierCommands;
+				m_metrics.barriers += workerMetrics.barriers;
+			}
+
+			if (workerResults[workerIndex] != STATUS_CODE::SUCCESS)
+			{
+				res = workerResults[workerIndex];
+			}
+		}
+
+		return res;
+	}
+
+	STATUS_CODE RenderGraphVk::RecordParallelPass(ParallelRecordedPass& recordedPass, DeviceContextVk* pWorkerContext, const DeviceContextHandle& workerContext)
+	{
+		PROFILE_SCOPE("RenderGraphVk_RecordParallelPass");
+
+		STATUS_CODE res = STATUS_CODE::SUCCESS;
+
+		const BakedRenderPass& bakedPass = *recordedPass.pBakedPass;
+		const RenderPassVk& currRenderPass = *m_registeredRenderPasses.Get(bakedPass.passIndex);
+		const QUEUE_TYPE passQueueType = GetPassQueueType(currRenderPass);
+
+		pWorkerContext->SetRecordingTarget(recordedPass.cmdBuffer);
+		TextureVk::SetThreadLayoutOverrides(&recordedPass.textureLayouts);
+
+#if defined(PHX_DEBUG)
+		const char* passName = currRenderPass.m_debugName;
+#else
+		const char* passName = "UnnamedPass";
+#endif
+		pWorkerContext->BeginLabel(passQueueType, passName);
+
+		if (currRenderPass.m_passType == PASS_TYPE::GRAPHICS)
+		{
+			if (bakedPass.subpassIndex == 0)
+			{
+				res = pWorkerContext->BeginRenderPass(bakedPass.renderPass, bakedPass.pFramebuffer, recordedPass.clearValues.data(), static_cast<u32>(recordedPass.clearValues.size()));
+			}
+			else
+			{
+				res = pWorkerContext->NextSubpass();
 			}
 
-			FramebufferAttachmentDesc desc;
-			desc.pTexture = ResolveTexture(outputResource);
-			desc.mipTarget = 0;
-			desc.type = resourceUsage->attachmentType;
-			desc.storeOp = resourceUsage->storeOp;
-			desc.loadOp = resourceUsage->loadOp;
+			if (res != STATUS_CODE::SUCCESS)
+			{
+				LogError("Failed to record render pass on worker thread. Device context could not begin render pass or subpass!");
+			}
+		}
 
-			attachments.push_back(desc);
+		if (res == STATUS_CODE::SUCCESS)
+		{
+			if (recordedPass.pPipeline != nullptr)
+			{
+				pWorkerContext->SetContextualPipeline(recordedPass.pPipeline);
+			}
+
+			BeginPassQueries(pWorkerContext, currRenderPass, recordedPass.position);
+			CallExecutionCallback(currRenderPass, workerContext);
+			EndPassQueries(pWorkerContext, currRenderPass, recordedPass.position);
+
+			if (recordedPass.pPipeline != nullptr)
+			{
+				pWorkerContext->ResetContextualPipeline();
+			}
 
-			maxWidth = Max(maxWidth, pAttachmentTex->GetWidth());
-			maxHeight = Max(maxHeight, pAttachmentTex->GetHeight());
+			if (currRenderPass.m_passType == PASS_TYPE::GRAPHICS && bakedPass.subpassIndex + 1 == bakedPass.subpassCount)
+			{
+				res = pWorkerContext->EndRenderPass();
+				if (res != STATUS_CODE::SUCCESS)
+				{
+					LogError("Failed to record render pass on worker thread. Device context could not end render pass!");
+				}
+			}
 		}
-		);
 
-		FramebufferDescription framebufferCI{};
-		framebufferCI.width = maxWidth; // TODO - Revisit
-		framebufferCI.height = maxHeight; // TODO - Revisit
-		framebufferCI.layers = 1;
-		framebufferCI.pAttachments = attachments.data();
-		framebufferCI.attachmentCount = static_cast<u32>(attachments.size());
-		framebufferCI.renderPass = renderPassVk;
-		framebufferCI.isBackbuffer = isBackBuffer;
-		FramebufferVk* pFramebuffer = m_pRenderDevice->CreateFramebuffer(framebufferCI);
-		return pFramebuffer;
+		pWorkerContext->EndLabel(passQueueType);
+
+		TextureVk::SetThreadLayoutOverrides(nullptr);
+		pWorkerContext->ResetRecordingTarget();
+
+		return res;
 	}
 
-	PipelineVk* RenderGraphVk::CreatePipeline(const RenderPassVk& renderPass, VkRenderPass renderPassVk)
+	STATUS_CODE RenderGraphVk::PreparePassBatch(const BakedRenderPass& bakedPass, std::vector<u32>& passBatchIndices, std::vector<u32>& producerBatchIndices)
 	{
-		PROFILE_SCOPE("RenderGraphVk_CreatePipeline");
-
-		PipelineVk* pipeline = nullptr;
+		DeviceContextVk* pDeviceContext = static_cast<DeviceContextVk*>(GetCurrentDeviceContext());
+		const RenderPassVk& currRenderPass = *m_registeredRenderPasses.Get(bakedPass.passIndex);
 
-		PASS_TYPE renderPassBindPoint = renderPass.m_passType;
-		switch (renderPassBindPoint)
-		{
-		case PASS_TYPE::GRAPHICS:
+		producerBatchIndices.clear();
+		for (const BakedDependency& dependency : bakedPass.dependencies)
 		{
-			pipeline = m_pRenderDevice->CreateGraphicsPipeline(renderPass.graphicsDesc, renderPassVk);
-			break;
+			const u32 producerBatchIndex = passBatchIndices[dependency.passIndex];
+			if (producerBatchIndex != U32_MAX)
+			{
+				producerBatchIndices.push_back(producerBatchIndex);
+			}
 		}
-		case PASS_TYPE::COMPUTE:
+
+		pDeviceContext->SetAsyncCompute(IsAsyncComputePass(currRenderPass));
+		pDeviceContext->SetTransferOnGraphicsQueue(currRenderPass.m_passType == PASS_TYPE::TRANSFER && GetPassQueueType(currRenderPass) == QUEUE_TYPE::GRAPHICS);
+		STATUS_CODE res = pDeviceContext->PrepareBatch(GetPassQueueType(currRenderPass), producerBatchIndices.data(), static_cast<u32>(producerBatchIndices.size()),
+			PassWritesResource(currRenderPass.m_index, m_presentResID), passBatchIndices[bakedPass.passIndex]);
+		if (res != STATUS_CODE::SUCCESS)
 		{
-			pipeline = m_pRenderDevice->CreateComputePipeline(renderPass.computeDesc);
-			break;
+			LogError("Failed to bake render graph. Could not prepare submission batch!");
+			pDeviceContext->SetAsyncCompute(false);
+			pDeviceContext->SetTransferOnGraphicsQueue(false);
+			return res;
 		}
-		case PASS_TYPE::RAY_TRACING:
+
+		return STATUS_CODE::SUCCESS;
+	}
+
+	STATUS_CODE RenderGraphVk::InsertPassBarriers(const BakedRenderGraph& bakedRenderGraph, const BakedRenderPass& bakedPass)
+	{
+		DeviceContextVk* pDeviceContext = static_cast<DeviceContextVk*>(GetCurrentDeviceContext());
+		const RenderPassVk& currRenderPass = *m_registeredRenderPasses.Get(bakedPass.passIndex);
+		const QUEUE_TYPE passQueueType = GetPassQueueType(currRenderPass);
+
+		// The waits go first, since they can't share a command with the regular barriers. Each wait must be given the
+		// exact barriers its event was signaled with
+		for (u32 splitBarrierIndex : bakedPass.splitBarrierWaits)
 		{
-			pipeline = m_pRenderDevice->CreateRayTracingPipeline(renderPass.rayTracingDesc);
-			break;
+			const VkEvent event = m_splitBarrierEvents[splitBarrierIndex];
+			if (event == VK_NULL_HANDLE)
+			{
+				LogError("Failed to bake render graph. Split barrier was never signaled!");
+				return STATUS_CODE::ERR_INTERNAL;
+			}
+
+			STATUS_CODE res = QueueResourceBarriers(bakedRenderGraph.splitBarriers[splitBarrierIndex].barriers, true);
+			if (res == STATUS_CODE::SUCCESS)
+			{
+				res = pDeviceContext->WaitEvent(passQueueType, event);
+			}
+
+			if (res != STATUS_CODE::SUCCESS)
+			{
+				LogError("Failed to bake render graph. Could not wait on split barrier!");
+				return res;
+			}
 		}
-		case PASS_TYPE::TRANSFER:
-		case PASS_TYPE::AS_BUILD:
+
+		// Aliased transient resources share memory with resources used earlier in the frame (or in the previous frame),
+		// so all prior memory accesses must be complete before they're first written to. Their contents are discarded
+		// anyway, so a single global memory barrier covers every aliased resource first used by this pass. It's recorded
+		// in the same barrier command as the pass' resource barriers
+		for (ResourceIndex resourceIndex : bakedPass.transientFirstUses)
 		{
-			// Transfer and AS build passes do not use pipelines
-			break;
+			if (m_pTransientResourcePool->IsAliased(m_physicalResources[resourceIndex].handle))
+			{
+				pDeviceContext->QueueMemoryBarrier(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+					VK_ACCESS_MEMORY_WRITE_BIT, VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT);
+				break;
+			}
 		}
-		default:
+
+		// Before calling execution callback, insert all barriers required by the render pass
+		STATUS_CODE res = InsertResourceBarriers(bakedPass, GetPassQueueType(currRenderPass));
+		if (res != STATUS_CODE::SUCCESS)
 		{
-			ASSERT_ALWAYS("Unknown pass type!");
-			break;
-		}
+			LogError("Failed to bake render graph. Could not insert dependency barriers!");
+			return res;
 		}
 
-		return pipeline;
+		return STATUS_CODE::SUCCESS;
 	}
 
-	ResourceIndex RenderGraphVk::RegisterResource(Handle resource, RESOURCE_TYPE type, const ResourceUsage& usage)
+	STATUS_CODE RenderGraphVk::SignalSplitBarriers(const BakedRenderGraph& bakedRenderGraph, const BakedRenderPass& bakedPass)
 	{
-		const ResourceIndex numPhysicalResources = static_cast<ResourceIndex>(m_physicalResources.size());
-		if (numPhysicalResources > MAX_REGISTERED_RESOURCES)
+		DeviceContextVk* pDeviceContext = static_cast<DeviceContextVk*>(GetCurrentDeviceContext());
+		const RenderPassVk& currRenderPass = *m_registeredRenderPasses.Get(bakedPass.passIndex);
+
+		for (u32 splitBarrierIndex : bakedPass.splitBarrierSignals)
 		{
-			LogError("Failed to register resource. Physical resource limit (%u) reached!", MAX_REGISTERED_RESOURCES);
-			return 0;
+			VkEvent& event = m_splitBarrierEvents[splitBarrierIndex];
+			STATUS_CODE res = pDeviceContext->AcquireEvent(event);
+			if (res == STATUS_CODE::SUCCESS)
+			{
+				// Texture layouts are updated by the wait, which is where the layout transitions take effect
+				res = QueueResourceBarriers(bakedRenderGraph.splitBarriers[splitBarrierIndex].barriers, false);
+			}
+
+			if (res == STATUS_CODE::SUCCESS)
+			{
+				res = pDeviceContext->SignalEvent(GetPassQueueType(currRenderPass), event);
+			}
+
+			if (res != STATUS_CODE::SUCCESS)
+			{
+				LogError("Failed to bake render graph. Could not signal split barrier!");
+				event = VK_NULL_HANDLE;
+				return res;
+			}
 		}
 
-		const u64 resourceID = HashResource(resource, type);
-		ResourceIndex physicalResourceIndex = MAX_REGISTERED_RESOURCES;
+		return STATUS_CODE::SUCCESS;
+	}
 
-		// Try to find an existing physical resource
-		for (ResourceIndex i = 0; i < numPhysicalResources; i++)
+	u32 RenderGraphVk::FindSplitBarrierSignalPosition(const std::vector<u32>& activeRenderPasses, const std::vector<u32>& activePositions, const std::vector<u32>& lastSubpasses,
+		const RenderPassVk& consumer, u32 consumerPosition, ResourceIndex resourceIndex) const
+	{
+		// The barrier must have a single producer, otherwise it has to wait on all of them anyway
+		u32 producerPassIndex = U32_MAX;
+		for (const DependencyInfo& dependencyInfo : consumer.m_dependencyInfos)
 		{
-			const RenderResource& physicalResource = m_physicalResources[i];
-			if (physicalResource.resourceID == resourceID)
+			if (!dependencyInfo.resources.Test(resourceIndex))
 			{
-				// Found match
-				physicalResourceIndex = i;
-				break;
+				continue;
+			}
+
+			if (producerPassIndex != U32_MAX)
+			{
+				return U32_MAX;
 			}
+			producerPassIndex = dependencyInfo.renderPass->m_index;
 		}
-		
-		if (physicalResourceIndex == MAX_REGISTERED_RESOURCES)
+
+		if (producerPassIndex == U32_MAX || activePositions[producerPassIndex] == U32_MAX)
 		{
-			// Couldn't find existing physical resource, create one instead
-			// TODO - Defer physical resource creation until baking?
-			RenderResource newPhysicalResource{};
-			newPhysicalResource.handle = resource;
-			newPhysicalResource.resourceID = resourceID;
-			newPhysicalResource.type = type;
+			return U32_MAX;
+		}
 
-			physicalResourceIndex = numPhysicalResources;
-			m_physicalResources.push_back(newPhysicalResource);
+		// Events can only synchronize commands submitted to the same queue. Dependencies across queues are already
+		// synchronized by semaphores between the batches
+		const RenderPassVk& producer = *m_registeredRenderPasses.Get(producerPassIndex);
+		if (GetPassQueueType(producer) != GetPassQueueType(consumer) || IsAsyncComputePass(producer) != IsAsyncComputePass(consumer))
+		{
+			return U32_MAX;
 		}
 
-		// Create logical resource
-		ResourceUsage newUsage = usage;
-		newUsage.resourceID = resourceID;
-		m_resourceUsages.push_back(newUsage);
+		// Events can't be signaled inside a render pass, so the producer's entire render pass has to end first
+		const u32 signalPosition = lastSubpasses[activePositions[producerPassIndex]];
+		if (consumerPosition <= signalPosition + 1)
+		{
+			return U32_MAX;
+		}
 
-		return physicalResourceIndex;
+		// The passes in between must not touch the resource (or any range overlapping it), or their barriers would be ordered
+		// around the split barrier
+		for (u32 position = signalPosition + 1; position < consumerPosition; position++)
+		{
+			const RenderPassVk& renderPass = *m_registeredRenderPasses.Get(activeRenderPasses[position]);
+			const ResourceIndexBitset passResources = renderPass.m_inputResources | renderPass.m_outputResources;
+			if (passResources.Test(resourceIndex))
+			{
+				return U32_MAX;
+			}
+
+			for (ResourceIndex overlappingIndex : m_overlappingResources[resourceIndex])
+			{
+				if (passResources.Test(overlappingIndex))
+				{
+					return U32_MAX;
+				}
+			}
+		}
+
+		return signalPosition;
+	}
+
+	void RenderGraphVk::RestoreBakedRenderGraph(const BakedRenderGraph& bakedRenderGraph)
+	{
+		for (const BakedRenderPass& bakedPass : bakedRenderGraph.passes)
+		{
+			RenderPassVk* pRenderPass = m_registeredRenderPasses.Get(bakedPass.passIndex);
+			ASSERT_PTR(pRenderPass);
+
+			pRenderPass->m_dependencyInfos.clear();
+			for (const BakedDependency& dependency : bakedPass.dependencies)
+			{
+				DependencyInfo dependencyInfo{};
+				dependencyInfo.renderPass = m_registeredRenderPasses.Get(dependency.passIndex);
+				dependencyInfo.resources = dependency.resources;
+				pRenderPass->m_dependencyInfos.push_back(dependencyInfo);
+			}
+
+			pRenderPass->m_inputBarriers = bakedPass.inputBarriers;
+			pRenderPass->m_outputBarriers = bakedPass.outputBarriers;
+		}
 	}
 
 	u32 RenderGraphVk::FindPresentRenderPassIndex(u64 presentResID)
@@ -1890,101 +3626,182 @@ namespace PHX
 		return presentRPIndex;
 	}
 
-	bool RenderGraphVk::PassWritesResource(u32 renderPassIndex, u64 resourceID) const
+	void RenderGraphVk::FindRootPasses(u32 presentPassIndex, std::vector<u32>& out_rootPassIndices) const
 	{
-		for (const ResourceUsage& usage : m_resourceUsages)
+		if (presentPassIndex != s_invalidRenderPassIndex)
+		{
+			out_rootPassIndices.push_back(presentPassIndex);
+		}
+
+		for (u32 passIndex = 0; passIndex < static_cast<u32>(m_registeredRenderPasses.Size()); passIndex++)
 		{
-			if (usage.passIndex == renderPassIndex && usage.io == RESOURCE_IO::OUTPUT && usage.resourceID == resourceID)
+			if (passIndex != presentPassIndex && m_registeredRenderPasses.Get(passIndex)->m_isRootPass)
 			{
-				return true;
+				out_rootPassIndices.push_back(passIndex);
 			}
 		}
-		return false;
 	}
 
-	void RenderGraphVk::BuildDependencyTree(u32 renderPassIndex)
+	bool RenderGraphVk::PassWritesResource(u32 renderPassIndex, u64 resourceID) const
+	{
+		if (renderPassIndex >= static_cast<u32>(m_registeredRenderPasses.Size()))
+		{
+			return false;
+		}
+
+		const ResourceIndex resourceIndex = GetPhysicalResourceIndex(resourceID);
+		if (resourceIndex == MAX_REGISTERED_RESOURCES)
+		{
+			return false;
+		}
+
+		return m_registeredRenderPasses.Get(renderPassIndex)->m_outputResources.Test(resourceIndex);
+	}
+
+	void RenderGraphVk::BuildDependencyTree(const std::vector<u32>& rootPassIndices)
 	{
 		PROFILE_SCOPE("RenderGraphVk_BuildDependencyTree");
 
-		// Base cases
-		if (renderPassIndex >= m_registeredRenderPasses.Size())
+		const u32 passCount = static_cast<u32>(m_registeredRenderPasses.Size());
+
+		// For every physical resource, the passes that read or write it in ascending submission order. This
+		// way hazards for a pass are only tested against passes that share at least one resource with it
+		std::vector<std::vector<u32>> resourcePasses(m_physicalResources.size());
+		for (u32 passIndex = 0; passIndex < passCount; passIndex++)
 		{
-			return;
+			const RenderPassVk* pRenderPass = m_registeredRenderPasses.Get(passIndex);
+			(pRenderPass->m_inputResources | pRenderPass->m_outputResources).ForEachSetBit([&](u32 resourceIndex)
+			{
+				resourcePasses[resourceIndex].push_back(passIndex);
+			});
 		}
 
-		RenderPassVk* pCurrRenderPass = m_registeredRenderPasses.Get(renderPassIndex);
-		if (pCurrRenderPass->m_inputResources.none() && pCurrRenderPass->m_outputResources.none())
+		// Find all other passes EARLIER IN SUBMISSION ORDER which pose an access hazard to any of the resources 
+		// in the current pass. These hazards can be read-after-write (RAW), write-after-read (WAR) and write-after-write (WAW).
+		// Every pass is expanded at most once, so passes reachable through multiple paths (diamond-shaped graphs) don't
+		// get their dependencies duplicated
+		std::vector<bool> visited(passCount, false);
+		std::vector<u32> pendingPasses;
+		std::vector<std::pair<u32, ResourceIndex>> hazards; // Pairs of (previous pass index, hazard resource index)
+		for (u32 rootPassIndex : rootPassIndices)
 		{
-			return;
+			if (rootPassIndex < passCount)
+			{
+				pendingPasses.push_back(rootPassIndex);
+			}
 		}
 
-		// Recursively find all other passes EARLIER IN SUBMISSION ORDER which pose an access 
-		// hazard to any of the resources in the current pass. These hazards can be read-after-write (RAW),
-		// write-after-read (WAR) and write-after-write (WAW)
-		for (u32 i = 0; i < renderPassIndex; i++)
+		while (!pendingPasses.empty())
 		{
-			// Prevent a render pass from listing itself as a dependency
-			if (renderPassIndex == i)
+			const u32 renderPassIndex = pendingPasses.back();
+			pendingPasses.pop_back();
+
+			if (visited[renderPassIndex])
 			{
 				continue;
 			}
+			visited[renderPassIndex] = true;
+
+			RenderPassVk* pCurrRenderPass = m_registeredRenderPasses.Get(renderPassIndex);
+
+			hazards.clear();
+			const auto FindHazards = [&](u32 resourceIndex)
+			{
+				const bool currReads = pCurrRenderPass->m_inputResources.Test(resourceIndex);
+				const bool currWrites = pCurrRenderPass->m_outputResources.Test(resourceIndex);
+
+				// Previous passes may access the same subresources through an overlapping range. The hazard is recorded
+				// on the current pass' resource either way
+				const auto FindResourceHazards = [&](u32 prevResourceIndex)
+				{
+					for (u32 prevPassIndex : resourcePasses[prevResourceIndex])
+					{
+						if (prevPassIndex >= renderPassIndex)
+						{
+							// Sorted by submission order, so no earlier passes remain
+							break;
+						}
 
-			RenderPassVk* pPrevRenderPass = m_registeredRenderPasses.Get(i);
+						const RenderPassVk* pPrevRenderPass = m_registeredRenderPasses.Get(prevPassIndex);
+						const bool prevWrites = pPrevRenderPass->m_outputResources.Test(prevResourceIndex);
+						const bool prevReads = pPrevRenderPass->m_inputResources.Test(prevResourceIndex);
+
+						const bool rawHazard = (prevWrites && currReads);
+						const bool warHazard = (prevReads && currWrites);
+						const bool wawHazard = (prevWrites && currWrites);
+						if (rawHazard || warHazard || wawHazard)
+						{
+							hazards.push_back({ prevPassIndex, static_cast<ResourceIndex>(resourceIndex) });
+						}
+					}
+				};
 
-			const ResourceIndexBitset rawHazardResources = (pPrevRenderPass->m_outputResources & pCurrRenderPass->m_inputResources);
-			const ResourceIndexBitset warHazardResources = (pPrevRenderPass->m_inputResources  & pCurrRenderPass->m_outputResources);
-			const ResourceIndexBitset wawHazardResources = (pPrevRenderPass->m_outputResources & pCurrRenderPass->m_outputResources);
+				FindResourceHazards(resourceIndex);
+				for (ResourceIndex overlappingIndex : m_overlappingResources[resourceIndex])
+				{
+					FindResourceHazards(overlappingIndex);
+				}
+			};
+			(pCurrRenderPass->m_inputResources | pCurrRenderPass->m_outputResources).ForEachSetBit(FindHazards);
 
-			// Create a new dependency to this previous render pass if any hazards are detected
-			const ResourceIndexBitset hazardResources = (rawHazardResources | warHazardResources | wawHazardResources);
-			const bool isDependencyRP = hazardResources.any();
-			if (isDependencyRP)
+			// Group hazards into one dependency per previous render pass, in submission order
+			std::sort(hazards.begin(), hazards.end());
+			for (size_t i = 0; i < hazards.size(); i++)
 			{
-				DependencyInfo newDependency{};
-				newDependency.renderPass = pPrevRenderPass;
-				newDependency.resources = hazardResources;
-				pCurrRenderPass->m_dependencyInfos.push_back(newDependency);
-				BuildDependencyTree(i);
+				const u32 prevPassIndex = hazards[i].first;
+				if (pCurrRenderPass->m_dependencyInfos.empty() || pCurrRenderPass->m_dependencyInfos.back().renderPass->m_index != prevPassIndex)
+				{
+					DependencyInfo newDependency{};
+					newDependency.renderPass = m_registeredRenderPasses.Get(prevPassIndex);
+					pCurrRenderPass->m_dependencyInfos.push_back(newDependency);
+
+					if (!visited[prevPassIndex])
+					{
+						pendingPasses.push_back(prevPassIndex);
+					}
+				}
+
+				pCurrRenderPass->m_dependencyInfos.back().resources.Set(hazards[i].second);
 			}
 		}
 	}
 
-	void RenderGraphVk::FindActivePasses(u32 finalPassIndex, std::vector<u32>& out_activeRenderPasses)
+	void RenderGraphVk::FindActivePasses(const std::vector<u32>& rootPassIndices, std::vector<u32>& out_activeRenderPasses)
 	{
 		PROFILE_SCOPE("RenderGraphVk_FindActivePasses");
 
-		// Traverse dependency tree and tag all passes which contribute to the final pass.
-		// A pass reachable via multiple dependency paths (diamond-shaped graphs) is visited
-		// more than once by the DFS, so de-duplicate here to avoid processing/executing it twice.
+		// Tag all passes which contribute to any of the root passes
 		const u32 passCount = static_cast<u32>(m_registeredRenderPasses.Size());
+		std::vector<bool> isActive(passCount, false);
+		TraverseDependencyTree(rootPassIndices, [&](const RenderPassVk& currRenderPass)
+		{
+			isActive[currRenderPass.m_index] = true;
+		});
 
-		TraverseDependencyTree(finalPassIndex, [&](const RenderPassVk& currRenderPass)
+		// Dependencies only ever point to passes earlier in submission order, so ordering the active passes
+		// by submission order is already a valid topological order. The list is built from last to first
+		// so that dependencies come after the passes that depend on them
+		for (u32 i = passCount; i > 0; i--)
 		{
-			const u32 passIndex = currRenderPass.m_index;
-			if (passIndex < passCount)
+			if (isActive[i - 1])
 			{
-				auto lastPassIndexIter = std::find(out_activeRenderPasses.begin(), out_activeRenderPasses.end(), passIndex);
-				const bool alreadyActive = (lastPassIndexIter != out_activeRenderPasses.end());
-				if (alreadyActive)
-				{
-					// This means the same pass appeared as a dependency for an earlier pass
-					// in submission order. Therefore we must push it to the back of the list
-					std::rotate(lastPassIndexIter, lastPassIndexIter + 1, out_activeRenderPasses.end());
-				}
-				else
-				{
-					// Push back new active pass
-					out_activeRenderPasses.push_back(passIndex);
-				}
-
+				out_activeRenderPasses.push_back(i - 1);
 			}
-		});
+		}
 	}
 
 	void RenderGraphVk::CalculateResourceBarriers(const std::vector<u32>& activeRenderPasses, u32 finalPassIndex)
 	{
 		PROFILE_SCOPE("RenderGraphVk_CalculateResourceBarriers");
 
+		// Barriers against a pass use its shader stage mask, so all of them are known before any barrier is calculated
+		m_removedStageBits = 0;
+		for (u32 activeRenderPassIndex : activeRenderPasses)
+		{
+			RenderPassVk* pRenderPass = m_registeredRenderPasses.Get(activeRenderPassIndex);
+			pRenderPass->m_shaderStageMask = CalculateShaderStageMask(*pRenderPass);
+		}
+
 		// Traverse the dependency tree from bottom-to-top, and for every dependency:
 		// 1. Find which resource usages caused that dependency
 		// 2. For all those resource usages, generate a barrier
@@ -1999,6 +3816,9 @@ namespace PHX
 			// Color attachments: only the final (backbuffer) pass needs the color->PRESENT transition.
 			//   Non-final color outputs get their output barrier filled in by the dependency loop below
 			//   (the next pass that writes the same color target will insert a WAW barrier entry there).
+			//   Root passes may have no later writer, so their color outputs get a terminal barrier that
+			//   keeps the attachment layout. Later passes were already visited, so this never replaces a
+			//   barrier from the dependency loop.
 			//
 			// Depth attachments: if no later pass reads/writes the depth buffer (the common case today),
 			//   the dependency loop will never insert an output barrier for it. We generate a terminal
@@ -2020,7 +3840,7 @@ namespace PHX
 
 				// Color->PRESENT is only needed for the final pass's color output; skip for all others
 				// (the dependency loop will supply the correct WAW output barrier for non-final writers).
-				if (isColorAttachment && !isFinalPass)
+				if (isColorAttachment && !isFinalPass && !pDstRenderPass->m_isRootPass)
 				{
 					return;
 				}
@@ -2029,17 +3849,17 @@ namespace PHX
 
 				Barrier newDstBarrier;
 				newDstBarrier.oldLayout = layout;
-				newDstBarrier.newLayout = isColorAttachment ? VK_IMAGE_LAYOUT_PRESENT_SRC_KHR : layout;
+				newDstBarrier.newLayout = (isColorAttachment && isFinalPass) ? VK_IMAGE_LAYOUT_PRESENT_SRC_KHR : layout;
 
 				// NOTE - Presentation engine is external and doesn't require an access mask, but if the backbuffer
 				//        is cleared (from loadOp) we must still sync the clear operation. As a result, we'll set
 				//        the dst flags to COLOR_ATTACHMENT-related write operations to be safe
 				newDstBarrier.srcAccessMask = CalculateResourceAccessFlags(*dstResourceUsage, resource, dstBindPoint);
 				newDstBarrier.dstAccessMask = isColorAttachment ? VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT : (VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
-				newDstBarrier.srcStageMask = CalculateResourcePipelineStageFlags(dstBindPoint, newDstBarrier.srcAccessMask, true);
+				newDstBarrier.srcStageMask = CalculatePassPipelineStageFlags(*pDstRenderPass, newDstBarrier.srcAccessMask, true);
 				newDstBarrier.dstStageMask = isColorAttachment ? VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT : VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
 
-				pDstRenderPass->m_outputBarriers.insert({ resourceID, newDstBarrier });
+				InsertBarrier(pDstRenderPass->m_outputBarriers, resourceID, newDstBarrier);
 			});
 
 			// Non-graphics passes (transfer/compute) write their output textures directly (e.g. via a
@@ -2061,7 +3881,7 @@ namespace PHX
 					const ResourceUsage* dstResourceUsage = GetResourceUsageFromPass(*pDstRenderPass, resourceID);
 					ASSERT_PTR(dstResourceUsage); // Should never be null
 
-					const VkImageLayout srcLayout = pTexture->GetLayout();
+					const VkImageLayout srcLayout = pTexture->GetLayout(pTexture->GetSubresourceRange(resource.subresourceRange));
 					const VkImageLayout dstLayout = CalculateResourceImageLayout(*dstResourceUsage, dstBindPoint);
 					if (srcLayout != dstLayout)
 					{
@@ -2069,11 +3889,11 @@ namespace PHX
 						newDstBarrier.dstAccessMask = CalculateResourceAccessFlags(*dstResourceUsage, resource, dstBindPoint);
 						newDstBarrier.srcAccessMask = 0; // TOP_OF_PIPE cannot have a non-zero access mask
 						newDstBarrier.srcStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-						newDstBarrier.dstStageMask = CalculateResourcePipelineStageFlags(dstBindPoint, newDstBarrier.dstAccessMask, false);
+						newDstBarrier.dstStageMask = CalculatePassPipelineStageFlags(*pDstRenderPass, newDstBarrier.dstAccessMask, false);
 						newDstBarrier.oldLayout = srcLayout;
 						newDstBarrier.newLayout = dstLayout;
 
-						pDstRenderPass->m_inputBarriers.insert({ resourceID, newDstBarrier });
+						InsertBarrier(pDstRenderPass->m_inputBarriers, resourceID, newDstBarrier);
 					}
 				});
 			}
@@ -2087,7 +3907,7 @@ namespace PHX
 				coveredResources |= dependencyInfo.resources;
 			}
 
-			const ResourceIndexBitset rootInputResources = (pDstRenderPass->m_inputResources & ~coveredResources);
+			const ResourceIndexBitset rootInputResources = pDstRenderPass->m_inputResources.Difference(coveredResources);
 			TraverseResources(rootInputResources, [&](const RenderResource& resource)
 			{
 				const u64& resourceID = resource.resourceID;
@@ -2101,11 +3921,11 @@ namespace PHX
 					newDstBarrier.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
 					newDstBarrier.dstAccessMask = CalculateResourceAccessFlags(*dstResourceUsage, resource, dstBindPoint);
 					newDstBarrier.srcStageMask = VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR;
-					newDstBarrier.dstStageMask = CalculateResourcePipelineStageFlags(dstBindPoint, newDstBarrier.dstAccessMask, false);
+					newDstBarrier.dstStageMask = CalculatePassPipelineStageFlags(*pDstRenderPass, newDstBarrier.dstAccessMask, false);
 					newDstBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 					newDstBarrier.newLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
-					pDstRenderPass->m_inputBarriers.insert({ resourceID, newDstBarrier });
+					InsertBarrier(pDstRenderPass->m_inputBarriers, resourceID, newDstBarrier);
 					return;
 				}
 				else if (resource.type == RESOURCE_TYPE::TEXTURE)
@@ -2113,8 +3933,9 @@ namespace PHX
 					TextureVk* pTexture = ResolveTexture(resource);
 					ASSERT_PTR(pTexture);
 
-					// Only insert barriers if the layout is not compatible with the render passes' usage
-					const VkImageLayout srcLayout = pTexture->GetLayout();
+					// Only insert barriers if the layout is not compatible with the render passes' usage. Ranges whose
+					// subresources are in different layouts always need one
+					const VkImageLayout srcLayout = pTexture->GetLayout(pTexture->GetSubresourceRange(resource.subresourceRange));
 					const VkImageLayout dstLayout = CalculateResourceImageLayout(*dstResourceUsage, dstBindPoint);
 					if (srcLayout != dstLayout)
 					{
@@ -2122,11 +3943,11 @@ namespace PHX
 						newDstBarrier.srcAccessMask = 0; // TOP_OF_PIPE cannot have a non-zero access mask
 						newDstBarrier.dstAccessMask = CalculateResourceAccessFlags(*dstResourceUsage, resource, dstBindPoint);
 						newDstBarrier.srcStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-						newDstBarrier.dstStageMask = CalculateResourcePipelineStageFlags(dstBindPoint, newDstBarrier.dstAccessMask, false);
+						newDstBarrier.dstStageMask = CalculatePassPipelineStageFlags(*pDstRenderPass, newDstBarrier.dstAccessMask, false);
 						newDstBarrier.oldLayout = srcLayout;
 						newDstBarrier.newLayout = dstLayout;
 
-						pDstRenderPass->m_inputBarriers.insert({ resourceID, newDstBarrier });
+						InsertBarrier(pDstRenderPass->m_inputBarriers, resourceID, newDstBarrier);
 					}
 				}
 			});
@@ -2137,9 +3958,11 @@ namespace PHX
 				TraverseResources(dependencyInfo.resources, [&](const RenderResource& resourceDependency)
 				{
 					// Setup the barrier. In this case the source corresponds to the active source render pass we're
-					// currently in. The destination corresponds to the dependency we're currently looping through
+					// currently in. The destination corresponds to the dependency we're currently looping through. The
+					// source may have accessed the resource through an overlapping subresource range
 					const u64& resourceID = resourceDependency.resourceID;
-					const ResourceUsage* srcResourceUsage = GetResourceUsageFromPass(*pSrcRenderPass, resourceID);
+					u64 srcResourceID = resourceID;
+					const ResourceUsage* srcResourceUsage = GetOverlappingResourceUsageFromPass(*pSrcRenderPass, GetPhysicalResourceIndex(resourceID), srcResourceID);
 					ASSERT_PTR(srcResourceUsage); // Should never be null
 					const ResourceUsage* dstResourceUsage = GetResourceUsageFromPass(*pDstRenderPass, resourceID);
 					ASSERT_PTR(dstResourceUsage); // Should never be null
@@ -2150,8 +3973,8 @@ namespace PHX
 					Barrier newDstBarrier;
 					newDstBarrier.srcAccessMask = CalculateResourceAccessFlags(*srcResourceUsage, resourceDependency, srcBindPoint);
 					newDstBarrier.dstAccessMask = CalculateResourceAccessFlags(*dstResourceUsage, resourceDependency, dstBindPoint);
-					newDstBarrier.srcStageMask = CalculateResourcePipelineStageFlags(srcBindPoint, newDstBarrier.srcAccessMask, true);
-					newDstBarrier.dstStageMask = CalculateResourcePipelineStageFlags(dstBindPoint, newDstBarrier.dstAccessMask, false);
+					newDstBarrier.srcStageMask = CalculatePassPipelineStageFlags(*pSrcRenderPass, newDstBarrier.srcAccessMask, true);
+					newDstBarrier.dstStageMask = CalculatePassPipelineStageFlags(*pDstRenderPass, newDstBarrier.dstAccessMask, false);
 
 					if (resourceDependency.type == RESOURCE_TYPE::TEXTURE)
 					{
@@ -2159,117 +3982,201 @@ namespace PHX
 						newDstBarrier.newLayout = CalculateResourceImageLayout(*dstResourceUsage, dstBindPoint);
 					}
 
-					// Add the barrier information to both src and dst pass
-					pDstRenderPass->m_inputBarriers[resourceID] = newDstBarrier;
-					pSrcRenderPass->m_outputBarriers[resourceID] = newDstBarrier;
+					// The semaphore between the batches of passes on different queue families already makes the source's
+					// writes available, and the source's stages may not even exist on the destination queue (e.g. fragment
+					// shaders on a transfer queue). The barrier only has to chain with the semaphore wait, which waits on
+					// all commands, and transition the layout. The source pass keeps the full barrier
+					const Barrier srcOutputBarrier = newDstBarrier;
+					if (IsCrossQueueFamilyDependency(*pSrcRenderPass, *pDstRenderPass))
+					{
+						newDstBarrier.srcAccessMask = 0;
+						newDstBarrier.srcStageMask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+					}
+
+					// Add the barrier information to both src and dst pass. A resource can depend on several passes writing
+					// overlapping ranges, in which case the barrier has to wait on all of them. The old layout of those
+					// barriers is resolved per subresource when they're recorded
+					const Barrier* pExistingBarrier = FindBarrier(pDstRenderPass->m_inputBarriers, resourceID);
+					if (pExistingBarrier != nullptr && !m_overlappingResources[GetPhysicalResourceIndex(resourceID)].empty())
+					{
+						Barrier mergedBarrier = newDstBarrier;
+						mergedBarrier.srcAccessMask |= pExistingBarrier->srcAccessMask;
+						mergedBarrier.dstAccessMask |= pExistingBarrier->dstAccessMask;
+						mergedBarrier.srcStageMask |= pExistingBarrier->srcStageMask;
+						mergedBarrier.dstStageMask |= pExistingBarrier->dstStageMask;
+						SetBarrier(pDstRenderPass->m_inputBarriers, resourceID, mergedBarrier);
+					}
+					else
+					{
+						SetBarrier(pDstRenderPass->m_inputBarriers, resourceID, newDstBarrier);
+					}
+					SetBarrier(pSrcRenderPass->m_outputBarriers, srcResourceID, srcOutputBarrier);
 				});
 			}
 		}
-	}
+	}
+
+	VkPipelineStageFlags RenderGraphVk::CalculateShaderStageMask(const RenderPassVk& renderPass) const
+	{
+		// Other pass types only have a single pipeline stage their shaders can execute in
+		const GraphicsPipelineDesc& graphicsDesc = renderPass.graphicsDesc;
+		if (renderPass.m_passType != PASS_TYPE::GRAPHICS || graphicsDesc.pShaders == nullptr)
+		{
+			return 0;
+		}
+
+		ShaderStageFlags stages = 0;
+		for (u32 i = 0; i < graphicsDesc.shaderCount; i++)
+		{
+			const ShaderVk* pShader = static_cast<const ShaderVk*>(m_pRenderDevice->ResolveHandle(graphicsDesc.pShaders[i]));
+			if (pShader == nullptr || !pShader->GetReflectionData().isValid)
+			{
+				return 0;
+			}
+
+			const ShaderReflectionData& reflectionData = pShader->GetReflectionData();
+			for (u32 j = 0; j < reflectionData.uniformCount; j++)
+			{
+				stages |= reflectionData.uniforms[j].stages;
+			}
+		}
+
+		return SHADER_UTILS::ConvertToPipelineStageFlags(stages);
+	}
+
+	VkPipelineStageFlags RenderGraphVk::CalculatePassPipelineStageFlags(const RenderPassVk& renderPass, VkAccessFlags accessFlags, bool isSrcFlag)
+	{
+		const VkPipelineStageFlags stageFlags = CalculateResourcePipelineStageFlags(renderPass.m_passType, accessFlags, isSrcFlag, renderPass.m_shaderStageMask);
+		if (renderPass.m_shaderStageMask != 0)
+		{
+			const VkPipelineStageFlags worstCaseStageFlags = CalculateResourcePipelineStageFlags(renderPass.m_passType, accessFlags, isSrcFlag, 0);
+			m_removedStageBits += CountStageBits(worstCaseStageFlags & ~stageFlags);
+		}
+
+		return stageFlags;
+	}
+
+	bool RenderGraphVk::RequiresExplicitResourceBarrier(const RenderPassVk& renderPass, u64 resourceID) const
+	{
+		if (FindBarrier(renderPass.m_outputBarriers, resourceID) != nullptr)
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	STATUS_CODE RenderGraphVk::PlaceTransientResources(BakedRenderGraph& bakedRenderGraph)
+	{
+		PROFILE_SCOPE("RenderGraphVk_PlaceTransientResources");
+
+		std::vector<TransientLifetime>& lifetimes = m_transientLifetimes;
+		lifetimes.clear();
+		for (const BakedTransientLifetime& bakedLifetime : bakedRenderGraph.transientLifetimes)
+		{
+			lifetimes.push_back({ m_physicalResources[bakedLifetime.resourceIndex].handle, bakedLifetime.firstUse, bakedLifetime.lastUse, bakedLifetime.isAttachmentOnly });
+		}
+
+		bool recreated = false;
+		STATUS_CODE res = m_pTransientResourcePool->UpdatePlacement(lifetimes, recreated);
+		if (res != STATUS_CODE::SUCCESS)
+		{
+			return res;
+		}
 
-	bool RenderGraphVk::RequiresExplicitResourceBarrier(const RenderPassVk& renderPass, u64 resourceID) const
-	{
-		if (renderPass.m_outputBarriers.find(resourceID) != renderPass.m_outputBarriers.end())
+		if (recreated)
 		{
-			return false;
+			// The framebuffers referencing the old transient textures were destroyed. Other baked render graphs are
+			// discarded on the next bake through the object cache version, but this one is about to execute
+			for (BakedRenderPass& bakedPass : bakedRenderGraph.passes)
+			{
+				bakedPass.renderPass = VK_NULL_HANDLE;
+				bakedPass.pFramebuffer = nullptr;
+			}
 		}
 
-		return true;
+		return STATUS_CODE::SUCCESS;
 	}
 
-	STATUS_CODE RenderGraphVk::InsertResourceBarriers(const RenderPassVk& renderPass)
+	STATUS_CODE RenderGraphVk::InsertResourceBarriers(const BakedRenderPass& bakedRenderPass, QUEUE_TYPE queueType)
 	{
 		PROFILE_SCOPE("RenderGraphVk_InsertResourceBarriers");
 
-		STATUS_CODE res = STATUS_CODE::SUCCESS;
 		DeviceContextVk* pDeviceContext = static_cast<DeviceContextVk*>(GetCurrentDeviceContext());
 
-		for (auto& barrierIter : renderPass.m_inputBarriers)
+		// All barriers of the pass are queued up and recorded in a single barrier command
+		STATUS_CODE res = QueueResourceBarriers(bakedRenderPass.barriers, true);
+		if (res == STATUS_CODE::SUCCESS)
 		{
-			u64 resourceID = barrierIter.first;
-			const Barrier& currBarrier = barrierIter.second;
+			res = pDeviceContext->FlushBarriers(queueType);
+		}
 
-			if (renderPass.m_passType == PASS_TYPE::GRAPHICS)
-			{
-				// HACK! We prevent barriers from being inserted for output textures that
-				// belong to a graphics pass. This is because the render pass implicitly performs
-				// these transitions, so we save work and also it's not possible to insert an explicit
-				// barrier to transition the backbuffer layout, so we must rely on the render pass implicit
-				// transitions anyway. I think ideally this logic would get moved to the CalculateResourceBarriers()
-				// function so that the barriers are never created to begin with
-				if (!RequiresExplicitResourceBarrier(renderPass, resourceID))
-				{
-					continue;
-				}
-			}
+		if (res != STATUS_CODE::SUCCESS)
+		{
+			LogError("Failed to insert dependency barriers. Could not record barrier command!");
+			return res;
+		}
+
+		return STATUS_CODE::SUCCESS;
+	}
+
+	STATUS_CODE RenderGraphVk::QueueResourceBarriers(const std::vector<BakedBarrier>& barriers, bool updateLayouts)
+	{
+		DeviceContextVk* pDeviceContext = static_cast<DeviceContextVk*>(GetCurrentDeviceContext());
 
-			const RenderResource* resourceBarrier = GetPhysicalResource(resourceID);
-			ASSERT_PTR(resourceBarrier);
+		for (const BakedBarrier& bakedBarrier : barriers)
+		{
+			const Barrier& currBarrier = bakedBarrier.barrier;
+			const RenderResource* resourceBarrier = &m_physicalResources[bakedBarrier.resourceIndex];
 
 			switch (resourceBarrier->type)
 			{
 			case RESOURCE_TYPE::BUFFER:
-			{
-				BufferVk* pBuffer = ResolveBuffer(*resourceBarrier);
-				res = pDeviceContext->InsertBufferMemoryBarrier(
-					pBuffer,
-					ConvertPassTypeToQueueType(renderPass.m_passType),
-					currBarrier.srcStageMask,
-					currBarrier.dstStageMask,
-					currBarrier.srcAccessMask,
-					currBarrier.dstAccessMask
-				);
-
-				if (res != STATUS_CODE::SUCCESS)
-				{
-					LogError("Failed to insert dependency barriers. Could not insert buffer memory barrier!");
-					return res;
-				}
-
-				break;
-			}
 			case RESOURCE_TYPE::ACCELERATION_STRUCTURE:
 			{
-				AccelerationStructureVk* pAccelerationStructure = ResolveAccelerationStructure(*resourceBarrier);
-				res = pDeviceContext->InsertAccelerationStructureMemoryBarrier(
-					pAccelerationStructure,
-					ConvertPassTypeToQueueType(renderPass.m_passType),
+				// Buffer hazards don't need to be tied to the buffer, since the render graph never transfers queue family
+				// ownership. They're folded into the global memory barrier of the pass
+				pDeviceContext->QueueMemoryBarrier(
 					currBarrier.srcStageMask,
 					currBarrier.dstStageMask,
 					currBarrier.srcAccessMask,
 					currBarrier.dstAccessMask
 				);
 
-				if (res != STATUS_CODE::SUCCESS)
-				{
-					LogError("Failed to insert dependency barriers. Could not insert acceleration structure memory barrier!");
-					return res;
-				}
-
 				break;
 			}
 			case RESOURCE_TYPE::TEXTURE:
 			{
 				TextureVk* pTexture = ResolveTexture(*resourceBarrier);
-				res = pDeviceContext->InsertImageMemoryBarrier(
-					pTexture,
-					ConvertPassTypeToQueueType(renderPass.m_passType),
-					currBarrier.srcStageMask,
-					currBarrier.dstStageMask,
-					currBarrier.srcAccessMask,
-					currBarrier.dstAccessMask,
-					currBarrier.oldLayout,
-					currBarrier.newLayout
-				);
-
-				if (res != STATUS_CODE::SUCCESS)
+				if (pTexture == nullptr || pTexture->GetBaseImage() == VK_NULL_HANDLE)
 				{
-					LogError("Failed to insert dependency barriers. Could not insert image memory barrier!");
-					return res;
+					LogError("Failed to insert dependency barriers. Texture \"%s\" is invalid!", GetResourceName(*resourceBarrier));
+					return STATUS_CODE::ERR_INTERNAL;
 				}
 
+				// The barrier only covers the resource's subresource range. Parts of the range may have been left in different
+				// layouts by passes using overlapping ranges, so the old layouts come from the texture's tracked layouts, with
+				// one barrier for every part of the range that's in a single layout
+				const VkImageSubresourceRange range = pTexture->GetSubresourceRange(resourceBarrier->subresourceRange);
+				pTexture->ForEachLayoutRange(range, [&](const VkImageSubresourceRange& subrange, VkImageLayout oldLayout)
+				{
+					pDeviceContext->QueueImageMemoryBarrier(
+						pTexture,
+						currBarrier.srcStageMask,
+						currBarrier.dstStageMask,
+						currBarrier.srcAccessMask,
+						currBarrier.dstAccessMask,
+						oldLayout,
+						currBarrier.newLayout,
+						subrange
+					);
+				});
+
 				// Update the texture's internal layout variable so it matches it's actual layout
-				pTexture->SetLayout(currBarrier.newLayout);
+				if (updateLayouts)
+				{
+					pTexture->SetLayout(currBarrier.newLayout, range);
+				}
 				break;
 			}
 			case RESOURCE_TYPE::UNIFORM:
@@ -2281,41 +4188,59 @@ namespace PHX
 			}
 		}
 
-		return res;
+		return STATUS_CODE::SUCCESS;
 	}
 
-	void RenderGraphVk::TraverseDependencyTree(u32 renderPassIndex, TraverseDependenciesCallbackFn callback)
+	void RenderGraphVk::TraverseDependencyTree(const std::vector<u32>& rootPassIndices, TraverseDependenciesCallbackFn callback)
 	{
-		// Depth-first traversal
-		if (renderPassIndex >= static_cast<u32>(m_registeredRenderPasses.Size()))
-		{
-			return;
-		}
+		// Depth-first traversal. Every pass is visited once, even if it can be reached through multiple paths or roots
+		const u32 passCount = static_cast<u32>(m_registeredRenderPasses.Size());
 
-		const RenderPassVk* pCurrRenderPass = m_registeredRenderPasses.Get(renderPassIndex);
-		if (callback != nullptr)
+		std::vector<bool> visited(passCount, false);
+		std::vector<u32> pendingPasses;
+		for (u32 rootPassIndex : rootPassIndices)
 		{
-			callback(*pCurrRenderPass);
+			if (rootPassIndex < passCount)
+			{
+				pendingPasses.push_back(rootPassIndex);
+			}
 		}
 
-		for (u32 i = 0; i < static_cast<u32>(pCurrRenderPass->m_dependencyInfos.size()); i++)
+		while (!pendingPasses.empty())
 		{
-			const DependencyInfo& dependencyInfo = pCurrRenderPass->m_dependencyInfos[i];
-			ASSERT_PTR(dependencyInfo.renderPass);
-			TraverseDependencyTree(dependencyInfo.renderPass->m_index, callback);
+			const u32 currPassIndex = pendingPasses.back();
+			pendingPasses.pop_back();
+
+			if (visited[currPassIndex])
+			{
+				continue;
+			}
+			visited[currPassIndex] = true;
+
+			const RenderPassVk* pCurrRenderPass = m_registeredRenderPasses.Get(currPassIndex);
+			if (callback != nullptr)
+			{
+				callback(*pCurrRenderPass);
+			}
+
+			for (const DependencyInfo& dependencyInfo : pCurrRenderPass->m_dependencyInfos)
+			{
+				ASSERT_PTR(dependencyInfo.renderPass);
+				pendingPasses.push_back(dependencyInfo.renderPass->m_index);
+			}
 		}
 	}
 
 	void RenderGraphVk::TraverseResources(const ResourceIndexBitset& resourceBitset, TraverseResourceCallbackFn callback) const
 	{
-		for (u32 i = 0; i < static_cast<u32>(m_physicalResources.size()); i++)
+		const u32 physicalResourceCount = static_cast<u32>(m_physicalResources.size());
+		resourceBitset.ForEachSetBit([&](u32 resourceIndex)
 		{
-			if (resourceBitset.test(i))
+			if (resourceIndex < physicalResourceCount)
 			{
-				const RenderResource& resource = m_physicalResources[i];
-				callback(resource);
+				callback(m_physicalResources[resourceIndex]);
 			}
-		}
+		});
 	}
 
 	void RenderGraphVk::TraverseRenderPassInputs(u32 renderPassIndex, TraverseResourceCallbackFn callback) const
@@ -2342,13 +4267,11 @@ namespace PHX
 
 	const ResourceUsage* RenderGraphVk::GetResourceUsageFromPass(const RenderPassVk& renderPass, u64 resourceID) const
 	{
-		u32 passIndex = renderPass.m_index;
-		for (u32 i = 0; i < static_cast<u32>(m_resourceUsages.size()); i++)
+		for (const ResourceUsageIndex& usageIndex : renderPass.m_resourceUsageIndices)
 		{
-			const ResourceUsage& usage = m_resourceUsages[i];
-			if ((passIndex == usage.passIndex) && (usage.resourceID == resourceID))
+			if (usageIndex.resourceID == resourceID)
 			{
-				return &usage;
+				return &m_resourceUsages[usageIndex.usageIndex];
 			}
 		}
 
@@ -2357,34 +4280,73 @@ namespace PHX
 
 	const RenderResource* RenderGraphVk::GetPhysicalResource(u64 resourceID) const
 	{
-		// TODO - Replace lookup with a map
-		for (u32 i = 0; i < static_cast<u32>(m_physicalResources.size()); i++)
+		const ResourceIndex resourceIndex = GetPhysicalResourceIndex(resourceID);
+		if (resourceIndex == MAX_REGISTERED_RESOURCES)
 		{
-			const RenderResource& resource = m_physicalResources[i];
-			if (resource.resourceID == resourceID)
+			return nullptr;
+		}
+
+		return &m_physicalResources[resourceIndex];
+	}
+
+	ResourceIndex RenderGraphVk::GetPhysicalResourceIndex(u64 resourceID) const
+	{
+		if (m_physicalResourceIndices.empty())
+		{
+			return MAX_REGISTERED_RESOURCES;
+		}
+
+		// Resource IDs are hashes already, so their bits are used as is. The table is never full, so every probe
+		// sequence ends at an empty slot
+		const size_t slotMask = m_physicalResourceIndices.size() - 1;
+		for (size_t slot = static_cast<size_t>(resourceID) & slotMask; ; slot = (slot + 1) & slotMask)
+		{
+			const PhysicalResourceIndex& entry = m_physicalResourceIndices[slot];
+			if (entry.resourceIndex == MAX_REGISTERED_RESOURCES)
 			{
-				return &resource;
+				return MAX_REGISTERED_RESOURCES;
 			}
-		}
 
-		return nullptr;
+			if (entry.resourceID == resourceID)
+			{
+				return entry.resourceIndex;
+			}
+		}
 	}
 
-	void RenderGraphVk::UpdateTextureLayouts(u32 renderPassIndex)
+	void RenderGraphVk::InsertPhysicalResourceIndex(u64 resourceID, ResourceIndex resourceIndex)
 	{
-		RenderPassVk* pRenderPass = m_registeredRenderPasses.Get(renderPassIndex);
-		for (const auto& iter : pRenderPass->m_outputBarriers)
+		// m_physicalResources already holds the new resource, so a rebuild indexes it along with all the others
+		if (m_physicalResources.size() * 2 > m_physicalResourceIndices.size())
+		{
+			const size_t tableSize = Max<size_t>(m_physicalResourceIndices.size() * 2, s_minPhysicalResourceTableSize);
+			m_physicalResourceIndices.assign(tableSize, PhysicalResourceIndex{ 0, MAX_REGISTERED_RESOURCES });
+			for (u32 i = 0; i < static_cast<u32>(m_physicalResources.size()); i++)
+			{
+				InsertPhysicalResourceIndex(m_physicalResources[i].resourceID, static_cast<ResourceIndex>(i));
+			}
+			return;
+		}
+
+		const size_t slotMask = m_physicalResourceIndices.size() - 1;
+		size_t slot = static_cast<size_t>(resourceID) & slotMask;
+		while (m_physicalResourceIndices[slot].resourceIndex != MAX_REGISTERED_RESOURCES)
 		{
-			u64 resourceID = iter.first;
-			const Barrier& barrierInfo = iter.second;
+			slot = (slot + 1) & slotMask;
+		}
 
-			const RenderResource* resource = GetPhysicalResource(resourceID);
-			ASSERT_PTR(resource);
+		m_physicalResourceIndices[slot] = { resourceID, resourceIndex };
+	}
 
-			TextureVk* textureResource = ResolveTexture(*resource);
+	void RenderGraphVk::UpdateTextureLayouts(const BakedRenderPass& bakedRenderPass)
+	{
+		for (const BakedLayoutTransition& layoutTransition : bakedRenderPass.layoutTransitions)
+		{
+			const RenderResource& resource = m_physicalResources[layoutTransition.resourceIndex];
+			TextureVk* textureResource = ResolveTexture(resource);
 			ASSERT_PTR(textureResource);
 
-			textureResource->SetLayout(barrierInfo.newLayout);
+			textureResource->SetLayout(layoutTransition.layout, textureResource->GetSubresourceRange(resource.subresourceRange));
 		}
 	}
 
@@ -2472,10 +4434,13 @@ namespace PHX
 		for (u32 i = 0; i < static_cast<u32>(m_registeredRenderPasses.Size()); i++)
 		{
 			const RenderPassVk* pCurrRenderPass = m_registeredRenderPasses.Get(i);
-			HashCombine(seed, pCurrRenderPass->m_inputResources);
-			HashCombine(seed, pCurrRenderPass->m_outputResources);
+			HashCombine(seed, pCurrRenderPass->m_inputResources.Hash());
+			HashCombine(seed, pCurrRenderPass->m_outputResources.Hash());
 			// Ignore callbacks
 			HashCombine(seed, pCurrRenderPass->m_index);
+			HashCombine(seed, pCurrRenderPass->m_isAsyncCompute);
+			HashCombine(seed, pCurrRenderPass->m_isRootPass);
+			HashCombine(seed, pCurrRenderPass->m_usesExclusiveTextures);
 
 			HashCombine(seed, pCurrRenderPass->m_passType);
 			switch (pCurrRenderPass->m_passType)
@@ -2510,13 +4475,13 @@ namespace PHX
 			}
 			}
 
-			auto HashBarrierFn = [&](const std::unordered_map<u64, Barrier>& barrierMap, u64& seed)
+			auto HashBarrierFn = [&](const ResourceBarrierList& barriers, u64& seed)
 			{
-				HashCombine(seed, barrierMap.size());
-				for (const auto& barrierIter : barrierMap)
+				HashCombine(seed, barriers.size());
+				for (const ResourceBarrier& resourceBarrier : barriers)
 				{
-					// Ignore barrierIter.first (resourceID) - may change per frame
-					const Barrier& currInputBarrier = barrierIter.second;
+					// Ignore resourceBarrier.resourceID - may change per frame
+					const Barrier& currInputBarrier = resourceBarrier.barrier;
 					HashCombine(seed, currInputBarrier.dstAccessMask);
 					HashCombine(seed, currInputBarrier.dstStageMask);
 					HashCombine(seed, currInputBarrier.srcAccessMask);
@@ -2541,6 +4506,7 @@ namespace PHX
 			HashCombine(seed, currUsage.storeOp);
 			HashCombine(seed, currUsage.loadOp);
 			// Ignore clearValue
+			HashCombine(seed, currUsage.isInputAttachment);
 			HashCombine(seed, currUsage.bufferUsage);
 			// Ignore resourceID - derived from handle, may change per frame
 			HashCombine(seed, currUsage.passIndex);
@@ -2556,11 +4522,86 @@ namespace PHX
 			// resourceID is derived from the handle (index + generation) and may
 			// change per frame
 			HashCombine(seed, currResource.type);
+			HashCombine(seed, currResource.subresourceRange.baseMipLevel);
+			HashCombine(seed, currResource.subresourceRange.mipLevelCount);
+			HashCombine(seed, currResource.subresourceRange.baseArrayLayer);
+			HashCombine(seed, currResource.subresourceRange.arrayLayerCount);
 		}
 
 		return seed;
 	}
 
+	void RenderGraphVk::BuildBakeKey(std::vector<u64>& out_key)
+	{
+		PROFILE_SCOPE("RenderGraphVk_BuildBakeKey");
+
+		out_key.clear();
+		out_key.push_back(m_presentResID);
+
+		// Render passes. Bitsets are written as their bit count followed by the set bits, so bitsets of different sizes
+		// can't produce the same words
+		auto AppendBitsetFn = [&out_key](const ResourceIndexBitset& bitset)
+		{
+			out_key.push_back(bitset.Count());
+			bitset.ForEachSetBit([&out_key](u32 index)
+			{
+				out_key.push_back(index);
+			});
+		};
+
+		out_key.push_back(m_registeredRenderPasses.Size());
+		for (u32 i = 0; i < static_cast<u32>(m_registeredRenderPasses.Size()); i++)
+		{
+			const RenderPassVk* pCurrRenderPass = m_registeredRenderPasses.Get(i);
+			out_key.push_back(pCurrRenderPass->m_index);
+			out_key.push_back(static_cast<u64>(pCurrRenderPass->m_passType));
+			out_key.push_back(pCurrRenderPass->m_isAsyncCompute);
+			out_key.push_back(pCurrRenderPass->m_isRootPass);
+			out_key.push_back(pCurrRenderPass->m_usesExclusiveTextures);
+			out_key.push_back(pCurrRenderPass->m_shaderStageMask);
+			AppendBitsetFn(pCurrRenderPass->m_inputResources);
+			AppendBitsetFn(pCurrRenderPass->m_outputResources);
+		}
+
+		// Resource usages. Clear values are read when the passes execute
+		out_key.push_back(m_resourceUsages.size());
+		for (const ResourceUsage& currUsage : m_resourceUsages)
+		{
+			out_key.push_back(static_cast<u64>(currUsage.io));
+			out_key.push_back(static_cast<u64>(currUsage.attachmentType));
+			out_key.push_back(static_cast<u64>(currUsage.storeOp));
+			out_key.push_back(static_cast<u64>(currUsage.loadOp));
+			out_key.push_back(currUsage.isInputAttachment);
+			out_key.push_back(static_cast<u64>(currUsage.bufferUsage));
+			out_key.push_back(currUsage.resourceID);
+			out_key.push_back(currUsage.passIndex);
+		}
+
+		// Physical resources. Barriers, render passes and framebuffers all depend on the texture objects
+		// and on the layout they're in at the start of the frame
+		out_key.push_back(m_physicalResources.size());
+		for (u32 i = 0; i < static_cast<u32>(m_physicalResources.size()); i++)
+		{
+			const RenderResource& currResource = m_physicalResources[i];
+			out_key.push_back(currResource.resourceID);
+			out_key.push_back(static_cast<u64>(currResource.type));
+			out_key.push_back(currResource.subresourceRange.baseMipLevel);
+			out_key.push_back(currResource.subresourceRange.mipLevelCount);
+			out_key.push_back(currResource.subresourceRange.baseArrayLayer);
+			out_key.push_back(currResource.subresourceRange.arrayLayerCount);
+
+			if (currResource.type == RESOURCE_TYPE::TEXTURE)
+			{
+				TextureVk* pTexture = ResolveTexture(currResource);
+				out_key.push_back(reinterpret_cast<u64>(pTexture));
+				if (pTexture != nullptr)
+				{
+					out_key.push_back(static_cast<u64>(pTexture->GetLayout(pTexture->GetSubresourceRange(currResource.subresourceRange))));
+				}
+			}
+		}
+	}
+
 	void RenderGraphVk::CallExecutionCallback(const RenderPassVk& renderPass, const DeviceContextHandle& deviceContext)
 	{
 		PROFILE_SCOPE("RenderGraphVk_CallExecutionCallback");
@@ -2570,4 +4611,262 @@ namespace PHX
 			renderPass.m_execCallback(deviceContext);
 		}
 	}
+
+	size_t RenderGraphVk::GetFrameStorageCapacity() const
+	{
+		size_t capacity = m_resourceUsages.capacity() * sizeof(ResourceUsage);
+		capacity += m_physicalResources.capacity() * sizeof(RenderResource);
+		capacity += m_physicalResourceIndices.capacity() * sizeof(PhysicalResourceIndex);
+		capacity += m_renderPassPool.capacity() * sizeof(RenderPassVk*);
+		capacity += m_passBatchIndices.capacity() * sizeof(u32);
+		capacity += m_producerBatchIndices.capacity() * sizeof(u32);
+		capacity += m_clearValues.capacity() * sizeof(ClearValues);
+		capacity += m_transientLifetimes.capacity() * sizeof(TransientLifetime);
+		capacity += m_workerContexts.capacity() * sizeof(DeviceContextVk*);
+		capacity += m_workerResults.capacity() * sizeof(STATUS_CODE);
+		capacity += m_splitBarrierEvents.capacity() * sizeof(VkEvent);
+		capacity += m_bakeKey.capacity() * sizeof(u64);
+		capacity += m_passMetrics.capacity() * sizeof(PassMetrics);
+		capacity += m_passMetricNames.capacity() * sizeof(PassMetricName);
+		for (const QueryRingSlot& slot : m_queryRing)
+		{
+			capacity += slot.passQueryRecords.capacity() * sizeof(PassQueryRecord);
+		}
+
+		return capacity;
+	}
+
+	void RenderGraphVk::CountFrameStorageGrowths()
+	{
+		// Containers never give back their memory, so their capacity only changes when they allocate. Every container
+		// that grew allocated at least once, which is all that's needed to tell whether a frame allocated at all
+		const size_t storageCapacity = GetFrameStorageCapacity();
+		if (storageCapacity > m_countedStorageCapacity)
+		{
+			m_frameStorageGrowths++;
+			m_countedStorageCapacity = storageCapacity;
+		}
+
+		for (u32 i = 0; i < m_usedRenderPassCount; i++)
+		{
+			RenderPassVk* pRenderPass = m_renderPassPool[i];
+
+			const size_t passStorageCapacity = pRenderPass->GetStorageCapacity();
+			if (passStorageCapacity > pRenderPass->m_countedStorageCapacity)
+			{
+				m_frameStorageGrowths++;
+				pRenderPass->m_countedStorageCapacity = passStorageCapacity;
+			}
+		}
+
+		DeviceContextVk* pDeviceContext = static_cast<DeviceContextVk*>(GetCurrentDeviceContext());
+		if (pDeviceContext->HasScratchStorageGrown())
+		{
+			m_frameStorageGrowths++;
+		}
+
+		for (DeviceContextVk* pWorkerContext : m_workerContexts)
+		{
+			if (pWorkerContext != nullptr && pWorkerContext->HasScratchStorageGrown())
+			{
+				m_frameStorageGrowths++;
+			}
+		}
+
+		if (m_pRenderDevice->GetReadbackPool()->HasStorageGrown())
+		{
+			m_frameStorageGrowths++;
+		}
+	}
+
+	bool RenderGraphVk::IsPassTimed(const RenderPassVk& renderPass, u32 position) const
+	{
+		// Transfer queues aren't guaranteed to support timestamps
+		return m_passTimestampQueryPool != VK_NULL_HANDLE && position < s_maxTimedPassCount && GetPassQueueType(renderPass) != QUEUE_TYPE::TRANSFER;
+	}
+
+	bool RenderGraphVk::HasPassPipelineStatistics(const RenderPassVk& renderPass) const
+	{
+		// The async compute queue isn't guaranteed to be in the graphics queue family
+		const QUEUE_TYPE queueType = GetPassQueueType(renderPass);
+		return m_passStatisticsQueryPool != VK_NULL_HANDLE && (queueType == QUEUE_TYPE::GRAPHICS || queueType == QUEUE_TYPE::COMPUTE) && !IsAsyncComputePass(renderPass);
+	}
+
+	void RenderGraphVk::ResetPassQueries(DeviceContextVk* pDeviceContext, const RenderPassVk& renderPass, const BakedRenderPass& bakedPass, u32 position)
+	{
+		if (!IsPassTimed(renderPass, position))
+		{
+			return;
+		}
+
+		const QUEUE_TYPE queueType = GetPassQueueType(renderPass);
+		const u32 subpassCount = (renderPass.m_passType == PASS_TYPE::GRAPHICS) ? bakedPass.subpassCount : 1;
+		const u32 passCount = std::min(subpassCount, s_maxTimedPassCount - position);
+		const u32 firstPassSlot = m_queryRingIndex * s_maxTimedPassCount + position;
+
+		pDeviceContext->ResetQueries(queueType, m_passTimestampQueryPool, firstPassSlot * 2, passCount * 2);
+		if (HasPassPipelineStatistics(renderPass))
+		{
+			pDeviceContext->ResetQueries(queueType, m_passStatisticsQueryPool, firstPassSlot, passCount);
+		}
+	}
+
+	void RenderGraphVk::BeginPassQueries(DeviceContextVk* pDeviceContext, const RenderPassVk& renderPass, u32 position)
+	{
+		if (!IsPassTimed(renderPass, position))
+		{
+			return;
+		}
+
+		const QUEUE_TYPE queueType = GetPassQueueType(renderPass);
+		const u32 passSlot = m_queryRingIndex * s_maxTimedPassCount + position;
+
+		pDeviceContext->WriteTimestamp(queueType, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_passTimestampQueryPool, passSlot * 2);
+		if (HasPassPipelineStatistics(renderPass))
+		{
+			pDeviceContext->BeginQuery(queueType, m_passStatisticsQueryPool, passSlot);
+		}
+	}
+
+	void RenderGraphVk::EndPassQueries(DeviceContextVk* pDeviceContext, const RenderPassVk& renderPass, u32 position)
+	{
+		if (!IsPassTimed(renderPass, position))
+		{
+			return;
+		}
+
+		const QUEUE_TYPE queueType = GetPassQueueType(renderPass);
+		const u32 passSlot = m_queryRingIndex * s_maxTimedPassCount + position;
+
+		if (HasPassPipelineStatistics(renderPass))
+		{
+			pDeviceContext->EndQuery(queueType, m_passStatisticsQueryPool, passSlot);
+		}
+		pDeviceContext->WriteTimestamp(queueType, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_passTimestampQueryPool, passSlot * 2 + 1);
+	}
+
+	void RenderGraphVk::AddPassQueryRecord(const RenderPassVk& renderPass, u32 position)
+	{
+		if (!IsPassTimed(renderPass, position))
+		{
+			return;
+		}
+
+		PassQueryRecord record;
+#if defined(PHX_DEBUG)
+		snprintf(record.name.name, MAX_PASS_METRIC_NAME_LENGTH, "%s", (renderPass.m_debugName != nullptr) ? renderPass.m_debugName : "");
+#else
+		snprintf(record.name.name, MAX_PASS_METRIC_NAME_LENGTH, "%u", renderPass.m_index);
+#endif
+		record.position = position;
+		record.hasPipelineStatistics = HasPassPipelineStatistics(renderPass);
+
+		m_queryRing[m_queryRingIndex].passQueryRecords.push_back(std::move(record));
+	}
+
+	void RenderGraphVk::ReadQueryResults()
+	{
+		PROFILE_SCOPE("RenderGraphVk_ReadQueryResults");
+
+		m_passMetrics.clear();
+		m_passMetricNames.clear();
+
+		// The device context has waited for every frame at least frames-in-flight old, so their queries are done. Only the
+		// newest of them is reported, which keeps the latency of the results constant
+		const u32 framesInFlight = m_pRenderDevice->GetFramesInFlight();
+		u32 newestSlotIndex = U32_MAX;
+		for (u32 slotIndex = 0; slotIndex < static_cast<u32>(m_queryRing.size()); slotIndex++)
+		{
+			QueryRingSlot& slot = m_queryRing[slotIndex];
+			if (!slot.isPending || slot.frameNumber + framesInFlight > m_frameNumber)
+			{
+				continue;
+			}
+
+			slot.isPending = false;
+			if (newestSlotIndex == U32_MAX || slot.frameNumber > m_queryRing[newestSlotIndex].frameNumber)
+			{
+				newestSlotIndex = slotIndex;
+			}
+		}
+
+		if (newestSlotIndex == U32_MAX)
+		{
+			return;
+		}
+
+		const QueryRingSlot& slot = m_queryRing[newestSlotIndex];
+		m_metrics.gpuFrameNumber = slot.frameNumber;
+
+		// Results are never waited on. Queries that aren't available were never written, e.g. if the frame didn't record
+		// any work on a queue that supports timestamps
+		if (m_queryPool != VK_NULL_HANDLE)
+		{
+			u64 timestamps[4] = { 0, 0, 0, 0 }; // Value and availability of each query
+			VkResult vkRes = vkGetQueryPoolResults(
+				m_pRenderDevice->GetLogicalDevice(),
+				m_queryPool,
+				newestSlotIndex * 2,
+				2,
+				sizeof(timestamps),
+				timestamps,
+				sizeof(u64) * 2,
+				VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+			if (vkRes == VK_SUCCESS && timestamps[1] != 0 && timestamps[3] != 0)
+			{
+				u64 diff = timestamps[2] - timestamps[0];
+				m_metrics.gpuFrameTime = static_cast<float>(diff) * m_timestampPeriod / 1e6f;
+			}
+		}
+
+		ReadPassQueryResults(slot, newestSlotIndex);
+	}
+
+	void RenderGraphVk::ReadPassQueryResults(const QueryRingSlot& slot, u32 slotIndex)
+	{
+		PROFILE_SCOPE("RenderGraphVk_ReadPassQueryResults");
+
+		VkDevice device = m_pRenderDevice->GetLogicalDevice();
+		for (const PassQueryRecord& record : slot.passQueryRecords)
+		{
+			const u32 passSlot = slotIndex * s_maxTimedPassCount + record.position;
+
+			u64 timestamps[4] = { 0, 0, 0, 0 }; // Value and availability of each query
+			VkResult vkRes = vkGetQueryPoolResults(device, m_passTimestampQueryPool, passSlot * 2, 2, sizeof(timestamps), timestamps, sizeof(u64) * 2,
+				VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+			if (vkRes != VK_SUCCESS || timestamps[1] == 0 || timestamps[3] == 0)
+			{
+				continue;
+			}
+
+			PassMetrics passMetrics{};
+			passMetrics.frameNumber = slot.frameNumber;
+			passMetrics.gpuTime = static_cast<float>(timestamps[2] - timestamps[0]) * m_timestampPeriod / 1e6f;
+
+			if (record.hasPipelineStatistics)
+			{
+				u64 statistics[s_passPipelineStatisticCount + 1] = {}; // Followed by the availability
+				vkRes = vkGetQueryPoolResults(device, m_passStatisticsQueryPool, passSlot, 1, sizeof(statistics), statistics, sizeof(statistics),
+					VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+				if (vkRes == VK_SUCCESS && statistics[s_passPipelineStatisticCount] != 0)
+				{
+					passMetrics.hasPipelineStatistics = true;
+					passMetrics.vertexShaderInvocations = statistics[0];
+					passMetrics.clippingPrimitives = statistics[1];
+					passMetrics.fragmentShaderInvocations = statistics[2];
+					passMetrics.computeShaderInvocations = statistics[3];
+				}
+			}
+
+			m_passMetrics.push_back(passMetrics);
+			m_passMetricNames.push_back(record.name);
+		}
+
+		// Only point to the names once they're done being added, since adding names may move them
+		for (size_t i = 0; i < m_passMetrics.size(); i++)
+		{
+			m_passMetrics[i].name = m_passMetricNames[i].name;
+		}
+	}
 }
\ No newline at end of file
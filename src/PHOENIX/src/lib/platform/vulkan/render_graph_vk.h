@@ -1,7 +1,8 @@
 #pragma once
 
-#include <bitset>
 #include <functional>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "BSL/crc32.h"
@@ -9,7 +10,10 @@
 #include "core/interface_types/render_graph_interface.h"
 #include "framebuffer_vk.h"
 #include "pipeline_vk.h"
+#include "texture_vk.h"
 #include "utils/render_graph_utils.h"
+#include "utils/resource_bitset.h"
+#include "utils/transient_resource_pool.h"
 
 namespace PHX
 {
@@ -22,25 +26,21 @@ namespace PHX
 	class RenderDeviceVk;
 	class RenderGraphVk;
 	class RenderPassVk;
+	class SwapChainVk;
 	class TextureVk;
+	class TransientResourcePool;
 	class BufferVk;
+	class WorkerPool;
 
 
-	// Callback used by the render pass class to register resources into
-	// the render graph. The render graph owns the resources, and once
-	// they're registered this function will return the resource index
-	// that should then be cached in the render pass's input/output bitsets.
-	// Parameters are the handle (Handle), resource type (RESOURCE_TYPE), and 
-	// resource usage (ResourceUsage)
-	typedef std::function<ResourceIndex(Handle, RESOURCE_TYPE, const ResourceUsage&)> RegisterResourceCallbackFn;
-
 	// Called for every render pass touched when traversing the dependency tree
 	typedef std::function<void(const RenderPassVk&)> TraverseDependenciesCallbackFn;
 
 	// Called for every resource touched while traversing a resource bitset
 	typedef std::function<void(const RenderResource&)> TraverseResourceCallbackFn;
 
-	typedef std::bitset<MAX_REGISTERED_RESOURCES> ResourceIndexBitset;
+	// Sized to the highest physical resource index set, rather than MAX_REGISTERED_RESOURCES
+	typedef ResourceBitset ResourceIndexBitset;
 
 	struct Barrier
 	{
@@ -53,29 +53,191 @@ namespace PHX
 		VkImageLayout newLayout; // Only for images, ignored for buffers
 	};
 
+	// Barrier of a single physical resource. Passes only touch a handful of resources, so their barriers are kept in flat
+	// lists rather than hash maps, which would allocate for every barrier
+	struct ResourceBarrier
+	{
+		u64 resourceID;
+		Barrier barrier;
+	};
+	typedef std::vector<ResourceBarrier> ResourceBarrierList;
+
+	// Index of a pass' first usage of a physical resource in the render graph's resource usages
+	struct ResourceUsageIndex
+	{
+		u64 resourceID;
+		u32 usageIndex;
+	};
+
+	// Index of a physical resource in the render graph's physical resources
+	struct PhysicalResourceIndex
+	{
+		u64 resourceID;
+		ResourceIndex resourceIndex;
+	};
+
 	struct DependencyInfo
 	{
 		RenderPassVk* renderPass = nullptr;
 		ResourceIndexBitset resources;
 	};
 
+	// Barrier against a physical resource index rather than a resource ID, so that it can be
+	// replayed against the resources registered in a later frame
+	struct BakedBarrier
+	{
+		ResourceIndex resourceIndex;
+		Barrier barrier;
+	};
+
+	// Layout a texture is implicitly transitioned to by a render pass
+	struct BakedLayoutTransition
+	{
+		ResourceIndex resourceIndex;
+		VkImageLayout layout;
+	};
+
+	// Barriers between a producer and a consumer which are separated by passes that don't touch the synchronized
+	// resources. The producer signals an event once it's done and the consumer waits on it, instead of a single
+	// barrier right before the consumer, so the passes in between can overlap with the tail of the producer
+	struct BakedSplitBarrier
+	{
+		u32 signalPosition;                 // Position of the pass that signals the event, which is the producer's last subpass
+		u32 waitPosition;                   // Position of the pass that waits on the event, which is the consumer's first subpass
+		std::vector<BakedBarrier> barriers;
+	};
+
+	struct BakedDependency
+	{
+		u32 passIndex;
+		ResourceIndexBitset resources;
+	};
+
+	// Everything required to execute a single render pass without re-baking the render graph
+	struct BakedRenderPass
+	{
+		u32 passIndex                                       = 0;
+		std::vector<BakedBarrier> barriers;                 // Explicit barriers inserted before the pass executes
+		std::vector<BakedLayoutTransition> layoutTransitions;
+		std::vector<BakedLayoutTransition> inputAttachmentLayouts; // Layouts the input attachments are read in during the pass
+		std::vector<ResourceIndex> transientFirstUses;      // Transient resources first used by this pass
+
+		// Indices into BakedRenderGraph::splitBarriers. Signals are recorded after the pass executes (last subpass only),
+		// and waits replace the barriers of the pass (first subpass only)
+		std::vector<u32> splitBarrierSignals;
+		std::vector<u32> splitBarrierWaits;
+
+		// Graphics passes merged into the same render pass execute as consecutive subpasses. The first subpass holds
+		// the barriers, attachments and render pass objects of the entire render pass
+		u32 subpassIndex                                    = 0;
+		u32 subpassCount                                    = 1;
+
+		// Graphics only, first subpass only. Looked up the first time the pass executes, and reused afterwards
+		std::vector<ResourceIndex> attachments;             // Attachments of the render pass, in attachment order
+		std::vector<u32> clearValueUsageIndices;            // Index into the resource usages for every attachment, in attachment order
+		ResourceIndexBitset discardedAttachments;           // Attachments which are never used outside of the render pass, so they're not stored
+		VkRenderPass renderPass                             = VK_NULL_HANDLE;
+		FramebufferVk* pFramebuffer                         = nullptr;
+		bool isBackbuffer                                   = false;
+
+		// Snapshot of the pass' dependencies and barriers. Only used to restore the state of
+		// the render passes when generating a visualization for a replayed render graph
+		std::vector<BakedDependency> dependencies;
+		ResourceBarrierList inputBarriers;
+		ResourceBarrierList outputBarriers;
+	};
+
+	// Range of baked passes during which a transient resource is used
+	struct BakedTransientLifetime
+	{
+		ResourceIndex resourceIndex;
+		u32 firstUse;
+		u32 lastUse;
+		bool isAttachmentOnly; // Only used as an attachment of a single render pass
+	};
+
+	struct BakedRenderGraph
+	{
+		std::vector<BakedRenderPass> passes; // In execution order
+		std::vector<BakedTransientLifetime> transientLifetimes;
+		std::vector<BakedSplitBarrier> splitBarriers;
+		u32 removedStageBits = 0;            // Stage bits removed from the barriers thanks to shader reflection, for debugging
+		u64 graphHash = 0;                   // HashState() after baking, used for visualization
+
+		// Everything the render graph was baked from, see BuildBakeKey(). Compared on lookup, since different
+		// render graphs may hash to the same value
+		std::vector<u64> key;
+		u32 lastUsedFrame = 0;               // Least recently used render graph is evicted when the cache is full
+	};
+
+	// Everything a worker thread needs to record a baked pass. Prepared on the calling thread in execution order, after
+	// the barriers of the pass have been recorded into the command buffer
+	struct ParallelRecordedPass
+	{
+		BakedRenderPass* pBakedPass                = nullptr;
+		const BakedRenderPass* pFirstSubpass       = nullptr;
+		PipelineVk* pPipeline                      = nullptr;
+		VkCommandBuffer cmdBuffer                  = VK_NULL_HANDLE; // Shared by all subpasses of a render pass
+		u32 workerIndex                            = 0;
+		u32 position                               = 0;              // Position of the pass in execution order
+		std::vector<ClearValues> clearValues;      // First subpass only
+		TextureVk::LayoutOverrides textureLayouts; // Layouts of the pass' textures while the pass executes
+	};
+
+	// Pass names are copied into fixed-size buffers, since the name passed to RegisterPass() only has to live for the
+	// frame, while query results are read back frames later. Longer names are truncated
+	static constexpr u32 MAX_PASS_METRIC_NAME_LENGTH = 64;
+
+	struct PassMetricName
+	{
+		char name[MAX_PASS_METRIC_NAME_LENGTH];
+	};
+
+	// Pass whose GPU queries were recorded in a frame. The queries are read back once the frame has finished executing
+	struct PassQueryRecord
+	{
+		PassMetricName name;
+		u32 position               = 0; // Position of the pass in execution order, which determines its query slots
+		bool hasPipelineStatistics = false;
+	};
+
+	// Queries of a single frame in the render graph's query ring. The ring is one slot deeper than the number of frames in
+	// flight, so a slot's results are always available by the time the slot is reused, and reading them never has to wait
+	struct QueryRingSlot
+	{
+		std::vector<PassQueryRecord> passQueryRecords;
+		u32 frameNumber = 0;
+		bool hasQueries = false; // The frame's queries were recorded by Bake()
+		bool isPending  = false; // The frame was submitted, but its results haven't been read back yet
+	};
+
 	class RenderPassVk : public IRenderPass
 	{
 	public:
 
 		friend class RenderGraphVk;
 
-		explicit RenderPassVk(const char* name, PASS_TYPE passType, u32 index, RegisterResourceCallbackFn registerResourceCallback);
+		explicit RenderPassVk(RenderGraphVk* pRenderGraph);
 		~RenderPassVk() override;
 
+		// Render passes are reused every frame. Resets the pass to its freshly registered state, while keeping the memory
+		// of its containers around so a steady frame doesn't allocate
+		void Reset(const char* name, PASS_TYPE passType, u32 index);
+
+		// Size of the memory held by the pass' containers, in bytes
+		size_t GetStorageCapacity() const;
+
 		// Inputs
 		void SetTextureInput(TextureHandle texture) override;
+		void SetTextureInput(TextureHandle texture, const TextureSubresourceRange& range) override;
 		void SetBufferInput(BufferHandle buffer) override;
 		void SetUniformInput(UniformCollectionHandle uniformCollection) override; // Not sure if I want to keep this
 		void SetAccelerationStructureInput(AccelerationStructureHandle accelerationStructure) override;
+		void SetInputAttachment(TextureHandle texture) override;
 
 		// Outputs
 		void SetTextureOutput(TextureHandle texture, ATTACHMENT_LOAD_OP loadOp, ATTACHMENT_STORE_OP storeOp, ClearValues clearValue = {}) override;
+		void SetTextureOutput(TextureHandle texture, const TextureSubresourceRange& range, ATTACHMENT_LOAD_OP loadOp, ATTACHMENT_STORE_OP storeOp, ClearValues clearValue = {}) override;
 		void SetColorOutput(TextureHandle texture) override;
 		void SetDepthOutput(TextureHandle texture) override;
 		void SetDepthStencilOutput(TextureHandle texture) override;
@@ -91,6 +253,10 @@ namespace PHX
 		// Callbacks
 		void SetExecuteCallback(ExecuteRenderPassCallbackFn callback) override;
 
+		// Scheduling
+		void SetAsyncCompute(bool asyncCompute) override;
+		void MarkAsRoot() override;
+
 	private:
 
 		BSL::CRC32 m_name;
@@ -101,9 +267,14 @@ namespace PHX
 
 		ResourceIndexBitset m_inputResources;					// Physical resource indices which this pass reads from
 		ResourceIndexBitset m_outputResources;					// Physical resources indices which this pass writes to
+		ResourceIndexBitset m_inputAttachments;					// Subset of m_inputResources which are read through input attachments
 		ExecuteRenderPassCallbackFn m_execCallback;				// Execution callback called by the render graph if all validation checks are passed
-		RegisterResourceCallbackFn m_registerResourceCallback;	// Callback used to register resources into the render graph
+		RenderGraphVk* m_pRenderGraph;							// Render graph the pass registers its resources into
 		u32 m_index;											// Index of the render pass in the context of the render graph
+		bool m_isAsyncCompute;									// Compute pass submitted to the async compute queue
+		bool m_isRootPass;										// Output of the render graph, never trimmed
+		bool m_usesExclusiveTextures;							// Transfer only. Touches a texture the transfer queue family can't access, or can't copy arbitrary regions of
+		VkPipelineStageFlags m_shaderStageMask;					// Stages of the pass' shaders which access resources, according to reflection. 0 if unknown
 
 		// TODO - Use union
 		GraphicsPipelineDesc graphicsDesc;
@@ -113,34 +284,46 @@ namespace PHX
 
 		std::vector<DependencyInfo> m_dependencyInfos;
 
-		// Maps a physical resource ID to it's barrier. These barriers guard the inputs to this render
+		// Barrier of every physical resource ID. These barriers guard the inputs to this render
 		// pass against all dependencies' outputs depending on usage. All src flags correspond to a dependent 
 		// resource, and all dst flags correspond to an input resource in this pass. For any given barrier, 
 		// the src/dst flags are all related to the same physical resource, but the usage is different between 
 		// the dependency and this pass.
-		std::unordered_map<u64, Barrier> m_inputBarriers;
+		ResourceBarrierList m_inputBarriers;
 
-		// Maps a physical resource ID to it's barrier. Same concept as m_inputBarriers above, except
+		// Barrier of every physical resource ID. Same concept as m_inputBarriers above, except
 		// that this holds barrier information for all outputs in this pass. This is useful when creating
 		// render passes, since the finalLayout of an image must be specified during subpass creation.
-		std::unordered_map<u64, Barrier> m_outputBarriers;
+		ResourceBarrierList m_outputBarriers;
+
+		// Index of this pass' first usage of every physical resource ID in the render graph's resource
+		// usages. Populated by the render graph when resources are registered
+		std::vector<ResourceUsageIndex> m_resourceUsageIndices;
 
-		//bool m_isRootPass; // TODO? Might be useful to prevent certain passes from being trimmed even if unused. E.g. their result is used in subsequent frames
+		size_t m_countedStorageCapacity; // GetStorageCapacity() when growths were last counted. Kept across Reset()
 	};
 
 	class RenderGraphVk : public IRenderGraph
 	{
 	public:
 
+		friend class RenderPassVk;
+
 		RenderGraphVk(RenderDeviceVk* pRenderDevice);
 		~RenderGraphVk() override;
 
 		STATUS_CODE BeginFrame(SwapChainHandle swapChain) override;
 		STATUS_CODE EndFrame(SwapChainHandle swapChain) override;
+		STATUS_CODE BeginFrame() override;
+		STATUS_CODE EndFrame() override;
 		STATUS_CODE RegisterPass(const char* passName, PASS_TYPE passType, RenderPassHandle& renderPass) override;
+		STATUS_CODE CreateTransientTexture(const TextureBaseCreateInfo& baseCreateInfo, const TextureViewCreateInfo& viewCreateInfo, const TextureSamplerCreateInfo& samplerCreateInfo, TextureHandle& texture) override;
+		STATUS_CODE CreateTransientBuffer(const BufferCreateInfo& createInfo, BufferHandle& buffer) override;
 		STATUS_CODE Bake(SwapChainHandle swapChain) override;
+		STATUS_CODE Bake() override;
 		u32 GetFrameNumber() const override;
 		const Metrics& GetMetrics() const override;
+		const PassMetrics* GetPassMetrics(u32& out_passCount) const override;
 		STATUS_CODE GenerateVisualization(const char* fileName, bool generateIfUnique) override;
 
 		IDeviceContext* GetCurrentDeviceContext() override;
@@ -153,32 +336,116 @@ namespace PHX
 
 	private:
 
-		VkRenderPass CreateRenderPass(const RenderPassVk& renderPass);
-		FramebufferVk* CreateFramebuffer(const RenderPassVk& renderPass, VkRenderPass renderPassVk, bool isBackBuffer);
-		PipelineVk* CreatePipeline(const RenderPassVk& renderPass, VkRenderPass renderPassVk);
-		ResourceIndex RegisterResource(Handle resource, RESOURCE_TYPE type, const ResourceUsage& usage);
+		// Shared by the swapchain and headless overloads. Headless frames pass a null swap chain, and bake with
+		// a present resource ID of 0
+		STATUS_CODE BeginFrameInternal(SwapChainVk* pSwapChain);
+		STATUS_CODE EndFrameInternal(SwapChainVk* pSwapChain);
+		STATUS_CODE BakeInternal();
+
+		// Creates the render pass for the given baked subpasses, which must be consecutive and start at the first subpass
+		VkRenderPass CreateRenderPass(const BakedRenderPass* pSubpasses, u32 subpassCount);
+		FramebufferVk* CreateFramebuffer(const BakedRenderPass& firstSubpass, VkRenderPass renderPassVk, bool isBackBuffer);
+		PipelineVk* CreatePipeline(const RenderPassVk& renderPass, VkRenderPass renderPassVk, u32 subpassIndex);
+		// Textures are registered as a separate physical resource for every subresource range they're used with. The range
+		// must already be clamped to the texture
+		ResourceIndex RegisterResource(Handle resource, RESOURCE_TYPE type, const ResourceUsage& usage, const TextureSubresourceRange& subresourceRange = {});
+
+		// Finds the physical resources which are different subresource ranges of the same texture, and share subresources
+		void FindOverlappingResources();
+
+		// Returns the pass' usage of the physical resource, or of a physical resource overlapping it if the pass doesn't use
+		// the resource itself. out_resourceID is set to the ID of the resource the usage belongs to
+		const ResourceUsage* GetOverlappingResourceUsageFromPass(const RenderPassVk& renderPass, ResourceIndex resourceIndex, u64& out_resourceID) const;
+
+		// Merges consecutive graphics passes into subpasses of the same render pass, if every dependency between them
+		// is on attachments that are only accessed at the same pixel (through input attachments). For every active render
+		// pass, out_firstSubpasses holds the position of the first pass of the render pass it's merged into. Active render
+		// passes must be given in execution order
+		void CombineRenderPasses(const std::vector<u32>& activeRenderPasses, std::vector<u32>& out_firstSubpasses);
+
+		// Returns the texture outputs and input attachments of the render pass
+		ResourceIndexBitset GetRenderPassAttachments(const RenderPassVk& renderPass) const;
+
+		// Returns true if the render pass is submitted to the async compute queue
+		bool IsAsyncComputePass(const RenderPassVk& renderPass) const;
+
+		// Returns the queue the render pass' commands are recorded for. Transfer passes run on the graphics queue unless they
+		// can run on a dedicated transfer queue family
+		QUEUE_TYPE GetPassQueueType(const RenderPassVk& renderPass) const;
+
+		// Returns true if the passes run on different queue families, so their dependency is synchronized by a semaphore
+		bool IsCrossQueueFamilyDependency(const RenderPassVk& srcRenderPass, const RenderPassVk& dstRenderPass) const;
+
+		// Compiles the dependency tree and barriers of the active render passes into a baked render graph,
+		// which can be replayed in later frames. Active render passes must be given in execution order, along
+		// with the first subpasses from CombineRenderPasses()
+		void BuildBakedRenderGraph(const std::vector<u32>& activeRenderPasses, const std::vector<u32>& firstSubpasses, BakedRenderGraph& out_bakedRenderGraph);
+		STATUS_CODE ExecuteBakedRenderGraph(BakedRenderGraph& bakedRenderGraph);
+
+		// Distributes the baked passes over the worker threads. Every render pass (including all of its subpasses) or
+		// non-graphics pass is recorded by a single worker into its own command buffer, and the command buffers are
+		// submitted in execution order. Barriers are still recorded on the calling thread, in execution order
+		STATUS_CODE ExecuteBakedRenderGraphParallel(BakedRenderGraph& bakedRenderGraph);
+		STATUS_CODE RecordParallelPass(ParallelRecordedPass& recordedPass, DeviceContextVk* pWorkerContext, const DeviceContextHandle& workerContext);
+
+		// Makes the device context record the pass into a batch that waits on the batches of its dependencies
+		STATUS_CODE PreparePassBatch(const BakedRenderPass& bakedPass, std::vector<u32>& passBatchIndices, std::vector<u32>& producerBatchIndices);
+
+		// Inserts the barriers required before the pass executes, including the ones for aliased transient resources
+		// and the waits of the split barriers the pass consumes
+		STATUS_CODE InsertPassBarriers(const BakedRenderGraph& bakedRenderGraph, const BakedRenderPass& bakedPass);
+
+		// Signals the events of the split barriers the pass produces. Must be recorded after the pass, outside of its render pass
+		STATUS_CODE SignalSplitBarriers(const BakedRenderGraph& bakedRenderGraph, const BakedRenderPass& bakedPass);
+
+		// Returns the position of the pass that should signal the split barrier for the given resource, which the consumer
+		// at the given position depends on. Returns U32_MAX if the barrier can't be split, or there's nothing to gain from it
+		u32 FindSplitBarrierSignalPosition(const std::vector<u32>& activeRenderPasses, const std::vector<u32>& activePositions, const std::vector<u32>& lastSubpasses,
+			const RenderPassVk& consumer, u32 consumerPosition, ResourceIndex resourceIndex) const;
+
+		// Restores the dependency infos and barriers of the current frame's render passes from a baked render graph
+		void RestoreBakedRenderGraph(const BakedRenderGraph& bakedRenderGraph);
 
 		// Returns the index of the pass that owns presentation: the last (highest submission index)
 		// active pass that writes to the current swapchain image. Earlier swapchain writers are pulled
 		// in as dependencies via the write-after-write hazard on the shared image.
 		u32 FindPresentRenderPassIndex(u64 presentResID);
 
+		// Returns the passes the render graph is trimmed against: the pass owning presentation (if any) followed by every
+		// pass marked as root, in submission order
+		void FindRootPasses(u32 presentPassIndex, std::vector<u32>& out_rootPassIndices) const;
+
 		// Returns true if the given pass writes to the physical resource with the given resource ID
 		bool PassWritesResource(u32 renderPassIndex, u64 resourceID) const;
 
-		void BuildDependencyTree(u32 finalPassIndex);
-		void FindActivePasses(u32 finalPassIndex, std::vector<u32>& out_activeRenderPasses);
+		void BuildDependencyTree(const std::vector<u32>& rootPassIndices);
+		void FindActivePasses(const std::vector<u32>& rootPassIndices, std::vector<u32>& out_activeRenderPasses);
 		void CalculateResourceBarriers(const std::vector<u32>& activeRenderPasses, u32 finalPassIndex);
 
+		// Returns the pipeline stages of the pass' shaders which access any resource, according to their reflection data.
+		// Returns 0 if that's unknown, e.g. if a shader was created without reflection
+		VkPipelineStageFlags CalculateShaderStageMask(const RenderPassVk& renderPass) const;
+
+		// Stage mask of the resource access in the given pass. Shader accesses are narrowed down to the pass' shader stage
+		// mask if it's known, and the stage bits this removes compared to the worst case are added to m_removedStageBits
+		VkPipelineStageFlags CalculatePassPipelineStageFlags(const RenderPassVk& renderPass, VkAccessFlags accessFlags, bool isSrcFlag);
+
 		// Returns true if an explicit pipeline barrier should be inserted for the given resource
 		// in the given render pass. Texture resources that are also render pass outputs (attachments)
 		// are handled implicitly by the VkRenderPass initialLayout/finalLayout transitions, so they
 		// do not need (and in the case of swapchain textures, cannot use) explicit image barriers.
 		bool RequiresExplicitResourceBarrier(const RenderPassVk& renderPass, u64 resourceID) const;
 
-		STATUS_CODE InsertResourceBarriers(const RenderPassVk& renderPass);
+		STATUS_CODE InsertResourceBarriers(const BakedRenderPass& bakedRenderPass, QUEUE_TYPE queueType);
+
+		// Queues the barriers in the device context without recording them. Texture layouts are only updated if requested
+		STATUS_CODE QueueResourceBarriers(const std::vector<BakedBarrier>& barriers, bool updateLayouts);
 
-		void TraverseDependencyTree(u32 renderPassIndex, TraverseDependenciesCallbackFn callback);
+		// Places the transient resources used by the baked render graph so that none of them share memory while
+		// they're in use. Cached render pass objects are discarded if the transient resources had to be re-created
+		STATUS_CODE PlaceTransientResources(BakedRenderGraph& bakedRenderGraph);
+
+		void TraverseDependencyTree(const std::vector<u32>& rootPassIndices, TraverseDependenciesCallbackFn callback);
 
 		void TraverseResources(const ResourceIndexBitset& resourceBitset, TraverseResourceCallbackFn callback) const;
 		void TraverseRenderPassInputs(u32 renderPassIndex, TraverseResourceCallbackFn callback) const;
@@ -188,9 +455,17 @@ namespace PHX
 		const ResourceUsage* GetResourceUsageFromPass(const RenderPassVk& renderPass, u64 resourceID) const;
 		const RenderResource* GetPhysicalResource(u64 resourceID) const;
 
+		// Returns MAX_REGISTERED_RESOURCES if the resource ID is not registered
+		ResourceIndex GetPhysicalResourceIndex(u64 resourceID) const;
+
+		// Open addressing hash table with linear probing. Empty slots have a resource index of MAX_REGISTERED_RESOURCES.
+		// The table is kept at most half full, and is rebuilt at twice the size from m_physicalResources when it would
+		// exceed that, so its memory is reused across frames
+		void InsertPhysicalResourceIndex(u64 resourceID, ResourceIndex resourceIndex);
+
 		// Updates the render pass' textures to whatever layout they were implicitly transitioned to
-		// by the render pass dependency. This information is stored in the output barriers
-		void UpdateTextureLayouts(u32 renderPassIndex);
+		// by the render pass dependency. This information is taken from the output barriers when baking
+		void UpdateTextureLayouts(const BakedRenderPass& bakedRenderPass);
 
 		TextureVk* ResolveTexture(const RenderResource& resource);
 		BufferVk* ResolveBuffer(const RenderResource& resource);
@@ -200,17 +475,81 @@ namespace PHX
 		// Returns a hash of the state of the render graph in the current frame
 		u64 HashState() const;
 
+		// Serializes everything a baked render graph depends on into out_key: the registered passes and their resources,
+		// the resource usages, and the physical resources with their texture objects and current layouts. Pipeline
+		// descriptions are left out, since pipelines are looked up when passes execute. Only the shader stages
+		// narrowing the barriers are baked
+		void BuildBakeKey(std::vector<u64>& out_key);
+
 		void CallExecutionCallback(const RenderPassVk& renderPass, const DeviceContextHandle& deviceContext);
 
+		// Size of the memory held by the render graph's per-frame containers, excluding the render passes, in bytes
+		size_t GetFrameStorageCapacity() const;
+
+		// Adds the containers of the per-frame state which had to grow since the last call to m_frameStorageGrowths, including
+		// the ones of the device contexts recording the frame and of the readback pool. Memory is kept across frames, so none
+		// of them grow once the render graph has reached a steady state. Device context containers only used on submission
+		// grow after this is called, so they're counted in the next frame
+		void CountFrameStorageGrowths();
+
+		// Per-pass GPU queries, which are written around the execution callback of every timed pass. Transfer passes and
+		// passes past the capacity of the query pools aren't timed. Pipeline statistics are only gathered for passes on
+		// the graphics queue family, since the statistics include graphics stages
+		bool IsPassTimed(const RenderPassVk& renderPass, u32 position) const;
+		bool HasPassPipelineStatistics(const RenderPassVk& renderPass) const;
+
+		// Resets the queries of the pass and its subpasses. Must be recorded outside of a render pass
+		void ResetPassQueries(DeviceContextVk* pDeviceContext, const RenderPassVk& renderPass, const BakedRenderPass& bakedPass, u32 position);
+		void BeginPassQueries(DeviceContextVk* pDeviceContext, const RenderPassVk& renderPass, u32 position);
+		void EndPassQueries(DeviceContextVk* pDeviceContext, const RenderPassVk& renderPass, u32 position);
+		void AddPassQueryRecord(const RenderPassVk& renderPass, u32 position);
+
+		// Reads back the results of the newest frame in the query ring which the GPU is known to be done with, without
+		// waiting. That's the frame which last used the current frame in flight, so results trail by the frames in flight
+		void ReadQueryResults();
+		void ReadPassQueryResults(const QueryRingSlot& slot, u32 slotIndex);
+
 	private:
 
 		HandleList<RenderPassVk> m_registeredRenderPasses;
 		std::vector<ResourceUsage> m_resourceUsages;
 		std::vector<RenderResource> m_physicalResources;
+		std::vector<PhysicalResourceIndex> m_physicalResourceIndices; // Hash table mapping resource IDs to their index in m_physicalResources, see InsertPhysicalResourceIndex()
 		RenderDeviceVk* m_pRenderDevice;
+		TransientResourcePool* m_pTransientResourcePool;
 
 		std::vector<DeviceContextHandle> m_deviceContextHandles;
 
+		// Parallel recording. Only created if recording threads are enabled in the settings. Worker device contexts are
+		// indexed by frame in flight first, then by worker
+		WorkerPool* m_pWorkerPool;
+		std::vector<DeviceContextHandle> m_workerDeviceContextHandles;
+		std::vector<Metrics> m_workerMetrics;
+		std::vector<ParallelRecordedPass> m_parallelRecordedPasses; // Reused every frame
+
+		// Render passes are reused every frame instead of being re-allocated, see RenderPassVk::Reset(). The first
+		// m_usedRenderPassCount passes of the pool are registered in the current frame
+		std::vector<RenderPassVk*> m_renderPassPool;
+		u32 m_usedRenderPassCount;
+
+		// Scratch memory used while executing the baked render graph, reused every frame
+		std::vector<u32> m_passBatchIndices;
+		std::vector<u32> m_producerBatchIndices;
+		std::vector<ClearValues> m_clearValues;
+		std::vector<TransientLifetime> m_transientLifetimes;
+		std::vector<DeviceContextVk*> m_workerContexts;
+		std::vector<STATUS_CODE> m_workerResults;
+
+		// Containers of the per-frame state which grew in the current frame. See CountFrameStorageGrowths()
+		u32 m_frameStorageGrowths;
+		size_t m_countedStorageCapacity; // GetFrameStorageCapacity() when growths were last counted
+
+		// Event of every split barrier of the baked render graph being executed, acquired when the barrier is signaled
+		std::vector<VkEvent> m_splitBarrierEvents;
+
+		// Stage bits removed from the barriers of the render graph being baked. See CalculatePassPipelineStageFlags()
+		u32 m_removedStageBits;
+
 		u64 m_currentFrameGraphHash;
 
 		// Stores the unique hashes for which a visualization has been generated
@@ -222,14 +561,33 @@ namespace PHX
 		const BSL::CRC32 m_reservedDepthBufferNameCRC;
 		u64 m_presentResID;
 
-		// True if last frame submitted work, false otherwise
-		// NOTE - This is NOT equivalent to DeviceContext->WasWorkFlushed()
-		//        because device contexts represent frames-in-flight, not sequential frames
-		bool m_didExecuteWork;
+		// True if any texture in the current frame is used with a subresource range other than the entire texture. For
+		// every physical resource, the physical resources sharing subresources with it. Only valid while baking
+		bool m_hasSubresourceRanges;
+		std::vector<std::vector<ResourceIndex>> m_overlappingResources;
+
+		// Render graphs baked in previous frames, keyed on the hash of their bake key
+		std::unordered_map<u64, BakedRenderGraph> m_bakedRenderGraphs;
+		std::vector<u64> m_bakeKey; // Bake key of the current frame, kept around so its memory is reused
+		const BakedRenderGraph* m_pCurrentBakedRenderGraph;
+		bool m_needsBakedStateRestore; // True if the current frame's render passes were never baked (replayed from cache)
+		u32 m_objectCacheVersion;
+		u32 m_bakeCacheHits;
+		u32 m_bakeCacheMisses;
 
 		// Metrics
 		mutable Metrics m_metrics;
 		VkQueryPool m_queryPool;
 		float m_timestampPeriod;
+
+		// Per-pass metrics. Queries are indexed by query ring slot first, then by pass position in execution order
+		VkQueryPool m_passTimestampQueryPool;
+		VkQueryPool m_passStatisticsQueryPool;       // Null unless pipeline statistics are gathered
+		std::vector<PassMetrics> m_passMetrics;      // Results of the frame in Metrics::gpuFrameNumber
+		std::vector<PassMetricName> m_passMetricNames; // Owns the names of m_passMetrics
+
+		// Query ring. Every query pool has a range of queries per slot, and frames use the slots in order
+		std::vector<QueryRingSlot> m_queryRing;
+		u32 m_queryRingIndex;
 	};
 }
\ No newline at end of file
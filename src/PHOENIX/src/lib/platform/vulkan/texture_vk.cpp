@@ -1,4 +1,5 @@
 
+#include <algorithm>
 #include <vulkan/vk_enum_string_helper.h>
 
 #include "texture_vk.h"
@@ -15,11 +16,18 @@ using namespace BSL;
 
 namespace PHX
 {
+	static thread_local const TextureVk::LayoutOverrides* s_pThreadLayoutOverrides = nullptr;
+
 	TextureVk::TextureVk(RenderDeviceVk* pRenderDevice, const TextureBaseCreateInfo& baseCreateInfo, const TextureViewCreateInfo& viewCreateInfo, const TextureSamplerCreateInfo& samplerCreateInfo) :
+		TextureVk(pRenderDevice, baseCreateInfo, viewCreateInfo, samplerCreateInfo, nullptr, 0)
+	{
+	}
+
+	TextureVk::TextureVk(RenderDeviceVk* pRenderDevice, const TextureBaseCreateInfo& baseCreateInfo, const TextureViewCreateInfo& viewCreateInfo, const TextureSamplerCreateInfo& samplerCreateInfo, VmaAllocation aliasedAlloc, VkDeviceSize aliasedOffset) :
 		m_renderDevice(nullptr), m_baseImage(VK_NULL_HANDLE), m_imageViews(), m_alloc(nullptr), m_sampler(VK_NULL_HANDLE), m_layout(VK_IMAGE_LAYOUT_UNDEFINED), m_pName(""), m_width(0), m_height(0),
-		m_format(BASE_FORMAT::INVALID), m_aspectFlags(0), m_arrayLayers(0), m_mipLevels(0), m_sampleCount(SAMPLE_COUNT::INVALID), m_viewType(VIEW_TYPE::INVALID), m_viewScope(VIEW_SCOPE::INVALID), 
+		m_format(BASE_FORMAT::INVALID), m_aspectFlags(0), m_arrayLayers(0), m_mipLevels(0), m_sampleCount(SAMPLE_COUNT::INVALID), m_usageFlags(0), m_viewType(VIEW_TYPE::INVALID), m_viewScope(VIEW_SCOPE::INVALID), 
 		m_minFilter(FILTER_MODE::INVALID), m_magFilter(FILTER_MODE::INVALID), m_sampAddressMode(SAMPLER_ADDRESS_MODE::INVALID), m_sampFilter(FILTER_MODE::INVALID), m_anisotropicFilteringEnabled(false), 
-		m_anisotropyLevel(0.0f), m_bytesPerTexel(0)
+		m_anisotropyLevel(0.0f), m_bytesPerTexel(0), m_isConcurrent(false)
 	{
 		RenderDeviceVk* renderDeviceVk = static_cast<RenderDeviceVk*>(pRenderDevice);
 		if (renderDeviceVk == nullptr)
@@ -30,7 +38,7 @@ namespace PHX
 
 		m_renderDevice = renderDeviceVk;
 
-		if (CreateBaseImage(baseCreateInfo, true, IsCubeView(viewCreateInfo.type)) != STATUS_CODE::SUCCESS)
+		if (CreateBaseImage(baseCreateInfo, true, IsCubeView(viewCreateInfo.type), aliasedAlloc, aliasedOffset) != STATUS_CODE::SUCCESS)
 		{
 			return;
 		}
@@ -55,9 +63,9 @@ namespace PHX
 
 	TextureVk::TextureVk(RenderDeviceVk* pRenderDevice, const TextureBaseCreateInfo& baseCreateInfo, VkImageView imageView) :
 		m_renderDevice(nullptr), m_baseImage(VK_NULL_HANDLE), m_imageViews(), m_alloc(nullptr), m_sampler(VK_NULL_HANDLE), m_layout(VK_IMAGE_LAYOUT_UNDEFINED), m_pName(""), m_width(0), m_height(0),
-		m_format(BASE_FORMAT::INVALID), m_aspectFlags(0), m_arrayLayers(0), m_mipLevels(0), m_sampleCount(SAMPLE_COUNT::INVALID), m_viewType(VIEW_TYPE::INVALID), m_viewScope(VIEW_SCOPE::INVALID),
+		m_format(BASE_FORMAT::INVALID), m_aspectFlags(0), m_arrayLayers(0), m_mipLevels(0), m_sampleCount(SAMPLE_COUNT::INVALID), m_usageFlags(0), m_viewType(VIEW_TYPE::INVALID), m_viewScope(VIEW_SCOPE::INVALID),
 		m_minFilter(FILTER_MODE::INVALID), m_magFilter(FILTER_MODE::INVALID), m_sampAddressMode(SAMPLER_ADDRESS_MODE::INVALID), m_sampFilter(FILTER_MODE::INVALID), m_anisotropicFilteringEnabled(false), 
-		m_anisotropyLevel(0.0f), m_bytesPerTexel(0)
+		m_anisotropyLevel(0.0f), m_bytesPerTexel(0), m_isConcurrent(false)
 	{
 		RenderDeviceVk* renderDeviceVk = static_cast<RenderDeviceVk*>(pRenderDevice);
 		if (renderDeviceVk == nullptr)
@@ -202,6 +210,16 @@ namespace PHX
 		return false;
 	}
 
+	bool TextureVk::IsConcurrent() const
+	{
+		return m_isConcurrent;
+	}
+
+	UsageTypeFlags TextureVk::GetUsageFlags() const
+	{
+		return m_usageFlags;
+	}
+
 	bool TextureVk::HasStencilComponent() const
 	{
 		switch (m_format)
@@ -244,7 +262,66 @@ namespace PHX
 
 	VkImageLayout TextureVk::GetLayout() const
 	{
-		return m_layout;
+		return GetLayout(GetSubresourceRange());
+	}
+
+	VkImageLayout TextureVk::GetLayout(const VkImageSubresourceRange& range) const
+	{
+		if (s_pThreadLayoutOverrides != nullptr)
+		{
+			for (const LayoutOverride& layoutOverride : *s_pThreadLayoutOverrides)
+			{
+				const VkImageSubresourceRange& overrideRange = layoutOverride.range;
+				if (layoutOverride.pTexture == this &&
+					range.baseMipLevel >= overrideRange.baseMipLevel && range.baseMipLevel + range.levelCount <= overrideRange.baseMipLevel + overrideRange.levelCount &&
+					range.baseArrayLayer >= overrideRange.baseArrayLayer && range.baseArrayLayer + range.layerCount <= overrideRange.baseArrayLayer + overrideRange.layerCount)
+				{
+					return layoutOverride.layout;
+				}
+			}
+		}
+		else if (m_layout != VK_IMAGE_LAYOUT_MAX_ENUM)
+		{
+			return m_layout;
+		}
+
+		// No single override covers the range, so it's resolved per subresource
+		const VkImageLayout firstLayout = GetSubresourceLayout(range.baseMipLevel, range.baseArrayLayer);
+		for (u32 layer = range.baseArrayLayer; layer < range.baseArrayLayer + range.layerCount; layer++)
+		{
+			for (u32 mip = range.baseMipLevel; mip < range.baseMipLevel + range.levelCount; mip++)
+			{
+				if (GetSubresourceLayout(mip, layer) != firstLayout)
+				{
+					return VK_IMAGE_LAYOUT_MAX_ENUM;
+				}
+			}
+		}
+
+		return firstLayout;
+	}
+
+	VkImageLayout TextureVk::GetSubresourceLayout(u32 mipLevel, u32 arrayLayer) const
+	{
+		if (s_pThreadLayoutOverrides == nullptr)
+		{
+			return (m_layout != VK_IMAGE_LAYOUT_MAX_ENUM) ? m_layout : m_subresourceLayouts[arrayLayer * m_mipLevels + mipLevel];
+		}
+
+		for (const LayoutOverride& layoutOverride : *s_pThreadLayoutOverrides)
+		{
+			const VkImageSubresourceRange& overrideRange = layoutOverride.range;
+			if (layoutOverride.pTexture == this &&
+				mipLevel >= overrideRange.baseMipLevel && mipLevel < overrideRange.baseMipLevel + overrideRange.levelCount &&
+				arrayLayer >= overrideRange.baseArrayLayer && arrayLayer < overrideRange.baseArrayLayer + overrideRange.layerCount)
+			{
+				return layoutOverride.layout;
+			}
+		}
+
+		// The live layouts are being changed by the main thread, so they can't be read here
+		LogError("Texture \"%s\" has no layout snapshot for mip %u, layer %u on this thread! Only resources of the pass can be used while it's recorded on a worker thread", m_pName, mipLevel, arrayLayer);
+		return VK_IMAGE_LAYOUT_UNDEFINED;
 	}
 
 	void TextureVk::SetLayout(VkImageLayout layout)
@@ -252,6 +329,81 @@ namespace PHX
 		PROFILE_SCOPE("TextureVk_SetLayout");
 
 		m_layout = layout;
+		m_subresourceLayouts.clear();
+	}
+
+	void TextureVk::SetLayout(VkImageLayout layout, const VkImageSubresourceRange& range)
+	{
+		PROFILE_SCOPE("TextureVk_SetLayout");
+
+		if (range.levelCount >= m_mipLevels && range.layerCount >= m_arrayLayers)
+		{
+			SetLayout(layout);
+			return;
+		}
+
+		if (m_layout == layout)
+		{
+			return;
+		}
+
+		// Switch to per-subresource tracking
+		if (m_layout != VK_IMAGE_LAYOUT_MAX_ENUM)
+		{
+			m_subresourceLayouts.assign(static_cast<size_t>(m_mipLevels) * m_arrayLayers, m_layout);
+			m_layout = VK_IMAGE_LAYOUT_MAX_ENUM;
+		}
+
+		for (u32 layer = range.baseArrayLayer; layer < range.baseArrayLayer + range.layerCount; layer++)
+		{
+			for (u32 mip = range.baseMipLevel; mip < range.baseMipLevel + range.levelCount; mip++)
+			{
+				m_subresourceLayouts[layer * m_mipLevels + mip] = layout;
+			}
+		}
+
+		// Switch back once every subresource ends up in the same layout, e.g. after a mip chain was written
+		if (std::all_of(m_subresourceLayouts.begin(), m_subresourceLayouts.end(), [&](VkImageLayout subresourceLayout) { return subresourceLayout == layout; }))
+		{
+			SetLayout(layout);
+		}
+	}
+
+	VkImageSubresourceRange TextureVk::GetSubresourceRange() const
+	{
+		VkImageSubresourceRange range{};
+		range.aspectMask = TEX_UTILS::ConvertAspectFlags(m_aspectFlags);
+		range.baseMipLevel = 0;
+		range.levelCount = m_mipLevels;
+		range.baseArrayLayer = 0;
+		range.layerCount = m_arrayLayers;
+		return range;
+	}
+
+	VkImageSubresourceRange TextureVk::GetSubresourceRange(const TextureSubresourceRange& range) const
+	{
+		VkImageSubresourceRange rangeVk = GetSubresourceRange();
+		rangeVk.baseMipLevel = std::min(range.baseMipLevel, m_mipLevels - 1);
+		rangeVk.levelCount = std::min(range.mipLevelCount, m_mipLevels - rangeVk.baseMipLevel);
+		rangeVk.baseArrayLayer = std::min(range.baseArrayLayer, m_arrayLayers - 1);
+		rangeVk.layerCount = std::min(range.arrayLayerCount, m_arrayLayers - rangeVk.baseArrayLayer);
+		return rangeVk;
+	}
+
+	VkImageSubresourceRange TextureVk::GetImageViewRange(u32 index) const
+	{
+		VkImageSubresourceRange range = GetSubresourceRange();
+		if (m_viewScope == VIEW_SCOPE::PER_MIP && index < m_mipLevels)
+		{
+			range.baseMipLevel = index;
+			range.levelCount = 1;
+		}
+		return range;
+	}
+
+	void TextureVk::SetThreadLayoutOverrides(const LayoutOverrides* pOverrides)
+	{
+		s_pThreadLayoutOverrides = pOverrides;
 	}
 
 	VkSampler TextureVk::GetSampler() const
@@ -259,7 +411,7 @@ namespace PHX
 		return m_sampler;
 	}
 
-	STATUS_CODE TextureVk::CreateBaseImage(const TextureBaseCreateInfo& createInfo, bool createVkImageHandle, bool isCubeMap)
+	STATUS_CODE TextureVk::CreateBaseImage(const TextureBaseCreateInfo& createInfo, bool createVkImageHandle, bool isCubeMap, VmaAllocation aliasedAlloc, VkDeviceSize aliasedOffset)
 	{
 		PROFILE_SCOPE("TextureVk_CreateBaseImage");
 
@@ -304,15 +456,51 @@ namespace PHX
 			imageInfo.initialLayout = initialImageLayout;
 			imageInfo.usage = TEX_UTILS::ConvertUsageFlags(createInfo.usageFlags);
 			imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+			// Textures uploaded on the transfer queue and sampled on the graphics queue are shared between both queue families.
+			// Attachments stay exclusive, since concurrent sharing can disable framebuffer compression on some GPUs
+			const std::vector<u32>& queueFamilies = m_renderDevice->GetConcurrentQueueFamilies();
+			const VkImageUsageFlags attachmentUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+			if (!queueFamilies.empty() && (imageInfo.usage & attachmentUsage) == 0)
+			{
+				imageInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+				imageInfo.queueFamilyIndexCount = static_cast<u32>(queueFamilies.size());
+				imageInfo.pQueueFamilyIndices = queueFamilies.data();
+				m_isConcurrent = true;
+			}
 			imageInfo.samples = TEX_UTILS::ConvertSampleCount(createInfo.sampleFlags);
 			imageInfo.flags = imageCreateFlags;
 
-			VmaAllocationCreateInfo allocCreateInfo = {};
-			allocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
-			allocCreateInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
-			allocCreateInfo.priority = 1.0f;
+			VkResult res = VK_SUCCESS;
+			if (aliasedAlloc != nullptr)
+			{
+				// The allocation is owned by someone else, so m_alloc is left as null and only the image gets destroyed
+				res = vmaCreateAliasingImage2(m_renderDevice->GetAllocator(), aliasedAlloc, aliasedOffset, &imageInfo, &m_baseImage);
+			}
+			else
+			{
+				VmaAllocationCreateInfo allocCreateInfo = {};
+				allocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
+				allocCreateInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+				allocCreateInfo.priority = 1.0f;
+
+				// Transient attachments never leave tile memory on tiled GPUs, so they don't need to be backed
+				// by physical memory. Lazily allocated memory isn't available on most desktop GPUs though
+				if (createInfo.usageFlags & USAGE_TYPE_FLAG_TRANSIENT_ATTACHMENT)
+				{
+					VmaAllocationCreateInfo lazyAllocCreateInfo = allocCreateInfo;
+					lazyAllocCreateInfo.usage = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED;
+
+					u32 memoryTypeIndex = 0;
+					if (vmaFindMemoryTypeIndexForImageInfo(m_renderDevice->GetAllocator(), &imageInfo, &lazyAllocCreateInfo, &memoryTypeIndex) == VK_SUCCESS)
+					{
+						allocCreateInfo = lazyAllocCreateInfo;
+					}
+				}
+
+				res = vmaCreateImage(m_renderDevice->GetAllocator(), &imageInfo, &allocCreateInfo, &m_baseImage, &m_alloc, nullptr);
+			}
 
-			VkResult res = vmaCreateImage(m_renderDevice->GetAllocator(), &imageInfo, &allocCreateInfo, &m_baseImage, &m_alloc, nullptr);
 			if (res != VK_SUCCESS)
 			{
 				LogError("Failed to create texture! Got error: \"%s\"", string_VkResult(res));
@@ -341,6 +529,7 @@ namespace PHX
 		m_arrayLayers = effectiveArrayLayers;
 		m_format = createInfo.format;
 		m_sampleCount = createInfo.sampleFlags;
+		m_usageFlags = createInfo.usageFlags;
 		m_mipLevels = mipsToUse;
 
 		return STATUS_CODE::SUCCESS;
@@ -19,8 +19,18 @@ namespace PHX
 	{
 	public:
 
+		// Layout of a subresource range of a texture, seen by one thread only
+		struct LayoutOverride
+		{
+			const TextureVk* pTexture;
+			VkImageSubresourceRange range;
+			VkImageLayout layout;
+		};
+		typedef std::vector<LayoutOverride> LayoutOverrides;
+
 		explicit TextureVk(RenderDeviceVk* pRenderDevice, const TextureBaseCreateInfo& baseCreateInfo, const TextureViewCreateInfo& viewCreateInfo, const TextureSamplerCreateInfo& samplerCreateInfo);
 		explicit TextureVk(RenderDeviceVk* pRenderDevice, const TextureBaseCreateInfo& baseCreateInfo, VkImageView imageView); // Create texture from existing image views (e.g. swap chain image views)
+		explicit TextureVk(RenderDeviceVk* pRenderDevice, const TextureBaseCreateInfo& baseCreateInfo, const TextureViewCreateInfo& viewCreateInfo, const TextureSamplerCreateInfo& samplerCreateInfo, VmaAllocation aliasedAlloc, VkDeviceSize aliasedOffset); // Create texture in existing memory (e.g. aliased transient resources)
 		~TextureVk();
 		TextureVk(const TextureVk&& other) noexcept;
 
@@ -52,23 +62,54 @@ namespace PHX
 		bool IsDepthTexture() const override;
 		bool HasStencilComponent() const override;
 
+		// True if the image is shared between the graphics and transfer queue families (VK_SHARING_MODE_CONCURRENT), so it
+		// can be used on the transfer queue without a queue family ownership transfer
+		bool IsConcurrent() const;
+
+		UsageTypeFlags GetUsageFlags() const;
+
 		VkImage GetBaseImage() const;
 
 		u32 GetNumImageViews() const;
 		VkImageView GetImageViewAt(u32 index) const;
 
+		// Layouts are tracked per mip level and array layer. GetLayout() returns VK_IMAGE_LAYOUT_MAX_ENUM if the subresources
+		// in the range aren't all in the same layout
 		VkImageLayout GetLayout() const;
+		VkImageLayout GetLayout(const VkImageSubresourceRange& range) const;
 		void SetLayout(VkImageLayout layout); // Used when device context adds transition commands to command buffer
+		void SetLayout(VkImageLayout layout, const VkImageSubresourceRange& range);
+
+		// Calls fn(const VkImageSubresourceRange& subrange, VkImageLayout layout) for every part of the range whose subresources
+		// share a layout. Called once with the entire range if it's in a single layout
+		template<typename FnT>
+		void ForEachLayoutRange(const VkImageSubresourceRange& range, FnT fn) const;
+
+		// Returns the entire texture, or the clamped range
+		VkImageSubresourceRange GetSubresourceRange() const;
+		VkImageSubresourceRange GetSubresourceRange(const TextureSubresourceRange& range) const;
+
+		// Range of the subresources seen through the image view at the given index
+		VkImageSubresourceRange GetImageViewRange(u32 index) const;
+
+		// While set, layouts are only ever read from the overrides on the calling thread, never from the texture itself. Used
+		// by worker threads recording render graph passes, since the main thread keeps changing the textures' layouts while
+		// the workers record. The overrides must cover every subresource of the textures the worker uses
+		static void SetThreadLayoutOverrides(const LayoutOverrides* pOverrides);
 
 		VkSampler GetSampler() const;
 
 	private:
 
-		STATUS_CODE CreateBaseImage(const TextureBaseCreateInfo& createInfo, bool createVkImageHandle, bool isCubeMap);
+		// If aliasedAlloc is not null, the image is bound to that allocation at aliasedOffset instead of getting its own memory
+		STATUS_CODE CreateBaseImage(const TextureBaseCreateInfo& createInfo, bool createVkImageHandle, bool isCubeMap, VmaAllocation aliasedAlloc = nullptr, VkDeviceSize aliasedOffset = 0);
 		STATUS_CODE CreateImageViews(const TextureViewCreateInfo& createInfo);
 		STATUS_CODE CreateSampler(const TextureSamplerCreateInfo& createInfo);
 		void DestroyImage();
 
+		// Layout of a single subresource, taken from the calling thread's overrides if it has any
+		VkImageLayout GetSubresourceLayout(u32 mipLevel, u32 arrayLayer) const;
+
 	private:
 
 		RenderDeviceVk* m_renderDevice;
@@ -77,7 +118,8 @@ namespace PHX
 		std::vector<VkImageView> m_imageViews;
 		VmaAllocation m_alloc;
 		VkSampler m_sampler;
-		VkImageLayout m_layout;
+		VkImageLayout m_layout;									// Layout of every subresource, or VK_IMAGE_LAYOUT_MAX_ENUM if they differ
+		std::vector<VkImageLayout> m_subresourceLayouts;		// Layout of every subresource (layer-major), only while m_layout is VK_IMAGE_LAYOUT_MAX_ENUM
 
 		const char* m_pName;
 		u32 m_width;
@@ -87,6 +129,7 @@ namespace PHX
 		u32 m_arrayLayers;
 		u32 m_mipLevels;
 		SAMPLE_COUNT m_sampleCount;
+		UsageTypeFlags m_usageFlags;
 
 		VIEW_TYPE m_viewType;
 		VIEW_SCOPE m_viewScope;
@@ -99,5 +142,46 @@ namespace PHX
 		float m_anisotropyLevel;
 
 		u32 m_bytesPerTexel;
+		bool m_isConcurrent;
 	};
+
+	template<typename FnT>
+	void TextureVk::ForEachLayoutRange(const VkImageSubresourceRange& range, FnT fn) const
+	{
+		const VkImageLayout rangeLayout = GetLayout(range);
+		if (rangeLayout != VK_IMAGE_LAYOUT_MAX_ENUM)
+		{
+			fn(range, rangeLayout);
+			return;
+		}
+
+		// Runs of consecutive mip levels within every array layer
+		for (u32 layer = range.baseArrayLayer; layer < range.baseArrayLayer + range.layerCount; layer++)
+		{
+			VkImageSubresourceRange subrange = range;
+			subrange.baseArrayLayer = layer;
+			subrange.layerCount = 1;
+			subrange.levelCount = 0;
+			VkImageLayout subrangeLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+			for (u32 mip = range.baseMipLevel; mip < range.baseMipLevel + range.levelCount; mip++)
+			{
+				const VkImageLayout layout = GetSubresourceLayout(mip, layer);
+				if (subrange.levelCount > 0 && layout != subrangeLayout)
+				{
+					fn(subrange, subrangeLayout);
+					subrange.levelCount = 0;
+				}
+
+				if (subrange.levelCount == 0)
+				{
+					subrange.baseMipLevel = mip;
+					subrangeLayout = layout;
+				}
+				subrange.levelCount++;
+			}
+
+			fn(subrange, subrangeLayout);
+		}
+	}
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 
+#include <algorithm>
 #include <vulkan/vk_enum_string_helper.h>
 
 #include "uniform_vk.h"
@@ -12,6 +13,7 @@
 #include "render_device_vk.h"
 #include "texture_vk.h"
 #include "utils/shader_type_converter.h"
+#include "utils/transient_uniform_ring.h"
 #include "utils/uniform_type_converter.h"
 
 using namespace BSL;
@@ -70,6 +72,11 @@ namespace PHX
 				vkSetLayoutBinding.pImmutableSamplers = nullptr; // Optional
 
 				setBindings.push_back(vkSetLayoutBinding);
+
+				if (uniformData.type == UNIFORM_TYPE::UNIFORM_BUFFER_DYNAMIC || uniformData.type == UNIFORM_TYPE::STORAGE_BUFFER_DYNAMIC)
+				{
+					m_dynamicOffsetCount += uniformData.count;
+				}
 			}
 
 			// Create descriptor set layouts
@@ -234,13 +241,15 @@ namespace PHX
 		VkDescriptorType descType = UNIFORM_UTILS::ConvertUniformType(uniformType);
 
 		// Validate that the buffer's usage is compatible with the descriptor type
-		if (uniformType == UNIFORM_TYPE::UNIFORM_BUFFER && !(usage & BUFFER_USAGE_FLAG_UNIFORM_BUFFER))
+		const bool isUniformBufferType = (uniformType == UNIFORM_TYPE::UNIFORM_BUFFER || uniformType == UNIFORM_TYPE::UNIFORM_BUFFER_DYNAMIC);
+		const bool isStorageBufferType = (uniformType == UNIFORM_TYPE::STORAGE_BUFFER || uniformType == UNIFORM_TYPE::STORAGE_BUFFER_DYNAMIC);
+		if (isUniformBufferType && !(usage & BUFFER_USAGE_FLAG_UNIFORM_BUFFER))
 		{
 			LogError("Buffer \"%s\" (usage=0x%x) bound to set %u binding %u as UNIFORM_BUFFER does not have UNIFORM_BUFFER usage flag!",
 				bufferVk->GetName(), usage, set, binding);
 			return STATUS_CODE::ERR_API;
 		}
-		if (uniformType == UNIFORM_TYPE::STORAGE_BUFFER && !(usage & BUFFER_USAGE_FLAG_STORAGE_BUFFER | BUFFER_USAGE_FLAG_ACCELERATION_STRUCTURE_BUILD_INPUT))
+		if (isStorageBufferType && !(usage & BUFFER_USAGE_FLAG_STORAGE_BUFFER | BUFFER_USAGE_FLAG_ACCELERATION_STRUCTURE_BUILD_INPUT))
 		{
 			LogError("Buffer \"%s\" (usage %u) bound to set %u binding %u as STORAGE_BUFFER does not have STORAGE_BUFFER or ACCELERATION_STRUCTURE_BUILD_INPUT usage flag!",
 				bufferVk->GetName(), static_cast<u32>(usage), set, binding);
@@ -285,8 +294,8 @@ namespace PHX
 			return STATUS_CODE::ERR_INTERNAL;
 		}
 
-		// Check if the image is in an appropriate layout
-		const VkImageLayout layout = textureVk->GetLayout();
+		// Check if the subresources seen through the image view are in an appropriate layout
+		const VkImageLayout layout = textureVk->GetLayout(textureVk->GetImageViewRange(imageViewIndex));
 		if (!IsImageInAppropriateLayout(layout))
 		{
 			LogError("Failed to queue image update! Image layout is invalid: \"%s\". Did you forget to register the input images in the render pass?", string_VkImageLayout(layout));
@@ -364,6 +373,59 @@ namespace PHX
 		return STATUS_CODE::SUCCESS;
 	}
 
+	STATUS_CODE UniformCollectionVk::QueueTransientBufferUpdate(u32 set, u32 binding, u64 size)
+	{
+		PROFILE_SCOPE("UniformCollectionVk_QueueTransientBufferUpdate");
+
+		const TransientUniformRing* pRing = m_pRenderDevice->GetTransientUniformRing();
+		if (pRing == nullptr || pRing->GetBuffer() == VK_NULL_HANDLE)
+		{
+			LogError("Failed to queue transient buffer update. Transient uniform ring is null!");
+			return STATUS_CODE::ERR_INTERNAL;
+		}
+
+		if (set >= m_descriptorSetLayouts.size())
+		{
+			LogError("Failed to queue transient buffer update! Set number is invalid (expected 0 to %u)", static_cast<u32>(m_descriptorSetLayouts.size()));
+			return STATUS_CODE::ERR_API;
+		}
+
+		// The ring is only ever addressed through dynamic offsets, a static binding would always read the start of the ring
+		const UNIFORM_TYPE uniformType = GetUniformType(set, binding);
+		if (uniformType != UNIFORM_TYPE::UNIFORM_BUFFER_DYNAMIC && uniformType != UNIFORM_TYPE::STORAGE_BUFFER_DYNAMIC)
+		{
+			LogError("Failed to queue transient buffer update! Set %u binding %u must be UNIFORM_BUFFER_DYNAMIC or STORAGE_BUFFER_DYNAMIC", set, binding);
+			return STATUS_CODE::ERR_API;
+		}
+
+		const VkPhysicalDeviceLimits& limits = m_pRenderDevice->GetDeviceProperties().limits;
+		const u64 maxRange = (uniformType == UNIFORM_TYPE::UNIFORM_BUFFER_DYNAMIC) ? limits.maxUniformBufferRange : limits.maxStorageBufferRange;
+		if (size == 0 || size > maxRange || size > pRing->GetRegionSize())
+		{
+			LogError("Failed to queue transient buffer update! Size %llu must be between 1 and %llu bytes", size, std::min(maxRange, pRing->GetRegionSize()));
+			return STATUS_CODE::ERR_API;
+		}
+
+		m_writeBufferInfo.push_back({});
+		VkDescriptorBufferInfo& bufferInfo = m_writeBufferInfo.back();
+		bufferInfo.buffer = pRing->GetBuffer();
+		bufferInfo.offset = 0;
+		bufferInfo.range = size;
+
+		VkWriteDescriptorSet writeDescSet{};
+		writeDescSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writeDescSet.dstSet = VK_NULL_HANDLE; // Patched in FlushForFrame
+		writeDescSet.dstBinding = binding;
+		writeDescSet.dstArrayElement = 0;
+		writeDescSet.descriptorType = UNIFORM_UTILS::ConvertUniformType(uniformType);
+		writeDescSet.descriptorCount = 1;
+		writeDescSet.pBufferInfo = &bufferInfo;
+
+		m_descriptorWrites.push_back(writeDescSet);
+		m_writeSetIndices.push_back(set);
+		return STATUS_CODE::SUCCESS;
+	}
+
 	STATUS_CODE UniformCollectionVk::Flush(u32 frameIndex)
 	{
 		PROFILE_SCOPE("UniformCollectionVk_Flush");
@@ -428,6 +490,11 @@ namespace PHX
 		return static_cast<u32>(m_descriptorSetLayouts.size());
 	}
 
+	u32 UniformCollectionVk::GetDynamicOffsetCount() const
+	{
+		return m_dynamicOffsetCount;
+	}
+
 	void UniformCollectionVk::CacheUniformGroupData(const UniformDataGroup* pDataGroups, u32 groupCount)
 	{
 		if (pDataGroups == nullptr || groupCount == 0)
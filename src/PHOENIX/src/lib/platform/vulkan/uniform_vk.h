@@ -25,6 +25,7 @@ namespace PHX
 		STATUS_CODE QueueBufferUpdate(BufferHandle buffer, u32 set, u32 binding, u64 offset, u64 size) override;
 		STATUS_CODE QueueImageUpdate(TextureHandle texture, u32 set, u32 binding, u32 imageViewIndex, u32 arrayElement) override;
 		STATUS_CODE QueueAccelerationStructureUpdate(AccelerationStructureHandle accelerationStructure, u32 set, u32 binding) override;
+		STATUS_CODE QueueTransientBufferUpdate(u32 set, u32 binding, u64 size) override;
 		STATUS_CODE Flush(u32 frameIndex);
 
 		const VkDescriptorSet* GetDescriptorSets(u32 frameIndex) const;
@@ -33,6 +34,9 @@ namespace PHX
 		const VkDescriptorSetLayout* GetDescriptorSetLayouts() const;
 		u32 GetDescriptorSetLayoutCount() const;
 
+		// Number of dynamic offsets that must be given when binding the collection
+		u32 GetDynamicOffsetCount() const;
+
 	private:
 
 		void CacheUniformGroupData(const UniformDataGroup* pDataGroups, u32 groupCount);
@@ -48,6 +52,7 @@ namespace PHX
 		std::vector<UniformData> m_uniforms;
 
 		std::vector<VkDescriptorSetLayout> m_descriptorSetLayouts;
+		u32 m_dynamicOffsetCount = 0;
 
 		// Per-frame-in-flight descriptor sets. Outer index = frame index, inner index = set index
 		std::vector<std::vector<VkDescriptorSet>> m_perFrameDescriptorSets;
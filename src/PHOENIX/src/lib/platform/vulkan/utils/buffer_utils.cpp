@@ -10,13 +10,29 @@ using namespace BSL;
 
 namespace PHX
 {
+	// Buffers are written by uploads on the transfer queue and read on the graphics queue. When those are different queue
+	// families, buffers are shared between them instead of having their ownership transferred around every upload
+	static void SetSharingMode(RenderDeviceVk* pRenderDevice, VkBufferCreateInfo& bufferInfo)
+	{
+		const std::vector<u32>& queueFamilies = pRenderDevice->GetConcurrentQueueFamilies();
+		if (queueFamilies.empty())
+		{
+			bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+			return;
+		}
+
+		bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+		bufferInfo.queueFamilyIndexCount = static_cast<u32>(queueFamilies.size());
+		bufferInfo.pQueueFamilyIndices = queueFamilies.data();
+	}
+
 	BufferData CreateBuffer(RenderDeviceVk* pRenderDevice, const char* pName, u64 size, VkBufferUsageFlags usageFlags, VmaAllocationCreateFlags allocFlags, VkMemoryPropertyFlags requiredFlags, VkMemoryPropertyFlags preferredFlags)
 	{
 		VkBufferCreateInfo vkBufferInfo{};
 		vkBufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
 		vkBufferInfo.size = size;
 		vkBufferInfo.usage = usageFlags;
-		vkBufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE; // Simply using exclusive sharing mode for now
+		SetSharingMode(pRenderDevice, vkBufferInfo);
 
 		// SEQUENTIAL_WRITE and USAGE_AUTO flags must go together, per VMA notes
 		VmaAllocationCreateInfo vmaAllocInfo{};
@@ -44,6 +60,37 @@ namespace PHX
 		return newData;
 	}
 
+	BufferData CreateAliasedBuffer(RenderDeviceVk* pRenderDevice, const char* pName, u64 size, VkBufferUsageFlags usageFlags, VmaAllocation alloc, VkDeviceSize offset)
+	{
+		VkBufferCreateInfo vkBufferInfo{};
+		vkBufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		vkBufferInfo.size = size;
+		vkBufferInfo.usage = usageFlags;
+		SetSharingMode(pRenderDevice, vkBufferInfo);
+
+		BufferData newData{};
+		newData.isValid = true;
+		newData.size = size;
+		newData.alloc = VK_NULL_HANDLE; // Not owned by this buffer
+
+		VkResult res = vmaCreateAliasingBuffer2(pRenderDevice->GetAllocator(), alloc, offset, &vkBufferInfo, &newData.buffer);
+		if (res != VK_SUCCESS)
+		{
+			LogError("Failed to create aliased buffer! Got result: %s", string_VkResult(res));
+			newData.isValid = false;
+			return newData;
+		}
+
+		VkMemoryRequirements memRequirements{};
+		vkGetBufferMemoryRequirements(pRenderDevice->GetLogicalDevice(), newData.buffer, &memRequirements);
+		newData.allocInfo.size = memRequirements.size;
+		newData.allocInfo.offset = offset;
+
+		DEBUG_UTILS::SetObjectName(pRenderDevice->GetLogicalDevice(), VK_OBJECT_TYPE_BUFFER, reinterpret_cast<uint64_t>(newData.buffer), pName);
+
+		return newData;
+	}
+
 	void DestroyBuffer(RenderDeviceVk* pRenderDevice, BufferData& buffer)
 	{
 		if (buffer.isValid)
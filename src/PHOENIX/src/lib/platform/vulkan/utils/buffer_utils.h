@@ -17,6 +17,9 @@ namespace PHX
 	};
 
 	BufferData CreateBuffer(RenderDeviceVk* pRenderDevice, const char* pName, u64 size, VkBufferUsageFlags usageFlags, VmaAllocationCreateFlags allocFlags, VkMemoryPropertyFlags requiredFlags, VkMemoryPropertyFlags preferredFlags);
+	// Creates a buffer bound to an existing allocation at the given offset. The returned buffer does not own the
+	// allocation, so destroying it leaves the allocation untouched
+	BufferData CreateAliasedBuffer(RenderDeviceVk* pRenderDevice, const char* pName, u64 size, VkBufferUsageFlags usageFlags, VmaAllocation alloc, VkDeviceSize offset);
 	void DestroyBuffer(RenderDeviceVk* pRenderDevice, BufferData& buffer);
 
 	bool ShouldUseDirectMemoryMapping(BufferUsageFlags usage);
@@ -42,6 +42,21 @@ namespace PHX
 		}
 	}
 
+	static void HashCombinePushConstantRanges(const PushConstantRange* pRanges, u32 rangeCount, size_t& out_seed)
+	{
+		if (pRanges != nullptr)
+		{
+			HashCombine(out_seed, rangeCount);
+
+			for (u32 i = 0; i < rangeCount; i++)
+			{
+				HashCombine(out_seed, pRanges[i].stages);
+				HashCombine(out_seed, pRanges[i].offset);
+				HashCombine(out_seed, pRanges[i].size);
+			}
+		}
+	}
+
 	static void HashCombineShaderArray(const ShaderHandle* pShaders, u32 shaderCount, size_t& out_seed)
 	{
 		if (pShaders != nullptr)
@@ -62,7 +77,7 @@ namespace PHX
 
 	size_t GraphicsPipelineDescHasher::operator()(const GraphicsPipelineDesc& desc) const
 	{
-		STATIC_ASSERT_MSG(sizeof(desc) == 256, "If graphics pipeline description changed, make sure to change this hashing function!");
+		STATIC_ASSERT_MSG(sizeof(desc) == 272, "If graphics pipeline description changed, make sure to change this hashing function!");
 
 		size_t seed = 0;
 
@@ -146,15 +161,32 @@ namespace PHX
 		// Uniform collection
 		HashCombineUniformCollection(desc.uniformCollection, seed);
 
+		// Push constants
+		HashCombinePushConstantRanges(desc.pPushConstantRanges, desc.pushConstantRangeCount, seed);
+
 		// Shader info
 		HashCombineShaderArray(desc.pShaders, desc.shaderCount, seed);
 
 		return seed;
 	}
 
+	bool GraphicsPipelineKey::operator==(const GraphicsPipelineKey& other) const
+	{
+		return (renderPass == other.renderPass) && (subpassIndex == other.subpassIndex) && (desc == other.desc);
+	}
+
+	size_t GraphicsPipelineKeyHasher::operator()(const GraphicsPipelineKey& key) const
+	{
+		size_t seed = GraphicsPipelineDescHasher()(key.desc);
+		HashCombine(seed, key.renderPass);
+		HashCombine(seed, key.subpassIndex);
+
+		return seed;
+	}
+
 	size_t ComputePipelineDescHasher::operator()(const ComputePipelineDesc& desc) const
 	{
-		STATIC_ASSERT_MSG(sizeof(desc) == 32, "If compute pipeline description changed, make sure to change this hashing function!");
+		STATIC_ASSERT_MSG(sizeof(desc) == 48, "If compute pipeline description changed, make sure to change this hashing function!");
 
 		size_t seed = 0;
 
@@ -164,12 +196,15 @@ namespace PHX
 		// Uniform collection
 		HashCombineUniformCollection(desc.uniformCollection, seed);
 
+		// Push constants
+		HashCombinePushConstantRanges(desc.pPushConstantRanges, desc.pushConstantRangeCount, seed);
+
 		return seed;
 	}
 
 	size_t RayTracingPipelineDescHasher::operator()(const RayTracingPipelineDesc& desc) const
 	{
-		STATIC_ASSERT_MSG(sizeof(desc) == 56, "If ray tracing pipeline description changed, make sure to change this hashing function!");
+		STATIC_ASSERT_MSG(sizeof(desc) == 64, "If ray tracing pipeline description changed, make sure to change this hashing function!");
 
 		size_t seed = 0;
 
@@ -187,6 +222,9 @@ namespace PHX
 		// Uniform collection
 		HashCombineUniformCollection(desc.uniformCollection, seed);
 
+		// Push constants
+		HashCombinePushConstantRanges(desc.pPushConstantRanges, desc.pushConstantRangeCount, seed);
+
 		return seed;
 	}
 
@@ -230,15 +268,16 @@ namespace PHX
 	}
 
 	// GRAPHICS
-	PipelineVk* PipelineCache::FindOrCreate(RenderDeviceVk* pRenderDevice, VkRenderPass renderPass, const GraphicsPipelineDesc& desc)
+	PipelineVk* PipelineCache::FindOrCreate(RenderDeviceVk* pRenderDevice, VkRenderPass renderPass, u32 subpassIndex, const GraphicsPipelineDesc& desc)
 	{
 		PipelineVk* res = nullptr;
 
-		auto iter = m_graphicsPipelineCache.find(desc);
+		const GraphicsPipelineKey key = { desc, renderPass, subpassIndex };
+		auto iter = m_graphicsPipelineCache.find(key);
 		if (iter == m_graphicsPipelineCache.end())
 		{
-			PipelineVk* newPipeline = new PipelineVk(pRenderDevice, m_vkCache, renderPass, desc);
-			m_graphicsPipelineCache.insert({desc, newPipeline});
+			PipelineVk* newPipeline = new PipelineVk(pRenderDevice, m_vkCache, renderPass, subpassIndex, desc);
+			m_graphicsPipelineCache.insert({key, newPipeline});
 			res = newPipeline;
 
 			LogDebug("Graphics pipeline added to cache. New cache size: %u", m_graphicsPipelineCache.size());
@@ -253,10 +292,12 @@ namespace PHX
 
 	PipelineVk* PipelineCache::Find(const GraphicsPipelineDesc& desc)
 	{
-		auto iter = m_graphicsPipelineCache.find(desc);
-		if (iter != m_graphicsPipelineCache.end())
+		for (const auto& iter : m_graphicsPipelineCache)
 		{
-			return iter->second;
+			if (iter.first.desc == desc)
+			{
+				return iter.second;
+			}
 		}
 
 		return nullptr;
@@ -264,11 +305,17 @@ namespace PHX
 
 	void PipelineCache::Delete(const GraphicsPipelineDesc& desc)
 	{
-		auto iter = m_graphicsPipelineCache.find(desc);
-		if (iter != m_graphicsPipelineCache.end())
+		for (auto iter = m_graphicsPipelineCache.begin(); iter != m_graphicsPipelineCache.end();)
 		{
-			delete iter->second;
-			m_graphicsPipelineCache.erase(iter);
+			if (iter->first.desc == desc)
+			{
+				delete iter->second;
+				iter = m_graphicsPipelineCache.erase(iter);
+			}
+			else
+			{
+				++iter;
+			}
 		}
 	}
 
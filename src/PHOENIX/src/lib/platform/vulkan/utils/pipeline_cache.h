@@ -12,6 +12,23 @@ namespace PHX
 		size_t operator()(const GraphicsPipelineDesc& desc) const;
 	};
 
+	// Graphics pipelines can only be used in render passes compatible with the one they were created with, and only
+	// in the subpass they were created for. Render passes are cached for the lifetime of the render device, so the
+	// render pass handle identifies its attachment and subpass layout
+	struct GraphicsPipelineKey
+	{
+		GraphicsPipelineDesc desc;
+		VkRenderPass renderPass = VK_NULL_HANDLE;
+		u32 subpassIndex        = 0;
+
+		bool operator==(const GraphicsPipelineKey& other) const;
+	};
+
+	struct GraphicsPipelineKeyHasher
+	{
+		size_t operator()(const GraphicsPipelineKey& key) const;
+	};
+
 	struct ComputePipelineDescHasher
 	{
 		size_t operator()(const ComputePipelineDesc& desc) const;
@@ -33,9 +50,9 @@ namespace PHX
 		PipelineCache& operator=(const PipelineCache& other) = delete;
 
 		// Graphics pipeline
-		PipelineVk* FindOrCreate(RenderDeviceVk* pRenderDevice, VkRenderPass renderPass, const GraphicsPipelineDesc& desc);
-		PipelineVk* Find(const GraphicsPipelineDesc& desc);
-		void Delete(const GraphicsPipelineDesc& desc);
+		PipelineVk* FindOrCreate(RenderDeviceVk* pRenderDevice, VkRenderPass renderPass, u32 subpassIndex, const GraphicsPipelineDesc& desc);
+		PipelineVk* Find(const GraphicsPipelineDesc& desc);	// Returns the first pipeline created from the description, for any render pass
+		void Delete(const GraphicsPipelineDesc& desc);			// Deletes the pipelines created from the description for all render passes
 
 		// Compute pipeline
 		PipelineVk* FindOrCreate(RenderDeviceVk* pRenderDevice, const ComputePipelineDesc& desc);
@@ -57,7 +74,7 @@ namespace PHX
 		RenderDeviceVk* m_renderDevice;
 
 		// PipelineVk caches
-		std::unordered_map<GraphicsPipelineDesc, PipelineVk*, GraphicsPipelineDescHasher> m_graphicsPipelineCache;
+		std::unordered_map<GraphicsPipelineKey, PipelineVk*, GraphicsPipelineKeyHasher> m_graphicsPipelineCache;
 		std::unordered_map<ComputePipelineDesc, PipelineVk*, ComputePipelineDescHasher> m_computePipelineCache;
 		std::unordered_map<RayTracingPipelineDesc, PipelineVk*, RayTracingPipelineDescHasher> m_rayTracingPipelineCache;
 
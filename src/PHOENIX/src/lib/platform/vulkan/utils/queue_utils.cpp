@@ -1,4 +1,5 @@
 
+#include <vector>
 #include <vulkan/vk_enum_string_helper.h>
 
 #include "BSL/logger.h"
@@ -10,7 +11,7 @@ using namespace BSL;
 namespace PHX
 {
 	// If anything changes with the QUEUE_TYPE enum, make sure to change every reference to queueFamilies below!
-	STATIC_ASSERT(static_cast<u32>(QUEUE_TYPE::COUNT) == 4);
+	STATIC_ASSERT(static_cast<u32>(QUEUE_TYPE::COUNT) == 5);
 
 	QueueFamilyIndices::QueueFamilyIndices()
 	{
@@ -18,6 +19,7 @@ namespace PHX
 		queueFamilies[QUEUE_TYPE::PRESENT ] = { INVALID_INDEX, INVALID_INDEX };
 		queueFamilies[QUEUE_TYPE::TRANSFER] = { INVALID_INDEX, INVALID_INDEX };
 		queueFamilies[QUEUE_TYPE::COMPUTE ] = { INVALID_INDEX, INVALID_INDEX };
+		queueFamilies[QUEUE_TYPE::ASYNC_COMPUTE] = { INVALID_INDEX, INVALID_INDEX };
 		queueFamilies[QUEUE_TYPE::COUNT   ] = { INVALID_INDEX, INVALID_INDEX };
 	}
 
@@ -42,6 +44,7 @@ namespace PHX
 		queueFamilies[QUEUE_TYPE::PRESENT ] = other.queueFamilies.at(QUEUE_TYPE::PRESENT );
 		queueFamilies[QUEUE_TYPE::TRANSFER] = other.queueFamilies.at(QUEUE_TYPE::TRANSFER);
 		queueFamilies[QUEUE_TYPE::COMPUTE ] = other.queueFamilies.at(QUEUE_TYPE::COMPUTE );
+		queueFamilies[QUEUE_TYPE::ASYNC_COMPUTE] = other.queueFamilies.at(QUEUE_TYPE::ASYNC_COMPUTE);
 		queueFamilies[QUEUE_TYPE::COUNT   ] = other.queueFamilies.at(QUEUE_TYPE::COUNT   );
 
 		return *this;
@@ -83,26 +86,15 @@ namespace PHX
 
 	QueueFamilyIndices FindQueueFamilies(VkPhysicalDevice device, VkSurfaceKHR surface)
 	{
-		// PLAN:
-		// - Loop through all queue families.
-		// - Try to find queues for all supported QUEUE_TYPE values
-		// - Try to find separate TRANSFER queue (even if within same queue family)
-		// - Try to find separate PRESENT queue (even if within same queue family)
-		// - Optimal scenario could be that all QUEUE_TYPE values have distinct
-		//   queue indices, but it's fine if GRAPHICS and COMPUTE share a queue for now.
-		// - PRESENT MUST have it's own queue to avoid blocking subsequent frames in flight
-		//   on work that's currently in-flight. This is seen through a very long fence wait in DeviceContextVk::BeginFrame()
+		// - GRAPHICS and COMPUTE share the first queue family that supports both
+		// - ASYNC_COMPUTE uses a second queue from the graphics family, so resources written by async compute passes never
+		//   have to be handed between queue families. See RenderDeviceVk::CreateLogicalDevice()
+		// - PRESENT prefers the graphics family, so presenting doesn't need a queue family ownership transfer
+		// - TRANSFER prefers a dedicated transfer (DMA) family, which copies in parallel with rendering. Failing that, any
+		//   family without graphics support, and finally the graphics family itself
 
 		QueueFamilyIndices indices;
 
-		// TEMP
-		indices.SetIndices(QUEUE_TYPE::COMPUTE, 0, 0);
-		indices.SetIndices(QUEUE_TYPE::GRAPHICS, 0, 0);
-		indices.SetIndices(QUEUE_TYPE::PRESENT, 0, 0);
-		indices.SetIndices(QUEUE_TYPE::TRANSFER, 0, 1);
-		return indices;
-		// TEMP
-
 		uint32_t queueFamilyCount = 0;
 		vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, nullptr);
 
@@ -110,57 +102,84 @@ namespace PHX
 		vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, queueFamilies.data());
 
 		LogDebug("Found %u queue families:", queueFamilies.size());
-		uint32_t graphicsTransferQueue = std::numeric_limits<uint32_t>::max();
-		uint32_t i = 0;
-		for (const auto& queueFamily : queueFamilies)
+
+		u32 graphicsFamily = QueueFamilyIndices::INVALID_INDEX;
+		u32 presentFamily = QueueFamilyIndices::INVALID_INDEX;
+		u32 dedicatedTransferFamily = QueueFamilyIndices::INVALID_INDEX;
+		u32 nonGraphicsTransferFamily = QueueFamilyIndices::INVALID_INDEX;
+		bool graphicsSupportsPresent = false;
+		for (u32 i = 0; i < queueFamilyCount; i++)
 		{
-			// Check that the device supports a graphics queue and compute queue
-			// NOTE - We could potentially select separate queues for graphics and
-			//        compute, but let's keep it simple for now
-			if ((queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) && (queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT))
+			const VkQueueFlags flags = queueFamilies[i].queueFlags;
+
+			VkBool32 presentSupport = VK_FALSE;
+			if (surface != VK_NULL_HANDLE)
 			{
-				indices.SetIndices(QUEUE_TYPE::GRAPHICS, i, 0);
-				indices.SetIndices(QUEUE_TYPE::COMPUTE, i, 0);
+				vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
 			}
 
-			// Check that the device supports present queues
-			VkBool32 presentSupport = false;
-			vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
-
 			LogDebug("\t[%u] - %u queues: %s, PresentSupported(%s) ", 
 				i, 
-				queueFamily.queueCount, 
-				string_VkQueueFlags(queueFamily.queueFlags).c_str(),
+				queueFamilies[i].queueCount, 
+				string_VkQueueFlags(flags).c_str(),
 				presentSupport ? "YES" : "NO");
 
-			if (presentSupport)
+			const bool supportsGraphics = (flags & VK_QUEUE_GRAPHICS_BIT) != 0;
+			const bool supportsCompute = (flags & VK_QUEUE_COMPUTE_BIT) != 0;
+			const bool supportsTransfer = (flags & VK_QUEUE_TRANSFER_BIT) != 0;
+
+			if (graphicsFamily == QueueFamilyIndices::INVALID_INDEX && supportsGraphics && supportsCompute)
 			{
-				indices.SetIndices(QUEUE_TYPE::PRESENT, i, 0);
+				graphicsFamily = i;
+				graphicsSupportsPresent = (presentSupport == VK_TRUE);
 			}
 
-			// Check that the device supports a transfer queue
-			if (queueFamily.queueFlags & VK_QUEUE_TRANSFER_BIT)
+			if (presentFamily == QueueFamilyIndices::INVALID_INDEX && presentSupport)
 			{
-				// Choose a different queue from the graphics queue, if possible
-				if (indices.GetQueueIndex(QUEUE_TYPE::GRAPHICS) == i)
-				{
-					graphicsTransferQueue = i;
-				}
-				else
-				{
-					indices.SetIndices(QUEUE_TYPE::TRANSFER, i, 0);
-				}
+				presentFamily = i;
 			}
 
-			i++;
+			// Graphics and compute families implicitly support transfers, even if they don't report the bit
+			if (!supportsGraphics && !supportsCompute && supportsTransfer && dedicatedTransferFamily == QueueFamilyIndices::INVALID_INDEX)
+			{
+				dedicatedTransferFamily = i;
+			}
+			else if (!supportsGraphics && (supportsTransfer || supportsCompute) && nonGraphicsTransferFamily == QueueFamilyIndices::INVALID_INDEX)
+			{
+				nonGraphicsTransferFamily = i;
+			}
 		}
 
-		// If we couldn't find a different queue for the TRANSFER and GRAPHICS operations, then simply
-		// use the same queue for both (if it supports TRANSFER operations)
-		if (!indices.IsValid({ 0, static_cast<u32>(QUEUE_TYPE::TRANSFER) }) && graphicsTransferQueue != QueueFamilyIndices::INVALID_INDEX)
+		if (graphicsFamily != QueueFamilyIndices::INVALID_INDEX)
+		{
+			indices.SetIndices(QUEUE_TYPE::GRAPHICS, graphicsFamily, 0);
+			indices.SetIndices(QUEUE_TYPE::COMPUTE, graphicsFamily, 0);
+			indices.SetIndices(QUEUE_TYPE::ASYNC_COMPUTE, graphicsFamily, 0); // Uses queue 1 instead if the device supports async compute
+		}
+
+		// Headless devices never present. The present queue is the graphics queue, so the queue setup stays the same
+		if (graphicsSupportsPresent || surface == VK_NULL_HANDLE)
+		{
+			presentFamily = graphicsFamily;
+		}
+
+		if (presentFamily != QueueFamilyIndices::INVALID_INDEX)
+		{
+			indices.SetIndices(QUEUE_TYPE::PRESENT, presentFamily, 0);
+		}
+
+		if (dedicatedTransferFamily != QueueFamilyIndices::INVALID_INDEX)
+		{
+			indices.SetIndices(QUEUE_TYPE::TRANSFER, dedicatedTransferFamily, 0);
+		}
+		else if (nonGraphicsTransferFamily != QueueFamilyIndices::INVALID_INDEX)
+		{
+			indices.SetIndices(QUEUE_TYPE::TRANSFER, nonGraphicsTransferFamily, 0);
+		}
+		else if (graphicsFamily != QueueFamilyIndices::INVALID_INDEX)
 		{
 			LogDebug("Failed to find separate queue family for transfer and graphics. Using the same queue for both operations!");
-			indices.SetIndices(QUEUE_TYPE::TRANSFER, 0, graphicsTransferQueue);
+			indices.SetIndices(QUEUE_TYPE::TRANSFER, graphicsFamily, 0);
 		}
 
 		// Check that we filled in all of our queue families, otherwise log a warning
@@ -185,6 +204,7 @@ namespace PHX
 		case QUEUE_TYPE::PRESENT:  return "PRESENT";
 		case QUEUE_TYPE::TRANSFER: return "TRANSFER";
 		case QUEUE_TYPE::COMPUTE:  return "COMPUTE";
+		case QUEUE_TYPE::ASYNC_COMPUTE: return "ASYNC_COMPUTE";
 		}
 
 		ASSERT_ALWAYS("Failed to get name for queue type. Unexpected value!");
@@ -0,0 +1,315 @@
+#include <string>
+#include <vulkan/vk_enum_string_helper.h>
+
+#include "readback_pool.h"
+
+#include "BSL/logger.h"
+#include "BSL/math.h"
+#include "core/profiling.h"
+
+using namespace BSL;
+
+namespace PHX
+{
+	// Readback buffers are rounded up to this size so that slightly different readback sizes can share buffers
+	static constexpr u64 READBACK_BUFFER_GRANULARITY = 64 * 1024;
+
+	ReadbackPool::ReadbackPool(RenderDeviceVk* pRenderDevice, u32 framesInFlight) :
+		m_renderDevice(nullptr), m_slots(), m_frameSubmissions(framesInFlight, 0), m_completedCallbacks(), m_countedStorageCapacity(0), m_mutex()
+	{
+		if (pRenderDevice == nullptr)
+		{
+			LogError("Failed to create readback pool. Render device is null!");
+			return;
+		}
+		m_renderDevice = pRenderDevice;
+	}
+
+	ReadbackPool::~ReadbackPool()
+	{
+		if (m_renderDevice == nullptr)
+		{
+			return;
+		}
+
+		for (Slot& slot : m_slots)
+		{
+			DestroyBuffer(m_renderDevice, slot.buffer);
+		}
+		m_slots.clear();
+	}
+
+	ReadbackAllocation ReadbackPool::Acquire(u32 frameIndex, u64 sizeBytes, ReadbackCallbackFn callback)
+	{
+		PROFILE_SCOPE("ReadbackPool_Acquire");
+
+		ReadbackAllocation alloc{};
+
+		if (m_renderDevice == nullptr)
+		{
+			LogError("Failed to acquire readback buffer. Render device is null!");
+			return alloc;
+		}
+
+		if (sizeBytes == 0)
+		{
+			LogWarning("Skipped readback buffer acquisition. Size is 0!");
+			return alloc;
+		}
+
+		if (frameIndex >= m_frameSubmissions.size())
+		{
+			LogError("Failed to acquire readback buffer. Frame index %u is invalid (expected 0 to %u)", frameIndex, static_cast<u32>(m_frameSubmissions.size()));
+			return alloc;
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		// Reuse the smallest free buffer which fits the readback
+		u32 slotIndex = U32_MAX;
+		for (u32 i = 0; i < static_cast<u32>(m_slots.size()); i++)
+		{
+			const Slot& currSlot = m_slots[i];
+			if (currSlot.state != SLOT_STATE::FREE || currSlot.buffer.size < sizeBytes)
+			{
+				continue;
+			}
+
+			if (slotIndex == U32_MAX || currSlot.buffer.size < m_slots[slotIndex].buffer.size)
+			{
+				slotIndex = i;
+			}
+		}
+
+		if (slotIndex == U32_MAX)
+		{
+			// Host-cached memory, since the CPU reads from it. Random access keeps VMA from picking uncached write-combined memory
+			const u64 bufferSize = AlignUp(sizeBytes, READBACK_BUFFER_GRANULARITY);
+			const VmaAllocationCreateFlags readbackFlags = VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT;
+			const VkBufferUsageFlags readbackUsage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+			std::string bufferName = "ReadbackPool_" + std::to_string(m_slots.size());
+			BufferData newBuffer = CreateBuffer(m_renderDevice, bufferName.c_str(), bufferSize, readbackUsage, readbackFlags, 0, VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+			if (!newBuffer.isValid || newBuffer.allocInfo.pMappedData == nullptr)
+			{
+				LogError("Failed to create readback buffer of size %llu bytes!", bufferSize);
+				DestroyBuffer(m_renderDevice, newBuffer);
+				return alloc;
+			}
+
+			LogDebug("Created new readback buffer of size %llu bytes!", bufferSize);
+
+			Slot newSlot{};
+			newSlot.buffer = newBuffer;
+			m_slots.push_back(newSlot);
+			slotIndex = static_cast<u32>(m_slots.size() - 1);
+		}
+
+		Slot& slot = m_slots[slotIndex];
+		slot.sizeBytes = sizeBytes;
+		slot.generation++;
+		if (slot.generation == 0)
+		{
+			// Generation 0 marks invalid tickets
+			slot.generation++;
+		}
+		slot.frameIndex = frameIndex;
+		slot.submission = m_frameSubmissions[frameIndex] + 1;
+		slot.state = SLOT_STATE::PENDING;
+		slot.isReleased = false;
+		slot.callback = callback;
+
+		alloc.buffer = slot.buffer.buffer;
+		alloc.ticket.slot = slotIndex;
+		alloc.ticket.generation = slot.generation;
+		alloc.isValid = true;
+
+		return alloc;
+	}
+
+	void ReadbackPool::CompleteFrame(u32 frameIndex)
+	{
+		PROFILE_SCOPE("ReadbackPool_CompleteFrame");
+
+		std::vector<CompletedCallback>& completedCallbacks = m_completedCallbacks;
+		completedCallbacks.clear();
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			for (u32 i = 0; i < static_cast<u32>(m_slots.size()); i++)
+			{
+				// Readbacks with a callback may already have been found ready by polling, but their callback still has to run
+				Slot& slot = m_slots[i];
+				const bool isPending = (slot.state == SLOT_STATE::PENDING) || (slot.state == SLOT_STATE::READY && slot.callback);
+				if (!isPending || slot.frameIndex != frameIndex)
+				{
+					continue;
+				}
+
+				if (slot.isReleased)
+				{
+					slot.state = SLOT_STATE::FREE;
+					slot.callback = nullptr;
+					continue;
+				}
+
+				if (slot.state == SLOT_STATE::PENDING)
+				{
+					InvalidateSlot(slot);
+					slot.state = SLOT_STATE::READY;
+				}
+
+				if (slot.callback)
+				{
+					slot.isInCallback = true;
+					completedCallbacks.push_back({ slot.callback, slot.buffer.allocInfo.pMappedData, slot.sizeBytes, { i, slot.generation } });
+				}
+			}
+		}
+
+		// Callbacks run without the lock held, so they're free to record new readbacks. The mapped pointers stay valid since
+		// releasing a slot while its callback runs only marks it, and it isn't handed out again until it's freed here
+		for (const CompletedCallback& completed : completedCallbacks)
+		{
+			completed.callback(completed.pData, completed.sizeBytes);
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			Slot& slot = m_slots[completed.ticket.slot];
+			slot.state = SLOT_STATE::FREE;
+			slot.sizeBytes = 0;
+			slot.isReleased = false;
+			slot.isInCallback = false;
+			slot.callback = nullptr;
+		}
+	}
+
+	void ReadbackPool::SubmitFrame(u32 frameIndex)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (frameIndex < m_frameSubmissions.size())
+		{
+			m_frameSubmissions[frameIndex]++;
+		}
+	}
+
+	READBACK_STATUS ReadbackPool::GetStatus(ReadbackTicket ticket)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		Slot* pSlot = ResolveTicket(ticket);
+		if (pSlot == nullptr)
+		{
+			return READBACK_STATUS::INVALID;
+		}
+
+		if (pSlot->state == SLOT_STATE::PENDING)
+		{
+			// The frame fence is reset when the frame begins and signaled once the GPU is done with the frame, so once the
+			// readback's frame has been submitted, a signaled fence means its copy has completed
+			if (m_frameSubmissions[pSlot->frameIndex] < pSlot->submission)
+			{
+				return READBACK_STATUS::PENDING;
+			}
+
+			VkFence frameFence = m_renderDevice->GetQueueFence(QUEUE_TYPE::GRAPHICS, pSlot->frameIndex);
+			if (vkGetFenceStatus(m_renderDevice->GetLogicalDevice(), frameFence) != VK_SUCCESS)
+			{
+				return READBACK_STATUS::PENDING;
+			}
+
+			InvalidateSlot(*pSlot);
+			pSlot->state = SLOT_STATE::READY;
+		}
+
+		return READBACK_STATUS::READY;
+	}
+
+	STATUS_CODE ReadbackPool::GetData(ReadbackTicket ticket, const void*& out_pData, u64& out_sizeBytes)
+	{
+		if (GetStatus(ticket) != READBACK_STATUS::READY)
+		{
+			LogError("Failed to get readback data. Ticket is invalid or the readback is still pending!");
+			return STATUS_CODE::ERR_API;
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		Slot* pSlot = ResolveTicket(ticket);
+		if (pSlot == nullptr)
+		{
+			LogError("Failed to get readback data. Ticket was released!");
+			return STATUS_CODE::ERR_API;
+		}
+
+		out_pData = pSlot->buffer.allocInfo.pMappedData;
+		out_sizeBytes = pSlot->sizeBytes;
+
+		return STATUS_CODE::SUCCESS;
+	}
+
+	void ReadbackPool::Release(ReadbackTicket ticket)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		Slot* pSlot = ResolveTicket(ticket);
+		if (pSlot == nullptr)
+		{
+			LogWarning("Skipped releasing readback. Ticket is invalid or was already released!");
+			return;
+		}
+
+		if (pSlot->state == SLOT_STATE::PENDING || pSlot->isInCallback)
+		{
+			// The GPU may still write to the buffer, or the callback still reads from it, so it can't be handed out again yet
+			pSlot->isReleased = true;
+			pSlot->callback = nullptr;
+			return;
+		}
+
+		pSlot->state = SLOT_STATE::FREE;
+		pSlot->sizeBytes = 0;
+		pSlot->callback = nullptr;
+	}
+
+	bool ReadbackPool::HasStorageGrown()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		const size_t capacity = m_slots.capacity() * sizeof(Slot) + m_completedCallbacks.capacity() * sizeof(CompletedCallback);
+		if (capacity > m_countedStorageCapacity)
+		{
+			m_countedStorageCapacity = capacity;
+			return true;
+		}
+
+		return false;
+	}
+
+	ReadbackPool::Slot* ReadbackPool::ResolveTicket(ReadbackTicket ticket)
+	{
+		if (ticket.generation == 0 || ticket.slot >= m_slots.size())
+		{
+			return nullptr;
+		}
+
+		Slot& slot = m_slots[ticket.slot];
+		if (slot.state == SLOT_STATE::FREE || slot.isReleased || slot.generation != ticket.generation)
+		{
+			return nullptr;
+		}
+
+		return &slot;
+	}
+
+	void ReadbackPool::InvalidateSlot(Slot& slot)
+	{
+		// No-op for coherent memory
+		VkResult res = vmaInvalidateAllocation(m_renderDevice->GetAllocator(), slot.buffer.alloc, 0, slot.sizeBytes);
+		if (res != VK_SUCCESS)
+		{
+			LogError("Failed to invalidate readback buffer! Got result: \"%s\"", string_VkResult(res));
+		}
+	}
+}
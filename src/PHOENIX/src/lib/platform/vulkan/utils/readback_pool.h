@@ -0,0 +1,102 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include "BSL/integral_types.h"
+#include "PHX/interface/device_context.h"
+
+#include "../render_device_vk.h"
+#include "buffer_utils.h"
+
+namespace PHX
+{
+	struct ReadbackAllocation
+	{
+		VkBuffer buffer 		= VK_NULL_HANDLE;
+		ReadbackTicket ticket 	= {};
+		bool isValid 			= false;
+	};
+
+	// Pool of host-cached buffers that the GPU copies readback data into. A buffer is handed out per readback and returned to the
+	// pool once its ticket is released, so buffers are reused across frames instead of being created per readback. Readbacks
+	// complete when the device context owning their frame-in-flight index waits on that frame's fence, which it does anyway
+	// before re-using the frame's resources, so nothing ever waits on the GPU just for a readback. Polling a pending readback
+	// checks the frame fence directly once the frame has been submitted, so results can also be picked up as soon as the GPU is
+	// done with the frame. Frame fences start out signaled, so they say nothing about readbacks that haven't been submitted yet.
+	// All functions are thread safe, since worker device contexts record readbacks into the same pool
+	class ReadbackPool
+	{
+	public:
+
+		ReadbackPool(RenderDeviceVk* pRenderDevice, u32 framesInFlight);
+		~ReadbackPool();
+
+		ReadbackPool(const ReadbackPool& other) = delete;
+		ReadbackPool& operator=(const ReadbackPool& other) = delete;
+
+		// Acquires a buffer of at least sizeBytes for a readback recorded in the given frame. Released buffers are reused if
+		// one is large enough, otherwise a new one is created
+		ReadbackAllocation Acquire(u32 frameIndex, u64 sizeBytes, ReadbackCallbackFn callback);
+
+		// Must only be called once the GPU is done with the frame that last used the given index. Marks every readback
+		// recorded in that frame as ready, runs their callbacks and releases the ones that had a callback
+		void CompleteFrame(u32 frameIndex);
+
+		// Must be called once the frame with the given index has been submitted with its fence. Polling only checks the frame
+		// fence for readbacks recorded before the submission
+		void SubmitFrame(u32 frameIndex);
+
+		READBACK_STATUS GetStatus(ReadbackTicket ticket);
+		STATUS_CODE GetData(ReadbackTicket ticket, const void*& out_pData, u64& out_sizeBytes);
+
+		// Readbacks released while still pending, or while their callback runs, keep their buffer until they're done
+		void Release(ReadbackTicket ticket);
+
+		// Returns true if the slots or the callback list had to grow since the last call
+		bool HasStorageGrown();
+
+	private:
+
+		enum class SLOT_STATE : u8
+		{
+			FREE = 0,
+			PENDING,
+			READY
+		};
+
+		struct Slot
+		{
+			BufferData buffer;
+			u64 sizeBytes 				= 0; // Size of the readback currently using the slot, not of the buffer
+			u32 generation 				= 0;
+			u32 frameIndex 				= 0;
+			u64 submission 				= 0; // Submission of the frame index the readback is recorded in
+			SLOT_STATE state 			= SLOT_STATE::FREE;
+			bool isReleased 			= false; // Released while pending, freed once the frame completes
+			bool isInCallback 			= false; // Callback is running without the lock held, the slot is freed once it returns
+			ReadbackCallbackFn callback = nullptr;
+		};
+
+		struct CompletedCallback
+		{
+			ReadbackCallbackFn callback;
+			const void* pData;
+			u64 sizeBytes;
+			ReadbackTicket ticket;
+		};
+
+		// Returns nullptr if the ticket doesn't refer to a slot in use, or was released. Requires m_mutex to be locked
+		Slot* ResolveTicket(ReadbackTicket ticket);
+
+		// Makes the GPU writes visible to the host, for memory types which aren't coherent. Requires m_mutex to be locked
+		void InvalidateSlot(Slot& slot);
+
+		RenderDeviceVk* m_renderDevice;
+		std::vector<Slot> m_slots;
+		std::vector<u64> m_frameSubmissions; // Number of submissions per frame index
+		std::vector<CompletedCallback> m_completedCallbacks; // Only used by CompleteFrame(), kept to reuse its memory
+		size_t m_countedStorageCapacity; // Capacity of the containers on the last call to HasStorageGrown()
+		std::mutex m_mutex;
+	};
+}
@@ -105,54 +105,79 @@ namespace PHX
 			attachmentRef.layout = attachmentDesc.layout;
 		}
 
-		VkSubpassDescription subpassDescVk{};
-		VkSubpassDependency subpassDepVk{};
-
-		if (desc.subpasses.size() > 1)
+		// Attachment references are stored per subpass, since the same attachment can be referenced in a
+		// different layout by every subpass (e.g. written as a color attachment, then read as an input attachment)
+		const u32 subpassCount = static_cast<u32>(desc.subpasses.size());
+		std::vector<VkSubpassDescription> subpassDescsVk(subpassCount);
+		std::vector<std::vector<VkAttachmentReference>> colorAttachmentRefs(subpassCount);
+		std::vector<VkSubpassDependency> subpassDepsVk;
+		subpassDepsVk.reserve(subpassCount + desc.dependencies.size());
+
+		for (u32 i = 0; i < subpassCount; i++)
 		{
-			LogWarning("Only one subpass is currently supported for render passes!");
+			const SubpassDescription& subpassInfo = desc.subpasses.at(i);
+			VkSubpassDescription& subpassDescVk = subpassDescsVk.at(i);
+
+			subpassDescVk.pipelineBindPoint = subpassInfo.bindPoint;
+			subpassDescVk.colorAttachmentCount = static_cast<u32>(subpassInfo.colorAttachmentIndices.size());
+			subpassDescVk.pInputAttachments = subpassInfo.inputAttachments.empty() ? nullptr : subpassInfo.inputAttachments.data();
+			subpassDescVk.inputAttachmentCount = static_cast<u32>(subpassInfo.inputAttachments.size());
+
+			if (subpassInfo.depthStencilAttachmentIndex != U32_MAX)
+			{
+				subpassDescVk.pDepthStencilAttachment = &(attachmentRefs.at(subpassInfo.depthStencilAttachmentIndex));
+			}
+
+			if (subpassInfo.resolveAttachmentIndex != U32_MAX)
+			{
+				subpassDescVk.pResolveAttachments = &(attachmentRefs.at(subpassInfo.resolveAttachmentIndex));
+			}
+
+			std::vector<VkAttachmentReference>& subpassColorRefs = colorAttachmentRefs.at(i);
+			subpassColorRefs.reserve(subpassInfo.colorAttachmentIndices.size());
+			for (const auto& colorAttachmentIndex : subpassInfo.colorAttachmentIndices)
+			{
+				subpassColorRefs.push_back(attachmentRefs.at(colorAttachmentIndex));
+			}
+			subpassDescVk.pColorAttachments = subpassColorRefs.data();
+
+			// Subpass dependencies. Later subpasses may only depend on earlier subpasses
+			if (i > 0 && subpassInfo.srcStageMask == VK_PIPELINE_STAGE_NONE && subpassInfo.dstStageMask == VK_PIPELINE_STAGE_NONE)
+			{
+				continue;
+			}
+
+			VkSubpassDependency subpassDepVk{};
+			subpassDepVk.srcSubpass = VK_SUBPASS_EXTERNAL;
+			subpassDepVk.dstSubpass = i;
+			subpassDepVk.srcStageMask = subpassInfo.srcStageMask;
+			subpassDepVk.dstStageMask = subpassInfo.dstStageMask;
+			subpassDepVk.srcAccessMask = subpassInfo.srcAccessMask;
+			subpassDepVk.dstAccessMask = subpassInfo.dstAccessMask;
+			subpassDepsVk.push_back(subpassDepVk);
 		}
-		const SubpassDescription& subpassInfo = desc.subpasses.at(0);
-
-		subpassDescVk.pipelineBindPoint = subpassInfo.bindPoint;
-		subpassDescVk.colorAttachmentCount = static_cast<u32>(subpassInfo.colorAttachmentIndices.size());
-		subpassDescVk.pInputAttachments = nullptr;
-		subpassDescVk.inputAttachmentCount = 0;
 
-		if (subpassInfo.depthStencilAttachmentIndex != U32_MAX)
+		for (const SubpassDependencyDescription& dependency : desc.dependencies)
 		{
-			subpassDescVk.pDepthStencilAttachment = &(attachmentRefs.at(subpassInfo.depthStencilAttachmentIndex));
+			VkSubpassDependency subpassDepVk{};
+			subpassDepVk.srcSubpass = dependency.srcSubpass;
+			subpassDepVk.dstSubpass = dependency.dstSubpass;
+			subpassDepVk.srcStageMask = dependency.srcStageMask;
+			subpassDepVk.dstStageMask = dependency.dstStageMask;
+			subpassDepVk.srcAccessMask = dependency.srcAccessMask;
+			subpassDepVk.dstAccessMask = dependency.dstAccessMask;
+			subpassDepVk.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+			subpassDepsVk.push_back(subpassDepVk);
 		}
 
-		if (subpassInfo.resolveAttachmentIndex != U32_MAX)
-		{
-			subpassDescVk.pResolveAttachments = &(attachmentRefs.at(subpassInfo.resolveAttachmentIndex));
-		}
-			
-		std::vector<VkAttachmentReference> colorAttachmentRefs;
-		colorAttachmentRefs.reserve(subpassInfo.colorAttachmentIndices.size());
-		for (const auto& colorAttachmentIndex : subpassInfo.colorAttachmentIndices)
-		{
-			colorAttachmentRefs.push_back(attachmentRefs.at(colorAttachmentIndex));
-		}
-		subpassDescVk.pColorAttachments = colorAttachmentRefs.data();
-
-		// Subpass dependencies
-		subpassDepVk.srcSubpass = VK_SUBPASS_EXTERNAL;
-		subpassDepVk.dstSubpass = 0;
-		subpassDepVk.srcStageMask = subpassInfo.srcStageMask;
-		subpassDepVk.dstStageMask = subpassInfo.dstStageMask;
-		subpassDepVk.srcAccessMask = subpassInfo.srcAccessMask;
-		subpassDepVk.dstAccessMask = subpassInfo.dstAccessMask;
-
 		VkRenderPassCreateInfo renderPassInfo{};
 		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
 		renderPassInfo.attachmentCount = static_cast<u32>(attachmentDescs.size());
 		renderPassInfo.pAttachments = attachmentDescs.data();
-		renderPassInfo.subpassCount = 1;
-		renderPassInfo.pSubpasses = &subpassDescVk;
-		renderPassInfo.dependencyCount = 1;
-		renderPassInfo.pDependencies = &subpassDepVk;
+		renderPassInfo.subpassCount = subpassCount;
+		renderPassInfo.pSubpasses = subpassDescsVk.data();
+		renderPassInfo.dependencyCount = static_cast<u32>(subpassDepsVk.size());
+		renderPassInfo.pDependencies = subpassDepsVk.data();
 
 		VkRenderPass renderPass = VK_NULL_HANDLE;
 		VkResult res = vkCreateRenderPass(pRenderDevice->GetLogicalDevice(), &renderPassInfo, nullptr, &renderPass);
@@ -163,7 +188,7 @@ namespace PHX
 
 		DEBUG_UTILS::SetObjectName(pRenderDevice->GetLogicalDevice(), VK_OBJECT_TYPE_RENDER_PASS, reinterpret_cast<uint64_t>(renderPass), "RenderPass");
 
-		LogDebug("RENDER PASS CREATED: %u attachments, %u subpasses, %u subpass dependencies", static_cast<u32>(attachmentDescs.size()), 1, 1);
+		LogDebug("RENDER PASS CREATED: %u attachments, %u subpasses, %u subpass dependencies", static_cast<u32>(attachmentDescs.size()), subpassCount, static_cast<u32>(subpassDepsVk.size()));
 
 		// ATTACHMENTS
 		for (u32 i = 0; i < static_cast<u32>(attachmentDescs.size()); i++)
@@ -185,13 +210,27 @@ namespace PHX
 		LogDebug(""); // Separation
 
 		// SUBPASSES + SUBPASS DEPENDENCIES
-		for (u32 i = 0; i < 1; i++) // Hard-coded to only 1 for now
+		for (u32 i = 0; i < subpassCount; i++)
 		{
-			LogDebug("\tSubpass %u (and dependencies)", i);
+			const VkSubpassDescription& subpassDescVk = subpassDescsVk.at(i);
+
+			LogDebug("\tSubpass %u", i);
 			LogDebug("\t- Bind point:               %s", string_VkPipelineBindPoint(subpassDescVk.pipelineBindPoint));
 			LogDebug("\t- Color attachment count:   %u", subpassDescVk.colorAttachmentCount);
+			LogDebug("\t- Input attachment count:   %u", subpassDescVk.inputAttachmentCount);
 			LogDebug("\t- Depth/stencil attachment: %u", subpassDescVk.pDepthStencilAttachment == nullptr ? 0 : 1);
 			LogDebug("\t- Resolve attachment count: %u", subpassDescVk.pResolveAttachments == nullptr ? 0 : 1);
+		}
+		for (const VkSubpassDependency& subpassDepVk : subpassDepsVk)
+		{
+			if (subpassDepVk.srcSubpass == VK_SUBPASS_EXTERNAL)
+			{
+				LogDebug("\tDependency external -> %u", subpassDepVk.dstSubpass);
+			}
+			else
+			{
+				LogDebug("\tDependency %u -> %u", subpassDepVk.srcSubpass, subpassDepVk.dstSubpass);
+			}
 			LogDebug("\t- Src access mask:          %s", string_VkAccessFlags(subpassDepVk.srcAccessMask).c_str());
 			LogDebug("\t- Dst access mask:          %s", string_VkAccessFlags(subpassDepVk.dstAccessMask).c_str());
 			LogDebug("\t- Src stage mask:           %s", string_VkPipelineStageFlags(subpassDepVk.srcStageMask).c_str());
@@ -30,7 +30,40 @@ namespace PHX
 			}
 		}
 
-		return isEqual;
+		if (!isEqual || subpasses.size() != other.subpasses.size() || dependencies.size() != other.dependencies.size())
+		{
+			return false;
+		}
+
+		for (u32 i = 0; i < subpasses.size(); i++)
+		{
+			const SubpassDescription& thisSubpass = subpasses[i];
+			const SubpassDescription& otherSubpass = other.subpasses[i];
+
+			if (thisSubpass.bindPoint != otherSubpass.bindPoint ||
+				thisSubpass.colorAttachmentIndices != otherSubpass.colorAttachmentIndices ||
+				thisSubpass.depthStencilAttachmentIndex != otherSubpass.depthStencilAttachmentIndex ||
+				thisSubpass.resolveAttachmentIndex != otherSubpass.resolveAttachmentIndex ||
+				thisSubpass.srcStageMask != otherSubpass.srcStageMask ||
+				thisSubpass.dstStageMask != otherSubpass.dstStageMask ||
+				thisSubpass.srcAccessMask != otherSubpass.srcAccessMask ||
+				thisSubpass.dstAccessMask != otherSubpass.dstAccessMask ||
+				thisSubpass.inputAttachments.size() != otherSubpass.inputAttachments.size())
+			{
+				return false;
+			}
+
+			for (u32 j = 0; j < thisSubpass.inputAttachments.size(); j++)
+			{
+				if (thisSubpass.inputAttachments[j].attachment != otherSubpass.inputAttachments[j].attachment ||
+					thisSubpass.inputAttachments[j].layout != otherSubpass.inputAttachments[j].layout)
+				{
+					return false;
+				}
+			}
+		}
+
+		return (dependencies.empty() || memcmp(dependencies.data(), other.dependencies.data(), dependencies.size() * sizeof(SubpassDependencyDescription)) == 0);
 	}
 
 	size_t RenderPassDescriptionHasher::operator()(const RenderPassDescription& desc) const
@@ -59,6 +92,12 @@ namespace PHX
 		{
 			HashCombine(seed, subpass.bindPoint);
 			HashCombine(seed, subpass.colorAttachmentIndices.size());
+			HashCombine(seed, subpass.inputAttachments.size());
+			for (const auto& inputAttachment : subpass.inputAttachments)
+			{
+				HashCombine(seed, inputAttachment.attachment);
+				HashCombine(seed, inputAttachment.layout);
+			}
 			HashCombine(seed, subpass.depthStencilAttachmentIndex);
 			HashCombine(seed, subpass.resolveAttachmentIndex);
 			HashCombine(seed, subpass.srcStageMask);
@@ -66,6 +105,17 @@ namespace PHX
 			HashCombine(seed, subpass.dstAccessMask);
 		}
 
+		HashCombine(seed, desc.dependencies.size());
+		for (const auto& dependency : desc.dependencies)
+		{
+			HashCombine(seed, dependency.srcSubpass);
+			HashCombine(seed, dependency.dstSubpass);
+			HashCombine(seed, dependency.srcStageMask);
+			HashCombine(seed, dependency.dstStageMask);
+			HashCombine(seed, dependency.srcAccessMask);
+			HashCombine(seed, dependency.dstAccessMask);
+		}
+
 		return seed;
 	}
 }
\ No newline at end of file
@@ -26,8 +26,23 @@ namespace PHX
 	{
 		VkPipelineBindPoint bindPoint				= VK_PIPELINE_BIND_POINT_GRAPHICS;
 		std::vector<u32> colorAttachmentIndices;
+		std::vector<VkAttachmentReference> inputAttachments; // Input attachments are read in a different layout than they're written in
 		u32 depthStencilAttachmentIndex				= U32_MAX;
 		u32 resolveAttachmentIndex					= U32_MAX;
+
+		// Dependency between this subpass and the commands outside of the render pass
+		VkPipelineStageFlags srcStageMask			= VK_PIPELINE_STAGE_NONE;
+		VkPipelineStageFlags dstStageMask			= VK_PIPELINE_STAGE_NONE;
+		VkAccessFlags srcAccessMask					= VK_ACCESS_NONE;
+		VkAccessFlags dstAccessMask					= VK_ACCESS_NONE;
+	};
+
+	// Dependency between two subpasses of the same render pass. These are always framebuffer-local,
+	// since subpasses are only merged when they access each other's attachments at the same pixel
+	struct SubpassDependencyDescription
+	{
+		u32 srcSubpass								= 0;
+		u32 dstSubpass								= 0;
 		VkPipelineStageFlags srcStageMask			= VK_PIPELINE_STAGE_NONE;
 		VkPipelineStageFlags dstStageMask			= VK_PIPELINE_STAGE_NONE;
 		VkAccessFlags srcAccessMask					= VK_ACCESS_NONE;
@@ -40,6 +55,7 @@ namespace PHX
 	{
 		std::vector<AttachmentDescription> attachments;
 		std::vector<SubpassDescription> subpasses;
+		std::vector<SubpassDependencyDescription> dependencies;
 
 		///////
 		bool operator==(const RenderPassDescription& other) const;
@@ -52,5 +52,21 @@ namespace PHX
 			if (flags & SHADER_STAGE_FLAG_TESSELLATION_EVALUATION) result |= VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
 			return result;
 		}
+
+		VkPipelineStageFlags ConvertToPipelineStageFlags(ShaderStageFlags flags)
+		{
+			const ShaderStageFlags rayTracingFlags = SHADER_STAGE_FLAG_RAYGEN | SHADER_STAGE_FLAG_INTERSECTION | SHADER_STAGE_FLAG_ANY_HIT |
+				SHADER_STAGE_FLAG_CLOSEST_HIT | SHADER_STAGE_FLAG_MISS | SHADER_STAGE_FLAG_CALLABLE;
+
+			VkPipelineStageFlags result = 0;
+			if (flags & SHADER_STAGE_FLAG_VERTEX)                  result |= VK_PIPELINE_STAGE_VERTEX_SHADER_BIT;
+			if (flags & SHADER_STAGE_FLAG_GEOMETRY)                result |= VK_PIPELINE_STAGE_GEOMETRY_SHADER_BIT;
+			if (flags & SHADER_STAGE_FLAG_FRAGMENT)                result |= VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+			if (flags & SHADER_STAGE_FLAG_COMPUTE)                 result |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+			if (flags & rayTracingFlags)                           result |= VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR;
+			if (flags & SHADER_STAGE_FLAG_TESSELLATION_CONTROL)    result |= VK_PIPELINE_STAGE_TESSELLATION_CONTROL_SHADER_BIT;
+			if (flags & SHADER_STAGE_FLAG_TESSELLATION_EVALUATION) result |= VK_PIPELINE_STAGE_TESSELLATION_EVALUATION_SHADER_BIT;
+			return result;
+		}
 	}
 }
\ No newline at end of file
@@ -10,5 +10,8 @@ namespace PHX
 	{
 		VkShaderStageFlagBits ConvertShaderStage(SHADER_STAGE stage);
 		VkShaderStageFlags ConvertShaderStageFlags(ShaderStageFlags flags);
+
+		// Returns the pipeline stages the given shader stages execute in
+		VkPipelineStageFlags ConvertToPipelineStageFlags(ShaderStageFlags flags);
 	}
 }
\ No newline at end of file
@@ -1,4 +1,3 @@
-
 #include <string>
 
 #include "staging_buffer_pool.h"
@@ -12,11 +11,26 @@ using namespace BSL;
 
 namespace PHX
 {
-	// TODO - Expose to client
-	static constexpr u64 DEFAULT_POOL_SIZE = MB(32);
+	// Small size classes. Every size class is twice the size of the previous one, and its slots are carved from slabs of a
+	// fixed size. Slot offsets are multiples of the smallest slot size, so they satisfy any alignment that divides it
+	static constexpr u64 MIN_SMALL_SLOT_SIZE = 256;
+	static constexpr u64 MAX_SMALL_SLOT_SIZE = 64 * 1024;
+	static constexpr u64 SMALL_SLAB_SIZE = 256 * 1024;
 
-	StagingBufferPool::StagingBufferPool(RenderDeviceVk* pRenderDevice) :
-	 	m_renderDevice(nullptr), m_poolBuffers(), m_poolOffsets()
+	static u32 GetSmallSizeClass(u64 sizeBytes)
+	{
+		u32 sizeClass = 0;
+		while ((MIN_SMALL_SLOT_SIZE << sizeClass) < sizeBytes)
+		{
+			sizeClass++;
+		}
+		return sizeClass;
+	}
+
+	StagingBufferPool::StagingBufferPool(RenderDeviceVk* pRenderDevice, u32 framesInFlight, u64 ringSize) :
+	 	m_renderDevice(nullptr), m_ringSize(ringSize), m_ring(), m_ringHead(0), m_ringTail(0), m_ringSpans(), m_smallSlabs(),
+		m_freeSmallSlots(GetSmallSizeClass(MAX_SMALL_SLOT_SIZE) + 1), m_frameSmallSlots(framesInFlight), m_frameOverflowBuffers(framesInFlight),
+		m_allocatedBytes(0), m_peakAllocatedBytes(0), m_mutex()
 	{
 		if (pRenderDevice == nullptr)
 		{
@@ -31,7 +45,7 @@ namespace PHX
 		Destroy();
 	}
 
-	StagingAllocation StagingBufferPool::Allocate(u64 sizeBytes, u64 alignment)
+	StagingAllocation StagingBufferPool::Allocate(u32 frameIndex, u64 sizeBytes, u64 alignment)
 	{
 		PROFILE_SCOPE("StagingBufferPool_Allocate");
 
@@ -43,6 +57,12 @@ namespace PHX
 			return alloc;
 		}
 
+		if (frameIndex >= m_frameSmallSlots.size())
+		{
+			LogError("Failed to allocate from staging pool. Frame index %u is out of range!", frameIndex);
+			return alloc;
+		}
+
 		const u64 maxBufferSize = m_renderDevice->GetDeviceProperties().limits.maxStorageBufferRange;
 		if (sizeBytes > maxBufferSize)
 		{
@@ -56,61 +76,175 @@ namespace PHX
 			return alloc;
 		}
 
-		// Search existing pools for one with enough remaining space
-		for (u32 i = 0; i < m_poolBuffers.size(); i++)
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (TryAllocateSmallSlot(frameIndex, sizeBytes, alignment, alloc) || TryAllocateFromRing(frameIndex, sizeBytes, alignment, alloc))
+		{
+			return alloc;
+		}
+
+		// The ring is full, or the allocation is larger than the ring. The buffer is only kept until the frame completes
+		BufferData overflowBuffer = CreateStagingBuffer("StagingBufferPool_Overflow", sizeBytes);
+		if (!overflowBuffer.isValid)
 		{
-			const BufferData& currPoolBuffer = m_poolBuffers[i];
-			u64 alignedOffset = AlignUp(m_poolOffsets[i], alignment);
-			if (alignedOffset + sizeBytes <= currPoolBuffer.size)
+			return alloc;
+		}
+		m_frameOverflowBuffers[frameIndex].push_back(overflowBuffer);
+
+		alloc.buffer = overflowBuffer.buffer;
+		alloc.offset = 0;
+		alloc.mappedData = overflowBuffer.allocInfo.pMappedData;
+		alloc.isValid = true;
+
+		return alloc;
+	}
+
+	void StagingBufferPool::CompleteFrame(u32 frameIndex)
+	{
+		PROFILE_SCOPE("StagingBufferPool_CompleteFrame");
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (frameIndex >= m_frameSmallSlots.size())
+		{
+			return;
+		}
+
+		// The ring can only move its tail past spans in allocation order, so a completed span stays in the ring until every
+		// span before it has completed as well
+		for (RingSpan& span : m_ringSpans)
+		{
+			if (span.frameIndex == frameIndex)
 			{
-				alloc.buffer = currPoolBuffer.buffer;
-				alloc.offset = alignedOffset;
-				alloc.mappedData = static_cast<u8*>(currPoolBuffer.allocInfo.pMappedData) + alignedOffset;
-				alloc.isValid = true;
-				m_poolOffsets[i] = alignedOffset + sizeBytes; // Update pool offset to reflect new allocation
-				return alloc;
+				span.isComplete = true;
 			}
 		}
 
-		// No existing pool has enough space, allocate a new one
-		u64 newPoolSize = DEFAULT_POOL_SIZE;
-		if (sizeBytes > newPoolSize)
+		u32 completedSpanCount = 0;
+		while (completedSpanCount < m_ringSpans.size() && m_ringSpans[completedSpanCount].isComplete)
 		{
-			newPoolSize = AlignUp(sizeBytes, DEFAULT_POOL_SIZE);
+			m_ringTail = m_ringSpans[completedSpanCount].end;
+			completedSpanCount++;
 		}
+		m_ringSpans.erase(m_ringSpans.begin(), m_ringSpans.begin() + completedSpanCount);
 
-		const VmaAllocationCreateFlags poolFlags = VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
-		const VkBufferUsageFlags poolUsage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+		// Start over at the beginning of the ring once it's empty, so the next frame doesn't have to wrap around
+		if (m_ringSpans.empty())
+		{
+			m_ringHead = 0;
+			m_ringTail = 0;
+		}
 
-		std::string poolName = "StagingBufferPool_" + std::to_string(m_poolBuffers.size());
-		BufferData newPool = CreateBuffer(m_renderDevice, poolName.c_str(), newPoolSize, poolUsage, poolFlags, 0, 0);
-		if (!newPool.isValid)
+		for (const SmallSlot& slot : m_frameSmallSlots[frameIndex])
 		{
-			LogError("Failed to create staging buffer pool of size %llu bytes!", newPoolSize);
-			return alloc;
+			m_freeSmallSlots[slot.sizeClass].push_back(slot);
 		}
+		m_frameSmallSlots[frameIndex].clear();
 
-		LogDebug("Created new staging buffer pool of size %llu bytes!", newPoolSize);
+		for (BufferData& overflowBuffer : m_frameOverflowBuffers[frameIndex])
+		{
+			DestroyStagingBuffer(overflowBuffer);
+		}
+		m_frameOverflowBuffers[frameIndex].clear();
+	}
 
-		m_poolBuffers.push_back(newPool);
-		m_poolOffsets.push_back(sizeBytes);
+	u64 StagingBufferPool::GetAllocatedBytes()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_allocatedBytes;
+	}
 
-		alloc.buffer = newPool.buffer;
-		alloc.offset = 0;
-		alloc.mappedData = newPool.allocInfo.pMappedData;
-		alloc.isValid = true;
+	u64 StagingBufferPool::GetPeakAllocatedBytes()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_peakAllocatedBytes;
+	}
 
-		return alloc;
+	bool StagingBufferPool::TryAllocateSmallSlot(u32 frameIndex, u64 sizeBytes, u64 alignment, StagingAllocation& out_alloc)
+	{
+		if (sizeBytes > MAX_SMALL_SLOT_SIZE || (MIN_SMALL_SLOT_SIZE % alignment) != 0)
+		{
+			return false;
+		}
+
+		const u32 sizeClass = GetSmallSizeClass(sizeBytes);
+		std::vector<SmallSlot>& freeSlots = m_freeSmallSlots[sizeClass];
+		if (freeSlots.empty())
+		{
+			// Carve a new slab into slots of this size class
+			const u64 slotSize = MIN_SMALL_SLOT_SIZE << sizeClass;
+			std::string slabName = "StagingBufferPool_Slab_" + std::to_string(slotSize);
+			BufferData slab = CreateStagingBuffer(slabName.c_str(), SMALL_SLAB_SIZE);
+			if (!slab.isValid)
+			{
+				return false;
+			}
+			m_smallSlabs.push_back(slab);
+
+			for (u64 offset = 0; offset + slotSize <= SMALL_SLAB_SIZE; offset += slotSize)
+			{
+				freeSlots.push_back({ slab.buffer, static_cast<u8*>(slab.allocInfo.pMappedData), offset, sizeClass });
+			}
+		}
+
+		const SmallSlot slot = freeSlots.back();
+		freeSlots.pop_back();
+		m_frameSmallSlots[frameIndex].push_back(slot);
+
+		out_alloc.buffer = slot.buffer;
+		out_alloc.offset = slot.offset;
+		out_alloc.mappedData = slot.pSlabData + slot.offset;
+		out_alloc.isValid = true;
+
+		return true;
 	}
 
-	void StagingBufferPool::Reset()
+	bool StagingBufferPool::TryAllocateFromRing(u32 frameIndex, u64 sizeBytes, u64 alignment, StagingAllocation& out_alloc)
 	{
-		PROFILE_SCOPE("StagingBufferPool_Reset");
+		// Created on first use, so a device which never uploads through the ring doesn't hold on to its memory
+		if (!m_ring.isValid && m_ringSize > 0)
+		{
+			m_ring = CreateStagingBuffer("StagingBufferPool_Ring", m_ringSize);
+		}
+
+		if (!m_ring.isValid || sizeBytes > m_ring.size)
+		{
+			return false;
+		}
 
-		for (u64& offset : m_poolOffsets)
+		// Allocations which don't fit before the end of the ring buffer wrap around to its start. The skipped bytes are
+		// reclaimed along with the allocation
+		const u64 headOffset = m_ringHead % m_ring.size;
+		const u64 alignedOffset = AlignUp(headOffset, alignment);
+		u64 start = m_ringHead + (alignedOffset - headOffset);
+		if (alignedOffset + sizeBytes > m_ring.size)
 		{
-			offset = 0;
+			start = m_ringHead + (m_ring.size - headOffset);
 		}
+
+		const u64 end = start + sizeBytes;
+		if (end - m_ringTail > m_ring.size)
+		{
+			return false;
+		}
+
+		if (!m_ringSpans.empty() && m_ringSpans.back().frameIndex == frameIndex && !m_ringSpans.back().isComplete)
+		{
+			m_ringSpans.back().end = end;
+		}
+		else
+		{
+			m_ringSpans.push_back({ end, frameIndex, false });
+		}
+		m_ringHead = end;
+
+		const u64 offset = start % m_ring.size;
+		out_alloc.buffer = m_ring.buffer;
+		out_alloc.offset = offset;
+		out_alloc.mappedData = static_cast<u8*>(m_ring.allocInfo.pMappedData) + offset;
+		out_alloc.isValid = true;
+
+		return true;
 	}
 
 	void StagingBufferPool::Destroy()
@@ -120,11 +254,66 @@ namespace PHX
 			return;
 		}
 
-		for (BufferData& pool : m_poolBuffers)
+		DestroyStagingBuffer(m_ring);
+		m_ringHead = 0;
+		m_ringTail = 0;
+		m_ringSpans.clear();
+
+		for (BufferData& slab : m_smallSlabs)
 		{
-			DestroyBuffer(m_renderDevice, pool);
+			DestroyStagingBuffer(slab);
 		}
-		m_poolBuffers.clear();
-		m_poolOffsets.clear();
+		m_smallSlabs.clear();
+
+		for (std::vector<SmallSlot>& freeSlots : m_freeSmallSlots)
+		{
+			freeSlots.clear();
+		}
+
+		for (std::vector<SmallSlot>& frameSlots : m_frameSmallSlots)
+		{
+			frameSlots.clear();
+		}
+
+		for (std::vector<BufferData>& overflowBuffers : m_frameOverflowBuffers)
+		{
+			for (BufferData& overflowBuffer : overflowBuffers)
+			{
+				DestroyStagingBuffer(overflowBuffer);
+			}
+			overflowBuffers.clear();
+		}
+	}
+
+	BufferData StagingBufferPool::CreateStagingBuffer(const char* name, u64 sizeBytes)
+	{
+		const VmaAllocationCreateFlags stagingFlags = VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+		const VkBufferUsageFlags stagingUsage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+
+		BufferData newBuffer = CreateBuffer(m_renderDevice, name, sizeBytes, stagingUsage, stagingFlags, 0, 0);
+		if (!newBuffer.isValid)
+		{
+			LogError("Failed to create staging buffer of size %llu bytes!", sizeBytes);
+			return newBuffer;
+		}
+
+		m_allocatedBytes += newBuffer.size;
+		m_peakAllocatedBytes = Max(m_peakAllocatedBytes, m_allocatedBytes);
+
+		LogDebug("Created new staging buffer of size %llu bytes!", sizeBytes);
+
+		return newBuffer;
+	}
+
+	void StagingBufferPool::DestroyStagingBuffer(BufferData& buffer)
+	{
+		if (!buffer.isValid)
+		{
+			return;
+		}
+
+		m_allocatedBytes -= buffer.size;
+		DestroyBuffer(m_renderDevice, buffer);
+		buffer = {};
 	}
-}
\ No newline at end of file
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <mutex>
+#include <vector>
+
 #include "BSL/integral_types.h"
 
 #include "../render_device_vk.h"
@@ -15,33 +18,85 @@ namespace PHX
 		bool isValid 		= false;
 	};
 
-	// Staging buffer pool that sub-allocates from a small number of large VMA allocations.
-	// This avoids creating thousands of individual staging buffers,
-	// which can overwhelm the driver and cause VK_ERROR_DEVICE_LOST
+	// Staging memory for uploads, shared by the device contexts of every frame in flight. Allocations are sub-allocated from a
+	// ring buffer, whose capacity is set with RenderDeviceCreateInfo::stagingRingSize. Every allocation is tagged with the
+	// frame index it's recorded in, and the ring reclaims a frame's memory once the device context with that frame index has
+	// waited on its fence. Memory is reclaimed in allocation order, so the ring never hands out memory past the oldest frame
+	// the GPU may still be copying from.
+	// Small allocations are served from fixed size slots of power of two size classes instead, so frequent small uploads
+	// neither fragment the ring nor take up its space. Slots are reclaimed the same way, back onto per-class free lists.
+	// Allocations which don't fit in the free part of the ring get a buffer of their own, which is destroyed as soon as their
+	// frame completes, so a burst of uploads (a scene loaded at startup, for example) doesn't keep the pool at its peak size.
+	// All functions are thread safe, since worker device contexts record uploads into the same pool
 	class StagingBufferPool
 	{
 	public:
 
-		explicit StagingBufferPool(RenderDeviceVk* pRenderDevice);
+		StagingBufferPool(RenderDeviceVk* pRenderDevice, u32 framesInFlight, u64 ringSize);
 		~StagingBufferPool();
 
 		StagingBufferPool(const StagingBufferPool& other) = delete;
 		StagingBufferPool& operator=(const StagingBufferPool& other) = delete;
 
-		// Sub-allocate from the pool. Alignment is applied to the offset.
-		// If the current pool buffer is too small, a new one is allocated
-		StagingAllocation Allocate(u64 sizeBytes, u64 alignment = 16);
+		// Sub-allocate staging memory for an upload recorded in the frame with the given index. Alignment is applied to the offset
+		StagingAllocation Allocate(u32 frameIndex, u64 sizeBytes, u64 alignment = 16);
 
-		// Reset the offset to reuse pool memory
-		void Reset();
+		// Must only be called once the GPU is done with the frame that last used the given index. Reclaims every allocation
+		// made in that frame
+		void CompleteFrame(u32 frameIndex);
 
-		// Free all pool buffers
-		void Destroy();
+		// Staging memory held by the pool in bytes. The peak is the highest it has been over the pool's lifetime
+		u64 GetAllocatedBytes();
+		u64 GetPeakAllocatedBytes();
 
 	private:
 
+		// Part of the ring used by a single frame. Positions only ever grow while the ring is in use, the offset into the
+		// ring buffer is the position modulo the ring size
+		struct RingSpan
+		{
+			u64 end 		= 0;
+			u32 frameIndex 	= 0;
+			bool isComplete = false; // Frame completed, but an older span is still in use
+		};
+
+		struct SmallSlot
+		{
+			VkBuffer buffer = VK_NULL_HANDLE;
+			u8* pSlabData 	= nullptr; // Mapped memory of the slab the slot is in
+			u64 offset 		= 0;
+			u32 sizeClass 	= 0;
+		};
+
+		// Require m_mutex to be locked. Return false without changing anything if the allocation can't be served
+		bool TryAllocateSmallSlot(u32 frameIndex, u64 sizeBytes, u64 alignment, StagingAllocation& out_alloc);
+		bool TryAllocateFromRing(u32 frameIndex, u64 sizeBytes, u64 alignment, StagingAllocation& out_alloc);
+
+		BufferData CreateStagingBuffer(const char* name, u64 sizeBytes);
+		void DestroyStagingBuffer(BufferData& buffer);
+
+		// Free all pool buffers
+		void Destroy();
+
 		RenderDeviceVk* m_renderDevice;
-		std::vector<BufferData> m_poolBuffers;
-		std::vector<u64> m_poolOffsets;
+		u64 m_ringSize;
+
+		// Ring buffer, created on first use
+		BufferData m_ring;
+		u64 m_ringHead; // Position the next allocation starts at
+		u64 m_ringTail; // Position of the oldest allocation the GPU may still be copying from
+		std::vector<RingSpan> m_ringSpans; // In allocation order
+
+		// Slabs small slots are carved from, free slots per size class, and slots in use per frame index
+		std::vector<BufferData> m_smallSlabs;
+		std::vector<std::vector<SmallSlot>> m_freeSmallSlots;
+		std::vector<std::vector<SmallSlot>> m_frameSmallSlots;
+
+		// Buffers of allocations which didn't fit in the ring, per frame index
+		std::vector<std::vector<BufferData>> m_frameOverflowBuffers;
+
+		u64 m_allocatedBytes;
+		u64 m_peakAllocatedBytes;
+		std::mutex m_mutex;
 	};
-}
\ No newline at end of file
+}
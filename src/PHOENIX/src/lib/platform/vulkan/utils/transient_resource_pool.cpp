@@ -0,0 +1,625 @@
+#include <algorithm>
+#include <vulkan/vk_enum_string_helper.h>
+
+#include "transient_resource_pool.h"
+
+#include "BSL/crc32.h"
+#include "BSL/logger.h"
+#include "BSL/math.h"
+#include "core/handle/handle_accessor.h"
+#include "core/profiling.h"
+#include "../buffer_vk.h"
+#include "../render_device_vk.h"
+#include "../texture_vk.h"
+#include "utils/cache_utils.h"
+
+using namespace BSL;
+
+namespace PHX
+{
+	static u64 HashTextureDescription(const TextureBaseCreateInfo& baseCreateInfo, const TextureViewCreateInfo& viewCreateInfo, const TextureSamplerCreateInfo& samplerCreateInfo)
+	{
+		size_t seed = 0;
+		HashCombine(seed, RESOURCE_TYPE::TEXTURE);
+		HashCombine(seed, static_cast<u32>(HashCRC32(baseCreateInfo.pName)));
+		HashCombine(seed, baseCreateInfo.width);
+		HashCombine(seed, baseCreateInfo.height);
+		HashCombine(seed, baseCreateInfo.format);
+		HashCombine(seed, baseCreateInfo.arrayLayers);
+		HashCombine(seed, baseCreateInfo.mipLevels);
+		HashCombine(seed, baseCreateInfo.usageFlags);
+		HashCombine(seed, baseCreateInfo.sampleFlags);
+		HashCombine(seed, viewCreateInfo.type);
+		HashCombine(seed, viewCreateInfo.scope);
+		HashCombine(seed, viewCreateInfo.aspectFlags);
+		HashCombine(seed, samplerCreateInfo.minificationFilter);
+		HashCombine(seed, samplerCreateInfo.magnificationFilter);
+		HashCombine(seed, samplerCreateInfo.addressModeUVW);
+		HashCombine(seed, samplerCreateInfo.samplerMipMapFilter);
+		HashCombine(seed, samplerCreateInfo.enableAnisotropicFiltering);
+		HashCombine(seed, samplerCreateInfo.maxAnisotropy);
+
+		return static_cast<u64>(seed);
+	}
+
+	static u64 HashBufferDescription(const BufferCreateInfo& createInfo)
+	{
+		size_t seed = 0;
+		HashCombine(seed, RESOURCE_TYPE::BUFFER);
+		HashCombine(seed, static_cast<u32>(HashCRC32(createInfo.pName)));
+		HashCombine(seed, createInfo.sizeBytes);
+		HashCombine(seed, createInfo.bufferUsage);
+
+		return static_cast<u64>(seed);
+	}
+
+	// Images with the transient attachment usage may only be used as attachments
+	static bool CanUseTransientAttachment(const TextureBaseCreateInfo& baseCreateInfo)
+	{
+		const UsageTypeFlags attachmentUsageFlags = USAGE_TYPE_FLAG_COLOR_ATTACHMENT | USAGE_TYPE_FLAG_DEPTH_STENCIL_ATTACHMENT | USAGE_TYPE_FLAG_INPUT_ATTACHMENT | USAGE_TYPE_FLAG_TRANSIENT_ATTACHMENT;
+		return (baseCreateInfo.usageFlags & ~attachmentUsageFlags) == 0;
+	}
+
+	static bool RangesOverlap(u64 beginA, u64 endA, u64 beginB, u64 endB)
+	{
+		// Ranges are [begin, end)
+		return (beginA < endB) && (beginB < endA);
+	}
+
+	TransientResourcePool::TransientResourcePool(RenderDeviceVk* pRenderDevice) :
+		m_pRenderDevice(nullptr), m_frameNumber(0), m_slots(), m_heaps(), m_slotIndices(), m_slotsByDesc(), m_claimedCounts()
+	{
+		if (pRenderDevice == nullptr)
+		{
+			LogError("Failed to create transient resource pool. Render device is null!");
+			return;
+		}
+		m_pRenderDevice = pRenderDevice;
+	}
+
+	TransientResourcePool::~TransientResourcePool()
+	{
+		// Destroy the resources before the memory they're bound to
+		for (TransientSlot*& pSlot : m_slots)
+		{
+			SAFE_DEL(pSlot);
+		}
+		m_slots.clear();
+		m_slotIndices.clear();
+		m_slotsByDesc.clear();
+
+		if (m_pRenderDevice != nullptr)
+		{
+			for (TransientHeap& heap : m_heaps)
+			{
+				vmaFreeMemory(m_pRenderDevice->GetAllocator(), heap.alloc);
+			}
+		}
+		m_heaps.clear();
+	}
+
+	void TransientResourcePool::BeginFrame(u32 frameNumber)
+	{
+		PROFILE_SCOPE("TransientResourcePool_BeginFrame");
+
+		m_frameNumber = frameNumber;
+		m_claimedCounts.clear();
+
+		// The device context waits for the frame that last used this frame-in-flight slot before the
+		// frame begins, so resources that were last acquired at least that many frames ago are no longer in use
+		const u32 framesInFlight = m_pRenderDevice->GetFramesInFlight();
+		bool releasedAnySlot = false;
+		for (u32 i = 0; i < static_cast<u32>(m_slots.size()); i++)
+		{
+			if (m_slots[i]->lastAcquiredFrame + framesInFlight < frameNumber)
+			{
+				ReleaseSlot(i);
+				releasedAnySlot = true;
+			}
+		}
+
+		if (releasedAnySlot)
+		{
+			RebuildLookups();
+		}
+	}
+
+	STATUS_CODE TransientResourcePool::AcquireTexture(const TextureBaseCreateInfo& baseCreateInfo, const TextureViewCreateInfo& viewCreateInfo, const TextureSamplerCreateInfo& samplerCreateInfo, TextureHandle& handle)
+	{
+		PROFILE_SCOPE("TransientResourcePool_AcquireTexture");
+
+		const u64 descHash = HashTextureDescription(baseCreateInfo, viewCreateInfo, samplerCreateInfo);
+		TransientSlot* pSlot = ClaimSlot(descHash);
+		if (pSlot == nullptr)
+		{
+			// First time this texture is requested. It gets its own memory until it's placed, since the lifetimes
+			// of the transient resources are only known once the render graph is baked
+			TextureHandle newTexture;
+			STATUS_CODE res = m_pRenderDevice->AllocateTexture(baseCreateInfo, viewCreateInfo, samplerCreateInfo, newTexture);
+			if (res != STATUS_CODE::SUCCESS)
+			{
+				LogError("Failed to acquire transient texture \"%s\". Texture allocation failed!", baseCreateInfo.pName);
+				return res;
+			}
+
+			const TextureVk* pTexture = static_cast<TextureVk*>(m_pRenderDevice->ResolveHandle(newTexture));
+			ASSERT_PTR(pTexture);
+
+			pSlot = new TransientSlot();
+			pSlot->type = RESOURCE_TYPE::TEXTURE;
+			pSlot->descHash = descHash;
+			pSlot->handle = newTexture;
+			pSlot->textureBaseCreateInfo = baseCreateInfo;
+			pSlot->textureViewCreateInfo = viewCreateInfo;
+			pSlot->textureSamplerCreateInfo = samplerCreateInfo;
+			vkGetImageMemoryRequirements(m_pRenderDevice->GetLogicalDevice(), pTexture->GetBaseImage(), &pSlot->memRequirements);
+
+			m_slots.push_back(pSlot);
+			RebuildLookups();
+			m_claimedCounts[descHash]++;
+		}
+
+		pSlot->lastAcquiredFrame = m_frameNumber;
+
+		// The contents of transient textures never carry over from a previous frame, so there's
+		// no need to preserve them when they're first transitioned
+		TextureVk* pTexture = static_cast<TextureVk*>(m_pRenderDevice->ResolveHandle(pSlot->handle));
+		ASSERT_PTR(pTexture);
+		pTexture->SetLayout(VK_IMAGE_LAYOUT_UNDEFINED);
+
+		handle = static_cast<TextureHandle>(pSlot->handle);
+		return STATUS_CODE::SUCCESS;
+	}
+
+	STATUS_CODE TransientResourcePool::AcquireBuffer(const BufferCreateInfo& createInfo, BufferHandle& handle)
+	{
+		PROFILE_SCOPE("TransientResourcePool_AcquireBuffer");
+
+		// Transient resources are placed in device-local memory, which can't be mapped
+		if (ShouldUseDirectMemoryMapping(createInfo.bufferUsage))
+		{
+			LogError("Failed to acquire transient buffer \"%s\". Uniform buffers can't be transient!", createInfo.pName);
+			return STATUS_CODE::ERR_API;
+		}
+
+		const u64 descHash = HashBufferDescription(createInfo);
+		TransientSlot* pSlot = ClaimSlot(descHash);
+		if (pSlot == nullptr)
+		{
+			// First time this buffer is requested. See AcquireTexture()
+			BufferHandle newBuffer;
+			STATUS_CODE res = m_pRenderDevice->AllocateBuffer(createInfo, newBuffer);
+			if (res != STATUS_CODE::SUCCESS)
+			{
+				LogError("Failed to acquire transient buffer \"%s\". Buffer allocation failed!", createInfo.pName);
+				return res;
+			}
+
+			const BufferVk* pBuffer = static_cast<BufferVk*>(m_pRenderDevice->ResolveHandle(newBuffer));
+			ASSERT_PTR(pBuffer);
+
+			pSlot = new TransientSlot();
+			pSlot->type = RESOURCE_TYPE::BUFFER;
+			pSlot->descHash = descHash;
+			pSlot->handle = newBuffer;
+			pSlot->bufferCreateInfo = createInfo;
+			vkGetBufferMemoryRequirements(m_pRenderDevice->GetLogicalDevice(), pBuffer->GetBuffer(), &pSlot->memRequirements);
+
+			m_slots.push_back(pSlot);
+			RebuildLookups();
+			m_claimedCounts[descHash]++;
+		}
+
+		pSlot->lastAcquiredFrame = m_frameNumber;
+
+		handle = static_cast<BufferHandle>(pSlot->handle);
+		return STATUS_CODE::SUCCESS;
+	}
+
+	bool TransientResourcePool::IsTransient(const Handle& handle) const
+	{
+		return (m_slotIndices.find(MakeHandleKey(handle)) != m_slotIndices.end());
+	}
+
+	bool TransientResourcePool::IsAliased(const Handle& handle) const
+	{
+		auto slotIter = m_slotIndices.find(MakeHandleKey(handle));
+		if (slotIter == m_slotIndices.end())
+		{
+			return false;
+		}
+		return m_slots[slotIter->second]->isAliased;
+	}
+
+	STATUS_CODE TransientResourcePool::UpdatePlacement(const std::vector<TransientLifetime>& lifetimes, bool& out_recreated)
+	{
+		PROFILE_SCOPE("TransientResourcePool_UpdatePlacement");
+
+		out_recreated = false;
+
+		for (TransientSlot* pSlot : m_slots)
+		{
+			pSlot->isUsed = false;
+		}
+
+		for (const TransientLifetime& lifetime : lifetimes)
+		{
+			auto slotIter = m_slotIndices.find(MakeHandleKey(lifetime.handle));
+			if (slotIter == m_slotIndices.end())
+			{
+				LogWarning("Skipped placing transient resource. Handle does not refer to a transient resource!");
+				continue;
+			}
+
+			TransientSlot& slot = *m_slots[slotIter->second];
+			slot.isUsed = true;
+			slot.firstUse = lifetime.firstUse;
+			slot.lastUse = lifetime.lastUse;
+			slot.wantsLazyAllocation = lifetime.isAttachmentOnly && (slot.type == RESOURCE_TYPE::TEXTURE) && CanUseTransientAttachment(slot.textureBaseCreateInfo);
+		}
+
+		if (IsPlacementValid())
+		{
+			return STATUS_CODE::SUCCESS;
+		}
+
+		STATUS_CODE res = RecreateResources();
+		if (res == STATUS_CODE::SUCCESS)
+		{
+			out_recreated = true;
+		}
+		return res;
+	}
+
+	u64 TransientResourcePool::GetAllocatedBytes() const
+	{
+		u64 allocatedBytes = 0;
+		for (const TransientHeap& heap : m_heaps)
+		{
+			allocatedBytes += heap.memRequirements.size;
+		}
+		return allocatedBytes;
+	}
+
+	u64 TransientResourcePool::GetUnaliasedBytes() const
+	{
+		u64 unaliasedBytes = 0;
+		for (const TransientSlot* pSlot : m_slots)
+		{
+			if (pSlot->heapIndex != U32_MAX)
+			{
+				unaliasedBytes += pSlot->memRequirements.size;
+			}
+		}
+		return unaliasedBytes;
+	}
+
+	TransientResourcePool::TransientSlot* TransientResourcePool::ClaimSlot(u64 descHash)
+	{
+		auto slotsIter = m_slotsByDesc.find(descHash);
+		if (slotsIter == m_slotsByDesc.end())
+		{
+			return nullptr;
+		}
+
+		u32& claimedCount = m_claimedCounts[descHash];
+		if (claimedCount >= static_cast<u32>(slotsIter->second.size()))
+		{
+			return nullptr;
+		}
+
+		const u32 slotIndex = slotsIter->second[claimedCount];
+		claimedCount++;
+		return m_slots[slotIndex];
+	}
+
+	bool TransientResourcePool::IsPlacementValid() const
+	{
+		for (u32 i = 0; i < static_cast<u32>(m_slots.size()); i++)
+		{
+			const TransientSlot& slotA = *m_slots[i];
+			if (!slotA.isUsed)
+			{
+				continue;
+			}
+
+			if (slotA.isLazilyAllocated != slotA.wantsLazyAllocation)
+			{
+				return false;
+			}
+
+			if (slotA.isLazilyAllocated)
+			{
+				// Lazily allocated slots don't share memory with anything
+				continue;
+			}
+
+			if (slotA.heapIndex == U32_MAX)
+			{
+				return false;
+			}
+
+			// Only resources used in the current frame matter. Unused ones may overlap anything, and previous
+			// frames are guarded by the aliasing barrier inserted before the first use of a resource
+			for (u32 j = i + 1; j < static_cast<u32>(m_slots.size()); j++)
+			{
+				const TransientSlot& slotB = *m_slots[j];
+				if (!slotB.isUsed || slotB.heapIndex != slotA.heapIndex)
+				{
+					continue;
+				}
+
+				const bool memoryOverlaps = RangesOverlap(slotA.heapOffset, slotA.heapOffset + slotA.memRequirements.size, slotB.heapOffset, slotB.heapOffset + slotB.memRequirements.size);
+				const bool lifetimeOverlaps = RangesOverlap(slotA.firstUse, slotA.lastUse + 1, slotB.firstUse, slotB.lastUse + 1);
+				if (memoryOverlaps && lifetimeOverlaps)
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	STATUS_CODE TransientResourcePool::RecreateResources()
+	{
+		PROFILE_SCOPE("TransientResourcePool_RecreateResources");
+
+		// Resources are about to be destroyed and re-created, so nothing can be in flight
+		m_pRenderDevice->WaitIdle();
+
+		// Release the resources which aren't used this frame instead of finding space for them
+		bool releasedAnySlot = false;
+		for (u32 i = 0; i < static_cast<u32>(m_slots.size()); i++)
+		{
+			if (!m_slots[i]->isUsed)
+			{
+				ReleaseSlot(i);
+				releasedAnySlot = true;
+			}
+		}
+
+		if (releasedAnySlot)
+		{
+			RebuildLookups();
+		}
+
+		// Group slots into heaps. Textures and buffers never share a heap, which sidesteps the buffer-image granularity
+		// requirements between linear and optimal resources. Slots only share a heap if they have a memory type in common
+		struct HeapGroup
+		{
+			RESOURCE_TYPE type;
+			u32 memoryTypeBits;
+			std::vector<u32> slotIndices;
+		};
+
+		std::vector<HeapGroup> heapGroups;
+		for (u32 i = 0; i < static_cast<u32>(m_slots.size()); i++)
+		{
+			const TransientSlot& slot = *m_slots[i];
+			if (slot.wantsLazyAllocation)
+			{
+				continue;
+			}
+
+			HeapGroup* pGroup = nullptr;
+			for (HeapGroup& group : heapGroups)
+			{
+				if (group.type == slot.type && (group.memoryTypeBits & slot.memRequirements.memoryTypeBits) != 0)
+				{
+					pGroup = &group;
+					break;
+				}
+			}
+
+			if (pGroup == nullptr)
+			{
+				heapGroups.push_back({ slot.type, slot.memRequirements.memoryTypeBits, {} });
+				pGroup = &heapGroups.back();
+			}
+
+			pGroup->memoryTypeBits &= slot.memRequirements.memoryTypeBits;
+			pGroup->slotIndices.push_back(i);
+		}
+
+		// Allocate all new heaps before touching any resources, so a failed allocation leaves the current placement intact
+		std::vector<TransientHeap> newHeaps;
+		std::vector<std::pair<u32, VkDeviceSize>> newPlacements(m_slots.size(), { U32_MAX, 0 });
+		for (const HeapGroup& group : heapGroups)
+		{
+			const VkDeviceSize heapSize = PlaceSlots(group.slotIndices);
+
+			TransientHeap newHeap{};
+			newHeap.type = group.type;
+			newHeap.memRequirements.size = heapSize;
+			newHeap.memRequirements.alignment = 1;
+			newHeap.memRequirements.memoryTypeBits = group.memoryTypeBits;
+			for (u32 slotIndex : group.slotIndices)
+			{
+				newHeap.memRequirements.alignment = Max(newHeap.memRequirements.alignment, m_slots[slotIndex]->memRequirements.alignment);
+				newPlacements[slotIndex] = { static_cast<u32>(newHeaps.size()), m_slots[slotIndex]->heapOffset };
+			}
+
+			VmaAllocationCreateInfo allocCreateInfo{};
+			allocCreateInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+			allocCreateInfo.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+			allocCreateInfo.priority = 1.0f;
+
+			VkResult vkRes = vmaAllocateMemory(m_pRenderDevice->GetAllocator(), &newHeap.memRequirements, &allocCreateInfo, &newHeap.alloc, nullptr);
+			if (vkRes != VK_SUCCESS)
+			{
+				LogError("Failed to place transient resources. Could not allocate %llu bytes! Got error: \"%s\"", heapSize, string_VkResult(vkRes));
+				for (TransientHeap& heap : newHeaps)
+				{
+					vmaFreeMemory(m_pRenderDevice->GetAllocator(), heap.alloc);
+				}
+				return STATUS_CODE::ERR_INTERNAL;
+			}
+
+			newHeaps.push_back(newHeap);
+		}
+
+		// Re-create every resource in its new place. The handles stay the same
+		STATUS_CODE res = STATUS_CODE::SUCCESS;
+		for (u32 i = 0; i < static_cast<u32>(m_slots.size()); i++)
+		{
+			TransientSlot& slot = *m_slots[i];
+			slot.heapIndex = newPlacements[i].first;
+			slot.heapOffset = newPlacements[i].second;
+			slot.isLazilyAllocated = slot.wantsLazyAllocation;
+
+			if (slot.isLazilyAllocated)
+			{
+				// Gets its own memory, which is only backed by physical memory if the attachment is spilled out of tile memory
+				TextureBaseCreateInfo lazyBaseCreateInfo = slot.textureBaseCreateInfo;
+				lazyBaseCreateInfo.usageFlags |= USAGE_TYPE_FLAG_TRANSIENT_ATTACHMENT;
+				res = m_pRenderDevice->ReallocateAliasedTexture(lazyBaseCreateInfo, slot.textureViewCreateInfo, slot.textureSamplerCreateInfo, nullptr, 0, static_cast<TextureHandle>(slot.handle));
+				if (res != STATUS_CODE::SUCCESS)
+				{
+					LogError("Failed to place transient resource. Resource could not be re-created!");
+				}
+				continue;
+			}
+
+			VmaAllocation heapAlloc = newHeaps[slot.heapIndex].alloc;
+			switch (slot.type)
+			{
+			case RESOURCE_TYPE::TEXTURE:
+			{
+				res = m_pRenderDevice->ReallocateAliasedTexture(slot.textureBaseCreateInfo, slot.textureViewCreateInfo, slot.textureSamplerCreateInfo, heapAlloc, slot.heapOffset, static_cast<TextureHandle>(slot.handle));
+				break;
+			}
+			case RESOURCE_TYPE::BUFFER:
+			{
+				res = m_pRenderDevice->ReallocateAliasedBuffer(slot.bufferCreateInfo, heapAlloc, slot.heapOffset, static_cast<BufferHandle>(slot.handle));
+				break;
+			}
+			default:
+			{
+				ASSERT_ALWAYS("Failed to place transient resource. Unsupported resource type!");
+				break;
+			}
+			}
+
+			if (res != STATUS_CODE::SUCCESS)
+			{
+				LogError("Failed to place transient resource. Resource could not be re-created!");
+			}
+		}
+
+		// Resources bound to the old heaps have all been destroyed by now
+		for (TransientHeap& heap : m_heaps)
+		{
+			vmaFreeMemory(m_pRenderDevice->GetAllocator(), heap.alloc);
+		}
+		m_heaps = newHeaps;
+
+		// Slots which share memory with any other slot must be synchronized before their first use
+		for (TransientSlot* pSlotA : m_slots)
+		{
+			pSlotA->isAliased = false;
+			if (pSlotA->heapIndex == U32_MAX)
+			{
+				continue;
+			}
+
+			for (const TransientSlot* pSlotB : m_slots)
+			{
+				if (pSlotA == pSlotB || pSlotA->heapIndex != pSlotB->heapIndex)
+				{
+					continue;
+				}
+
+				if (RangesOverlap(pSlotA->heapOffset, pSlotA->heapOffset + pSlotA->memRequirements.size, pSlotB->heapOffset, pSlotB->heapOffset + pSlotB->memRequirements.size))
+				{
+					pSlotA->isAliased = true;
+					break;
+				}
+			}
+		}
+
+		LogInfo("Placed %u transient resources in %llu bytes (%llu bytes without aliasing)", static_cast<u32>(m_slots.size()), GetAllocatedBytes(), GetUnaliasedBytes());
+
+		return res;
+	}
+
+	VkDeviceSize TransientResourcePool::PlaceSlots(const std::vector<u32>& slotIndices)
+	{
+		// Place the largest resources first, each at the lowest offset that doesn't overlap the memory of any
+		// already placed resource whose lifetime overlaps
+		std::vector<u32> sortedSlotIndices = slotIndices;
+		std::sort(sortedSlotIndices.begin(), sortedSlotIndices.end(), [&](u32 a, u32 b)
+		{
+			return m_slots[a]->memRequirements.size > m_slots[b]->memRequirements.size;
+		});
+
+		VkDeviceSize heapSize = 0;
+		std::vector<u32> placedSlotIndices;
+		placedSlotIndices.reserve(sortedSlotIndices.size());
+		for (u32 slotIndex : sortedSlotIndices)
+		{
+			TransientSlot& slot = *m_slots[slotIndex];
+			const VkDeviceSize size = slot.memRequirements.size;
+
+			VkDeviceSize offset = 0;
+			bool hasConflict = true;
+			while (hasConflict)
+			{
+				hasConflict = false;
+				for (u32 placedSlotIndex : placedSlotIndices)
+				{
+					const TransientSlot& placedSlot = *m_slots[placedSlotIndex];
+					const bool lifetimeOverlaps = RangesOverlap(slot.firstUse, slot.lastUse + 1, placedSlot.firstUse, placedSlot.lastUse + 1);
+					const bool memoryOverlaps = RangesOverlap(offset, offset + size, placedSlot.heapOffset, placedSlot.heapOffset + placedSlot.memRequirements.size);
+					if (lifetimeOverlaps && memoryOverlaps)
+					{
+						// Move past the conflicting resource and check again
+						offset = AlignUp(placedSlot.heapOffset + placedSlot.memRequirements.size, slot.memRequirements.alignment);
+						hasConflict = true;
+					}
+				}
+			}
+
+			slot.heapOffset = offset;
+			placedSlotIndices.push_back(slotIndex);
+			heapSize = Max(heapSize, offset + size);
+		}
+
+		return heapSize;
+	}
+
+	void TransientResourcePool::ReleaseSlot(u32 slotIndex)
+	{
+		TransientSlot*& pSlot = m_slots[slotIndex];
+		if (pSlot->type == RESOURCE_TYPE::TEXTURE)
+		{
+			const TextureVk* pTexture = static_cast<TextureVk*>(m_pRenderDevice->ResolveHandle(pSlot->handle));
+			if (pTexture != nullptr)
+			{
+				m_pRenderDevice->InvalidateFramebuffers(pTexture);
+			}
+		}
+
+		// Deleting the slot releases the pool's reference to the resource
+		SAFE_DEL(pSlot);
+	}
+
+	void TransientResourcePool::RebuildLookups()
+	{
+		m_slots.erase(std::remove(m_slots.begin(), m_slots.end(), nullptr), m_slots.end());
+
+		m_slotIndices.clear();
+		m_slotsByDesc.clear();
+		for (u32 i = 0; i < static_cast<u32>(m_slots.size()); i++)
+		{
+			const TransientSlot* pSlot = m_slots[i];
+			m_slotIndices[MakeHandleKey(pSlot->handle)] = i;
+			m_slotsByDesc[pSlot->descHash].push_back(i);
+		}
+	}
+
+	u64 TransientResourcePool::MakeHandleKey(const Handle& handle)
+	{
+		return (static_cast<u64>(handle.GetType()) << 32) | static_cast<u64>(handle.GetIndex());
+	}
+}
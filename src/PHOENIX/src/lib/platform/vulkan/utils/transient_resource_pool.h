@@ -0,0 +1,137 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include <vma/vk_mem_alloc.h>
+#include <vulkan/vulkan.h>
+
+#include "BSL/integral_types.h"
+#include "PHX/interface/buffer.h"
+#include "PHX/interface/texture.h"
+#include "PHX/types/status_code.h"
+#include "utils/render_graph_utils.h"
+
+namespace PHX
+{
+	// Forward declarations
+	class RenderDeviceVk;
+
+	// Range of positions in the render graph's execution order during which a transient resource is used
+	struct TransientLifetime
+	{
+		Handle handle;
+		u32 firstUse          = 0;
+		u32 lastUse           = 0;
+		bool isAttachmentOnly = false; // Only used as an attachment within a single render pass, so it never has to be stored to memory
+	};
+
+	// Owns the transient resources of a render graph. Transient resources are created from a description every frame,
+	// and slots are matched against the descriptions requested in previous frames so an unchanged render graph gets the
+	// same handles every frame. Once the lifetimes of the resources are known, resources whose lifetimes don't overlap
+	// are placed in the same memory.
+	// NOTE - The contents of transient resources are undefined at the start of every frame
+	class TransientResourcePool
+	{
+	public:
+
+		explicit TransientResourcePool(RenderDeviceVk* pRenderDevice);
+		~TransientResourcePool();
+
+		TransientResourcePool(const TransientResourcePool& other) = delete;
+		TransientResourcePool& operator=(const TransientResourcePool& other) = delete;
+
+		// Releases resources which haven't been acquired for more frames than there are frames in flight. Must be called
+		// at the start of a frame, once the GPU is done with that frame's previous work
+		void BeginFrame(u32 frameNumber);
+
+		STATUS_CODE AcquireTexture(const TextureBaseCreateInfo& baseCreateInfo, const TextureViewCreateInfo& viewCreateInfo, const TextureSamplerCreateInfo& samplerCreateInfo, TextureHandle& handle);
+		STATUS_CODE AcquireBuffer(const BufferCreateInfo& createInfo, BufferHandle& handle);
+
+		// Returns true if the handle refers to a resource owned by this pool
+		bool IsTransient(const Handle& handle) const;
+
+		// Returns true if the handle refers to a transient resource which shares memory with other transient resources. The
+		// memory must then be synchronized against the previous user before the resource is first used in a frame
+		bool IsAliased(const Handle& handle) const;
+
+		// Makes sure all resources used in the current frame are placed in memory that isn't used by any other resource
+		// during their lifetime. Attachment-only textures are given lazily allocated memory instead, if their usage allows
+		// it. The current placement is kept if it's still valid for the given lifetimes, otherwise all resources are
+		// re-created in new memory. out_recreated is set to true in the latter case
+		STATUS_CODE UpdatePlacement(const std::vector<TransientLifetime>& lifetimes, bool& out_recreated);
+
+		// Total size of the memory transient resources are placed in. This is the peak amount of memory required by
+		// the transient resources at any point in the frame
+		u64 GetAllocatedBytes() const;
+
+		// Total size of the placed transient resources if none of them were aliased
+		u64 GetUnaliasedBytes() const;
+
+	private:
+
+		struct TransientSlot
+		{
+			RESOURCE_TYPE type = RESOURCE_TYPE::TEXTURE;
+			u64 descHash       = 0;
+			Handle handle;
+
+			TextureBaseCreateInfo textureBaseCreateInfo;
+			TextureViewCreateInfo textureViewCreateInfo;
+			TextureSamplerCreateInfo textureSamplerCreateInfo;
+			BufferCreateInfo bufferCreateInfo;
+
+			VkMemoryRequirements memRequirements = {};
+			u32 lastAcquiredFrame                = 0;
+
+			// Placement. Slots which haven't been placed yet own their memory, as do lazily allocated slots
+			u32 heapIndex                        = U32_MAX;
+			VkDeviceSize heapOffset              = 0;
+			bool isAliased                       = false;
+			bool isLazilyAllocated               = false;
+
+			// Lifetime in the current frame
+			bool isUsed                          = false;
+			bool wantsLazyAllocation             = false;
+			u32 firstUse                         = 0;
+			u32 lastUse                          = 0;
+		};
+
+		struct TransientHeap
+		{
+			VmaAllocation alloc = VK_NULL_HANDLE;
+			VkMemoryRequirements memRequirements = {};
+			RESOURCE_TYPE type = RESOURCE_TYPE::TEXTURE;
+		};
+
+		// Returns the next unclaimed slot in the current frame with the given description, or nullptr if there are none
+		TransientSlot* ClaimSlot(u64 descHash);
+
+		bool IsPlacementValid() const;
+
+		// Computes a new placement for all used slots and re-creates them in newly allocated memory. Unused slots are released
+		STATUS_CODE RecreateResources();
+
+		// Assigns heap offsets to the given slots, all of which must go in the same heap. Returns the required heap size
+		VkDeviceSize PlaceSlots(const std::vector<u32>& slotIndices);
+
+		// Releases the pool's reference to the slot's resource and deletes the slot
+		void ReleaseSlot(u32 slotIndex);
+
+		// Removes all deleted slots and rebuilds the lookup tables
+		void RebuildLookups();
+
+		static u64 MakeHandleKey(const Handle& handle);
+
+	private:
+
+		RenderDeviceVk* m_pRenderDevice;
+		u32 m_frameNumber;
+
+		std::vector<TransientSlot*> m_slots; // Heap-allocated, so slots can be removed without copying handles around
+		std::vector<TransientHeap> m_heaps;
+
+		std::unordered_map<u64, u32> m_slotIndices;                   // Maps a handle's type and index to its slot
+		std::unordered_map<u64, std::vector<u32>> m_slotsByDesc;      // Maps a description hash to its slots, in creation order
+		std::unordered_map<u64, u32> m_claimedCounts;                 // Number of slots claimed per description hash in the current frame
+	};
+}
@@ -0,0 +1,140 @@
+#include <algorithm>
+
+#include "transient_uniform_ring.h"
+
+#include "BSL/logger.h"
+#include "BSL/math.h"
+#include "core/profiling.h"
+
+using namespace BSL;
+
+namespace PHX
+{
+	TransientUniformRing::TransientUniformRing(RenderDeviceVk* pRenderDevice, const char* pName, u32 framesInFlight, u64 regionSize, VkBufferUsageFlags usage, u64 alignment) :
+		m_renderDevice(nullptr), m_buffer(), m_regionSize(0), m_alignment(1), m_regionCount(0), m_regionOffsets(nullptr)
+	{
+		if (pRenderDevice == nullptr || framesInFlight == 0 || regionSize == 0 || alignment == 0)
+		{
+			LogError("Failed to create transient uniform ring. Render device is null, there are no frames in flight or the region size or alignment is 0!");
+			return;
+		}
+		m_renderDevice = pRenderDevice;
+
+		m_alignment = alignment;
+		m_regionSize = AlignUp(regionSize, m_alignment);
+
+		// Allocations are bound through 32-bit dynamic offsets, so every region has to be addressable with one
+		if (m_regionSize > U32_MAX / framesInFlight)
+		{
+			LogError("Failed to create transient uniform ring. Regions of %llu bytes for %u frames in flight exceed the 32-bit dynamic offset range!", m_regionSize, framesInFlight);
+			m_regionSize = 0;
+			return;
+		}
+
+		const VmaAllocationCreateFlags ringFlags = VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+
+		// Coherent memory so the CPU writes are visible to the frame's submissions without any explicit flushes
+		m_buffer = CreateBuffer(pRenderDevice, pName, m_regionSize * framesInFlight, usage, ringFlags, VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 0);
+		if (!m_buffer.isValid || m_buffer.allocInfo.pMappedData == nullptr)
+		{
+			LogError("Failed to create transient uniform ring of size %llu bytes!", m_regionSize * framesInFlight);
+			return;
+		}
+
+		m_regionCount = framesInFlight;
+		m_regionOffsets = std::make_unique<std::atomic<u64>[]>(framesInFlight);
+		for (u32 i = 0; i < framesInFlight; i++)
+		{
+			m_regionOffsets[i].store(0, std::memory_order_relaxed);
+		}
+	}
+
+	TransientUniformRing::~TransientUniformRing()
+	{
+		if (m_renderDevice == nullptr)
+		{
+			return;
+		}
+
+		DestroyBuffer(m_renderDevice, m_buffer);
+	}
+
+	TransientUniformRingAllocation TransientUniformRing::Allocate(u32 frameIndex, u64 sizeBytes)
+	{
+		PROFILE_SCOPE("TransientUniformRing_Allocate");
+
+		TransientUniformRingAllocation alloc{};
+
+		if (frameIndex >= m_regionCount)
+		{
+			LogError("Failed to allocate from transient uniform ring. Frame index %u is invalid (expected 0 to %u)", frameIndex, m_regionCount);
+			return alloc;
+		}
+
+		if (sizeBytes == 0)
+		{
+			LogWarning("Skipped transient uniform ring allocation. Size is 0!");
+			return alloc;
+		}
+
+		alloc = TryAllocate(frameIndex, sizeBytes);
+		if (!alloc.isValid)
+		{
+			LogError("Failed to allocate %llu bytes from transient uniform ring. Frame region of %llu bytes is full!", sizeBytes, m_regionSize);
+		}
+
+		return alloc;
+	}
+
+	TransientUniformRingAllocation TransientUniformRing::TryAllocate(u32 frameIndex, u64 sizeBytes)
+	{
+		PROFILE_SCOPE("TransientUniformRing_TryAllocate");
+
+		TransientUniformRingAllocation alloc{};
+
+		if (frameIndex >= m_regionCount || sizeBytes == 0)
+		{
+			return alloc;
+		}
+
+		// Every allocation starts on an aligned offset, so reserving aligned sizes keeps the next one aligned as well
+		const u64 alignedSize = AlignUp(sizeBytes, m_alignment);
+		// Only reserved once it is known to fit, so a failed allocation leaves the space for smaller ones that still do
+		std::atomic<u64>& regionOffsetAtomic = m_regionOffsets[frameIndex];
+		u64 regionOffset = regionOffsetAtomic.load(std::memory_order_relaxed);
+		do
+		{
+			if (regionOffset + alignedSize > m_regionSize)
+			{
+				return alloc;
+			}
+		} while (!regionOffsetAtomic.compare_exchange_weak(regionOffset, regionOffset + alignedSize, std::memory_order_relaxed));
+
+		const u64 offset = (frameIndex * m_regionSize) + regionOffset;
+		alloc.mappedData = static_cast<u8*>(m_buffer.allocInfo.pMappedData) + offset;
+		alloc.offset = static_cast<u32>(offset);
+		alloc.isValid = true;
+
+		return alloc;
+	}
+
+	void TransientUniformRing::Reset(u32 frameIndex)
+	{
+		if (frameIndex >= m_regionCount)
+		{
+			return;
+		}
+
+		m_regionOffsets[frameIndex].store(0, std::memory_order_relaxed);
+	}
+
+	VkBuffer TransientUniformRing::GetBuffer() const
+	{
+		return m_buffer.buffer;
+	}
+
+	u64 TransientUniformRing::GetRegionSize() const
+	{
+		return m_regionSize;
+	}
+}
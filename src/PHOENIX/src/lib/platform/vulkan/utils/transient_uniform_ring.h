@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include "BSL/integral_types.h"
+
+#include "../render_device_vk.h"
+#include "buffer_utils.h"
+
+namespace PHX
+{
+	struct TransientUniformRingAllocation
+	{
+		void* mappedData 	= nullptr;
+		u32 offset 			= 0;
+		bool isValid 		= false;
+	};
+
+	// Persistently mapped buffer that per-frame shader constants are written into directly, without a staging copy or a
+	// transfer pass. The buffer is split into one region per frame in flight, and each region is reset once the GPU is done
+	// with the frame it was last used for. A single buffer is used for every region so descriptors only have to point at it
+	// once, and allocations are selected through the dynamic offsets of UNIFORM_BUFFER_DYNAMIC/STORAGE_BUFFER_DYNAMIC bindings.
+	// Allocations are thread safe, so worker device contexts can allocate from the same region.
+	// The render device keeps a second ring with indirect buffer usage for the commands of batched draws
+	class TransientUniformRing
+	{
+	public:
+
+		// Allocation offsets are aligned to the given alignment, which has to suit every way the buffer is bound through its usage
+		TransientUniformRing(RenderDeviceVk* pRenderDevice, const char* pName, u32 framesInFlight, u64 regionSize, VkBufferUsageFlags usage, u64 alignment);
+		~TransientUniformRing();
+
+		TransientUniformRing(const TransientUniformRing& other) = delete;
+		TransientUniformRing& operator=(const TransientUniformRing& other) = delete;
+
+		// Sub-allocate from the given frame's region. The region never grows, since descriptors may already point at the
+		// buffer, so allocations fail once the region is full. A failed allocation doesn't use up any space
+		TransientUniformRingAllocation Allocate(u32 frameIndex, u64 sizeBytes);
+
+		// Same as Allocate, but doesn't log anything when the allocation fails. For callers that have a fallback
+		TransientUniformRingAllocation TryAllocate(u32 frameIndex, u64 sizeBytes);
+
+		// Must only be called once the GPU is done with the frame that last used the region
+		void Reset(u32 frameIndex);
+
+		VkBuffer GetBuffer() const;
+		u64 GetRegionSize() const;
+
+	private:
+
+		RenderDeviceVk* m_renderDevice;
+		BufferData m_buffer;
+		u64 m_regionSize;
+		u64 m_alignment;
+		u32 m_regionCount;
+		std::unique_ptr<std::atomic<u64>[]> m_regionOffsets;
+	};
+}
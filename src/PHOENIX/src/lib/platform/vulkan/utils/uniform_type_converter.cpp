@@ -21,6 +21,8 @@ namespace PHX
 			case UNIFORM_TYPE::STORAGE_BUFFER:			return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
 			case UNIFORM_TYPE::INPUT_ATTACHMENT:		return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
 			case UNIFORM_TYPE::ACCELERATION_STRUCTURE:	return VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+			case UNIFORM_TYPE::UNIFORM_BUFFER_DYNAMIC:	return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+			case UNIFORM_TYPE::STORAGE_BUFFER_DYNAMIC:	return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
 			case UNIFORM_TYPE::MAX:						break;
 			}
 
@@ -131,6 +131,28 @@ namespace PHX
 
 	////////////////////////////////////////////////////////////////////////////////
 
+	static bool ArePushConstantRangesEqual(const PushConstantRange* pRangesA, u32 rangeCountA, const PushConstantRange* pRangesB, u32 rangeCountB)
+	{
+		if (!CanPointersBeUsedForComparison(pRangesA, pRangesB))
+		{
+			return false;
+		}
+
+		if (!ArePointersNotNull(pRangesA, pRangesB))
+		{
+			return true;
+		}
+
+		if (rangeCountA != rangeCountB)
+		{
+			return false;
+		}
+
+		return (memcmp(pRangesA, pRangesB, rangeCountA * sizeof(PushConstantRange)) == 0);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+
 	bool ComputePipelineDesc::operator==(const ComputePipelineDesc& other) const
 	{
 		// SHADERS
@@ -140,6 +162,12 @@ namespace PHX
 			return false;
 		}
 
+		// PUSH CONSTANTS
+		if (!ArePushConstantRangesEqual(pPushConstantRanges, pushConstantRangeCount, other.pPushConstantRanges, other.pushConstantRangeCount))
+		{
+			return false;
+		}
+
 		// UNIFORMS
 		bool uniformsEqual = AreUniformsEqual(uniformCollection, other.uniformCollection);
 
@@ -185,6 +213,12 @@ namespace PHX
 			return false;
 		}
 
+		// PUSH CONSTANTS
+		if (!ArePushConstantRangesEqual(pPushConstantRanges, pushConstantRangeCount, other.pPushConstantRanges, other.pushConstantRangeCount))
+		{
+			return false;
+		}
+
 		// OTHER MEMBERS: everything else from the pipeline desc struct is trivially-comparable
 		const int cmpResult = memcmp(this, &other, offsetof(GraphicsPipelineDesc, uniformCollection));
 		return (cmpResult == 0);
@@ -227,6 +261,12 @@ namespace PHX
 			return false;
 		}
 
+		// PUSH CONSTANTS
+		if (!ArePushConstantRangesEqual(pPushConstantRanges, pushConstantRangeCount, other.pPushConstantRanges, other.pushConstantRangeCount))
+		{
+			return false;
+		}
+
 		// HIT GROUPS
 		if (hitGroupCount != other.hitGroupCount)
 		{
@@ -2,6 +2,7 @@
 
 #include "PHX/types/attachment_desc.h"
 #include "PHX/types/clear_color.h"
+#include "PHX/types/texture_desc.h"
 
 namespace PHX
 {
@@ -24,6 +25,9 @@ namespace PHX
 		Handle handle		= INVALID_HANDLE;
 		RESOURCE_TYPE type	= RESOURCE_TYPE::TEXTURE;
 
+		// Texture only. Clamped to the texture, and left at the default range if it covers the entire texture
+		TextureSubresourceRange subresourceRange = {};
+
 		u64 resourceID		= U64_MAX;
 	};
 
@@ -36,6 +40,7 @@ namespace PHX
 		ATTACHMENT_STORE_OP storeOp		= ATTACHMENT_STORE_OP::IGNORE;
 		ATTACHMENT_LOAD_OP loadOp		= ATTACHMENT_LOAD_OP::IGNORE;
 		ClearValues clearValue			= {};	// Used when loadOp == CLEAR
+		bool isInputAttachment			= false;	// Read through an input attachment rather than sampled
 
 		// Buffer only
 		BufferUsageFlags bufferUsage	= BUFFER_USAGE_FLAG_UNIFORM_BUFFER;
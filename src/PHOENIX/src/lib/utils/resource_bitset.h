@@ -0,0 +1,206 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "BSL/integral_types.h"
+#include "cache_utils.h"
+
+namespace PHX
+{
+	// Dynamically-sized bitset used to track physical resource indices in the render graph. Storage
+	// only grows up to the highest bit that was set, so the cost of every operation scales with the number
+	// of resources registered in a frame instead of the maximum number of resources that can be registered.
+	// Bits that were never set are implicitly zero, so bitsets of different sizes can be freely combined
+	class ResourceBitset
+	{
+	public:
+
+		ResourceBitset() = default;
+		~ResourceBitset() = default;
+
+		void Set(u32 index)
+		{
+			const u32 wordIndex = index / s_bitsPerWord;
+			if (wordIndex >= static_cast<u32>(m_words.size()))
+			{
+				m_words.resize(wordIndex + 1, 0);
+			}
+			m_words[wordIndex] |= (1ull << (index % s_bitsPerWord));
+		}
+
+		bool Test(u32 index) const
+		{
+			const u32 wordIndex = index / s_bitsPerWord;
+			if (wordIndex >= static_cast<u32>(m_words.size()))
+			{
+				return false;
+			}
+			return (m_words[wordIndex] & (1ull << (index % s_bitsPerWord))) != 0;
+		}
+
+		// Keeps the storage around, so setting bits again doesn't allocate
+		void Clear()
+		{
+			m_words.clear();
+		}
+
+		// Size of the storage in bytes
+		size_t GetCapacityBytes() const
+		{
+			return m_words.capacity() * sizeof(u64);
+		}
+
+		bool Any() const
+		{
+			for (u64 word : m_words)
+			{
+				if (word != 0)
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		bool None() const
+		{
+			return !Any();
+		}
+
+		// Returns the number of set bits
+		u32 Count() const
+		{
+			u32 count = 0;
+			for (u64 word : m_words)
+			{
+				count += PopCount(word);
+			}
+			return count;
+		}
+
+		// Returns true if any bit is set in both bitsets. Cheaper than Any() on the result
+		// of operator&, since no intermediate bitset is created
+		bool Intersects(const ResourceBitset& other) const
+		{
+			const size_t wordCount = std::min(m_words.size(), other.m_words.size());
+			for (size_t i = 0; i < wordCount; i++)
+			{
+				if ((m_words[i] & other.m_words[i]) != 0)
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		// Returns the bits that are set in this bitset but not in other. Equivalent to (a & ~b)
+		ResourceBitset Difference(const ResourceBitset& other) const
+		{
+			ResourceBitset result = *this;
+			const size_t wordCount = std::min(m_words.size(), other.m_words.size());
+			for (size_t i = 0; i < wordCount; i++)
+			{
+				result.m_words[i] &= ~other.m_words[i];
+			}
+			return result;
+		}
+
+		ResourceBitset& operator|=(const ResourceBitset& other)
+		{
+			if (other.m_words.size() > m_words.size())
+			{
+				m_words.resize(other.m_words.size(), 0);
+			}
+			for (size_t i = 0; i < other.m_words.size(); i++)
+			{
+				m_words[i] |= other.m_words[i];
+			}
+			return *this;
+		}
+
+		ResourceBitset operator|(const ResourceBitset& other) const
+		{
+			ResourceBitset result = *this;
+			result |= other;
+			return result;
+		}
+
+		ResourceBitset operator&(const ResourceBitset& other) const
+		{
+			ResourceBitset result;
+			result.m_words.resize(std::min(m_words.size(), other.m_words.size()));
+			for (size_t i = 0; i < result.m_words.size(); i++)
+			{
+				result.m_words[i] = m_words[i] & other.m_words[i];
+			}
+			return result;
+		}
+
+		// Calls fn(u32 index) for every set bit, in ascending order. Only visits set bits, so
+		// sparse bitsets are iterated in roughly one step per set bit
+		template<typename FnT>
+		void ForEachSetBit(FnT fn) const
+		{
+			for (u32 wordIndex = 0; wordIndex < static_cast<u32>(m_words.size()); wordIndex++)
+			{
+				u64 word = m_words[wordIndex];
+				while (word != 0)
+				{
+					const u32 bitIndex = CountTrailingZeros(word);
+					fn(wordIndex * s_bitsPerWord + bitIndex);
+					word &= (word - 1); // Clear lowest set bit
+				}
+			}
+		}
+
+		// Hash of the set bits. Trailing zero words are ignored, so equal sets of bits
+		// always hash to the same value regardless of how much storage was allocated
+		size_t Hash() const
+		{
+			size_t wordCount = m_words.size();
+			while (wordCount > 0 && m_words[wordCount - 1] == 0)
+			{
+				wordCount--;
+			}
+
+			size_t seed = 0;
+			HashCombine(seed, wordCount);
+			for (size_t i = 0; i < wordCount; i++)
+			{
+				HashCombine(seed, m_words[i]);
+			}
+			return seed;
+		}
+
+	private:
+
+		static u32 CountTrailingZeros(u64 word)
+		{
+#if defined(_MSC_VER)
+			unsigned long index;
+			_BitScanForward64(&index, word);
+			return static_cast<u32>(index);
+#else
+			return static_cast<u32>(__builtin_ctzll(word));
+#endif
+		}
+
+		static u32 PopCount(u64 word)
+		{
+#if defined(_MSC_VER)
+			return static_cast<u32>(__popcnt64(word));
+#else
+			return static_cast<u32>(__builtin_popcountll(word));
+#endif
+		}
+
+		static constexpr u32 s_bitsPerWord = 64;
+
+		std::vector<u64> m_words;
+	};
+}
@@ -0,0 +1,90 @@
+
+#include "worker_pool.h"
+
+#include "core/profiling.h"
+
+namespace PHX
+{
+	WorkerPool::WorkerPool(u32 workerCount) : m_workers(), m_mutex(), m_jobAvailable(), m_jobFinished(), m_pJob(nullptr), m_runIndex(0), m_pendingWorkers(0),
+		m_isStopping(false)
+	{
+		m_workers.reserve(workerCount);
+		for (u32 i = 0; i < workerCount; i++)
+		{
+			m_workers.emplace_back(&WorkerPool::WorkerMain, this, i);
+		}
+	}
+
+	WorkerPool::~WorkerPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_isStopping = true;
+		}
+		m_jobAvailable.notify_all();
+
+		for (std::thread& worker : m_workers)
+		{
+			worker.join();
+		}
+		m_workers.clear();
+	}
+
+	void WorkerPool::Run(const std::function<void(u32)>& job)
+	{
+		PROFILE_SCOPE("WorkerPool_Run");
+
+		if (m_workers.empty())
+		{
+			return;
+		}
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_pJob = &job;
+		m_pendingWorkers = static_cast<u32>(m_workers.size());
+		m_runIndex++;
+		m_jobAvailable.notify_all();
+
+		m_jobFinished.wait(lock, [this]() { return m_pendingWorkers == 0; });
+		m_pJob = nullptr;
+	}
+
+	u32 WorkerPool::GetWorkerCount() const
+	{
+		return static_cast<u32>(m_workers.size());
+	}
+
+	void WorkerPool::WorkerMain(u32 workerIndex)
+	{
+		u64 lastRunIndex = 0;
+		while (true)
+		{
+			const std::function<void(u32)>* pJob = nullptr;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_jobAvailable.wait(lock, [&]() { return m_isStopping || m_runIndex != lastRunIndex; });
+				if (m_isStopping)
+				{
+					return;
+				}
+
+				lastRunIndex = m_runIndex;
+				pJob = m_pJob;
+			}
+
+			(*pJob)(workerIndex);
+
+			bool isLastWorker = false;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_pendingWorkers--;
+				isLastWorker = (m_pendingWorkers == 0);
+			}
+
+			if (isLastWorker)
+			{
+				m_jobFinished.notify_one();
+			}
+		}
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "BSL/integral_types.h"
+
+namespace PHX
+{
+	// Fixed set of worker threads which all run the same job. Work is distributed by the job itself based on the
+	// worker index, so the worker that processes any given piece of work is always the same. This lets callers set up
+	// per-worker state ahead of time (e.g. command pools) without any synchronization
+	class WorkerPool
+	{
+	public:
+
+		explicit WorkerPool(u32 workerCount);
+		~WorkerPool();
+
+		WorkerPool(const WorkerPool& other) = delete;
+		WorkerPool& operator=(const WorkerPool& other) = delete;
+
+		// Calls job(workerIndex) once on every worker, and blocks until all of them return
+		void Run(const std::function<void(u32)>& job);
+
+		u32 GetWorkerCount() const;
+
+	private:
+
+		void WorkerMain(u32 workerIndex);
+
+	private:
+
+		std::vector<std::thread> m_workers;
+
+		std::mutex m_mutex;
+		std::condition_variable m_jobAvailable;
+		std::condition_variable m_jobFinished;
+
+		const std::function<void(u32)>* m_pJob; // Job of the current run, only valid while Run() is blocking
+		u64 m_runIndex;                         // Incremented for every run, so workers can tell a new job apart from the previous one
+		u32 m_pendingWorkers;                   // Workers which haven't finished the current run yet
+		bool m_isStopping;
+	};
+}
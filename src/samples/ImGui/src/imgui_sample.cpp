@@ -30,7 +30,14 @@ void ImGuiSample::UpdateSample(float dt)
 	ImGui::Text("Vertex count: %u", metrics.vertices);
 	ImGui::Text("Index count: %u", metrics.indices);
 	ImGui::Text("Triangle count: %u", metrics.triangles);
+	ImGui::Text("Skipped state commands: %u", metrics.skippedStateCommands);
 	ImGui::Text("Pass count: %u", metrics.passCount);
+	ImGui::Text("Frame storage growths: %u", metrics.frameStorageGrowths);
+	ImGui::Text("Barrier commands / barriers: %u / %u", metrics.barrierCommands, metrics.barriers);
+	ImGui::Text("Split barriers: %u", metrics.splitBarriers);
+	ImGui::Text("Removed barrier stage bits: %u", metrics.removedStageBits);
+	ImGui::Text("Bake cache hits / misses: %u / %u", metrics.bakeCacheHits, metrics.bakeCacheMisses);
+	ImGui::Text("Bake time: %2.3f (milliseconds)", metrics.bakeTime);
 	ImGui::Text("");
 	ImGui::Text("Buffer count: %u", metrics.bufferCount);
 	ImGui::Text("Texture count: %u", metrics.textureCount);
@@ -40,7 +47,17 @@ void ImGuiSample::UpdateSample(float dt)
 	ImGui::Text("Accel struct count: %u", metrics.accelerationStructureCount);
 	ImGui::Text("");
 	ImGui::Text("Allocated memory (bytes): %u", metrics.allocatedMemoryBytes);
-	ImGui::Text("GPU frametime: %2.3f (milliseconds)", metrics.gpuFrameTime);
+	ImGui::Text("Transient memory (bytes): %u / %u unaliased", metrics.transientMemoryBytes, metrics.transientMemoryUnaliasedBytes);
+	ImGui::Text("Staging memory (bytes): %llu / %llu peak", metrics.stagingMemoryBytes, metrics.peakStagingMemoryBytes);
+	ImGui::Text("GPU frametime: %2.3f (milliseconds), frame %u", metrics.gpuFrameTime, metrics.gpuFrameNumber);
+	ImGui::Text("");
+
+	u32 passMetricsCount = 0;
+	const PHX::PassMetrics* pPassMetrics = m_renderGraph.GetPassMetrics(passMetricsCount);
+	for (u32 i = 0; i < passMetricsCount; i++)
+	{
+		ImGui::Text("Pass \"%s\": %2.3f (milliseconds)", pPassMetrics[i].name, pPassMetrics[i].gpuTime);
+	}
 	ImGui::End();
 
 	ImGui::ShowDemoWindow();
@@ -2,6 +2,7 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstring>
 #include <fstream>
 #include <gtc/matrix_transform.hpp>
 #include <gtc/quaternion.hpp>
@@ -162,13 +163,18 @@ void InstancedAnimationSample::Draw()
 
 		graphicsPass.SetExecuteCallback([&, indexCount](DeviceContextHandle deviceContext)
 		{
-			// Update camera UBO
+			// Write the camera data straight into transient uniform memory, no copy or transfer pass needed
 			m_cameraData.boneCount = static_cast<uint32_t>(asset->skeleton.bones.size());
-			deviceContext.CopyDataToBuffer(m_cameraBuffer, &m_cameraData, sizeof(CameraData));
+			TransientUniformAllocation cameraAlloc{};
+			if (deviceContext.AllocateTransientUniform(sizeof(CameraData), cameraAlloc) != STATUS_CODE::SUCCESS)
+			{
+				return;
+			}
+			memcpy(cameraAlloc.pData, &m_cameraData, sizeof(CameraData));
 
 			m_graphicsUniformCollection.QueueBufferUpdate(m_boneMatrixBuffer, 0, 0, 0);
 			m_graphicsUniformCollection.QueueBufferUpdate(m_instanceBuffer, 0, 1, 0);
-			m_graphicsUniformCollection.QueueBufferUpdate(m_cameraBuffer, 0, 2, 0);
+			m_graphicsUniformCollection.QueueTransientBufferUpdate(0, 2, sizeof(CameraData));
 
 			for (u32 i = 0; i < m_assetTextures.size(); i++)
 			{
@@ -177,7 +183,7 @@ void InstancedAnimationSample::Draw()
 
 			deviceContext.FlushUniformUpdates(m_graphicsUniformCollection);
 
-			deviceContext.BindUniformCollection(m_graphicsUniformCollection);
+			deviceContext.BindUniformCollection(m_graphicsUniformCollection, &cameraAlloc.offset, 1);
 			deviceContext.BindMesh(m_vertexBuffer, m_indexBuffer);
 			deviceContext.SetScissor({ m_swapChain.GetWidth(), m_swapChain.GetHeight() }, { 0, 0 });
 			deviceContext.SetViewport({ m_swapChain.GetWidth(), m_swapChain.GetHeight() }, { 0, 0 });
@@ -418,16 +424,6 @@ void InstancedAnimationSample::InitSample()
 		CHECK_PHX_RES(phxRes);
 	}
 
-	// Camera UBO
-	{
-		BufferCreateInfo ci{};
-		ci.pName = "CameraBuffer";
-		ci.bufferUsage = BUFFER_USAGE_FLAG_UNIFORM_BUFFER;
-		ci.sizeBytes = sizeof(CameraData);
-		phxRes = m_renderDevice.AllocateBuffer(ci, m_cameraBuffer);
-		CHECK_PHX_RES(phxRes);
-	}
-
 	// Animation params UBO
 	{
 		BufferCreateInfo ci{};
@@ -579,12 +575,12 @@ void InstancedAnimationSample::CreateUniformCollections()
 	m_computeUniformCollection.QueueBufferUpdate(m_nodeTransformBuffer, 0, 8, 0);
 
 	// GRAPHICS uniform collection
-	// Set 0: bone matrices, instance data, camera
+	// Set 0: bone matrices, instance data, camera. The camera data is allocated from the transient uniform ring every frame
 	std::vector<UniformData> graphicsSet0 =
 	{
 		{ 0, UNIFORM_TYPE::STORAGE_BUFFER, SHADER_STAGE_FLAG_VERTEX },
 		{ 1, UNIFORM_TYPE::STORAGE_BUFFER, SHADER_STAGE_FLAG_VERTEX },
-		{ 2, UNIFORM_TYPE::UNIFORM_BUFFER, SHADER_STAGE_FLAG_VERTEX },
+		{ 2, UNIFORM_TYPE::UNIFORM_BUFFER_DYNAMIC, SHADER_STAGE_FLAG_VERTEX },
 	};
 
 	UniformDataGroup gSet0{};
@@ -616,7 +612,7 @@ void InstancedAnimationSample::CreateUniformCollections()
 	// Queue buffer bindings for graphics
 	m_graphicsUniformCollection.QueueBufferUpdate(m_boneMatrixBuffer, 0, 0, 0);
 	m_graphicsUniformCollection.QueueBufferUpdate(m_instanceBuffer, 0, 1, 0);
-	m_graphicsUniformCollection.QueueBufferUpdate(m_cameraBuffer, 0, 2, 0);
+	m_graphicsUniformCollection.QueueTransientBufferUpdate(0, 2, sizeof(CameraData));
 }
 
 void InstancedAnimationSample::RegenerateInstanceData()
@@ -780,9 +776,18 @@ void InstancedAnimationSample::UploadDataToGPU()
 			const Common::TextureType& texSrc = asset->textures[i];
 			TextureHandle texDst = m_assetTextures[i];
 
+			// Every mip level is uploaded with a single copy
+			std::vector<TextureUploadRegion> mipRegions(texSrc.mipLevels.size());
 			for (u32 mip = 0; mip < texSrc.mipLevels.size(); mip++)
 			{
-				deviceContext.CopyDataToTexture(texDst, texSrc.mipLevels[mip].data.data(), texSrc.mipLevels[mip].dataSize, mip);
+				mipRegions[mip].pData = texSrc.mipLevels[mip].data.data();
+				mipRegions[mip].sizeBytes = texSrc.mipLevels[mip].dataSize;
+				mipRegions[mip].mipLevel = mip;
+			}
+
+			if (!mipRegions.empty())
+			{
+				deviceContext.CopyDataToTexture(texDst, mipRegions.data(), static_cast<u32>(mipRegions.size()));
 			}
 		}
 	});
@@ -123,7 +123,6 @@ private:
 
 	// GPU buffers — dynamic (updated per frame)
 	PHX::BufferHandle m_boneMatrixBuffer;    // mat4[instanceCount * boneCount]
-	PHX::BufferHandle m_cameraBuffer;        // CameraData
 	PHX::BufferHandle m_animParamsBuffer;    // AnimParamsData
 
 	// Textures
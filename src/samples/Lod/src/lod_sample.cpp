@@ -311,6 +311,7 @@ void LodSample::UpdateSample(float dt)
 	ImGui::Text("Toggle to Freefly to inspect culling");
 	ImGui::Separator();
 	ImGui::Text("Instances: %u", m_lodManager.GetInstanceCount());
+	ImGui::Text("Visible instances: %u", m_visibleInstanceCount);
 	ImGui::Text("LOD groups: %u", m_lodManager.GetGroupCount());
 	ImGui::Text("Total LOD levels: %u", m_lodManager.GetTotalLodLevels());
 	ImGui::Text("IndirectCount: %s", m_useIndirectCount ? "Yes" : "No (fallback)");
@@ -581,6 +582,38 @@ void LodSample::Draw()
 		});
 	}
 
+	// TRANSFER PASS — read back the culling results to count the visible instances.
+	// Nothing in the frame depends on it, so it's marked as a root to keep it from being trimmed.
+	{
+		PHX::RenderPassHandle readbackPass;
+		phxRes = m_renderGraph.RegisterPass("LodVisibleReadback", PHX::PASS_TYPE::TRANSFER, readbackPass);
+		if (phxRes != PHX::STATUS_CODE::SUCCESS) return;
+
+		readbackPass.SetBufferInput(m_lodManager.GetArgsBuffer());
+		readbackPass.MarkAsRoot();
+
+		readbackPass.SetExecuteCallback([this](PHX::DeviceContextHandle deviceContext)
+		{
+			// The callback runs once the GPU is done with this frame, and releases the readback afterwards
+			PHX::ReadbackTicket ticket;
+			const uint64_t argsSize = static_cast<uint64_t>(m_lodManager.GetMaxDrawCount()) * sizeof(Common::DrawIndexedIndirectCommand);
+			if (argsSize == 0) return;
+
+			deviceContext.ReadbackBuffer(m_lodManager.GetArgsBuffer(), 0, argsSize, ticket, [this](const void* pData, uint64_t sizeBytes)
+			{
+				const Common::DrawIndexedIndirectCommand* pCommands = static_cast<const Common::DrawIndexedIndirectCommand*>(pData);
+				const uint64_t commandCount = sizeBytes / sizeof(Common::DrawIndexedIndirectCommand);
+
+				uint32_t visibleCount = 0;
+				for (uint64_t i = 0; i < commandCount; i++)
+				{
+					visibleCount += pCommands[i].instanceCount;
+				}
+				m_visibleInstanceCount = visibleCount;
+			});
+		});
+	}
+
 	// GRAPHICS PASS — render LOD meshes
 	{
 		PHX::RenderPassHandle graphicsPass;
@@ -87,6 +87,7 @@ private:
 	std::vector<Common::LodInstanceData> m_instances;
 	uint32_t m_instanceCount = 1000;
 	bool m_instancesDirty = true;
+	uint32_t m_visibleInstanceCount = 0; // Read back from the culling results, a few frames late
 
 	// Settings (ImGui-controlled)
 	bool m_wireframe = false;
@@ -703,9 +703,19 @@ void RayTracingSample::BuildSceneAccelerationStructures()
 			u32 texHandleIdx = m_textureIndexRemap[i];
 			if (texHandleIdx >= m_sceneTextures.size())
 				continue;
+
+			// Every mip level is uploaded with a single copy
+			std::vector<TextureUploadRegion> mipRegions(texSrc.mipLevels.size());
 			for (u32 mip = 0; mip < texSrc.mipLevels.size(); mip++)
 			{
-				deviceContext.CopyDataToTexture(m_sceneTextures[texHandleIdx], texSrc.mipLevels[mip].data.data(), texSrc.mipLevels[mip].dataSize, mip);
+				mipRegions[mip].pData = texSrc.mipLevels[mip].data.data();
+				mipRegions[mip].sizeBytes = texSrc.mipLevels[mip].dataSize;
+				mipRegions[mip].mipLevel = mip;
+			}
+
+			if (!mipRegions.empty())
+			{
+				deviceContext.CopyDataToTexture(m_sceneTextures[texHandleIdx], mipRegions.data(), static_cast<u32>(mipRegions.size()));
 			}
 		}
 	});
@@ -0,0 +1,18 @@
+#include "render_graph_stress_sample.h"
+
+int main(int argc, char** argv)
+{
+	(void)argc;
+	(void)argv;
+
+	RenderGraphStressSample sample;
+	sample.Init();
+
+	while (!sample.Update(0.016f))
+	{
+		sample.Draw();
+	}
+
+	sample.Shutdown();
+	return 0;
+}
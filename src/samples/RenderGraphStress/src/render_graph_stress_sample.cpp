@@ -0,0 +1,145 @@
+#include <imgui.h>
+
+#include "render_graph_stress_sample.h"
+
+using namespace PHX;
+
+#define CHECK_PHX_RES(phxRes) if(phxRes != PHX::STATUS_CODE::SUCCESS) { return; }
+
+static constexpr u32 PASS_COUNT = 1000;
+static constexpr u32 BUFFER_COUNT = 5000;
+static constexpr u32 OUTPUTS_PER_PASS = BUFFER_COUNT / PASS_COUNT;
+static constexpr u32 INPUTS_PER_PASS = 2; // Read from the previous pass' outputs
+
+// Frames replayed from the bake cache before the render graph counts as steady. Covers the frames in flight, whose
+// query records only reach their final size the first time each of them is used
+static constexpr u32 STEADY_STATE_WARMUP_FRAMES = 8;
+
+RenderGraphStressSample::RenderGraphStressSample() : m_buffers(), m_forceRebake(false), m_averageBakeTime(0.0f), m_lastBakeCacheMisses(0),
+	m_replayedFrameCount(0), m_growingSteadyStateFrames(0)
+{
+}
+
+RenderGraphStressSample::~RenderGraphStressSample()
+{
+}
+
+void RenderGraphStressSample::UpdateSample(float dt)
+{
+	m_imguiBackend.NewFrame(dt, m_swapChain.GetWidth(), m_swapChain.GetHeight());
+
+	const PHX::Metrics& metrics = m_renderGraph.GetMetrics();
+	m_averageBakeTime += (metrics.bakeTime - m_averageBakeTime) * 0.05f;
+
+	if (metrics.bakeCacheMisses != m_lastBakeCacheMisses)
+	{
+		m_lastBakeCacheMisses = metrics.bakeCacheMisses;
+		m_replayedFrameCount = 0;
+	}
+	else if (++m_replayedFrameCount > STEADY_STATE_WARMUP_FRAMES && metrics.frameStorageGrowths != 0)
+	{
+		m_growingSteadyStateFrames++;
+	}
+
+	ImGui::Begin("Render Graph Stress");
+	ImGui::Text("Registered passes: %u", PASS_COUNT + 1);
+	ImGui::Text("Registered buffers: %u", BUFFER_COUNT);
+	ImGui::Text("Active passes: %u", metrics.passCount);
+	ImGui::Checkbox("Force re-bake every frame", &m_forceRebake);
+	ImGui::Separator();
+	ImGui::Text("Bake time: %2.3f (milliseconds)", metrics.bakeTime);
+	ImGui::Text("Bake time (average): %2.3f (milliseconds)", m_averageBakeTime);
+	ImGui::Text("Bake cache hits / misses: %u / %u", metrics.bakeCacheHits, metrics.bakeCacheMisses);
+	ImGui::Text("Frame storage growths: %u", metrics.frameStorageGrowths);
+	if (m_growingSteadyStateFrames > 0)
+	{
+		ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "Steady-state frames that grew storage: %u (expected 0)", m_growingSteadyStateFrames);
+	}
+	ImGui::Text("GPU frametime: %2.3f (milliseconds)", metrics.gpuFrameTime);
+	ImGui::End();
+}
+
+void RenderGraphStressSample::Draw()
+{
+	m_renderGraph.BeginFrame(m_swapChain);
+
+	RegisterStressPasses();
+
+	ImGui::Render();
+	m_imguiRenderer.RenderDrawData(m_renderGraph, m_swapChain, ImGui::GetDrawData(), false);
+
+	m_renderGraph.Bake(m_swapChain);
+
+	m_renderGraph.EndFrame(m_swapChain);
+}
+
+void RenderGraphStressSample::InitSample()
+{
+	m_window.SetWindowTitle("PHX %u.%u.%u | RENDER GRAPH STRESS", PHX::GetMajorVersion(), PHX::GetMinorVersion(), PHX::GetPatchVersion());
+
+	m_buffers.resize(BUFFER_COUNT);
+	for (u32 i = 0; i < BUFFER_COUNT; i++)
+	{
+		BufferCreateInfo bufferCI{};
+		bufferCI.pName = "StressBuffer";
+		bufferCI.bufferUsage = BUFFER_USAGE_FLAG_STORAGE_BUFFER;
+		bufferCI.sizeBytes = 16;
+		STATUS_CODE phxRes = m_renderDevice.AllocateBuffer(bufferCI, m_buffers[i]);
+		CHECK_PHX_RES(phxRes);
+	}
+}
+
+void RenderGraphStressSample::ShutdownSample()
+{
+	m_buffers.clear();
+}
+
+void RenderGraphStressSample::RegisterStressPasses()
+{
+	STATUS_CODE phxRes;
+
+	// Chain of transfer passes. Every pass owns OUTPUTS_PER_PASS buffers and reads some of the
+	// previous pass' outputs, so the whole chain contributes to the final pass and is never trimmed
+	for (u32 passIndex = 0; passIndex < PASS_COUNT; passIndex++)
+	{
+		RenderPassHandle renderPass;
+		phxRes = m_renderGraph.RegisterPass("StressPass", PASS_TYPE::TRANSFER, renderPass);
+		CHECK_PHX_RES(phxRes);
+
+		if (passIndex > 0)
+		{
+			const u32 prevFirstOutput = (passIndex - 1) * OUTPUTS_PER_PASS;
+			for (u32 i = 0; i < INPUTS_PER_PASS; i++)
+			{
+				renderPass.SetBufferInput(m_buffers[prevFirstOutput + i]);
+			}
+		}
+		else if (m_forceRebake)
+		{
+			// Read from a different buffer every frame, which changes the shape of the render graph
+			renderPass.SetBufferInput(m_buffers[m_renderGraph.GetFrameNumber() % BUFFER_COUNT]);
+		}
+
+		const u32 firstOutput = passIndex * OUTPUTS_PER_PASS;
+		for (u32 i = 0; i < OUTPUTS_PER_PASS; i++)
+		{
+			renderPass.SetBufferOutput(m_buffers[firstOutput + i]);
+		}
+	}
+
+	// Clear-only pass that consumes the end of the chain and writes the backbuffer
+	ClearValues clearColor{};
+	clearColor.color.color = { 0.1f, 0.1f, 0.1f, 0.0f };
+	clearColor.useClearColor = true;
+
+	RenderPassHandle finalPass;
+	phxRes = m_renderGraph.RegisterPass("StressFinal", PASS_TYPE::GRAPHICS, finalPass);
+	CHECK_PHX_RES(phxRes);
+
+	const u32 lastFirstOutput = (PASS_COUNT - 1) * OUTPUTS_PER_PASS;
+	for (u32 i = 0; i < INPUTS_PER_PASS; i++)
+	{
+		finalPass.SetBufferInput(m_buffers[lastFirstOutput + i]);
+	}
+	finalPass.SetTextureOutput(m_swapChain.GetCurrentImage(), ATTACHMENT_LOAD_OP::CLEAR, ATTACHMENT_STORE_OP::STORE, clearColor);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+
+#include "../../common/src/base_sample.h"
+
+// Synthetic render graph used to measure the CPU cost of baking large graphs. Registers a long
+// chain of transfer passes every frame, each one declaring a handful of buffer inputs and outputs
+class RenderGraphStressSample : public Common::BaseSample
+{
+public:
+
+	RenderGraphStressSample();
+	~RenderGraphStressSample() override;
+
+	void Draw() override;
+
+private:
+
+	void InitSample() override;
+	void ShutdownSample() override;
+	void UpdateSample(float dt) override;
+
+	void RegisterStressPasses();
+
+private:
+
+	std::vector<PHX::BufferHandle> m_buffers;
+
+	// Changes the shape of the render graph every frame so that it is always re-baked
+	// instead of being replayed from the render graph's bake cache
+	bool m_forceRebake;
+
+	float m_averageBakeTime;
+
+	// Steady-state storage check. Once the render graph has been replayed from the bake cache for a few frames, no frame
+	// should have to grow the storage reused every frame, so any frame that does is counted
+	u32 m_lastBakeCacheMisses;
+	u32 m_replayedFrameCount;
+	u32 m_growingSteadyStateFrames;
+};
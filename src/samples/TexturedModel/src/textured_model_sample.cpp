@@ -459,9 +459,18 @@ void TexturedModelSample::UploadMeshDataToGPU()
 			const Common::TextureType& texSrc = pAsset->textures[i];
 			TextureHandle texDst = m_assetTextures[i];
 
+			// Every mip level is uploaded with a single copy
+			std::vector<TextureUploadRegion> mipRegions(texSrc.mipLevels.size());
 			for (u32 mip = 0; mip < texSrc.mipLevels.size(); mip++)
 			{
-				deviceContext.CopyDataToTexture(texDst, texSrc.mipLevels[mip].data.data(), texSrc.mipLevels[mip].dataSize, mip);
+				mipRegions[mip].pData = texSrc.mipLevels[mip].data.data();
+				mipRegions[mip].sizeBytes = texSrc.mipLevels[mip].dataSize;
+				mipRegions[mip].mipLevel = mip;
+			}
+
+			if (!mipRegions.empty())
+			{
+				deviceContext.CopyDataToTexture(texDst, mipRegions.data(), static_cast<u32>(mipRegions.size()));
 			}
 		}
 	});
@@ -362,6 +362,18 @@ namespace Common
 				u32 globalVertexOffset = 0;
 				u32 globalIndexOffset = 0;
 
+				// Consecutive commands with the same clip rect only differ in their ranges, so they're drawn as a single batch
+				std::vector<DrawIndexedArgs> batch;
+				u32 batchScissor[4] = { 0, 0, 0, 0 }; // x, y, w, h
+				auto flushBatch = [&]()
+				{
+					if (batch.empty()) return;
+
+					deviceContext.SetScissor({ batchScissor[2], batchScissor[3] }, { batchScissor[0], batchScissor[1] });
+					deviceContext.DrawIndexedBatch(batch.data(), static_cast<u32>(batch.size()));
+					batch.clear();
+				};
+
 				for (int n = 0; n < drawData->CmdListsCount; n++)
 				{
 					const ImDrawList* cmdList = drawData->CmdLists[n];
@@ -386,9 +398,20 @@ namespace Common
 						u32 scissorW = static_cast<u32>(clipMax.x - clipMin.x);
 						u32 scissorH = static_cast<u32>(clipMax.y - clipMin.y);
 
-						deviceContext.SetScissor({ scissorW, scissorH }, { scissorX, scissorY });
+						if (scissorX != batchScissor[0] || scissorY != batchScissor[1] || scissorW != batchScissor[2] || scissorH != batchScissor[3])
+						{
+							flushBatch();
+							batchScissor[0] = scissorX;
+							batchScissor[1] = scissorY;
+							batchScissor[2] = scissorW;
+							batchScissor[3] = scissorH;
+						}
 
-						deviceContext.DrawIndexed(static_cast<u32>(cmd.ElemCount), indexOffset, globalVertexOffset);
+						DrawIndexedArgs draw{};
+						draw.indexCount = static_cast<u32>(cmd.ElemCount);
+						draw.firstIndex = indexOffset;
+						draw.vertexOffset = static_cast<i32>(globalVertexOffset);
+						batch.push_back(draw);
 
 						indexOffset += static_cast<u32>(cmd.ElemCount);
 					}
@@ -396,6 +419,8 @@ namespace Common
 					globalVertexOffset += static_cast<u32>(cmdList->VtxBuffer.Size);
 					globalIndexOffset += static_cast<u32>(cmdList->IdxBuffer.Size);
 				}
+
+				flushBatch();
 			});
 		}
 
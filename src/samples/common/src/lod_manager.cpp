@@ -1,5 +1,6 @@
 #include "lod_manager.h"
 
+#include <cstring>
 #include <iostream>
 
 namespace Common
@@ -209,9 +210,47 @@ namespace Common
 
 	void LodManager::SetInstances(const std::vector<LodInstanceData>& instances)
 	{
+		// Diff against the previous instances so only runs of changed instances have to be uploaded.
+		// Any change in instance count re-uploads everything.
+		const bool sameCount = m_instanceBuffer.IsValid() && instances.size() == m_instances.size();
+		std::vector<std::pair<uint32_t, uint32_t>> dirtyRuns; // (first instance, instance count)
+		if (sameCount)
+		{
+			for (uint32_t i = 0; i < static_cast<uint32_t>(instances.size()); i++)
+			{
+				if (memcmp(&instances[i], &m_instances[i], sizeof(LodInstanceData)) == 0) continue;
+
+				if (!dirtyRuns.empty() && dirtyRuns.back().first + dirtyRuns.back().second == i)
+				{
+					dirtyRuns.back().second++;
+				}
+				else
+				{
+					dirtyRuns.push_back({ i, 1 });
+				}
+			}
+		}
+		else
+		{
+			dirtyRuns.push_back({ 0, static_cast<uint32_t>(instances.size()) });
+		}
+
 		m_instances = instances;
 		m_instanceCount = static_cast<uint32_t>(instances.size());
 
+		// Regions point into m_instances, which isn't touched again until the next SetInstances() call
+		m_dirtyInstanceRegions.clear();
+		for (const auto& run : dirtyRuns)
+		{
+			if (run.second == 0) continue;
+
+			PHX::BufferCopyRegion region{};
+			region.dstOffset = static_cast<uint64_t>(run.first) * sizeof(LodInstanceData);
+			region.pData = &m_instances[run.first];
+			region.sizeBytes = static_cast<uint64_t>(run.second) * sizeof(LodInstanceData);
+			m_dirtyInstanceRegions.push_back(region);
+		}
+
 		// Reallocate instance buffer if the current one is too small.
 		// PHX doesn't support buffer resize, so we drop the old handle and allocate a new one.
 		uint64_t requiredSize = static_cast<uint64_t>(m_instanceCount) * sizeof(LodInstanceData);
@@ -297,7 +336,7 @@ namespace Common
 
 	void LodManager::UploadInstances(PHX::RenderGraphHandle renderGraph)
 	{
-		if (m_instanceCount == 0) return;
+		if (m_instanceCount == 0 || m_dirtyInstanceRegions.empty()) return;
 
 		PHX::RenderPassHandle transferPass;
 		PHX::STATUS_CODE phxRes = renderGraph.RegisterPass("LodInstanceUpload", PHX::PASS_TYPE::TRANSFER, transferPass);
@@ -305,9 +344,13 @@ namespace Common
 
 		transferPass.SetBufferOutput(m_instanceBuffer);
 
-		transferPass.SetExecuteCallback([this](PHX::DeviceContextHandle deviceContext)
+		// All changed runs go through a single staging allocation and copy command
+		std::vector<PHX::BufferCopyRegion> regions = std::move(m_dirtyInstanceRegions);
+		m_dirtyInstanceRegions.clear();
+
+		transferPass.SetExecuteCallback([this, regions](PHX::DeviceContextHandle deviceContext)
 		{
-			deviceContext.CopyDataToBuffer(m_instanceBuffer, m_instances.data(), m_instanceCount * sizeof(LodInstanceData));
+			deviceContext.CopyDataToBuffer(m_instanceBuffer, regions.data(), static_cast<uint32_t>(regions.size()));
 		});
 	}
 
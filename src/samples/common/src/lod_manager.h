@@ -93,7 +93,8 @@ namespace Common
 		// Upload static data (vertex/index/lod descriptors) to GPU. Call once during init.
 		void UploadStaticData(PHX::RenderGraphHandle renderGraph);
 
-		// Upload instance data to GPU. Call when instance data changes.
+		// Upload instance data to GPU. Call when instance data changes. Only the instances
+		// that changed since the last SetInstances() call are uploaded.
 		void UploadInstances(PHX::RenderGraphHandle renderGraph);
 
 		// Zero the args and count buffers. Must be called before CullAndSelectGPU each frame.
@@ -146,6 +147,7 @@ namespace Common
 		std::vector<LodInstanceData>   m_instances;
 		std::vector<LodLevelGpu>       m_lodLevelsGpu;
 		std::vector<LodGroupGpu>       m_lodGroupsGpu;
+		std::vector<PHX::BufferCopyRegion> m_dirtyInstanceRegions; // Runs of changed instances, pending upload
 
 		uint32_t m_instanceCount = 0;
 		uint64_t m_instanceBufferSize = 0;  // Tracks allocated size of m_instanceBuffer